@@ -1,9 +1,13 @@
 #include "Channel.h"
+#include "Channel/ChannelCommandQueue.h"
+#include "System/AudioSystem.h"
+#include "Voice/VoiceManager.h"
 
 Channel::Channel()
 {
     this->pChannel = 0;
     this->pausedFlag = false;
+    this->suspendFlags = 0;
     this->volume = 1.0f;
     this->volumeRampFlag = false;
     this->pitch = 1.0f;
@@ -14,11 +18,47 @@ Channel::Channel()
     this->priority = 0;
     this->loopFlag = false;
     this->loopCount = -1;
+    this->sentPosition.x = 0.0f;
+    this->sentPosition.y = 0.0f;
+    this->sentPosition.z = 0.0f;
+    this->sentVelocity.x = 0.0f;
+    this->sentVelocity.y = 0.0f;
+    this->sentVelocity.z = 0.0f;
+    this->attributeEpsilon = 0.001f;
+    this->autoVelocityFlag = false;
+    this->autoVelocityPrimedFlag = false;
+    this->previousPosition.x = 0.0f;
+    this->previousPosition.y = 0.0f;
+    this->previousPosition.z = 0.0f;
+    this->velocitySmoothing = AUTOVELOCITY_DEFAULT_SMOOTHING;
+    this->teleportSpeed = AUTOVELOCITY_DEFAULT_TELEPORT_SPEED;
+    this->unregisteredFlag = false;
 }
 
 Channel::~Channel()
 {
+    // Leave the update thread (the derived destructors have done this already)
+    this->unregisterChannel();
+}
 
+void Channel::unregisterChannel()
+{
+    // Only once
+    if (this->unregisteredFlag == true)
+        return;
+    this->unregisteredFlag = true;
+    // Forget any commands still waiting for this Channel
+    if (FMODGlobals::pChannelCommandQueue != 0)
+        FMODGlobals::pChannelCommandQueue->remove(this);
+    // Stop the Voice Manager looking at this Channel
+    if (FMODGlobals::pVoiceManager != 0)
+        FMODGlobals::pVoiceManager->removeChannel(this);
+    // Stop the update thread publishing a VoiceState for this Channel
+    if (FMODGlobals::pAudioSystem != 0)
+        FMODGlobals::pAudioSystem->unwatchChannel(this);
+    // Forget any posted commands still waiting for this Channel
+    if (FMODGlobals::pAudioSystem != 0)
+        FMODGlobals::pAudioSystem->forgetCommands(this);
 }
 
 Channel::Channel(const Channel& other)
@@ -35,10 +75,17 @@ FMOD_SYSTEM* Channel::getSystemObject()
     return pFMODSystem;
 }
 
+void Channel::play()
+{
+    // Nothing to play without a sound
+}
+
 void Channel::stop()
 {
     // Sound is no longer paused so set flag
     this->pausedFlag = false;
+    // Nor virtual (played again it starts from the beginning, not where the VoiceManager would resume it)
+    this->suspendFlags.fetch_and(~CHANNEL_SUSPEND_VIRTUAL);
     // Grab the channe; playing flag
     FMOD_BOOL playingFlag = false;
     FMOD_Channel_IsPlaying(this->pChannel, &playingFlag);
@@ -62,24 +109,44 @@ void Channel::setPaused(bool pausedFlag)
 {
     // Set local paused flag
     this->pausedFlag = pausedFlag;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PAUSED) == true)
+        return;
     // Set channel paused flag
-    FMOD_Channel_SetPaused(this->pChannel, this->pausedFlag);
+    FMOD_Channel_SetPaused(this->pChannel, this->isHeldPaused());
+}
+
+void Channel::setSuspended(unsigned int reason, bool suspendedFlag)
+{
+    // Set or clear the reason (the game's paused flag is left alone)
+    if (suspendedFlag == true)
+        this->suspendFlags.fetch_or(reason);
+    else
+        this->suspendFlags.fetch_and(~reason);
+    // Hold the channel paused while there is any reason or the game paused it
+    FMOD_Channel_SetPaused(this->pChannel, this->isHeldPaused());
 }
 
 void Channel::pause()
 {
     // Set local paused flag
     this->pausedFlag = true;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PAUSED) == true)
+        return;
     // Set channel paused flag
-    FMOD_Channel_SetPaused(this->pChannel, this->pausedFlag);
+    FMOD_Channel_SetPaused(this->pChannel, this->isHeldPaused());
 }
 
 void Channel::resume()
 {
     // Set local paused flag
     this->pausedFlag = false;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PAUSED) == true)
+        return;
     // Set channel paused flag
-    FMOD_Channel_SetPaused(this->pChannel, this->pausedFlag);
+    FMOD_Channel_SetPaused(this->pChannel, this->isHeldPaused());
 }
 
 float Channel::getVolume()
@@ -92,6 +159,9 @@ void Channel::setVolume(float volume)
 {
     // Set local volume
     this->volume = volume;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_VOLUME) == true)
+        return;
     // Set channel volume
     FMOD_Channel_SetVolume(this->pChannel, this->volume);
 }
@@ -123,6 +193,9 @@ void Channel::setPitch(float pitch)
 {
     // Set local pitch
     this->pitch = pitch;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PITCH) == true)
+        return;
     // Set channel pitch
     FMOD_Channel_SetPitch(this->pChannel, this->pitch);
 }
@@ -137,6 +210,9 @@ void Channel::setMute(bool muteFlag)
 {
     // Set mute flag
     this->muteFlag = muteFlag;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_MUTE) == true)
+        return;
     // Set channel mute flag
     FMOD_Channel_SetMute(this->pChannel, this->muteFlag);
 }
@@ -145,6 +221,9 @@ void Channel::mute()
 {
     // Set mute flag
     this->muteFlag = true;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_MUTE) == true)
+        return;
     // Set channel mute flag
     FMOD_Channel_SetMute(this->pChannel, this->muteFlag);
 }
@@ -153,6 +232,9 @@ void Channel::unmute()
 {
     // Set local mute flag
     this->muteFlag = false;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_MUTE) == true)
+        return;
     // Set channel mute flag
     FMOD_Channel_SetMute(this->pChannel, this->muteFlag);
 }
@@ -182,6 +264,9 @@ void Channel::setLowPassGain(float lowPassGain)
 {
     // Set local lowPassGain
     this->lowPassGain = lowPassGain;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_LOWPASSGAIN) == true)
+        return;
     // Set Low Pass Gain for the Channel
     FMOD_Channel_SetLowPassGain(this->pChannel, lowPassGain);
 }
@@ -225,10 +310,104 @@ void Channel::setBalance(float balance)
 {
     // Set local balance
     this->balance = balance;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_BALANCE) == true)
+        return;
     // Set Channel Pan
     FMOD_Channel_SetPan(this->pChannel, this->balance);
 }
 
+float Channel::getAudibility()
+{
+    // Get Audibility
+    float audibility = 0.0f;
+    FMOD_Channel_GetAudibility(this->pChannel, &audibility);
+    // return audibility
+    return audibility;
+}
+
+float Channel::getEstimatedAudibility(const FMOD_VECTOR* /*pListenerPositions*/, int /*numberOfListeners*/)
+{
+    // A muted Channel can't be heard
+    if (this->muteFlag == true)
+        return 0.0f;
+    // Without a position all we have is the volume
+    return this->volume;
+}
+
+unsigned int Channel::getPlaybackPosition()
+{
+    // Grab the position
+    unsigned int position = 0;
+    FMOD_Channel_GetPosition(this->pChannel, &position, FMOD_TIMEUNIT_MS);
+    // return position
+    return position;
+}
+
+void Channel::setPlaybackPosition(unsigned int position)
+{
+    // Set the position
+    FMOD_Channel_SetPosition(this->pChannel, position, FMOD_TIMEUNIT_MS);
+}
+
+unsigned int Channel::getPlaybackLength()
+{
+    // Grab the Sound playing on the Channel
+    FMOD_SOUND* pSound = 0;
+    if (FMOD_Channel_GetCurrentSound(this->pChannel, &pSound) != FMOD_OK || pSound == 0)
+        return 0;
+    // Grab the length
+    unsigned int length = 0;
+    FMOD_Sound_GetLength(pSound, &length, FMOD_TIMEUNIT_MS);
+    // return length
+    return length;
+}
+
+float Channel::estimateAudibility(const FMOD_VECTOR& position, float minDistance, float maxDistance, const FMOD_VECTOR* pListenerPositions, int numberOfListeners)
+{
+    // No listeners means no attenuation
+    if (pListenerPositions == 0 || numberOfListeners < 1)
+        return (this->muteFlag == true) ? 0.0f : this->volume;
+    // Find the closest listener
+    float distance = 0.0f;
+    NearestListener::find(position, pListenerPositions, numberOfListeners, &distance);
+    // Estimate at that distance
+    return this->estimateAudibilityAt(distance, minDistance, maxDistance);
+}
+
+float Channel::estimateAudibilityAt(float distance, float minDistance, float maxDistance)
+{
+    // A muted Channel can't be heard
+    if (this->muteFlag == true)
+        return 0.0f;
+    // Inside min distance there is no attenuation
+    if (distance <= minDistance || minDistance <= 0.0f)
+        return this->volume;
+    // Sounds are not attenuated any further beyond max distance
+    if (distance > maxDistance)
+        distance = maxDistance;
+    // Attenuation
+    float attenuation = 1.0f;
+    if ((this->mode & FMOD_3D_LINEARROLLOFF) != 0 || (this->mode & FMOD_3D_LINEARSQUAREROLLOFF) != 0)
+    {
+        // Linear from 1 at min distance to 0 at max distance
+        attenuation = (maxDistance > minDistance) ? 1.0f - ((distance - minDistance) / (maxDistance - minDistance)) : 0.0f;
+        // Linear Square
+        if ((this->mode & FMOD_3D_LINEARSQUAREROLLOFF) != 0)
+            attenuation = attenuation * attenuation;
+    }
+    else
+    {
+        // Inverse (FMOD's default, also used as the estimate for custom rolloff)
+        attenuation = minDistance / distance;
+        // Inverse Tapered falls off to 0 at max distance
+        if ((this->mode & FMOD_3D_INVERSETAPEREDROLLOFF) != 0 && maxDistance > minDistance)
+            attenuation = attenuation * (1.0f - ((distance - minDistance) / (maxDistance - minDistance)));
+    }
+    // return volume times attenuation
+    return this->volume * attenuation;
+}
+
 unsigned long long Channel::getDSPClock()
 {
     // Get DSP Clock
@@ -327,6 +506,9 @@ void Channel::setPriority(int priority)
 {
     // Set local priority
     this->priority = priority;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PRIORITY) == true)
+        return;
     // Set channel priority
     FMOD_Channel_SetPriority(this->pChannel, this->priority);
 }
@@ -446,6 +628,141 @@ void Channel::setDSPIndex(FMOD_DSP* pDSP, int index)
     FMOD_Channel_SetDSPIndex(this->pChannel, pDSP, index);
 }
 
+bool Channel::has3DAttributesChanged(const FMOD_VECTOR& position, const FMOD_VECTOR& velocity)
+{
+    // Squared distance moved since the last send
+    float dx = position.x - this->sentPosition.x;
+    float dy = position.y - this->sentPosition.y;
+    float dz = position.z - this->sentPosition.z;
+    float epsilonSquared = this->attributeEpsilon * this->attributeEpsilon;
+    if (dx * dx + dy * dy + dz * dz > epsilonSquared)
+        return true;
+    // Squared velocity change since the last send
+    dx = velocity.x - this->sentVelocity.x;
+    dy = velocity.y - this->sentVelocity.y;
+    dz = velocity.z - this->sentVelocity.z;
+    return (dx * dx + dy * dy + dz * dz > epsilonSquared);
+}
+
+void Channel::mark3DAttributesSent(const FMOD_VECTOR& position, const FMOD_VECTOR& velocity)
+{
+    // Remember Position
+    this->sentPosition = position;
+    // Remember Velocity
+    this->sentVelocity = velocity;
+}
+
+void Channel::send3DAttributes(const FMOD_VECTOR& position, const FMOD_VECTOR& velocity)
+{
+    // AltPanPos
+    FMOD_VECTOR altPanPos;
+        altPanPos.x = 0.0f;
+        altPanPos.y = 0.0f;
+        altPanPos.z = 0.0f;
+    // Set Position and Velocity of the Channel
+    FMOD_Channel_Set3DAttributes(this->pChannel, &position, &velocity, &altPanPos);
+    // Remember what FMOD has
+    this->mark3DAttributesSent(position, velocity);
+}
+
+void Channel::setAutoVelocity(bool autoVelocityFlag)
+{
+    // Set Auto Velocity Flag
+    this->autoVelocityFlag = autoVelocityFlag;
+    // Take the previous position again at the next update (so a long gap is not a huge velocity)
+    this->autoVelocityPrimedFlag = false;
+}
+
+bool Channel::deriveVelocity(float dTime, FMOD_VECTOR& velocity)
+{
+    // Velocity is set by hand
+    if (this->autoVelocityFlag == false)
+        return false;
+    // Where are we now
+    FMOD_VECTOR position;
+    float minDistance = 0.0f;
+    float maxDistance = 0.0f;
+    if (this->getEstimatePosition(position, minDistance, maxDistance) == false)
+        return false;
+    // The first update only takes the position
+    if (this->autoVelocityPrimedFlag == false)
+    {
+        this->previousPosition = position;
+        this->autoVelocityPrimedFlag = true;
+        return false;
+    }
+    // Work out the velocity
+    AutoVelocity::derive(position, this->previousPosition, velocity, dTime, this->velocitySmoothing, this->teleportSpeed);
+    // Success
+    return true;
+}
+
+bool Channel::isDeferred()
+{
+    // No command queue means we talk to FMOD directly
+    if (FMODGlobals::pChannelCommandQueue == 0)
+        return false;
+    // return enabled flag of the command queue
+    return FMODGlobals::pChannelCommandQueue->isEnabled();
+}
+
+bool Channel::deferCommand(unsigned int command)
+{
+    // If commands are not deferred then the caller talks to FMOD
+    if (this->isDeferred() == false)
+        return false;
+    // Record the command
+    FMODGlobals::pChannelCommandQueue->record(this, command);
+    // Command has been deferred
+    return true;
+}
+
+void Channel::storeCommand(unsigned int command, ChannelCommandBuffer& buffer)
+{
+    // Copy the local value for the command into the buffer
+    switch (command)
+    {
+        case CHANNEL_COMMAND_PAUSED: buffer.pausedFlag = this->pausedFlag; break;
+        case CHANNEL_COMMAND_VOLUME: buffer.volume = this->volume; break;
+        case CHANNEL_COMMAND_PITCH: buffer.pitch = this->pitch; break;
+        case CHANNEL_COMMAND_MUTE: buffer.muteFlag = this->muteFlag; break;
+        case CHANNEL_COMMAND_BALANCE: buffer.balance = this->balance; break;
+        case CHANNEL_COMMAND_LOWPASSGAIN: buffer.lowPassGain = this->lowPassGain; break;
+        case CHANNEL_COMMAND_PRIORITY: buffer.priority = this->priority; break;
+        default: break;
+    }
+}
+
+void Channel::applyCommands(const ChannelCommandBuffer& buffer)
+{
+    // The channel may have been stopped since the commands were recorded
+    if (this->pChannel == 0)
+        return;
+    // Set channel volume
+    if ((buffer.commands & CHANNEL_COMMAND_VOLUME) != 0)
+        FMOD_Channel_SetVolume(this->pChannel, buffer.volume);
+    // Set channel pitch
+    if ((buffer.commands & CHANNEL_COMMAND_PITCH) != 0)
+        FMOD_Channel_SetPitch(this->pChannel, buffer.pitch);
+    // Set channel mute flag
+    if ((buffer.commands & CHANNEL_COMMAND_MUTE) != 0)
+        FMOD_Channel_SetMute(this->pChannel, buffer.muteFlag);
+    // Set Channel Pan
+    if ((buffer.commands & CHANNEL_COMMAND_BALANCE) != 0)
+        FMOD_Channel_SetPan(this->pChannel, buffer.balance);
+    // Set Low Pass Gain for the Channel
+    if ((buffer.commands & CHANNEL_COMMAND_LOWPASSGAIN) != 0)
+        FMOD_Channel_SetLowPassGain(this->pChannel, buffer.lowPassGain);
+    // Set channel priority
+    if ((buffer.commands & CHANNEL_COMMAND_PRIORITY) != 0)
+        FMOD_Channel_SetPriority(this->pChannel, buffer.priority);
+    /* NOTE: Paused goes last so a channel started paused by play()
+        only becomes audible once everything else has been applied */
+    // Set channel paused flag (held paused while suspended)
+    if ((buffer.commands & CHANNEL_COMMAND_PAUSED) != 0)
+        FMOD_Channel_SetPaused(this->pChannel, (buffer.pausedFlag == true || this->suspendFlags.load() != 0));
+}
+
 //void Channel::overridePanDSP(FMOD_DSP* pDSP)
 //{
 //    /* Override FMOD's default pan with a new DSP or
@@ -1,6 +1,10 @@
 #ifndef CHANNEL_H
 #define CHANNEL_H
 
+// C++ Includes
+#include <atomic>
+#include <cmath>
+
 // FMOD Includes
 #include <fmod.h>
 #include <fmod_codec.h>
@@ -12,10 +16,27 @@
 
 // GAMEAUDIO Includes
 #include "FMODGlobals.h"
+#include "Channel/ChannelCommandBuffer.h"
+#include "System/AutoVelocity.h"
+#include "System/NearestListener.h"
+
+class ChannelCommandQueue;
+
+// Why a Channel is held paused behind the game's back (bit flags)
+enum CHANNEL_SUSPEND
+{
+    // The VoiceManager made it virtual
+    CHANNEL_SUSPEND_VIRTUAL = 0x00000001,
+    // The SpatialGrid found no listener within its max distance
+    CHANNEL_SUSPEND_SPATIAL = 0x00000002
+};
 
 /** Channel **/
 class Channel
 {
+    // The ChannelCommandQueue reads and applies our command buffer
+    friend class ChannelCommandQueue;
+
     // ******************************
     // * CONSTRUCTORS / DESTRUCTORS *
     // ******************************
@@ -46,6 +67,9 @@ class Channel
         /** @brief Get system object
           * @return FMOD_SYSTEM **/
         virtual FMOD_SYSTEM* getSystemObject();
+        /** @brief Play the sound (Sound, Stream, Music and Recording
+          * know what to play, a bare Channel does nothing) **/
+        virtual void play();
         /** @brief Stop the sound **/
         virtual void stop();
         /** @briefIs Paused? **/
@@ -56,6 +80,20 @@ class Channel
         virtual void pause();
         /** @brief Resume Sound Playback **/
         virtual void resume();
+        /** @brief isSuspended
+          * @return true if the Channel is held paused for any CHANNEL_SUSPEND reason **/
+        virtual bool isSuspended() { return (this->suspendFlags.load() != 0); }
+        /** @brief isSuspendedFor
+          * @param reason a CHANNEL_SUSPEND flag
+          * @return true if the Channel is held paused for this reason **/
+        virtual bool isSuspendedFor(unsigned int reason) { return ((this->suspendFlags.load() & reason) != 0); }
+        /** @brief setSuspended
+          * Hold the Channel paused (or stop holding it) without touching the
+          * paused flag the game sees, so a pause or resume from the game is
+          * kept. Safe to call from the update thread
+          * @param reason a CHANNEL_SUSPEND flag
+          * @param suspendedFlag true to hold it paused for this reason **/
+        virtual void setSuspended(unsigned int reason, bool suspendedFlag);
         /** @brief Get Volume
           * @return volume (0.0 silent 1.0 fullblast) **/
         virtual float getVolume();
@@ -117,6 +155,41 @@ class Channel
         /** @brief Set Balance (Pan)
           * @param pan (-1.0 full left 1.0 full right) **/
         virtual void setBalance(float balance);
+        /** @brief getAudibility
+          * @return returns the combined volume after 3D spatialization
+          * and geometry occlusion calculations including any volumes set via the API **/
+        virtual float getAudibility();
+        /** @brief getEstimatedAudibility
+          * Estimate how loud the Channel is from our own shadow values (volume,
+          * mute and for spatial channels distance and rolloff) without asking FMOD
+          * @param pListenerPositions positions of the listeners
+          * @param numberOfListeners number of listeners
+          * @return estimated audibility (0.0 silent 1.0 fullblast) **/
+        virtual float getEstimatedAudibility(const FMOD_VECTOR* pListenerPositions, int numberOfListeners);
+        /** @brief getEstimatePosition
+          * Where the Channel is for estimating (so the VoiceManager can find
+          * the closest listener to all of its Channels in one pass)
+          * @param position receives the position of the Channel
+          * @param minDistance receives the min distance of the Channel
+          * @param maxDistance receives the max distance of the Channel
+          * @return false if the Channel has no position **/
+        virtual bool getEstimatePosition(FMOD_VECTOR& /*position*/, float& /*minDistance*/, float& /*maxDistance*/) { return false; }
+        /** @brief estimateAudibilityAt
+          * Volume times distance attenuation (using the rolloff in mode)
+          * @param distance distance to the closest listener
+          * @param minDistance min distance of the Channel
+          * @param maxDistance max distance of the Channel
+          * @return estimated audibility **/
+        virtual float estimateAudibilityAt(float distance, float minDistance, float maxDistance);
+        /** @brief getPlaybackPosition
+          * @return the playback position of the Channel in milliseconds **/
+        virtual unsigned int getPlaybackPosition();
+        /** @brief setPlaybackPosition
+          * @param position the playback position in milliseconds **/
+        virtual void setPlaybackPosition(unsigned int position);
+        /** @brief getPlaybackLength
+          * @return the length of the sound playing on the Channel in milliseconds (0 if unknown) **/
+        virtual unsigned int getPlaybackLength();
         // Don't need to implement these
         //FMOD_RESULT F_API FMOD_Channel_SetMixLevelsOutput       (FMOD_CHANNEL *channel, float frontleft, float frontright, float center, float lfe, float surroundleft, float surroundright, float backleft, float backright);
         //FMOD_RESULT F_API FMOD_Channel_SetMixLevelsInput        (FMOD_CHANNEL *channel, float *levels, int numlevels);
@@ -215,6 +288,9 @@ class Channel
         /** @brief GetChannelIndex
           * @return channel index **/
         virtual int getChannelIndex();
+        /** @brief getFMODChannel
+          * @return the FMOD_CHANNEL it is playing on (0 if it has not been played) **/
+        virtual FMOD_CHANNEL* getFMODChannel() { return this->pChannel; }
         /** @brief getDSP
           * @param index see FMOD_CHANNELCONTROL_DSP_INDEX for
           * special offsets
@@ -245,11 +321,113 @@ class Channel
 //          * @param pDSP pointer to an FMOD_DSP Object **/
 //        virtual void overridePanDSP(FMOD_DSP* pDSP);
 
+    public:
+        /** @brief get3DAttributeEpsilon
+          * @return how far position or velocity must move before FMOD is told **/
+        virtual float get3DAttributeEpsilon() { return this->attributeEpsilon; }
+        /** @brief set3DAttributeEpsilon
+          * Position and velocity changes smaller than this (from what FMOD was
+          * last sent) are not sent, so still emitters cost nothing per update
+          * @param attributeEpsilon distance in world units (default 0.001) **/
+        virtual void set3DAttributeEpsilon(float attributeEpsilon) { this->attributeEpsilon = attributeEpsilon; }
+
+    public:
+        /** @brief isAutoVelocity
+          * @return true if update works out the velocity from the position **/
+        virtual bool isAutoVelocity() { return this->autoVelocityFlag; }
+        /** @brief setAutoVelocity
+          * Work out the velocity (for doppler) from how far the Channel moved
+          * each update, replacing whatever setVelocity was given
+          * @param autoVelocityFlag true to derive the velocity, false to set it by hand **/
+        virtual void setAutoVelocity(bool autoVelocityFlag);
+        /** @brief getVelocitySmoothing
+          * @return time the derived velocity takes to settle in seconds **/
+        virtual float getVelocitySmoothing() { return this->velocitySmoothing; }
+        /** @brief setVelocitySmoothing
+          * @param velocitySmoothing time the derived velocity takes to settle in seconds (default 0.1, 0 for none) **/
+        virtual void setVelocitySmoothing(float velocitySmoothing) { this->velocitySmoothing = velocitySmoothing; }
+        /** @brief getTeleportSpeed
+          * @return speed at which a move zeroes the derived velocity instead **/
+        virtual float getTeleportSpeed() { return this->teleportSpeed; }
+        /** @brief setTeleportSpeed
+          * @param teleportSpeed speed in world units a second at which a move zeroes the derived velocity instead (default 500, 0 for never) **/
+        virtual void setTeleportSpeed(float teleportSpeed) { this->teleportSpeed = teleportSpeed; }
+
+    protected:
+        /** @brief has3DAttributesChanged
+          * @param position position of the Channel
+          * @param velocity velocity of the Channel
+          * @return true if either has moved more than the epsilon since they were last sent **/
+        virtual bool has3DAttributesChanged(const FMOD_VECTOR& position, const FMOD_VECTOR& velocity);
+        /** @brief mark3DAttributesSent
+          * Remember what FMOD has (or will have once a deferred command is flushed)
+          * @param position position of the Channel
+          * @param velocity velocity of the Channel **/
+        virtual void mark3DAttributesSent(const FMOD_VECTOR& position, const FMOD_VECTOR& velocity);
+        /** @brief send3DAttributes
+          * FMOD_Channel_Set3DAttributes and remember what was sent
+          * @param position position of the Channel
+          * @param velocity velocity of the Channel **/
+        virtual void send3DAttributes(const FMOD_VECTOR& position, const FMOD_VECTOR& velocity);
+        /** @brief deriveVelocity
+          * Work out the velocity from where getEstimatePosition says the
+          * Channel is now and where it was at the last update
+          * @param dTime time since the last update (seconds)
+          * @param velocity the velocity (smoothed in place)
+          * @return false if auto velocity is off, there is no position or this is the first update **/
+        virtual bool deriveVelocity(float dTime, FMOD_VECTOR& velocity);
+
+    protected:
+        /** @brief estimateAudibility
+          * Work out volume times distance attenuation (using the rolloff in mode)
+          * for the closest listener
+          * @param position position of the Channel
+          * @param minDistance min distance of the Channel
+          * @param maxDistance max distance of the Channel
+          * @param pListenerPositions positions of the listeners
+          * @param numberOfListeners number of listeners
+          * @return estimated audibility **/
+        virtual float estimateAudibility(const FMOD_VECTOR& position, float minDistance, float maxDistance, const FMOD_VECTOR* pListenerPositions, int numberOfListeners);
+        /** @brief unregisterChannel
+          * Take the Channel out of everything the update thread calls into
+          * (deferred and posted commands, the Voice Manager and the watch
+          * list). Each destructor calls this first, so the update thread is
+          * done with the Channel before any of the derived parts go **/
+        virtual void unregisterChannel();
+        /** @brief isDeferred
+          * @return true if setters are being recorded into the
+          * ChannelCommandQueue instead of sent to FMOD **/
+        virtual bool isDeferred();
+        /** @brief deferCommand
+          * Record a command for the next AudioSystem::update(). Call this
+          * after the local (shadow) value has been written
+          * @param command one of the CHANNEL_COMMAND flags
+          * @return true if the command was deferred, false if the caller should
+          * send it to FMOD itself **/
+        virtual bool deferCommand(unsigned int command);
+        /** @brief storeCommand
+          * Copy the local value for a command into a command buffer. Derived
+          * classes with extra commands override this and call the base
+          * @param command one of the CHANNEL_COMMAND flags
+          * @param buffer the command buffer to write into **/
+        virtual void storeCommand(unsigned int command, ChannelCommandBuffer& buffer);
+        /** @brief applyCommands
+          * Send the commands in a command buffer to FMOD. Derived classes with
+          * extra commands apply theirs first and then call the base so that
+          * CHANNEL_COMMAND_PAUSED is always the last thing applied
+          * @param buffer the command buffer to apply **/
+        virtual void applyCommands(const ChannelCommandBuffer& buffer);
+        /** @brief isHeldPaused
+          * @return true if FMOD should have the channel paused (the game paused it or it is suspended) **/
+        inline bool isHeldPaused() { return (this->pausedFlag.load() == true || this->suspendFlags.load() != 0); }
+
     protected:
         // FMOD Channel
         FMOD_CHANNEL* pChannel;
-        // Paused Flag
-        bool pausedFlag;
+        // Paused Flag (set by the game)
+        std::atomic<bool> pausedFlag;
+        // CHANNEL_SUSPEND reasons the Channel is held paused for (set by the update thread)
+        std::atomic<unsigned int> suspendFlags;
         // Volume 0 silent 1.0 full voltume
         float volume;
         // Volume Ramp Flag
@@ -270,6 +448,26 @@ class Channel
         bool loopFlag;
         // Loop count
         int loopCount;
+        // Commands waiting for the ChannelCommandQueue to flush
+        ChannelCommandBuffer commandBuffer;
+        // Position last sent to FMOD
+        FMOD_VECTOR sentPosition;
+        // Velocity last sent to FMOD
+        FMOD_VECTOR sentVelocity;
+        // Attribute Epsilon
+        float attributeEpsilon;
+        // Auto Velocity Flag
+        bool autoVelocityFlag;
+        // Has the previous position been taken since auto velocity went on
+        bool autoVelocityPrimedFlag;
+        // Position at the last update (auto velocity)
+        FMOD_VECTOR previousPosition;
+        // Velocity Smoothing
+        float velocitySmoothing;
+        // Teleport Speed
+        float teleportSpeed;
+        // Has the Channel been taken out of the update thread's lists
+        bool unregisteredFlag;
 
 };
 
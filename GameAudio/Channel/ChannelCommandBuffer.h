@@ -0,0 +1,97 @@
+/**
+  * @file   ChannelCommandBuffer.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  ChannelCommandBuffer holds the setter calls a Channel
+  * has recorded while deferred commands are switched on
+*/
+
+#ifndef CHANNELCOMMANDBUFFER_H
+#define CHANNELCOMMANDBUFFER_H
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+/** The CHANNEL_COMMAND flags identify one property of a Channel.
+    Each property has a single slot in the ChannelCommandBuffer so
+    writing it twice before a flush keeps only the last value **/
+enum CHANNEL_COMMAND
+{
+    CHANNEL_COMMAND_NONE                = 0x00000000,
+    CHANNEL_COMMAND_PAUSED              = 0x00000001,
+    CHANNEL_COMMAND_VOLUME              = 0x00000002,
+    CHANNEL_COMMAND_PITCH               = 0x00000004,
+    CHANNEL_COMMAND_MUTE                = 0x00000008,
+    CHANNEL_COMMAND_BALANCE             = 0x00000010,
+    CHANNEL_COMMAND_LOWPASSGAIN         = 0x00000020,
+    CHANNEL_COMMAND_PRIORITY            = 0x00000040,
+    CHANNEL_COMMAND_3DATTRIBUTES        = 0x00000100,
+    CHANNEL_COMMAND_3DMINMAXDISTANCE    = 0x00000200,
+    CHANNEL_COMMAND_3DOCCLUSION         = 0x00000400,
+    CHANNEL_COMMAND_3DLEVEL             = 0x00000800,
+    CHANNEL_COMMAND_3DDOPPLERLEVEL      = 0x00001000,
+    CHANNEL_COMMAND_3DROLLOFF           = 0x00002000
+};
+
+/** The ChannelCommandBuffer struct is a compact record of the pending
+    property writes for one Channel. commands is a mask of CHANNEL_COMMAND
+    flags saying which of the values below are waiting to be sent to FMOD **/
+struct ChannelCommandBuffer
+{
+    //! Constructor
+    ChannelCommandBuffer()
+    {
+        this->commands = CHANNEL_COMMAND_NONE;
+        this->pausedFlag = false;
+        this->volume = 1.0f;
+        this->pitch = 1.0f;
+        this->muteFlag = false;
+        this->balance = 0.0f;
+        this->lowPassGain = 1.0f;
+        this->priority = 0;
+        this->position.x = this->position.y = this->position.z = 0.0f;
+        this->velocity.x = this->velocity.y = this->velocity.z = 0.0f;
+        this->minDistance = 0.1f;
+        this->maxDistance = 10000.0f;
+        this->directOcclusion = 0.0f;
+        this->reverbOcclusion = 0.0f;
+        this->level = 1.0f;
+        this->dopplerLevel = 1.0f;
+        this->rolloffCurve = -1;
+    }
+
+    // Mask of CHANNEL_COMMAND flags waiting to be sent
+    unsigned int commands;
+    // CHANNEL_COMMAND_PAUSED
+    bool pausedFlag;
+    // CHANNEL_COMMAND_VOLUME
+    float volume;
+    // CHANNEL_COMMAND_PITCH
+    float pitch;
+    // CHANNEL_COMMAND_MUTE
+    bool muteFlag;
+    // CHANNEL_COMMAND_BALANCE
+    float balance;
+    // CHANNEL_COMMAND_LOWPASSGAIN
+    float lowPassGain;
+    // CHANNEL_COMMAND_PRIORITY
+    int priority;
+    // CHANNEL_COMMAND_3DATTRIBUTES
+    FMOD_VECTOR position;
+    FMOD_VECTOR velocity;
+    // CHANNEL_COMMAND_3DMINMAXDISTANCE
+    float minDistance;
+    float maxDistance;
+    // CHANNEL_COMMAND_3DOCCLUSION
+    float directOcclusion;
+    float reverbOcclusion;
+    // CHANNEL_COMMAND_3DLEVEL
+    float level;
+    // CHANNEL_COMMAND_3DDOPPLERLEVEL
+    float dopplerLevel;
+    // CHANNEL_COMMAND_3DROLLOFF (bound with minDistance and maxDistance)
+    int rolloffCurve;
+};
+
+#endif // CHANNELCOMMANDBUFFER_H
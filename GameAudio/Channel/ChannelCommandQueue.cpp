@@ -0,0 +1,101 @@
+#include "ChannelCommandQueue.h"
+#include "Channel.h"
+
+ChannelCommandQueue::ChannelCommandQueue()
+{
+    // Enabled Flag
+    this->enabledFlag = false;
+    // Queued Channels
+    this->queuedChannels.clear();
+    // Recorded Commands
+    this->recordedCommands = 0;
+}
+
+ChannelCommandQueue::~ChannelCommandQueue()
+{
+
+}
+
+void ChannelCommandQueue::record(Channel* pChannel, unsigned int command)
+{
+    // Validate the Channel
+    if (pChannel == 0)
+        return;
+    // Lock the Queue
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Grab the command buffer for the Channel
+    ChannelCommandBuffer& buffer = pChannel->commandBuffer;
+    // Copy the value into the Channel's slot (overwriting any earlier write)
+    pChannel->storeCommand(command, buffer);
+    // The first command for a Channel puts it into the queue
+    if (buffer.commands == CHANNEL_COMMAND_NONE)
+        this->queuedChannels.push_back(pChannel);
+    // Mark the command as waiting
+    buffer.commands |= command;
+    // Track how many setter calls we have soaked up
+    this->recordedCommands++;
+}
+
+void ChannelCommandQueue::remove(Channel* pChannel)
+{
+    // Lock the Queue
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Nothing to do unless the Channel is queued
+    if (pChannel->commandBuffer.commands == CHANNEL_COMMAND_NONE)
+        return;
+    // Forget the commands
+    pChannel->commandBuffer.commands = CHANNEL_COMMAND_NONE;
+    // Take the Channel out of the queue
+    std::vector<Channel*>::iterator i = std::find(this->queuedChannels.begin(), this->queuedChannels.end(), pChannel);
+    if (i != this->queuedChannels.end())
+        this->queuedChannels.erase(i);
+}
+
+void ChannelCommandQueue::flush()
+{
+    // Lock the Queue
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Go through all the queued Channels
+    for (std::vector<Channel*>::iterator i = this->queuedChannels.begin(); i != this->queuedChannels.end(); i++)
+    {
+        // Grab the Channel
+        Channel* pChannel = (*i);
+        // Send the last value of each property to FMOD
+        pChannel->applyCommands(pChannel->commandBuffer);
+        // Nothing left waiting for this Channel
+        pChannel->commandBuffer.commands = CHANNEL_COMMAND_NONE;
+    }
+    // Empty the Queue (keeps its capacity so there are no allocations next frame)
+    this->queuedChannels.clear();
+    // Reset Recorded Commands
+    this->recordedCommands = 0;
+}
+
+void ChannelCommandQueue::clear()
+{
+    // Lock the Queue
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Forget the commands of every queued Channel
+    for (std::vector<Channel*>::iterator i = this->queuedChannels.begin(); i != this->queuedChannels.end(); i++)
+        (*i)->commandBuffer.commands = CHANNEL_COMMAND_NONE;
+    // Empty the Queue
+    this->queuedChannels.clear();
+    // Reset Recorded Commands
+    this->recordedCommands = 0;
+}
+
+int ChannelCommandQueue::getNumberOfQueuedChannels()
+{
+    // Lock the Queue
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Return the number of queued channels
+    return (int)this->queuedChannels.size();
+}
+
+int ChannelCommandQueue::getNumberOfRecordedCommands()
+{
+    // Lock the Queue
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Return recordedCommands
+    return this->recordedCommands;
+}
@@ -0,0 +1,105 @@
+/**
+  * @file   ChannelCommandQueue.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  ChannelCommandQueue collects the Channels which have
+  * deferred setter calls and sends them to FMOD in one pass
+*/
+
+#ifndef CHANNELCOMMANDQUEUE_H
+#define CHANNELCOMMANDQUEUE_H
+
+// C++ Includes
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <mutex>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Channel/ChannelCommandBuffer.h"
+
+class Channel;
+
+/** The ChannelCommandQueue is owned by the AudioSystem. When it is enabled
+    Channel setters no longer call FMOD, they store their value in the
+    Channel's ChannelCommandBuffer and register the Channel here. The
+    AudioSystem flushes the queue once per update so each property of
+    each Channel costs at most one FMOD call per frame no matter how
+    many times gameplay code set it. Recording is guarded by a mutex so
+    any thread can call the setters **/
+class ChannelCommandQueue
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        ChannelCommandQueue();
+        //! Destructor
+        virtual ~ChannelCommandQueue();
+
+    protected:
+        //! ChannelCommandQueue Copy constructor
+        ChannelCommandQueue(const ChannelCommandQueue& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! ChannelCommandQueue Assignment operator
+        ChannelCommandQueue& operator=(const ChannelCommandQueue& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief Is Enabled
+          * @return true if Channel setters are being deferred **/
+        virtual bool isEnabled() { return this->enabledFlag.load(); }
+        /** @brief Set Enabled
+          * @param enabledFlag true to defer Channel setters until flush **/
+        virtual void setEnabled(bool enabledFlag) { this->enabledFlag.store(enabledFlag); }
+        /** @brief record
+          * Store a command in the Channel's command buffer and queue the Channel
+          * @param pChannel the Channel the command belongs to
+          * @param command one of the CHANNEL_COMMAND flags **/
+        virtual void record(Channel* pChannel, unsigned int command);
+        /** @brief remove
+          * Forget any commands recorded for a Channel (called when a Channel is destroyed)
+          * @param pChannel the Channel to remove **/
+        virtual void remove(Channel* pChannel);
+        /** @brief flush
+          * Send every recorded command to FMOD and empty the queue **/
+        virtual void flush();
+        /** @brief clear
+          * Throw away every recorded command without sending it **/
+        virtual void clear();
+
+    public:
+        /** @brief Get the number of Channels waiting to be flushed
+          * @return number of queued Channels **/
+        virtual int getNumberOfQueuedChannels();
+        /** @brief Get the number of setter calls recorded since the last flush
+          * @return number of recorded commands **/
+        virtual int getNumberOfRecordedCommands();
+
+    protected:
+        // Enabled Flag (set by the game, read by the update thread)
+        std::atomic<bool> enabledFlag;
+        // Guards the queue and the command buffers of the queued Channels
+        std::mutex mutex;
+        // Channels with at least one command waiting
+        std::vector<Channel*> queuedChannels;
+        // Setter calls recorded since the last flush
+        int recordedCommands;
+};
+
+#endif // CHANNELCOMMANDQUEUE_H
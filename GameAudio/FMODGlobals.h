@@ -18,6 +18,16 @@
 #include <fmod_errors.h>
 #include <fmod_output.h>
 
+class AudioFileSystem;
+class AudioSystem;
+class ChannelCommandQueue;
+class OcclusionService;
+class OcclusionTracer;
+class RolloffManager;
+class SpatialGrid;
+class StreamPool;
+class VoiceManager;
+
 namespace FMODGlobals
 {
     // ********************
@@ -58,6 +68,27 @@ namespace FMODGlobals
     extern FMOD_CHANNELGROUP* pSoundEffectsChannelGroup;
     // Music Channel Group
     extern FMOD_CHANNELGROUP* pMusicChannelGroup;
+    /* NOTE: The AudioSystem owns the ChannelCommandQueue and points this
+        at it between init and shutdown. While it is 0 (or disabled) the
+        Channel setters talk to FMOD straight away */
+    // Deferred Channel Command Queue
+    extern ChannelCommandQueue* pChannelCommandQueue;
+    // Voice Manager (so a Channel can remove itself when it is destroyed)
+    extern VoiceManager* pVoiceManager;
+    // Spatial Grid (so a SpatialObject can move itself and leave when it is destroyed)
+    extern SpatialGrid* pSpatialGrid;
+    // Occlusion Service (so a Channel can leave when it is destroyed and Geometry can say it changed)
+    extern OcclusionService* pOcclusionService;
+    // Occlusion Tracer (so Geometry can say it changed and leave when it is released)
+    extern OcclusionTracer* pOcclusionTracer;
+    // Rolloff Manager (so Channels can find the curves)
+    extern RolloffManager* pRolloffManager;
+    // Audio File System (so the file callbacks can find it)
+    extern AudioFileSystem* pAudioFileSystem;
+    // Stream Pool (so Streams and Music can take pre-opened streams)
+    extern StreamPool* pStreamPool;
+    // Audio System (so a Channel can stop being watched when it is destroyed)
+    extern AudioSystem* pAudioSystem;
     // ********************
     // * GLOBAL FUNCTIONS *
     // ********************
@@ -29,10 +29,16 @@
 #include "DSP/DSP.h"
 #include "DSP/DSPConnection.h"
 #include "Geometry/Geometry.h"
+#include "Geometry/OcclusionService.h"
+#include "Geometry/OcclusionTracer.h"
 #include "Group/ChannelGroup.h"
 #include "Group/SoundGroup.h"
 #include "Music/Music.h"
+#include "Music/MusicPlayer.h"
+#include "Music/MusicScheduler.h"
 #include "Recording/Recording.h"
+#include "Sound/RolloffCurve.h"
+#include "Sound/RolloffManager.h"
 #include "Sound/Sound.h"
 #include "Sound/Sound2D.h"
 #include "Sound/Sound3D.h"
@@ -40,8 +46,20 @@
 #include "Stream/Stream.h"
 #include "Stream/Stream2D.h"
 #include "Stream/Stream3D.h"
+#include "Stream/StreamPool.h"
 #include "Reverb/Reverb2D.h"
 #include "Reverb/Reverb3D.h"
+#include "System/AudioFileStats.h"
+#include "System/AudioFileSystem.h"
+#include "System/AudioIOScheduler.h"
 #include "System/AudioSystem.h"
+#include "System/AutoVelocity.h"
+#include "System/NearestListener.h"
+#include "System/SpatialGrid.h"
+#include "System/SpatialObject.h"
+#include "Voice/EmitterSystem.h"
+#include "Voice/VoiceHandle.h"
+#include "Voice/VoiceManager.h"
+#include "Voice/VoicePool.h"
 
 #endif // GAMEAUDIO_H
@@ -1,4 +1,6 @@
 #include "Geometry.h"
+#include "Geometry/OcclusionService.h"
+#include "Geometry/OcclusionTracer.h"
 
 Geometry::Geometry()
 {
@@ -24,7 +26,9 @@ Geometry::Geometry()
 
 Geometry::~Geometry()
 {
-
+    // Leave the OcclusionTracer
+    if (FMODGlobals::pOcclusionTracer != 0)
+        FMODGlobals::pOcclusionTracer->removeGeometry(this);
 }
 
 Geometry::Geometry(Geometry& other)
@@ -48,17 +52,46 @@ bool Geometry::load(const void* pData, int dataSize)
     // Load the geomatry
     FMOD_RESULT result;
     result = FMOD_System_LoadGeometry(FMODGlobals::pFMODSystem, pData, dataSize, &(this->pGeometry));
-    // Result
-    return result;
+    if (result != FMOD_OK)
+    {
+        std::cout << "bool Geometry::load() failure. FMOD error! (" << FMOD_ErrorString(result) << ") " << std::endl;
+        this->pGeometry = 0;
+        return false;
+    }
+    // Set userdata for the Geometry
+    FMOD_Geometry_SetUserData(this->pGeometry, (void*)this);
+    // The occlusion has changed
+    this->geometryChanged();
+    // Success
+    return true;
 }
 
 bool Geometry::save(void* pData, int dataSize)
 {
-    // Load the geomatry
+    // Make sure the block is big enough (FMOD writes the whole mesh)
+    int saveSize = this->getSaveSize();
+    if (saveSize == 0 || pData == 0 || dataSize < saveSize)
+    {
+        std::cout << "bool Geometry::save() failure. Needs a block of " << saveSize << " bytes" << std::endl;
+        return false;
+    }
+    // Save the geomatry
     FMOD_RESULT result;
-    FMOD_Geometry_Save(this->pGeometry, pData, &dataSize);
+    result = FMOD_Geometry_Save(this->pGeometry, pData, &saveSize);
     // Result
-    return result;
+    return (result == FMOD_OK);
+}
+
+int Geometry::getSaveSize()
+{
+    // No geometry
+    if (this->pGeometry == 0)
+        return 0;
+    // Ask FMOD (a null block returns the size)
+    int saveSize = 0;
+    FMOD_Geometry_Save(this->pGeometry, 0, &saveSize);
+    // return saveSize
+    return saveSize;
 }
 
 void Geometry::release()
@@ -71,6 +104,8 @@ void Geometry::release()
     }
     // Clear the geometry pointer
     this->pGeometry = 0;
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 float Geometry::getX()
@@ -89,6 +124,8 @@ void Geometry::setX(float x)
         position.y = this->y;
         position.z = this->z;
     FMOD_Geometry_SetPosition(this->pGeometry, &position);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 float Geometry::getY()
@@ -107,6 +144,8 @@ void Geometry::setY(float y)
         position.y = this->y;
         position.z = this->z;
     FMOD_Geometry_SetPosition(this->pGeometry, &position);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 float Geometry::getZ()
@@ -125,6 +164,8 @@ void Geometry::setZ(float z)
         position.y = this->y;
         position.z = this->z;
     FMOD_Geometry_SetPosition(this->pGeometry, &position);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 void Geometry::setPosition(float x, float y, float z)
@@ -139,6 +180,8 @@ void Geometry::setPosition(float x, float y, float z)
         position.y = this->y;
         position.z = this->z;
     FMOD_Geometry_SetPosition(this->pGeometry, &position);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 float Geometry::getXUp()
@@ -175,6 +218,8 @@ void Geometry::setUpVector(float xUp, float yUp, float zUp)
         up.y = this->yUp;
         up.z = this->zUp;
     FMOD_Geometry_SetRotation(this->pGeometry, &forward, &up);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 void Geometry::setForward(float xForward, float yForward, float zForward)
@@ -193,6 +238,31 @@ void Geometry::setForward(float xForward, float yForward, float zForward)
         up.y = this->yUp;
         up.z = this->zUp;
     FMOD_Geometry_SetRotation(this->pGeometry, &forward, &up);
+    // The occlusion has changed
+    this->geometryChanged();
+}
+
+void Geometry::setRotation(float xForward, float yForward, float zForward, float xUp, float yUp, float zUp)
+{
+    // Set local forward and up
+    this->xForward = xForward;
+    this->yForward = yForward;
+    this->zForward = zForward;
+    this->xUp = xUp;
+    this->yUp = yUp;
+    this->zUp = zUp;
+    // Set the Geometry Rotation
+    FMOD_VECTOR forward;
+        forward.x = this->xForward;
+        forward.y = this->yForward;
+        forward.z = this->zForward;
+    FMOD_VECTOR up;
+        up.x = this->xUp;
+        up.y = this->yUp;
+        up.z = this->zUp;
+    FMOD_Geometry_SetRotation(this->pGeometry, &forward, &up);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 float Geometry::getXScale()
@@ -211,6 +281,8 @@ void Geometry::setXScale(float xScale)
         scale.y = this->yScale;
         scale.z = this->zScale;
     FMOD_Geometry_SetScale(this->pGeometry, &scale);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 float Geometry::getYScale()
@@ -229,6 +301,8 @@ void Geometry::setYScale(float yScale)
         scale.y = this->yScale;
         scale.z = this->zScale;
     FMOD_Geometry_SetScale(this->pGeometry, &scale);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 float Geometry::getZScale()
@@ -247,6 +321,8 @@ void Geometry::setZScale(float zScale)
         scale.y = this->yScale;
         scale.z = this->zScale;
     FMOD_Geometry_SetScale(this->pGeometry, &scale);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 void Geometry::setScale(float xScale, float yScale, float zScale)
@@ -261,6 +337,8 @@ void Geometry::setScale(float xScale, float yScale, float zScale)
         scale.y = this->yScale;
         scale.z = this->zScale;
     FMOD_Geometry_SetScale(this->pGeometry, &scale);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 bool Geometry::isActive()
@@ -276,6 +354,8 @@ void Geometry::setActive(bool activeFlag)
 {
     // Set activeFlag for the FMOD_GEOMETRY
     FMOD_Geometry_SetActive(this->pGeometry, activeFlag);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 int Geometry::getPolyCount()
@@ -323,6 +403,8 @@ int Geometry::addPolygon(float directOcclusion, float reverbOcclusion, bool doub
         FMOD_Geometry_AddPolygon(this->pGeometry, directOcclusion, reverbOcclusion, doubleSidedFlag, numVertices, pVertices, &polygonIndex);
     // Release heap memory for the Vertices
     delete pVertices;
+    // The occlusion has changed
+    this->geometryChanged();
     // return polygonIndex
     return polygonIndex;
 }
@@ -345,6 +427,8 @@ void Geometry::setPolygonVertex(int polygonIndex, int vertexIndex, float x, floa
         vertex.z = z;
     // Set Polygon Vertex
     FMOD_Geometry_SetPolygonVertex(this->pGeometry, polygonIndex, vertexIndex, &vertex);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 FMOD_VECTOR Geometry::getPolygonVertex(int polygonIndex, int vertexIndex)
@@ -360,6 +444,8 @@ void Geometry::setPolygonAttributes(int polygonIndex, float directOcclusion, flo
 {
     // Set Polygon Atrtibutes
     FMOD_Geometry_SetPolygonAttributes(this->pGeometry, polygonIndex, directOcclusion, reverbOcclusion, doubleSidedFlag);
+    // The occlusion has changed
+    this->geometryChanged();
 }
 
 float Geometry::getPolygonAttributeDirectOcclusion(int polygonIndex)
@@ -395,6 +481,69 @@ bool Geometry::getPolygonAttributeDoubleSided(bool polygonIndex)
     return doubleSidedFlag;
 }
 
+bool Geometry::getWorldBounds(FMOD_VECTOR& minimum, FMOD_VECTOR& maximum)
+{
+    // No polygons
+    int polyCount = this->getPolyCount();
+    if (this->pGeometry == 0 || polyCount == 0)
+        return false;
+    // Grab the transform FMOD has
+    FMOD_VECTOR position = { 0.0f, 0.0f, 0.0f };
+    FMOD_VECTOR forward = { 0.0f, 0.0f, 1.0f };
+    FMOD_VECTOR up = { 0.0f, 1.0f, 0.0f };
+    FMOD_VECTOR scale = { 1.0f, 1.0f, 1.0f };
+    FMOD_Geometry_GetPosition(this->pGeometry, &position);
+    FMOD_Geometry_GetRotation(this->pGeometry, &forward, &up);
+    FMOD_Geometry_GetScale(this->pGeometry, &scale);
+    // Right completes the basis (up x forward)
+    FMOD_VECTOR right;
+        right.x = up.y * forward.z - up.z * forward.y;
+        right.y = up.z * forward.x - up.x * forward.z;
+        right.z = up.x * forward.y - up.y * forward.x;
+    // Grow the box around every vertex (scaled, rotated then moved)
+    bool firstFlag = true;
+    for (int i = 0; i < polyCount; i++)
+    {
+        int numVertices = this->getPolygonNumVertices(i);
+        for (int v = 0; v < numVertices; v++)
+        {
+            FMOD_VECTOR vertex = this->getPolygonVertex(i, v);
+            vertex.x *= scale.x;
+            vertex.y *= scale.y;
+            vertex.z *= scale.z;
+            FMOD_VECTOR world;
+                world.x = position.x + right.x * vertex.x + up.x * vertex.y + forward.x * vertex.z;
+                world.y = position.y + right.y * vertex.x + up.y * vertex.y + forward.y * vertex.z;
+                world.z = position.z + right.z * vertex.x + up.z * vertex.y + forward.z * vertex.z;
+            if (firstFlag == true)
+            {
+                minimum = world;
+                maximum = world;
+                firstFlag = false;
+                continue;
+            }
+            minimum.x = (world.x < minimum.x) ? world.x : minimum.x;
+            minimum.y = (world.y < minimum.y) ? world.y : minimum.y;
+            minimum.z = (world.z < minimum.z) ? world.z : minimum.z;
+            maximum.x = (world.x > maximum.x) ? world.x : maximum.x;
+            maximum.y = (world.y > maximum.y) ? world.y : maximum.y;
+            maximum.z = (world.z > maximum.z) ? world.z : maximum.z;
+        }
+    }
+    // return true if there was a vertex
+    return (firstFlag == false);
+}
+
+void Geometry::geometryChanged()
+{
+    // Throw away the cached occlusion
+    if (FMODGlobals::pOcclusionService != 0)
+        FMODGlobals::pOcclusionService->invalidate();
+    // Rebuild the traced hierarchy
+    if (FMODGlobals::pOcclusionTracer != 0)
+        FMODGlobals::pOcclusionTracer->invalidate();
+}
+
 //void Geometry::bindToLua(lua_State* pLuaState)
 //{
 //
@@ -2,6 +2,7 @@
 #define GEOMETRY_H
 
 // C++ Includes
+#include <iostream>
 #include <string>
 
 // FMOD Includes
@@ -51,15 +52,24 @@ class Geometry
           * @return true on success false otherwise **/
         virtual bool create(int maxPolygons, int maxVertices);
         /** @brief loadGeometry
-          * @param pData address with the geometry data
-          * @param dataSize size of the data block in bytes **/
+          * @param pData address with the geometry data (FMOD reads it in place, it
+          * can be freed or unmapped afterwards)
+          * @param dataSize size of the data block in bytes
+          * @return true on success false otherwise **/
         virtual bool load(const void* pData, int dataSize);
         /** @brief saveGeometry
-          * @param pData address with the geometry data
-          * @param dataSize size of the data block in bytes **/
+          * @param pData address to save the geometry data to
+          * @param dataSize size of the data block in bytes (at least getSaveSize())
+          * @return true on success false otherwise **/
         virtual bool save(void* pData, int dataSize);
+        /** @brief getSaveSize
+          * @return size in bytes save needs (0 if there is no geometry) **/
+        virtual int getSaveSize();
         /** @brief release **/
         virtual void release();
+        /** @brief getFMODGeometry
+          * @return the FMOD_GEOMETRY (0 before create or load) **/
+        virtual FMOD_GEOMETRY* getFMODGeometry() { return this->pGeometry; }
         /** @brief getX
           * @return Horizontal coordinate **/
         virtual float getX();
@@ -102,6 +112,16 @@ class Geometry
           * @param yForward
           * @param zForward **/
         virtual void setForward(float xForward, float yForward, float zForward);
+        /** @brief setRotation
+          * Set forward and up together (setting them one at a time passes FMOD
+          * a pair which is not perpendicular in between)
+          * @param xForward forward horizontal coordinate
+          * @param yForward forward vertical coordinate
+          * @param zForward forward depth coordinate
+          * @param xUp up horizontal coordinate
+          * @param yUp up vertical coordinate
+          * @param zUp up depth coordinate **/
+        virtual void setRotation(float xForward, float yForward, float zForward, float xUp, float yUp, float zUp);
         /** @brief getXScale
           * @return Horizontal Scale **/
         virtual float getXScale();
@@ -186,6 +206,17 @@ class Geometry
           * @param index index of the polygon in the mesh
           * @return double sided polygon flag **/
         virtual bool getPolygonAttributeDoubleSided(bool polygonIndex);
+        /** @brief getWorldBounds
+          * Box around every polygon once FMOD has moved, rotated and scaled them
+          * @param minimum receives the smallest corner
+          * @param maximum receives the largest corner
+          * @return false if there are no polygons **/
+        virtual bool getWorldBounds(FMOD_VECTOR& minimum, FMOD_VECTOR& maximum);
+
+    protected:
+        /** @brief geometryChanged
+          * Tell the OcclusionService and OcclusionTracer their results are out of date **/
+        virtual void geometryChanged();
 
     protected:
         // FMOD_GEOMETRY
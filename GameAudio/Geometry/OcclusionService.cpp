@@ -0,0 +1,351 @@
+#include "OcclusionService.h"
+
+OcclusionService::OcclusionService()
+{
+    // Channels
+    this->channels.clear();
+    this->pendingTraces.clear();
+    this->cursor = 0;
+    // Cache
+    this->cache.clear();
+    this->maxCacheSize = 4096;
+    // Settings
+    this->timeBudget = 1.0f;
+    this->quantization = 0.5f;
+    this->smoothingTime = 0.15f;
+    this->refreshInterval = 0.5f;
+    // Trace through FMOD
+    this->pOcclusionTracer = 0;
+    // Stats
+    this->numberOfQueries = 0;
+    this->numberOfCacheHits = 0;
+    this->numberOfPendingChannels = 0;
+    // Not updated yet
+    this->updatedFlag = false;
+}
+
+OcclusionService::~OcclusionService()
+{
+
+}
+
+void OcclusionService::update(const FMOD_VECTOR* pListenerPositions, int numberOfListeners)
+{
+    // Time of this update
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    // Lock the Service
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Time since the last update
+    float dTime = (this->updatedFlag == true) ? std::chrono::duration<float>(now - this->lastUpdate).count() : 0.0f;
+    this->lastUpdate = now;
+    this->updatedFlag = true;
+    // Reset Stats
+    this->numberOfQueries = 0;
+    this->numberOfCacheHits = 0;
+    // Nothing to trace to without a listener
+    if (pListenerPositions == 0 || numberOfListeners < 1)
+        return;
+    // Bring the tracer's hierarchy up to date first (a rebuild is not charged to the time budget)
+    if (this->pOcclusionTracer != 0)
+        this->pOcclusionTracer->update();
+    // Find the Channels which need a trace
+    this->pendingTraces.clear();
+    for (unsigned int i = 0; i < this->channels.size(); i++)
+    {
+        // Grab the Channel
+        OccludedChannel& channel = this->channels[i];
+        channel.age += dTime;
+        // Channels out of earshot or not playing can wait
+        if (channel.pSound3D != 0 && channel.pSound3D->isSpatialActive() == false)
+            continue;
+        if (channel.pStream3D != 0 && channel.pStream3D->isSpatialActive() == false)
+            continue;
+        if (channel.pChannel->isPlaying() == false)
+            continue;
+        // Closest listener
+        FMOD_VECTOR start = this->getPosition(channel);
+        FMOD_VECTOR finish = pListenerPositions[0];
+        float closestDistanceSquared = -1.0f;
+        for (int l = 0; l < numberOfListeners; l++)
+        {
+            float dx = start.x - pListenerPositions[l].x;
+            float dy = start.y - pListenerPositions[l].y;
+            float dz = start.z - pListenerPositions[l].z;
+            float distanceSquared = dx * dx + dy * dy + dz * dz;
+            if (closestDistanceSquared < 0.0f || distanceSquared < closestDistanceSquared)
+            {
+                closestDistanceSquared = distanceSquared;
+                finish = pListenerPositions[l];
+            }
+        }
+        // Only trace when something moved cell or the result is old
+        unsigned long long key = this->makeKey(start, finish);
+        bool refreshFlag = (channel.age >= this->refreshInterval);
+        if (channel.tracedFlag == true && channel.key == key && refreshFlag == false)
+            continue;
+        // Queue the trace
+        PendingTrace trace;
+        trace.index = (int)i;
+        trace.start = start;
+        trace.finish = finish;
+        trace.key = key;
+        trace.refreshFlag = (channel.tracedFlag == true && channel.key == key);
+        this->pendingTraces.push_back(trace);
+    }
+    // Start where the last update ran out of time so every Channel gets a turn
+    unsigned int first = 0;
+    while (first < this->pendingTraces.size() && this->pendingTraces[first].index < this->cursor)
+        first++;
+    // Trace until the budget runs out
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::microseconds((long long)(this->timeBudget * 1000.0f));
+    unsigned int traced = 0;
+    this->cursor = 0;
+    for (; traced < this->pendingTraces.size(); traced++)
+    {
+        // Out of time, carry on from here next update
+        const PendingTrace& trace = this->pendingTraces[(first + traced) % this->pendingTraces.size()];
+        if (this->numberOfQueries > 0 && std::chrono::steady_clock::now() >= deadline)
+        {
+            this->cursor = trace.index;
+            break;
+        }
+        // Use the cache unless the result is being refreshed
+        OcclusionResult result;
+        std::unordered_map<unsigned long long, OcclusionResult>::iterator cached = this->cache.find(trace.key);
+        if (cached != this->cache.end() && trace.refreshFlag == false)
+        {
+            result = cached->second;
+            this->numberOfCacheHits++;
+        }
+        else
+        {
+            this->traceOcclusion(trace.start, trace.finish, result.directOcclusion, result.reverbOcclusion);
+            this->numberOfQueries++;
+            // Start the cache again when it is full
+            if (this->cache.size() >= this->maxCacheSize)
+                this->cache.clear();
+            this->cache[trace.key] = result;
+        }
+        // Hand the result to the Channel
+        OccludedChannel& channel = this->channels[trace.index];
+        channel.key = trace.key;
+        channel.age = 0.0f;
+        channel.targetDirectOcclusion = result.directOcclusion;
+        channel.targetReverbOcclusion = result.reverbOcclusion;
+        // The first result is used straight away
+        if (channel.tracedFlag == false)
+        {
+            channel.tracedFlag = true;
+            channel.directOcclusion = result.directOcclusion;
+            channel.reverbOcclusion = result.reverbOcclusion;
+            this->applyOcclusion(channel);
+        }
+    }
+    this->numberOfPendingChannels = (int)(this->pendingTraces.size() - traced);
+    // Ease every Channel towards its result
+    float blend = (this->smoothingTime > 0.0f) ? 1.0f - std::exp(-dTime / this->smoothingTime) : 1.0f;
+    for (unsigned int i = 0; i < this->channels.size(); i++)
+    {
+        // Grab the Channel
+        OccludedChannel& channel = this->channels[i];
+        if (channel.tracedFlag == false)
+            continue;
+        // Already there
+        float directDifference = channel.targetDirectOcclusion - channel.directOcclusion;
+        float reverbDifference = channel.targetReverbOcclusion - channel.reverbOcclusion;
+        if (directDifference == 0.0f && reverbDifference == 0.0f)
+            continue;
+        // Close enough to snap
+        if (std::fabs(directDifference) < 0.001f && std::fabs(reverbDifference) < 0.001f)
+        {
+            channel.directOcclusion = channel.targetDirectOcclusion;
+            channel.reverbOcclusion = channel.targetReverbOcclusion;
+        }
+        else
+        {
+            channel.directOcclusion += directDifference * blend;
+            channel.reverbOcclusion += reverbDifference * blend;
+        }
+        // Hand it over
+        this->applyOcclusion(channel);
+    }
+}
+
+void OcclusionService::clear()
+{
+    // Lock the Service
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Forget everything
+    this->channels.clear();
+    this->pendingTraces.clear();
+    this->cursor = 0;
+    this->cache.clear();
+    // Reset Stats
+    this->numberOfQueries = 0;
+    this->numberOfCacheHits = 0;
+    this->numberOfPendingChannels = 0;
+    this->updatedFlag = false;
+}
+
+void OcclusionService::invalidate()
+{
+    // Lock the Service
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Throw the cache away
+    this->cache.clear();
+    // Make every result old so it is traced again (keeping the current value to ease from)
+    for (unsigned int i = 0; i < this->channels.size(); i++)
+        this->channels[i].age = this->refreshInterval;
+}
+
+void OcclusionService::addChannel(Channel* pChannel)
+{
+    // Validate the Channel
+    if (pChannel == 0)
+        return;
+    // Only 3D Channels have occlusion
+    Sound3D* pSound3D = dynamic_cast<Sound3D*>(pChannel);
+    Stream3D* pStream3D = dynamic_cast<Stream3D*>(pChannel);
+    if (pSound3D == 0 && pStream3D == 0)
+    {
+        std::cout << "void OcclusionService::addChannel() failure. Only a Sound3D or Stream3D can be occluded" << std::endl;
+        return;
+    }
+    // Lock the Service
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Only look after a Channel once
+    for (unsigned int i = 0; i < this->channels.size(); i++)
+    {
+        if (this->channels[i].pChannel == pChannel)
+            return;
+    }
+    // Add the Channel
+    OccludedChannel channel;
+    channel.pChannel = pChannel;
+    channel.pSound3D = pSound3D;
+    channel.pStream3D = pStream3D;
+    channel.key = 0;
+    channel.age = 0.0f;
+    channel.tracedFlag = false;
+    channel.targetDirectOcclusion = 0.0f;
+    channel.targetReverbOcclusion = 0.0f;
+    channel.directOcclusion = 0.0f;
+    channel.reverbOcclusion = 0.0f;
+    this->channels.push_back(channel);
+}
+
+void OcclusionService::removeChannel(Channel* pChannel)
+{
+    // Lock the Service
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the Channel
+    for (unsigned int i = 0; i < this->channels.size(); i++)
+    {
+        if (this->channels[i].pChannel == pChannel)
+        {
+            // Swap with the last Channel and remove
+            this->channels[i] = this->channels.back();
+            this->channels.pop_back();
+            // Indices have moved so start from the beginning next update
+            this->cursor = 0;
+            return;
+        }
+    }
+}
+
+void OcclusionService::setQuantization(float quantization)
+{
+    // Validate the quantization
+    if (quantization <= 0.0f)
+    {
+        std::cout << "void OcclusionService::setQuantization() failure. quantization must be above 0" << std::endl;
+        return;
+    }
+    // Lock the Service
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Set Quantization (the old keys mean nothing now)
+    this->quantization = quantization;
+    this->cache.clear();
+}
+
+void OcclusionService::setOcclusionTracer(OcclusionTracer* pOcclusionTracer)
+{
+    // Lock the Service
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Set Occlusion Tracer (the two may not agree so start the cache again)
+    this->pOcclusionTracer = pOcclusionTracer;
+    this->cache.clear();
+}
+
+int OcclusionService::getNumberOfChannels()
+{
+    // Lock the Service
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of Channels
+    return (int)this->channels.size();
+}
+
+void OcclusionService::traceOcclusion(const FMOD_VECTOR& start, const FMOD_VECTOR& finish, float& directOcclusion, float& reverbOcclusion)
+{
+    // Nothing in the way unless FMOD says otherwise
+    directOcclusion = 0.0f;
+    reverbOcclusion = 0.0f;
+    // Trace through the Occlusion Tracer when there is one
+    if (this->pOcclusionTracer != 0)
+    {
+        this->pOcclusionTracer->trace(start, finish, directOcclusion, reverbOcclusion);
+        return;
+    }
+    // Trace the ray (one call gives both results)
+    FMOD_System_GetGeometryOcclusion(FMODGlobals::pFMODSystem, &start, &finish, &directOcclusion, &reverbOcclusion);
+}
+
+unsigned long long OcclusionService::makeKey(const FMOD_VECTOR& start, const FMOD_VECTOR& finish)
+{
+    // Snap both positions to the quantization
+    long long cells[6];
+    cells[0] = (long long)std::floor(start.x / this->quantization);
+    cells[1] = (long long)std::floor(start.y / this->quantization);
+    cells[2] = (long long)std::floor(start.z / this->quantization);
+    cells[3] = (long long)std::floor(finish.x / this->quantization);
+    cells[4] = (long long)std::floor(finish.y / this->quantization);
+    cells[5] = (long long)std::floor(finish.z / this->quantization);
+    // Hash the cells (FNV-1a over each 64 bit value)
+    unsigned long long key = 0xCBF29CE484222325ULL;
+    for (int i = 0; i < 6; i++)
+    {
+        key ^= (unsigned long long)cells[i];
+        key *= 0x100000001B3ULL;
+    }
+    // return the key
+    return key;
+}
+
+FMOD_VECTOR OcclusionService::getPosition(const OccludedChannel& channel)
+{
+    // Position
+    FMOD_VECTOR position;
+    if (channel.pSound3D != 0)
+    {
+        position.x = channel.pSound3D->getX();
+        position.y = channel.pSound3D->getY();
+        position.z = channel.pSound3D->getZ();
+    }
+    else
+    {
+        position.x = channel.pStream3D->getX();
+        position.y = channel.pStream3D->getY();
+        position.z = channel.pStream3D->getZ();
+    }
+    // return position
+    return position;
+}
+
+void OcclusionService::applyOcclusion(OccludedChannel& channel)
+{
+    // Set Direct and Reverb Occlusion together
+    if (channel.pSound3D != 0)
+        channel.pSound3D->setOcclusion(channel.directOcclusion, channel.reverbOcclusion);
+    else
+        channel.pStream3D->setOcclusion(channel.directOcclusion, channel.reverbOcclusion);
+}
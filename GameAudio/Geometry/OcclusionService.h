@@ -0,0 +1,242 @@
+/**
+  * @file   OcclusionService.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  OcclusionService traces geometry occlusion for 3D Channels
+  * under a time budget and feeds it to them smoothed
+*/
+
+#ifndef OCCLUSIONSERVICE_H
+#define OCCLUSIONSERVICE_H
+
+// C++ Includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Channel/Channel.h"
+#include "Geometry/OcclusionTracer.h"
+#include "Sound/Sound3D.h"
+#include "Stream/Stream3D.h"
+
+/** The OcclusionService looks after the direct and reverb occlusion of
+    the Sound3Ds and Stream3Ds added to it. Each update the Channels whose
+    position or closest listener has moved into a different quantization
+    cell (or whose result is older than the refresh interval) are queued
+    and traced one ray each (FMOD_System_GetGeometryOcclusion, keeping both
+    results) until the time budget for the update is used up, the rest
+    wait for the next update. Results are cached by quantized emitter and
+    listener position so Channels at the same spot, or one going back and
+    forth, do not trace again. The occlusion handed to each Channel eases
+    towards the traced value over the smoothing time so it never jumps.
+    Channels added here should be created with FMOD_3D_IGNOREGEOMETRY or
+    FMOD will occlude them a second time itself. With an OcclusionTracer
+    set the rays are traced through its hierarchy instead of through FMOD
+    (a rebuild of the hierarchy happens before the budget starts) **/
+class OcclusionService
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        OcclusionService();
+        //! Destructor
+        virtual ~OcclusionService();
+
+    protected:
+        //! OcclusionService Copy constructor
+        OcclusionService(const OcclusionService& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! OcclusionService Assignment operator
+        OcclusionService& operator=(const OcclusionService& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief update
+          * Trace what has changed (within the time budget) and ease every Channel towards its result
+          * @param pListenerPositions positions of the listeners
+          * @param numberOfListeners number of listeners **/
+        virtual void update(const FMOD_VECTOR* pListenerPositions, int numberOfListeners);
+        /** @brief clear
+          * Forget every Channel and the cache **/
+        virtual void clear();
+        /** @brief invalidate
+          * Throw the cache away and trace everything again (Geometry calls
+          * this whenever it changes) **/
+        virtual void invalidate();
+
+    public:
+        /** @brief addChannel
+          * @param pChannel a Sound3D or Stream3D **/
+        virtual void addChannel(Channel* pChannel);
+        /** @brief removeChannel (called by the Sound3D and Stream3D destructors)
+          * @param pChannel the Channel to stop looking after **/
+        virtual void removeChannel(Channel* pChannel);
+
+    public:
+        /** @brief Get Time Budget
+          * @return milliseconds of tracing allowed per update **/
+        virtual float getTimeBudget() { return this->timeBudget; }
+        /** @brief Set Time Budget
+          * @param timeBudget milliseconds of tracing allowed per update (default 1.0) **/
+        virtual void setTimeBudget(float timeBudget) { this->timeBudget = timeBudget; }
+        /** @brief Get Quantization
+          * @return size of the cells positions are snapped to **/
+        virtual float getQuantization() { return this->quantization; }
+        /** @brief Set Quantization
+          * @param quantization size of the cells positions are snapped to (default 0.5) **/
+        virtual void setQuantization(float quantization);
+        /** @brief Get Smoothing Time
+          * @return seconds to ease most of the way to a new result **/
+        virtual float getSmoothingTime() { return this->smoothingTime; }
+        /** @brief Set Smoothing Time
+          * @param smoothingTime seconds to ease most of the way to a new result (default 0.15) **/
+        virtual void setSmoothingTime(float smoothingTime) { this->smoothingTime = smoothingTime; }
+        /** @brief Get Refresh Interval
+          * @return seconds before a result which has not moved is traced again **/
+        virtual float getRefreshInterval() { return this->refreshInterval; }
+        /** @brief Set Refresh Interval
+          * @param refreshInterval seconds before a result which has not moved is traced again (default 0.5) **/
+        virtual void setRefreshInterval(float refreshInterval) { this->refreshInterval = refreshInterval; }
+        /** @brief Get Occlusion Tracer
+          * @return the tracer rays go through (0 for FMOD's geometry engine) **/
+        virtual OcclusionTracer* getOcclusionTracer() { return this->pOcclusionTracer; }
+        /** @brief Set Occlusion Tracer
+          * @param pOcclusionTracer the tracer rays go through (0 for FMOD's geometry engine, the default) **/
+        virtual void setOcclusionTracer(OcclusionTracer* pOcclusionTracer);
+        /** @brief Get the number of Channels
+          * @return Channels looked after **/
+        virtual int getNumberOfChannels();
+        /** @brief Get the number of rays traced in the last update
+          * @return rays **/
+        virtual int getNumberOfQueries() { return this->numberOfQueries; }
+        /** @brief Get the number of results found in the cache in the last update
+          * @return cache hits **/
+        virtual int getNumberOfCacheHits() { return this->numberOfCacheHits; }
+        /** @brief Get the number of Channels left waiting by the last update
+          * @return Channels waiting for a trace **/
+        virtual int getNumberOfPendingChannels() { return this->numberOfPendingChannels; }
+
+    protected:
+        // A Channel the service looks after
+        struct OccludedChannel
+        {
+            // The Channel
+            Channel* pChannel;
+            // The Channel as a Sound3D (or 0)
+            Sound3D* pSound3D;
+            // The Channel as a Stream3D (or 0)
+            Stream3D* pStream3D;
+            // Key of the quantized emitter and listener positions last traced
+            unsigned long long key;
+            // Seconds since the last trace
+            float age;
+            // Has it ever been traced
+            bool tracedFlag;
+            // Traced occlusion
+            float targetDirectOcclusion;
+            float targetReverbOcclusion;
+            // Occlusion handed to the Channel
+            float directOcclusion;
+            float reverbOcclusion;
+        };
+        // A ray waiting to be traced
+        struct PendingTrace
+        {
+            // Index of the Channel
+            int index;
+            // Emitter position
+            FMOD_VECTOR start;
+            // Closest listener position
+            FMOD_VECTOR finish;
+            // Key of the quantized positions
+            unsigned long long key;
+            // Trace even if the cache has it (the result is old)
+            bool refreshFlag;
+        };
+        // A cached result
+        struct OcclusionResult
+        {
+            // Direct Occlusion
+            float directOcclusion;
+            // Reverb Occlusion
+            float reverbOcclusion;
+        };
+
+    protected:
+        /** @brief traceOcclusion
+          * Trace one ray through the geometry
+          * @param start emitter position
+          * @param finish listener position
+          * @param directOcclusion receives the direct occlusion
+          * @param reverbOcclusion receives the reverb occlusion **/
+        virtual void traceOcclusion(const FMOD_VECTOR& start, const FMOD_VECTOR& finish, float& directOcclusion, float& reverbOcclusion);
+        /** @brief makeKey
+          * @param start emitter position
+          * @param finish listener position
+          * @return hash of both positions snapped to the quantization **/
+        virtual unsigned long long makeKey(const FMOD_VECTOR& start, const FMOD_VECTOR& finish);
+        /** @brief getPosition
+          * @param channel a Channel looked after by the service
+          * @return position of the Channel **/
+        virtual FMOD_VECTOR getPosition(const OccludedChannel& channel);
+        /** @brief applyOcclusion
+          * @param channel a Channel looked after by the service **/
+        virtual void applyOcclusion(OccludedChannel& channel);
+
+    protected:
+        // Channels
+        std::vector<OccludedChannel> channels;
+        // Rays to trace this update (kept to avoid reallocating)
+        std::vector<PendingTrace> pendingTraces;
+        // Channel the last update stopped tracing at (so every Channel gets a turn)
+        int cursor;
+        // Cached results
+        std::unordered_map<unsigned long long, OcclusionResult> cache;
+        // Most results the cache holds before it starts again
+        unsigned int maxCacheSize;
+        // Time Budget (milliseconds)
+        float timeBudget;
+        // Quantization
+        float quantization;
+        // Smoothing Time (seconds)
+        float smoothingTime;
+        // Refresh Interval (seconds)
+        float refreshInterval;
+        // Tracer rays go through instead of FMOD (or 0)
+        OcclusionTracer* pOcclusionTracer;
+        // Rays traced in the last update
+        int numberOfQueries;
+        // Cache hits in the last update
+        int numberOfCacheHits;
+        // Channels still waiting after the last update
+        int numberOfPendingChannels;
+        // Time of the last update
+        std::chrono::steady_clock::time_point lastUpdate;
+        // Has update been called yet
+        bool updatedFlag;
+        // Guards everything (Channels can be added from any thread)
+        std::mutex mutex;
+};
+
+#endif // OCCLUSIONSERVICE_H
@@ -0,0 +1,560 @@
+#include "OcclusionTracer.h"
+#include "Geometry/Geometry.h"
+
+OcclusionTracer::OcclusionTracer()
+{
+    // Polygons
+    this->geometries.clear();
+    this->worldPolygons.clear();
+    this->worldVertices.clear();
+    this->polygons.clear();
+    this->vertices.clear();
+    // Hierarchy
+    this->order.clear();
+    this->centres.clear();
+    this->nodes.clear();
+    // Settings
+    this->cutOff = 0.001f;
+    this->leafSize = 4;
+    // Nothing to build yet
+    this->dirtyFlag = false;
+}
+
+OcclusionTracer::~OcclusionTracer()
+{
+
+}
+
+void OcclusionTracer::addGeometry(Geometry* pGeometry)
+{
+    // Validate the Geometry
+    if (pGeometry == 0)
+        return;
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Only add a Geometry once
+    if (std::find(this->geometries.begin(), this->geometries.end(), pGeometry) != this->geometries.end())
+        return;
+    // Add the Geometry
+    this->geometries.push_back(pGeometry);
+    this->dirtyFlag = true;
+}
+
+void OcclusionTracer::removeGeometry(Geometry* pGeometry)
+{
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the Geometry
+    std::vector<Geometry*>::iterator iter = std::find(this->geometries.begin(), this->geometries.end(), pGeometry);
+    if (iter == this->geometries.end())
+        return;
+    // Remove the Geometry
+    this->geometries.erase(iter);
+    this->dirtyFlag = true;
+}
+
+int OcclusionTracer::addPolygon(float directOcclusion, float reverbOcclusion, bool doubleSidedFlag, int numVertices, const FMOD_VECTOR* pVertices)
+{
+    // Validate the polygon
+    if (numVertices < 3 || pVertices == 0)
+    {
+        std::cout << "int OcclusionTracer::addPolygon() failure. A polygon needs at least 3 vertices" << std::endl;
+        return -1;
+    }
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Add the polygon
+    int index = this->addWorldPolygon(directOcclusion, reverbOcclusion, doubleSidedFlag, numVertices, pVertices, this->worldPolygons, this->worldVertices);
+    if (index == -1)
+    {
+        std::cout << "int OcclusionTracer::addPolygon() failure. The polygon has no area" << std::endl;
+        return -1;
+    }
+    // The hierarchy needs rebuilding
+    this->dirtyFlag = true;
+    // return the index
+    return index;
+}
+
+void OcclusionTracer::clear()
+{
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Forget everything
+    this->geometries.clear();
+    this->worldPolygons.clear();
+    this->worldVertices.clear();
+    this->polygons.clear();
+    this->vertices.clear();
+    this->order.clear();
+    this->centres.clear();
+    this->nodes.clear();
+    this->dirtyFlag = false;
+}
+
+void OcclusionTracer::invalidate()
+{
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Rebuild before the next trace
+    this->dirtyFlag = true;
+}
+
+void OcclusionTracer::build()
+{
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Rebuild now
+    this->rebuild();
+}
+
+void OcclusionTracer::update()
+{
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Rebuild if anything changed
+    if (this->dirtyFlag == true)
+        this->rebuild();
+}
+
+void OcclusionTracer::trace(const FMOD_VECTOR& start, const FMOD_VECTOR& finish, float& directOcclusion, float& reverbOcclusion)
+{
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Rebuild if anything changed
+    if (this->dirtyFlag == true)
+        this->rebuild();
+    // Trace the ray on its own
+    TracerPacket packet;
+    this->setupPacket(packet, &start, &finish, 1);
+    this->tracePacket(packet);
+    // What does not get through is occluded
+    directOcclusion = 1.0f - packet.directTransmission[0];
+    reverbOcclusion = 1.0f - packet.reverbTransmission[0];
+}
+
+void OcclusionTracer::traceBatch(const FMOD_VECTOR* pStarts, const FMOD_VECTOR* pFinishes, int numberOfRays, float* pDirectOcclusions, float* pReverbOcclusions, int numberOfThreads)
+{
+    // Validate the batch
+    if (pStarts == 0 || pFinishes == 0 || pDirectOcclusions == 0 || pReverbOcclusions == 0 || numberOfRays < 1)
+        return;
+    // Lock the Tracer (the threads only read)
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Rebuild if anything changed
+    if (this->dirtyFlag == true)
+        this->rebuild();
+    // One thread per core unless told otherwise
+    if (numberOfThreads < 1)
+        numberOfThreads = (int)std::thread::hardware_concurrency();
+    // No point starting a thread for fewer than 64 rays
+    numberOfThreads = std::max(1, std::min(numberOfThreads, numberOfRays / 64));
+    // Small batches are traced here
+    if (numberOfThreads == 1)
+    {
+        this->tracePackets(pStarts, pFinishes, 0, numberOfRays, pDirectOcclusions, pReverbOcclusions);
+        return;
+    }
+    // Share whole packets between the threads
+    int numberOfPackets = (numberOfRays + 3) / 4;
+    int packetsPerThread = (numberOfPackets + numberOfThreads - 1) / numberOfThreads;
+    std::vector<std::thread> threads;
+    int first = 0;
+    while (first < numberOfRays)
+    {
+        // Rays for this thread
+        int count = std::min(packetsPerThread * 4, numberOfRays - first);
+        // The last share is traced here
+        if (first + count >= numberOfRays)
+            this->tracePackets(pStarts, pFinishes, first, count, pDirectOcclusions, pReverbOcclusions);
+        else
+            threads.push_back(std::thread(&OcclusionTracer::tracePackets, this, pStarts, pFinishes, first, count, pDirectOcclusions, pReverbOcclusions));
+        first += count;
+    }
+    // Wait for the threads
+    for (unsigned int i = 0; i < threads.size(); i++)
+        threads[i].join();
+}
+
+void OcclusionTracer::setLeafSize(int leafSize)
+{
+    // Validate the leaf size
+    if (leafSize < 1)
+    {
+        std::cout << "void OcclusionTracer::setLeafSize() failure. leafSize must be at least 1" << std::endl;
+        return;
+    }
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Set Leaf Size
+    this->leafSize = leafSize;
+    this->dirtyFlag = true;
+}
+
+int OcclusionTracer::getNumberOfPolygons()
+{
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of polygons
+    return (int)this->polygons.size();
+}
+
+int OcclusionTracer::getNumberOfNodes()
+{
+    // Lock the Tracer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of nodes
+    return (int)this->nodes.size();
+}
+
+void OcclusionTracer::addGeometryPolygons(Geometry* pGeometry)
+{
+    // Grab the FMOD_GEOMETRY
+    FMOD_GEOMETRY* pFMODGeometry = pGeometry->getFMODGeometry();
+    if (pFMODGeometry == 0)
+        return;
+    // Inactive Geometry does not occlude
+    FMOD_BOOL activeFlag = true;
+    FMOD_Geometry_GetActive(pFMODGeometry, &activeFlag);
+    if (activeFlag == false)
+        return;
+    // Grab the transform FMOD places the Geometry with
+    FMOD_VECTOR position = { 0.0f, 0.0f, 0.0f };
+    FMOD_VECTOR forward = { 0.0f, 0.0f, 1.0f };
+    FMOD_VECTOR up = { 0.0f, 1.0f, 0.0f };
+    FMOD_VECTOR scale = { 1.0f, 1.0f, 1.0f };
+    FMOD_Geometry_GetPosition(pFMODGeometry, &position);
+    FMOD_Geometry_GetRotation(pFMODGeometry, &forward, &up);
+    FMOD_Geometry_GetScale(pFMODGeometry, &scale);
+    // Right completes the basis (up x forward)
+    FMOD_VECTOR right;
+        right.x = up.y * forward.z - up.z * forward.y;
+        right.y = up.z * forward.x - up.x * forward.z;
+        right.z = up.x * forward.y - up.y * forward.x;
+    // Copy each polygon into the world
+    int numberOfPolygons = 0;
+    FMOD_Geometry_GetNumPolygons(pFMODGeometry, &numberOfPolygons);
+    std::vector<FMOD_VECTOR> worldVertices;
+    for (int i = 0; i < numberOfPolygons; i++)
+    {
+        // Polygon Attributes
+        float directOcclusion = 0.0f;
+        float reverbOcclusion = 0.0f;
+        FMOD_BOOL doubleSidedFlag = false;
+        FMOD_Geometry_GetPolygonAttributes(pFMODGeometry, i, &directOcclusion, &reverbOcclusion, &doubleSidedFlag);
+        // Transform the vertices (scale, rotate then move)
+        int numVertices = 0;
+        FMOD_Geometry_GetPolygonNumVertices(pFMODGeometry, i, &numVertices);
+        worldVertices.resize(numVertices);
+        for (int v = 0; v < numVertices; v++)
+        {
+            FMOD_VECTOR vertex = { 0.0f, 0.0f, 0.0f };
+            FMOD_Geometry_GetPolygonVertex(pFMODGeometry, i, v, &vertex);
+            vertex.x *= scale.x;
+            vertex.y *= scale.y;
+            vertex.z *= scale.z;
+            worldVertices[v].x = position.x + right.x * vertex.x + up.x * vertex.y + forward.x * vertex.z;
+            worldVertices[v].y = position.y + right.y * vertex.x + up.y * vertex.y + forward.y * vertex.z;
+            worldVertices[v].z = position.z + right.z * vertex.x + up.z * vertex.y + forward.z * vertex.z;
+        }
+        // Add the polygon (degenerate ones are skipped)
+        if (numVertices >= 3)
+            this->addWorldPolygon(directOcclusion, reverbOcclusion, (doubleSidedFlag != 0), numVertices, &(worldVertices[0]), this->polygons, this->vertices);
+    }
+}
+
+int OcclusionTracer::addWorldPolygon(float directOcclusion, float reverbOcclusion, bool doubleSidedFlag, int numVertices, const FMOD_VECTOR* pVertices, std::vector<TracerPolygon>& polygons, std::vector<FMOD_VECTOR>& vertices)
+{
+    // Normal by Newell's method (works for any planar polygon)
+    FMOD_VECTOR normal = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < numVertices; i++)
+    {
+        const FMOD_VECTOR& a = pVertices[i];
+        const FMOD_VECTOR& b = pVertices[(i + 1) % numVertices];
+        normal.x += (a.y - b.y) * (a.z + b.z);
+        normal.y += (a.z - b.z) * (a.x + b.x);
+        normal.z += (a.x - b.x) * (a.y + b.y);
+    }
+    float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+    // No area
+    if (length <= FLT_EPSILON)
+        return -1;
+    // Build the polygon
+    TracerPolygon polygon;
+    polygon.firstVertex = (int)vertices.size();
+    polygon.numVertices = numVertices;
+    polygon.normal.x = normal.x / length;
+    polygon.normal.y = normal.y / length;
+    polygon.normal.z = normal.z / length;
+    polygon.distance = polygon.normal.x * pVertices[0].x + polygon.normal.y * pVertices[0].y + polygon.normal.z * pVertices[0].z;
+    polygon.directOcclusion = directOcclusion;
+    polygon.reverbOcclusion = reverbOcclusion;
+    polygon.doubleSidedFlag = doubleSidedFlag;
+    polygon.minimum = pVertices[0];
+    polygon.maximum = pVertices[0];
+    for (int i = 0; i < numVertices; i++)
+    {
+        polygon.minimum.x = std::min(polygon.minimum.x, pVertices[i].x);
+        polygon.minimum.y = std::min(polygon.minimum.y, pVertices[i].y);
+        polygon.minimum.z = std::min(polygon.minimum.z, pVertices[i].z);
+        polygon.maximum.x = std::max(polygon.maximum.x, pVertices[i].x);
+        polygon.maximum.y = std::max(polygon.maximum.y, pVertices[i].y);
+        polygon.maximum.z = std::max(polygon.maximum.z, pVertices[i].z);
+        vertices.push_back(pVertices[i]);
+    }
+    polygons.push_back(polygon);
+    // return the index
+    return (int)polygons.size() - 1;
+}
+
+void OcclusionTracer::buildNode(int first, int count)
+{
+    // Add the node
+    int index = (int)this->nodes.size();
+    TracerNode node;
+    node.offset = first;
+    node.count = count;
+    // Bounds of the polygons and of their centres
+    const TracerPolygon& firstPolygon = this->polygons[this->order[first]];
+    node.minimum = firstPolygon.minimum;
+    node.maximum = firstPolygon.maximum;
+    FMOD_VECTOR centreMinimum = this->centres[this->order[first]];
+    FMOD_VECTOR centreMaximum = centreMinimum;
+    for (int i = first; i < first + count; i++)
+    {
+        const TracerPolygon& polygon = this->polygons[this->order[i]];
+        const FMOD_VECTOR& centre = this->centres[this->order[i]];
+        node.minimum.x = std::min(node.minimum.x, polygon.minimum.x);
+        node.minimum.y = std::min(node.minimum.y, polygon.minimum.y);
+        node.minimum.z = std::min(node.minimum.z, polygon.minimum.z);
+        node.maximum.x = std::max(node.maximum.x, polygon.maximum.x);
+        node.maximum.y = std::max(node.maximum.y, polygon.maximum.y);
+        node.maximum.z = std::max(node.maximum.z, polygon.maximum.z);
+        centreMinimum.x = std::min(centreMinimum.x, centre.x);
+        centreMinimum.y = std::min(centreMinimum.y, centre.y);
+        centreMinimum.z = std::min(centreMinimum.z, centre.z);
+        centreMaximum.x = std::max(centreMaximum.x, centre.x);
+        centreMaximum.y = std::max(centreMaximum.y, centre.y);
+        centreMaximum.z = std::max(centreMaximum.z, centre.z);
+    }
+    this->nodes.push_back(node);
+    // Small enough for a leaf
+    if (count <= this->leafSize)
+        return;
+    // Split across the widest spread of centres
+    float xExtent = centreMaximum.x - centreMinimum.x;
+    float yExtent = centreMaximum.y - centreMinimum.y;
+    float zExtent = centreMaximum.z - centreMinimum.z;
+    int axis = (xExtent >= yExtent && xExtent >= zExtent) ? 0 : ((yExtent >= zExtent) ? 1 : 2);
+    // Every centre in the same place, nothing to split
+    if (std::max(xExtent, std::max(yExtent, zExtent)) <= 0.0f)
+        return;
+    // Half the polygons each side of the median
+    int middle = first + count / 2;
+    const std::vector<FMOD_VECTOR>& centres = this->centres;
+    std::nth_element(this->order.begin() + first, this->order.begin() + middle, this->order.begin() + first + count,
+        [&centres, axis](int a, int b)
+        {
+            return (axis == 0) ? (centres[a].x < centres[b].x) : ((axis == 1) ? (centres[a].y < centres[b].y) : (centres[a].z < centres[b].z));
+        });
+    // Build the children (the first follows this node)
+    this->nodes[index].count = 0;
+    this->buildNode(first, middle - first);
+    this->nodes[index].offset = (int)this->nodes.size();
+    this->buildNode(middle, first + count - middle);
+}
+
+void OcclusionTracer::rebuild()
+{
+    // Start from the world polygons
+    this->polygons = this->worldPolygons;
+    this->vertices = this->worldVertices;
+    // Copy in the Geometry
+    for (unsigned int i = 0; i < this->geometries.size(); i++)
+        this->addGeometryPolygons(this->geometries[i]);
+    // Centres of the polygon bounds
+    this->centres.resize(this->polygons.size());
+    this->order.resize(this->polygons.size());
+    for (unsigned int i = 0; i < this->polygons.size(); i++)
+    {
+        this->centres[i].x = (this->polygons[i].minimum.x + this->polygons[i].maximum.x) * 0.5f;
+        this->centres[i].y = (this->polygons[i].minimum.y + this->polygons[i].maximum.y) * 0.5f;
+        this->centres[i].z = (this->polygons[i].minimum.z + this->polygons[i].maximum.z) * 0.5f;
+        this->order[i] = (int)i;
+    }
+    // Build the hierarchy
+    this->nodes.clear();
+    if (this->polygons.empty() == false)
+        this->buildNode(0, (int)this->polygons.size());
+    // Up to date
+    this->dirtyFlag = false;
+}
+
+void OcclusionTracer::setupPacket(TracerPacket& packet, const FMOD_VECTOR* pStarts, const FMOD_VECTOR* pFinishes, int numberOfRays)
+{
+    // Fill all four lanes (unused lanes copy the first ray and stay inactive)
+    for (int i = 0; i < 4; i++)
+    {
+        int ray = (i < numberOfRays) ? i : 0;
+        packet.xStart[i] = pStarts[ray].x;
+        packet.yStart[i] = pStarts[ray].y;
+        packet.zStart[i] = pStarts[ray].z;
+        packet.xDirection[i] = pFinishes[ray].x - pStarts[ray].x;
+        packet.yDirection[i] = pFinishes[ray].y - pStarts[ray].y;
+        packet.zDirection[i] = pFinishes[ray].z - pStarts[ray].z;
+        // A huge inverse instead of infinity keeps the box test free of NaNs
+        packet.xInverse[i] = (std::fabs(packet.xDirection[i]) > 1e-20f) ? 1.0f / packet.xDirection[i] : 1e30f;
+        packet.yInverse[i] = (std::fabs(packet.yDirection[i]) > 1e-20f) ? 1.0f / packet.yDirection[i] : 1e30f;
+        packet.zInverse[i] = (std::fabs(packet.zDirection[i]) > 1e-20f) ? 1.0f / packet.zDirection[i] : 1e30f;
+        packet.directTransmission[i] = 1.0f;
+        packet.reverbTransmission[i] = 1.0f;
+    }
+    packet.activeMask = (1 << std::min(numberOfRays, 4)) - 1;
+}
+
+void OcclusionTracer::tracePacket(TracerPacket& packet)
+{
+    // Nothing to hit
+    if (this->nodes.empty() == true)
+        return;
+    // Walk the hierarchy (a median split is never deeper than 64 for an int count of polygons)
+    int stack[64];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0 && packet.activeMask != 0)
+    {
+        // Next node
+        int index = stack[--stackSize];
+        const TracerNode& node = this->nodes[index];
+        // Skip it unless one of the rays passes through
+        int mask = this->hitNode(node, packet);
+        if (mask == 0)
+            continue;
+        // Inner node
+        if (node.count == 0)
+        {
+            stack[stackSize++] = node.offset;
+            stack[stackSize++] = index + 1;
+            continue;
+        }
+        // Leaf: test each polygon against each ray which reached it
+        for (int p = node.offset; p < node.offset + node.count; p++)
+        {
+            const TracerPolygon& polygon = this->polygons[this->order[p]];
+            for (int ray = 0; ray < 4; ray++)
+            {
+                // Ray has stopped or missed the leaf
+                if ((mask & packet.activeMask & (1 << ray)) == 0)
+                    continue;
+                if (this->hitPolygon(polygon, packet, ray) == false)
+                    continue;
+                // Take away what the polygon stops
+                packet.directTransmission[ray] *= 1.0f - polygon.directOcclusion;
+                packet.reverbTransmission[ray] *= 1.0f - polygon.reverbOcclusion;
+                // Stop once nothing much gets through
+                if (packet.directTransmission[ray] <= this->cutOff && packet.reverbTransmission[ray] <= this->cutOff)
+                    packet.activeMask &= ~(1 << ray);
+            }
+        }
+    }
+}
+
+void OcclusionTracer::tracePackets(const FMOD_VECTOR* pStarts, const FMOD_VECTOR* pFinishes, int first, int count, float* pDirectOcclusions, float* pReverbOcclusions)
+{
+    // Four rays at a time
+    TracerPacket packet;
+    for (int i = first; i < first + count; i += 4)
+    {
+        // Trace the packet
+        int numberOfRays = std::min(4, first + count - i);
+        this->setupPacket(packet, &(pStarts[i]), &(pFinishes[i]), numberOfRays);
+        this->tracePacket(packet);
+        // What does not get through is occluded
+        for (int ray = 0; ray < numberOfRays; ray++)
+        {
+            pDirectOcclusions[i + ray] = 1.0f - packet.directTransmission[ray];
+            pReverbOcclusions[i + ray] = 1.0f - packet.reverbTransmission[ray];
+        }
+    }
+}
+
+int OcclusionTracer::hitNode(const TracerNode& node, const TracerPacket& packet)
+{
+    #ifdef OCCLUSIONTRACER_SSE
+    // Slab test on all four rays at once (t runs from 0 at start to 1 at finish)
+    __m128 xStart = _mm_loadu_ps(packet.xStart);
+    __m128 yStart = _mm_loadu_ps(packet.yStart);
+    __m128 zStart = _mm_loadu_ps(packet.zStart);
+    __m128 xInverse = _mm_loadu_ps(packet.xInverse);
+    __m128 yInverse = _mm_loadu_ps(packet.yInverse);
+    __m128 zInverse = _mm_loadu_ps(packet.zInverse);
+    __m128 x0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.minimum.x), xStart), xInverse);
+    __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.maximum.x), xStart), xInverse);
+    __m128 y0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.minimum.y), yStart), yInverse);
+    __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.maximum.y), yStart), yInverse);
+    __m128 z0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.minimum.z), zStart), zInverse);
+    __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(node.maximum.z), zStart), zInverse);
+    __m128 closest = _mm_max_ps(_mm_setzero_ps(), _mm_max_ps(_mm_min_ps(x0, x1), _mm_max_ps(_mm_min_ps(y0, y1), _mm_min_ps(z0, z1))));
+    __m128 furthest = _mm_min_ps(_mm_set1_ps(1.0f), _mm_min_ps(_mm_max_ps(x0, x1), _mm_min_ps(_mm_max_ps(y0, y1), _mm_max_ps(z0, z1))));
+    // return the rays which pass through
+    return _mm_movemask_ps(_mm_cmple_ps(closest, furthest)) & packet.activeMask;
+    #else
+    // Slab test one ray at a time (t runs from 0 at start to 1 at finish)
+    int mask = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        float x0 = (node.minimum.x - packet.xStart[i]) * packet.xInverse[i];
+        float x1 = (node.maximum.x - packet.xStart[i]) * packet.xInverse[i];
+        float y0 = (node.minimum.y - packet.yStart[i]) * packet.yInverse[i];
+        float y1 = (node.maximum.y - packet.yStart[i]) * packet.yInverse[i];
+        float z0 = (node.minimum.z - packet.zStart[i]) * packet.zInverse[i];
+        float z1 = (node.maximum.z - packet.zStart[i]) * packet.zInverse[i];
+        float closest = std::max(0.0f, std::max(std::min(x0, x1), std::max(std::min(y0, y1), std::min(z0, z1))));
+        float furthest = std::min(1.0f, std::min(std::max(x0, x1), std::min(std::max(y0, y1), std::max(z0, z1))));
+        if (closest <= furthest)
+            mask |= (1 << i);
+    }
+    // return the rays which pass through
+    return mask & packet.activeMask;
+    #endif
+}
+
+bool OcclusionTracer::hitPolygon(const TracerPolygon& polygon, const TracerPacket& packet, int ray)
+{
+    // How fast the ray closes on the plane
+    float approach = polygon.normal.x * packet.xDirection[ray] + polygon.normal.y * packet.yDirection[ray] + polygon.normal.z * packet.zDirection[ray];
+    // Parallel rays never cross
+    if (std::fabs(approach) <= FLT_EPSILON)
+        return false;
+    // A single sided polygon only stops rays arriving on its front
+    if (polygon.doubleSidedFlag == false && approach > 0.0f)
+        return false;
+    // Where the ray crosses the plane
+    float startDistance = polygon.normal.x * packet.xStart[ray] + polygon.normal.y * packet.yStart[ray] + polygon.normal.z * packet.zStart[ray];
+    float t = (polygon.distance - startDistance) / approach;
+    if (t < 0.0f || t > 1.0f)
+        return false;
+    FMOD_VECTOR point;
+        point.x = packet.xStart[ray] + packet.xDirection[ray] * t;
+        point.y = packet.yStart[ray] + packet.yDirection[ray] * t;
+        point.z = packet.zStart[ray] + packet.zDirection[ray] * t;
+    // Inside when the point is on the inner side of every edge
+    const FMOD_VECTOR* pVertices = &(this->vertices[polygon.firstVertex]);
+    for (int i = 0; i < polygon.numVertices; i++)
+    {
+        const FMOD_VECTOR& a = pVertices[i];
+        const FMOD_VECTOR& b = pVertices[(i + 1) % polygon.numVertices];
+        float xEdge = b.x - a.x;
+        float yEdge = b.y - a.y;
+        float zEdge = b.z - a.z;
+        float xPoint = point.x - a.x;
+        float yPoint = point.y - a.y;
+        float zPoint = point.z - a.z;
+        float side = polygon.normal.x * (yEdge * zPoint - zEdge * yPoint)
+                   + polygon.normal.y * (zEdge * xPoint - xEdge * zPoint)
+                   + polygon.normal.z * (xEdge * yPoint - yEdge * xPoint);
+        if (side < 0.0f)
+            return false;
+    }
+    // The ray crosses the polygon
+    return true;
+}
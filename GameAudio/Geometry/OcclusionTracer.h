@@ -0,0 +1,271 @@
+/**
+  * @file   OcclusionTracer.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  OcclusionTracer traces geometry occlusion through its own
+  * bounding volume hierarchy instead of FMOD's geometry engine
+*/
+
+#ifndef OCCLUSIONTRACER_H
+#define OCCLUSIONTRACER_H
+
+// C++ Includes
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define OCCLUSIONTRACER_SSE
+    #include <xmmintrin.h>
+#endif
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+
+// Forward declaration
+class Geometry;
+
+/** The OcclusionTracer is an optional replacement for
+    FMOD_System_GetGeometryOcclusion. It copies the polygons out of the
+    Geometry added to it (moved, rotated and scaled into the world the way
+    FMOD places them) along with any polygons added directly in world space,
+    and builds a bounding volume hierarchy over them. A ray picks up the
+    direct and reverb occlusion of every polygon it crosses between start
+    and finish and they combine the way FMOD combines them: what gets
+    through is the product of (1 - occlusion) over the polygons crossed.
+    A single sided polygon only occludes a ray arriving on its front
+    (the side its winding faces). Rays are traced four at a time down the
+    hierarchy (SSE box tests when available) and traceBatch splits a large
+    batch over several threads. The hierarchy is rebuilt on the next trace
+    after anything changes. Polygons added directly need no FMOD at all so
+    the tracer works headless **/
+class OcclusionTracer
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        OcclusionTracer();
+        //! Destructor
+        virtual ~OcclusionTracer();
+
+    protected:
+        //! OcclusionTracer Copy constructor
+        OcclusionTracer(const OcclusionTracer& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! OcclusionTracer Assignment operator
+        OcclusionTracer& operator=(const OcclusionTracer& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief addGeometry
+          * Trace against the polygons of a Geometry (read from FMOD when the
+          * hierarchy is built so later edits are picked up)
+          * @param pGeometry the Geometry **/
+        virtual void addGeometry(Geometry* pGeometry);
+        /** @brief removeGeometry (called by Geometry when it is released)
+          * @param pGeometry the Geometry **/
+        virtual void removeGeometry(Geometry* pGeometry);
+        /** @brief addPolygon
+          * Add a polygon already in world space (convex and planar, as FMOD requires)
+          * @param directOcclusion direct occlusion of the polygon
+          * @param reverbOcclusion reverb occlusion of the polygon
+          * @param doubleSidedFlag true if both sides occlude
+          * @param numVertices number of vertices
+          * @param pVertices the vertices
+          * @return index of the polygon or -1 on failure **/
+        virtual int addPolygon(float directOcclusion, float reverbOcclusion, bool doubleSidedFlag, int numVertices, const FMOD_VECTOR* pVertices);
+        /** @brief clear
+          * Forget every Geometry and polygon **/
+        virtual void clear();
+        /** @brief invalidate
+          * Rebuild the hierarchy before the next trace (Geometry calls this
+          * whenever it changes) **/
+        virtual void invalidate();
+        /** @brief build
+          * Rebuild the hierarchy now rather than on the next trace **/
+        virtual void build();
+        /** @brief update
+          * Rebuild the hierarchy if anything changed. Call it ahead of
+          * budgeted tracing so no trace has to pay for a rebuild **/
+        virtual void update();
+
+    public:
+        /** @brief trace
+          * Trace one ray
+          * @param start start position
+          * @param finish finish position
+          * @param directOcclusion receives the direct occlusion
+          * @param reverbOcclusion receives the reverb occlusion **/
+        virtual void trace(const FMOD_VECTOR& start, const FMOD_VECTOR& finish, float& directOcclusion, float& reverbOcclusion);
+        /** @brief traceBatch
+          * Trace many rays, four at a time, spread over several threads
+          * @param pStarts start positions
+          * @param pFinishes finish positions
+          * @param numberOfRays number of rays
+          * @param pDirectOcclusions receives a direct occlusion per ray
+          * @param pReverbOcclusions receives a reverb occlusion per ray
+          * @param numberOfThreads threads to use (0 for one per core) **/
+        virtual void traceBatch(const FMOD_VECTOR* pStarts, const FMOD_VECTOR* pFinishes, int numberOfRays, float* pDirectOcclusions, float* pReverbOcclusions, int numberOfThreads = 0);
+
+    public:
+        /** @brief Get Cut Off
+          * @return transmission below which a ray stops looking for more polygons **/
+        virtual float getCutOff() { return this->cutOff; }
+        /** @brief Set Cut Off
+          * Trades accuracy for speed: a ray which is already this close to
+          * fully occluded (on both direct and reverb) stops early
+          * @param cutOff transmission (0.0 exact; default 0.001) **/
+        virtual void setCutOff(float cutOff) { this->cutOff = cutOff; }
+        /** @brief Get Leaf Size
+          * @return most polygons in a leaf of the hierarchy **/
+        virtual int getLeafSize() { return this->leafSize; }
+        /** @brief Set Leaf Size
+          * @param leafSize most polygons in a leaf of the hierarchy (default 4) **/
+        virtual void setLeafSize(int leafSize);
+        /** @brief Get the number of polygons
+          * @return polygons in the hierarchy after the last build **/
+        virtual int getNumberOfPolygons();
+        /** @brief Get the number of nodes
+          * @return nodes in the hierarchy after the last build **/
+        virtual int getNumberOfNodes();
+
+    protected:
+        // A polygon in world space
+        struct TracerPolygon
+        {
+            // Index of the first vertex
+            int firstVertex;
+            // Number of vertices
+            int numVertices;
+            // Plane (normal and distance)
+            FMOD_VECTOR normal;
+            float distance;
+            // Direct Occlusion
+            float directOcclusion;
+            // Reverb Occlusion
+            float reverbOcclusion;
+            // Double sided
+            bool doubleSidedFlag;
+            // Bounds
+            FMOD_VECTOR minimum;
+            FMOD_VECTOR maximum;
+        };
+        // A node of the hierarchy
+        struct TracerNode
+        {
+            // Bounds
+            FMOD_VECTOR minimum;
+            FMOD_VECTOR maximum;
+            // Leaf: first polygon index; inner node: index of the second child (the first follows this node)
+            int offset;
+            // Leaf: number of polygons; inner node: 0
+            int count;
+        };
+        // Four rays traced together
+        struct TracerPacket
+        {
+            // Starts
+            float xStart[4];
+            float yStart[4];
+            float zStart[4];
+            // Directions (finish - start)
+            float xDirection[4];
+            float yDirection[4];
+            float zDirection[4];
+            // Inverse directions
+            float xInverse[4];
+            float yInverse[4];
+            float zInverse[4];
+            // What gets through
+            float directTransmission[4];
+            float reverbTransmission[4];
+            // Rays still looking (one bit each)
+            int activeMask;
+        };
+
+    protected:
+        /** @brief addGeometryPolygons (lock must be held)
+          * Copy the polygons of a Geometry into world space
+          * @param pGeometry the Geometry **/
+        virtual void addGeometryPolygons(Geometry* pGeometry);
+        /** @brief addWorldPolygon (lock must be held)
+          * @return index of the polygon or -1 if it is degenerate **/
+        virtual int addWorldPolygon(float directOcclusion, float reverbOcclusion, bool doubleSidedFlag, int numVertices, const FMOD_VECTOR* pVertices, std::vector<TracerPolygon>& polygons, std::vector<FMOD_VECTOR>& vertices);
+        /** @brief buildNode (lock must be held)
+          * @param first first polygon in the order array
+          * @param count number of polygons **/
+        virtual void buildNode(int first, int count);
+        /** @brief rebuild (lock must be held) **/
+        virtual void rebuild();
+        /** @brief setupPacket
+          * @param packet the packet to fill
+          * @param pStarts start positions
+          * @param pFinishes finish positions
+          * @param numberOfRays rays in the packet (1 to 4) **/
+        virtual void setupPacket(TracerPacket& packet, const FMOD_VECTOR* pStarts, const FMOD_VECTOR* pFinishes, int numberOfRays);
+        /** @brief tracePacket
+          * @param packet the rays to trace **/
+        virtual void tracePacket(TracerPacket& packet);
+        /** @brief tracePackets
+          * Trace a range of rays a packet at a time (what each thread runs) **/
+        virtual void tracePackets(const FMOD_VECTOR* pStarts, const FMOD_VECTOR* pFinishes, int first, int count, float* pDirectOcclusions, float* pReverbOcclusions);
+        /** @brief hitNode
+          * @param node a node
+          * @param packet the rays
+          * @return mask of the active rays which pass through the node **/
+        virtual int hitNode(const TracerNode& node, const TracerPacket& packet);
+        /** @brief hitPolygon
+          * @param polygon a polygon
+          * @param packet the rays
+          * @param ray index of the ray in the packet
+          * @return true if the ray crosses the polygon from a side which occludes **/
+        virtual bool hitPolygon(const TracerPolygon& polygon, const TracerPacket& packet, int ray);
+
+    protected:
+        /* NOTE: Polygons added with addPolygon are kept in worldPolygons,
+            those copied out of Geometry are built again into polygons (after
+            the world ones) each rebuild. The order array is what the
+            hierarchy sorts so the polygons never move */
+        // Geometry to copy polygons from
+        std::vector<Geometry*> geometries;
+        // Polygons added in world space
+        std::vector<TracerPolygon> worldPolygons;
+        std::vector<FMOD_VECTOR> worldVertices;
+        // Every polygon (world ones first)
+        std::vector<TracerPolygon> polygons;
+        std::vector<FMOD_VECTOR> vertices;
+        // Polygon order the hierarchy leaves point into
+        std::vector<int> order;
+        // Centres of the polygon bounds (used while building)
+        std::vector<FMOD_VECTOR> centres;
+        // Nodes (the root is node 0)
+        std::vector<TracerNode> nodes;
+        // Transmission below which a ray stops
+        float cutOff;
+        // Most polygons in a leaf
+        int leafSize;
+        // Does the hierarchy need rebuilding
+        bool dirtyFlag;
+        // Guards everything
+        std::mutex mutex;
+};
+
+#endif // OCCLUSIONTRACER_H
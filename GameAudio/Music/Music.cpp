@@ -16,6 +16,8 @@ Music::Music()
     this->loopFlag = false;
     // Stream Specific Stuff
     this->pFMODSound = 0;
+    this->pooledFlag = false;
+    this->pPrimedChannel = 0;
     this->filename.clear();
     this->enabledFlag = true;
     this->name.clear();
@@ -25,7 +27,8 @@ Music::Music()
 
 Music::~Music()
 {
-
+    // Leave the update thread before anything is torn down
+    this->unregisterChannel();
 }
 
 Music::Music(const Music& other)
@@ -48,18 +51,25 @@ bool Music::load(std::string filename)
         // Free any audio
         this->free();
     }
-    // Track Result of calling FMOD Functions
-    FMOD_RESULT result;
-    // Create the FMODSound
-    result = FMOD_System_CreateStream(FMODGlobals::pFMODSystem, filename.c_str(), FMOD_DEFAULT | FMOD_LOOP_NORMAL, 0, &(this->pFMODSound));
-    // If there was a problem
-    if (result != FMOD_OK)
+    // Take a pre-opened stream from the StreamPool if it has one
+    if (this->acquirePooledSound(filename, FMOD_DEFAULT | FMOD_LOOP_NORMAL) == false)
     {
-        // Send a message to the console
-        std::cout << "ERROR: Unable to load stream: " << filename.c_str() << std::endl;
-        std::cout << FMOD_ErrorString(result) << std::endl;
-        // Failure
-        return false;
+        // Track Result of calling FMOD Functions
+        FMOD_RESULT result;
+        // Tag the file as a stream (its async reads are refilled ahead of loads)
+        FMOD_CREATESOUNDEXINFO exinfo;
+        AudioFileSystem::getStreamExInfo(exinfo);
+        // Create the FMODSound
+        result = FMOD_System_CreateStream(FMODGlobals::pFMODSystem, filename.c_str(), FMOD_DEFAULT | FMOD_LOOP_NORMAL, &exinfo, &(this->pFMODSound));
+        // If there was a problem
+        if (result != FMOD_OK)
+        {
+            // Send a message to the console
+            std::cout << "ERROR: Unable to load stream: " << filename.c_str() << std::endl;
+            std::cout << FMOD_ErrorString(result) << std::endl;
+            // Failure
+            return false;
+        }
     }
     // Send a message to the console
     std::cout << "bool Stream::load((" << filename.c_str() << ")" << std::endl;
@@ -108,14 +118,8 @@ void Music::free()
     }
     // Clear the Channel Pointer
     this->pChannel = 0;
-    // Don't do anything unless we have loaded a soundstream
-    if (this->pFMODSound != 0)
-    {
-        // Release our FMODSound
-        FMOD_Sound_Release(this->pFMODSound);
-        // Reset the FMODSound pointer
-        this->pFMODSound = 0;
-    }
+    // Hand back or release our FMODSound
+    this->releaseFMODSound();
     // Clear the filename
     this->filename.clear();
     // Clear the Name
@@ -132,8 +136,10 @@ void Music::play()
         return;
     // Track result of FMOD Function calls
     FMOD_RESULT result;
+    /* NOTE: With deferred commands the channel starts paused and the
+        queue unpauses it once every property below has been applied */
     // Play the sound
-    result = FMOD_System_PlaySound(FMODGlobals::pFMODSystem, this->pFMODSound, FMODGlobals::pMusicChannelGroup, false, &(this->pChannel));
+    result = this->playFMODSound(FMODGlobals::pMusicChannelGroup, this->isDeferred());
     // If playback failed return
     if (result != FMOD_OK)
         return;
@@ -166,7 +172,7 @@ void Music::playEx()
     // Track result of FMOD Function calls
     FMOD_RESULT result;
     // Play the sound
-    result = FMOD_System_PlaySound(FMODGlobals::pFMODSystem, this->pFMODSound, FMODGlobals::pMusicChannelGroup, true, &(this->pChannel));
+    result = this->playFMODSound(FMODGlobals::pMusicChannelGroup, true);
     // If playback failed return
     if (result != FMOD_OK)
         return;
@@ -197,6 +203,8 @@ void Music::stop()
 {
     // Sound is no longer paused so set flag
     this->pausedFlag = false;
+    // Nor virtual (played again it starts from the beginning, not where the VoiceManager would resume it)
+    this->suspendFlags.fetch_and(~CHANNEL_SUSPEND_VIRTUAL);
     // Grab the channe; playing flag
     FMOD_BOOL playingFlag = false;
     FMOD_Channel_IsPlaying(this->pChannel, &playingFlag);
@@ -225,24 +233,33 @@ void Music::setPaused(bool pausedFlag)
 {
     // Set local paused flag
     this->pausedFlag = pausedFlag;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PAUSED) == true)
+        return;
     // Set channel paused flag
-    FMOD_Channel_SetPaused(this->pChannel, this->pausedFlag);
+    FMOD_Channel_SetPaused(this->pChannel, this->isHeldPaused());
 }
 
 void Music::pause()
 {
     // Set local paused flag
     this->pausedFlag = true;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PAUSED) == true)
+        return;
     // Set channel paused flag
-    FMOD_Channel_SetPaused(this->pChannel, this->pausedFlag);
+    FMOD_Channel_SetPaused(this->pChannel, this->isHeldPaused());
 }
 
 void Music::resume()
 {
     // Set local paused flag
     this->pausedFlag = false;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PAUSED) == true)
+        return;
     // Set channel paused flag
-    FMOD_Channel_SetPaused(this->pChannel, this->pausedFlag);
+    FMOD_Channel_SetPaused(this->pChannel, this->isHeldPaused());
 }
 
 bool Music::isPlaying()
@@ -254,6 +271,48 @@ bool Music::isPlaying()
     return playingFlag;
 }
 
+bool Music::acquirePooledSound(const std::string& filename, FMOD_MODE mode)
+{
+    // No StreamPool
+    if (FMODGlobals::pStreamPool == 0)
+        return false;
+    // Take a stream (and its primed Channel)
+    this->pooledFlag = FMODGlobals::pStreamPool->acquire(filename, mode, &(this->pFMODSound), &(this->pPrimedChannel));
+    // return the pooled flag
+    return this->pooledFlag;
+}
+
+FMOD_RESULT Music::playFMODSound(FMOD_CHANNELGROUP* pChannelGroup, bool pausedFlag)
+{
+    // Played before so swap it for a primed stream (playing it again would seek and refill)
+    if (this->pooledFlag == true && this->pPrimedChannel == 0 && FMODGlobals::pStreamPool != 0)
+        FMODGlobals::pStreamPool->recycle(&(this->pFMODSound), &(this->pPrimedChannel));
+    // No primed Channel so play as usual
+    if (this->pPrimedChannel == 0)
+        return FMOD_System_PlaySound(FMODGlobals::pFMODSystem, this->pFMODSound, pChannelGroup, pausedFlag, &(this->pChannel));
+    // Use the primed Channel (it stays paused until setPaused is called after the properties)
+    this->pChannel = this->pPrimedChannel;
+    this->pPrimedChannel = 0;
+    FMOD_Channel_SetChannelGroup(this->pChannel, pChannelGroup);
+    // Success
+    return FMOD_OK;
+}
+
+void Music::releaseFMODSound()
+{
+    // Don't do anything unless we have loaded a soundstream
+    if (this->pFMODSound != 0)
+    {
+        // Hand a pooled stream back (it stays open) or release it
+        if (this->pooledFlag == false || FMODGlobals::pStreamPool == 0 || FMODGlobals::pStreamPool->release(this->pFMODSound, this->pPrimedChannel) == false)
+            FMOD_Sound_Release(this->pFMODSound);
+    }
+    // Reset the FMODSound pointer
+    this->pFMODSound = 0;
+    this->pooledFlag = false;
+    this->pPrimedChannel = 0;
+}
+
 //FMOD_SYSTEM* Music::getSystemObject()
 //{
 //    // Grab the FMODSystem associated with this channel
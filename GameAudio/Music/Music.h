@@ -34,6 +34,8 @@
 // GAMEAUDIO Includes
 #include "FMODGlobals.h"
 #include "Channel/Channel.h"
+#include "System/AudioFileSystem.h"
+#include "Stream/StreamPool.h"
 
 /** @class Music
     @brief The Music class is a container around a Music Module (tracker music)
@@ -404,9 +406,30 @@ class Music : public Channel
           * @return pointer the the FMOD_SOUND **/
         virtual FMOD_SOUND* getFMODSound() { return this->pFMODSound; }
 
+    protected:
+        /** @brief acquirePooledSound
+          * Take a pre-opened stream from the StreamPool
+          * @param filename file to stream
+          * @param mode FMOD_MODE the file is loaded with
+          * @return false if the pool has none (open it as usual) **/
+        virtual bool acquirePooledSound(const std::string& filename, FMOD_MODE mode);
+        /** @brief playFMODSound
+          * Play the FMODSound on a new Channel (or the primed Channel of a pooled stream)
+          * @param pChannelGroup the channel group to play in
+          * @param pausedFlag true to start paused (a primed Channel is always paused)
+          * @return the result of playing **/
+        virtual FMOD_RESULT playFMODSound(FMOD_CHANNELGROUP* pChannelGroup, bool pausedFlag);
+        /** @brief releaseFMODSound
+          * Hand a pooled stream back to the StreamPool or release the FMODSound **/
+        virtual void releaseFMODSound();
+
     protected:
         // A pointer to the FMOD_SOUND
         FMOD_SOUND* pFMODSound;
+        // The FMODSound came from the StreamPool
+        bool pooledFlag;
+        // Paused Channel of a pooled stream with its buffer full (until played)
+        FMOD_CHANNEL* pPrimedChannel;
 
 //    // ****************
 //    // * LUA BINDINGS *
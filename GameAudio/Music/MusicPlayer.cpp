@@ -0,0 +1,319 @@
+#include "MusicPlayer.h"
+
+MusicPlayer::MusicPlayer()
+{
+    // No decks in use
+    for (int i = 0; i < MUSICPLAYER_NUMBER_OF_DECKS; i++)
+        this->startClocks[i] = 0;
+    this->currentDeck = -1;
+    this->cuedFlag = false;
+    // No switch
+    this->transitionEndClock = 0;
+    // Volume
+    this->volume = 1.0f;
+}
+
+MusicPlayer::~MusicPlayer()
+{
+
+}
+
+bool MusicPlayer::cue(const std::string& filename, bool loopFlag)
+{
+    // We need an FMODSystem
+    if (FMODGlobals::pFMODSystem == 0)
+    {
+        std::cout << "bool MusicPlayer::cue() failure. AudioSystem has not been initialised" << std::endl;
+        return false;
+    }
+    // The idle deck is still fading out or a switch to the cued deck is scheduled
+    if (this->isTransitioning() == true)
+    {
+        std::cout << "bool MusicPlayer::cue() failure. A switch is still scheduled or fading: " << filename << std::endl;
+        return false;
+    }
+    // Open it on the idle deck (whatever was there is stopped and freed)
+    this->cuedFlag = false;
+    Music& music = this->decks[this->getIdleDeck()];
+    if (music.load(filename) == false)
+    {
+        std::cout << "bool MusicPlayer::cue() failure. Unable to load: " << filename << std::endl;
+        return false;
+    }
+    // Set it up to play
+    music.setLoop(loopFlag);
+    music.setVolume(this->volume);
+    this->cuedFlag = true;
+    // Success
+    return true;
+}
+
+bool MusicPlayer::play(const std::string& filename, bool loopFlag)
+{
+    // Cue it
+    if (this->cue(filename, loopFlag) == false)
+        return false;
+    // Cut to it
+    return this->crossfade(0.0f);
+}
+
+bool MusicPlayer::crossfade(float fadeTime)
+{
+    // As soon as can be scheduled
+    return this->crossfadeAt(0, fadeTime);
+}
+
+bool MusicPlayer::crossfadeAt(unsigned long long dspClock, float fadeTime)
+{
+    // Something must be cued
+    if (this->cuedFlag == false)
+    {
+        std::cout << "bool MusicPlayer::crossfadeAt() failure. Nothing is cued" << std::endl;
+        return false;
+    }
+    // Never schedule inside the mixer blocks already being mixed
+    unsigned long long earliestClock = this->getClock() + this->getLead();
+    if (dspClock < earliestClock)
+        dspClock = earliestClock;
+    // Fade length in clock samples
+    unsigned long long fadeLength = (unsigned long long)(std::max(0.0f, fadeTime) * (float)this->getSampleRate());
+    // Start the cued deck
+    int previousDeck = this->currentDeck;
+    if (this->startDeck(dspClock, fadeLength) == false)
+        return false;
+    // Stop the deck it replaces on the same sample
+    if (previousDeck != -1 && this->decks[previousDeck].isPlaying() == true)
+        this->stopDeck(previousDeck, dspClock, fadeLength);
+    // Fading until
+    this->transitionEndClock = dspClock + fadeLength;
+    // Success
+    return true;
+}
+
+bool MusicPlayer::queue()
+{
+    // Something must be cued
+    if (this->cuedFlag == false)
+    {
+        std::cout << "bool MusicPlayer::queue() failure. Nothing is cued" << std::endl;
+        return false;
+    }
+    // Switch at the end of the current loop (straight away if nothing is playing)
+    return this->crossfadeAt(this->getEndClock(), 0.0f);
+}
+
+void MusicPlayer::stop(float fadeTime)
+{
+    // Nothing playing
+    if (this->currentDeck == -1)
+        return;
+    // Stop straight away
+    Music& music = this->decks[this->currentDeck];
+    if (fadeTime <= 0.0f)
+    {
+        music.stop();
+        this->transitionEndClock = 0;
+        return;
+    }
+    // Fade out as soon as can be scheduled
+    this->stopAt(0, fadeTime);
+}
+
+void MusicPlayer::stopAt(unsigned long long dspClock, float fadeTime)
+{
+    // Nothing playing
+    if (this->currentDeck == -1 || this->decks[this->currentDeck].isPlaying() == false)
+        return;
+    // Never schedule inside the mixer blocks already being mixed
+    unsigned long long earliestClock = this->getClock() + this->getLead();
+    if (dspClock < earliestClock)
+        dspClock = earliestClock;
+    // Fade out
+    unsigned long long fadeLength = (unsigned long long)(std::max(0.0f, fadeTime) * (float)this->getSampleRate());
+    this->stopDeck(this->currentDeck, dspClock, fadeLength);
+    this->transitionEndClock = dspClock + fadeLength;
+}
+
+void MusicPlayer::free()
+{
+    // Stop and free both decks
+    for (int i = 0; i < MUSICPLAYER_NUMBER_OF_DECKS; i++)
+    {
+        this->decks[i].stop();
+        this->decks[i].free();
+        this->startClocks[i] = 0;
+    }
+    this->currentDeck = -1;
+    this->cuedFlag = false;
+    this->transitionEndClock = 0;
+}
+
+void MusicPlayer::setVolume(float volume)
+{
+    // Set Volume
+    this->volume = volume;
+    // Both decks (fades are applied on top)
+    for (int i = 0; i < MUSICPLAYER_NUMBER_OF_DECKS; i++)
+        this->decks[i].setVolume(this->volume);
+}
+
+unsigned long long MusicPlayer::getClock()
+{
+    // The music Channels are delayed against the music channel group
+    unsigned long long dspClock = 0;
+    if (FMODGlobals::pMusicChannelGroup != 0)
+        FMOD_ChannelGroup_GetDSPClock(FMODGlobals::pMusicChannelGroup, &dspClock, 0);
+    // return the clock
+    return dspClock;
+}
+
+int MusicPlayer::getSampleRate()
+{
+    // Grab the mixer rate
+    int sampleRate = 0;
+    FMOD_System_GetSoftwareFormat(FMODGlobals::pFMODSystem, &sampleRate, 0, 0);
+    // return the sample rate
+    return sampleRate;
+}
+
+unsigned long long MusicPlayer::getLead()
+{
+    // Grab the mixer block length
+    unsigned int blockLength = 0;
+    FMOD_System_GetDSPBufferSize(FMODGlobals::pFMODSystem, &blockLength, 0);
+    // return two blocks
+    return (unsigned long long)blockLength * 2;
+}
+
+unsigned long long MusicPlayer::getLoopLength()
+{
+    // Nothing playing
+    if (this->currentDeck == -1)
+        return 0;
+    // return the loop length of the current deck
+    return this->getLoopLength(this->currentDeck);
+}
+
+unsigned long long MusicPlayer::getEndClock()
+{
+    // The first loop end after now
+    return this->getLoopEndClock(this->getClock() + 1);
+}
+
+unsigned long long MusicPlayer::getLoopEndClock(unsigned long long dspClock)
+{
+    // Nothing playing
+    if (this->currentDeck == -1 || this->decks[this->currentDeck].isPlaying() == false)
+        return 0;
+    // Unknown length
+    unsigned long long loopLength = this->getLoopLength(this->currentDeck);
+    if (loopLength == 0)
+        return 0;
+    // Estimate the loops done by then (at least the first)
+    unsigned long long startClock = this->startClocks[this->currentDeck];
+    unsigned long long loops = 1;
+    if (dspClock > startClock)
+        loops = std::max(1ULL, (dspClock - startClock + loopLength - 1) / loopLength);
+    // Settle the estimate on the exact loop ends
+    while (startClock + this->getLoopsLength(this->currentDeck, loops) < dspClock)
+        loops++;
+    while (loops > 1 && startClock + this->getLoopsLength(this->currentDeck, loops - 1) >= dspClock)
+        loops--;
+    // return the end of that loop
+    return startClock + this->getLoopsLength(this->currentDeck, loops);
+}
+
+float MusicPlayer::getFadeLevel(FMOD_CHANNEL* pChannel, unsigned long long dspClock)
+{
+    // How many fade points it has
+    unsigned int numPoints = 0;
+    if (pChannel == 0 || FMOD_Channel_GetFadePoints(pChannel, &numPoints, 0, 0) != FMOD_OK || numPoints == 0)
+        return 1.0f;
+    // Grab them
+    std::vector<unsigned long long> pointClocks(numPoints);
+    std::vector<float> pointVolumes(numPoints);
+    if (FMOD_Channel_GetFadePoints(pChannel, &numPoints, &(pointClocks[0]), &(pointVolumes[0])) != FMOD_OK || numPoints == 0)
+        return 1.0f;
+    // Held at the first point before it and at the last point after it
+    if (dspClock <= pointClocks[0])
+        return pointVolumes[0];
+    if (dspClock >= pointClocks[numPoints - 1])
+        return pointVolumes[numPoints - 1];
+    // Ramps from one point to the next in between
+    for (unsigned int i = 1; i < numPoints; i++)
+    {
+        if (dspClock > pointClocks[i])
+            continue;
+        double t = (double)(dspClock - pointClocks[i - 1]) / (double)(pointClocks[i] - pointClocks[i - 1]);
+        return (float)((double)pointVolumes[i - 1] + (double)(pointVolumes[i] - pointVolumes[i - 1]) * t);
+    }
+    // return the last level
+    return pointVolumes[numPoints - 1];
+}
+
+unsigned long long MusicPlayer::getLoopsLength(int deck, unsigned long long loops)
+{
+    // No track
+    FMOD_SOUND* pFMODSound = this->decks[deck].getFMODSound();
+    if (pFMODSound == 0)
+        return 0;
+    // Length in samples of the track
+    unsigned int length = 0;
+    FMOD_Sound_GetLength(pFMODSound, &length, FMOD_TIMEUNIT_PCM);
+    float frequency = 0.0f;
+    FMOD_Sound_GetDefaults(pFMODSound, &frequency, 0);
+    if (length == 0 || frequency <= 0.0f)
+        return 0;
+    // In samples of the mixer (rounded down once for all the loops)
+    return (unsigned long long)std::floor((double)loops * (double)length * (double)this->getSampleRate() / (double)frequency);
+}
+
+bool MusicPlayer::startDeck(unsigned long long startClock, unsigned long long fadeLength)
+{
+    // Grab the cued deck
+    int deck = this->getIdleDeck();
+    Music& music = this->decks[deck];
+    // Start paused so the delay is in place before a sample can be heard
+    music.setPaused(true);
+    music.play();
+    if (music.isPlaying() == false)
+    {
+        std::cout << "bool MusicPlayer::startDeck() failure. Unable to play: " << music.getFilename() << std::endl;
+        return false;
+    }
+    // Start on the clock
+    music.setDelay(startClock, 0, false);
+    // Fade in
+    if (fadeLength > 0)
+    {
+        music.addFadePoint(startClock, 0.0f);
+        music.addFadePoint(startClock + fadeLength, 1.0f);
+    }
+    // Let it go
+    music.resume();
+    // It is current
+    this->startClocks[deck] = startClock;
+    this->currentDeck = deck;
+    this->cuedFlag = false;
+    // Success
+    return true;
+}
+
+void MusicPlayer::stopDeck(int deck, unsigned long long startClock, unsigned long long fadeLength)
+{
+    // Grab the deck
+    Music& music = this->decks[deck];
+    // Levels now and when the fade starts (it may still be fading in from the last switch)
+    unsigned long long dspClock = this->getClock();
+    float level = MusicPlayer::getFadeLevel(music.getFMODChannel(), dspClock);
+    float startLevel = MusicPlayer::getFadeLevel(music.getFMODChannel(), startClock);
+    // Forget any fades still to come, keeping the level it is at
+    music.removeFadePoints(dspClock, (unsigned long long)-1);
+    music.addFadePoint(dspClock, level);
+    // Fade out from where it will be
+    music.addFadePoint(startClock, startLevel);
+    if (fadeLength > 0)
+        music.addFadePoint(startClock + fadeLength, 0.0f);
+    // Stop on the clock (keeping the clock it started on)
+    music.setDelay(this->startClocks[deck], startClock + fadeLength, true);
+}
@@ -0,0 +1,208 @@
+/**
+  * @file   MusicPlayer.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  MusicPlayer moves between Music tracks with sample accurate
+  * crossfades and gapless transitions
+*/
+
+#ifndef MUSICPLAYER_H
+#define MUSICPLAYER_H
+
+// C++ Includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_codec.h>
+#include <fmod_common.h>
+#include <fmod_dsp.h>
+#include <fmod_dsp_effects.h>
+#include <fmod_errors.h>
+#include <fmod_output.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Music/Music.h"
+
+// Number of decks (the track playing and the one cued)
+const int MUSICPLAYER_NUMBER_OF_DECKS = 2;
+
+/** Switching tracks with Music alone means stopping one and opening the
+    next, which leaves a gap and a load spike. The MusicPlayer keeps two
+    Music decks. The next track is cued on the idle deck ahead of time (so
+    the file is opened then, or taken from the StreamPool, and never at the
+    moment of the switch), then the switch is scheduled on the DSP clock of
+    the music channel group: the cued deck is started with setDelay at a
+    clock value and the deck playing is stopped with setDelay at the same
+    value, with fade points either side for a crossfade. Both are worked
+    out from the one clock reading so the switch lands on the same sample
+    whatever the frame rate. queue switches at the end of the loop the
+    current track is in, for gapless playlists. At most two streams are
+    open, the cued track replaces whatever the idle deck held. Tracks must
+    play at their own frequency for the end of a loop to be worked out **/
+class MusicPlayer
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        MusicPlayer();
+        //! Destructor
+        virtual ~MusicPlayer();
+
+    protected:
+        //! MusicPlayer Copy constructor
+        MusicPlayer(const MusicPlayer& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! MusicPlayer Assignment operator
+        MusicPlayer& operator=(const MusicPlayer& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief cue
+          * Open the next track on the idle deck (do this ahead of the switch).
+          * Refused while a switch is scheduled or fading, the idle deck is still in use
+          * @param filename file to stream
+          * @param loopFlag true to loop the track until the next switch
+          * @return true on success **/
+        virtual bool cue(const std::string& filename, bool loopFlag = true);
+        /** @brief play
+          * Cue a track and switch to it straight away with no fade
+          * @param filename file to stream
+          * @param loopFlag true to loop the track until the next switch
+          * @return true on success **/
+        virtual bool play(const std::string& filename, bool loopFlag = true);
+        /** @brief crossfade
+          * Switch to the cued track straight away
+          * @param fadeTime seconds the tracks fade over (0.0 for a cut)
+          * @return false if nothing is cued **/
+        virtual bool crossfade(float fadeTime);
+        /** @brief crossfadeAt
+          * Switch to the cued track at a DSP clock value of the music channel group
+          * @param dspClock clock value the cued track starts at (brought forward if it has passed)
+          * @param fadeTime seconds the tracks fade over (0.0 for a cut)
+          * @return false if nothing is cued **/
+        virtual bool crossfadeAt(unsigned long long dspClock, float fadeTime);
+        /** @brief queue
+          * Switch to the cued track with no gap when the current track reaches the end of its loop
+          * @return false if nothing is cued **/
+        virtual bool queue();
+        /** @brief stop
+          * @param fadeTime seconds to fade out over (0.0 to stop straight away) **/
+        virtual void stop(float fadeTime = 0.0f);
+        /** @brief stopAt
+          * Fade out the current track from a DSP clock value of the music channel group and stop it
+          * @param dspClock clock value the fade out starts at (brought forward if it has passed)
+          * @param fadeTime seconds to fade out over **/
+        virtual void stopAt(unsigned long long dspClock, float fadeTime);
+        /** @brief free
+          * Stop and free both decks **/
+        virtual void free();
+
+    public:
+        /** @brief Get the Current track
+          * @return the Music playing (or scheduled to play), 0 if none **/
+        virtual Music* getCurrent() { return (this->currentDeck != -1) ? &(this->decks[this->currentDeck]) : 0; }
+        /** @brief Get the Cued track
+          * @return the Music cued, 0 if none **/
+        virtual Music* getCued() { return (this->cuedFlag == true) ? &(this->decks[this->getIdleDeck()]) : 0; }
+        /** @brief isCued
+          * @return true if a track is cued **/
+        virtual bool isCued() { return this->cuedFlag; }
+        /** @brief isTransitioning
+          * @return true until the last switch has finished fading **/
+        virtual bool isTransitioning() { return (this->getClock() < this->transitionEndClock); }
+        /** @brief Get Volume
+          * @return volume of the tracks **/
+        virtual float getVolume() { return this->volume; }
+        /** @brief Set Volume
+          * @param volume volume of the tracks (0.0 silent 1.0 fullblast) **/
+        virtual void setVolume(float volume);
+
+    public:
+        /** @brief getClock
+          * @return DSP clock of the music channel group (samples at the mixer rate) **/
+        virtual unsigned long long getClock();
+        /** @brief getSampleRate
+          * @return samples a second of the mixer **/
+        virtual int getSampleRate();
+        /** @brief getLead
+          * @return clock samples a switch is scheduled ahead of now (two mixer blocks) **/
+        virtual unsigned long long getLead();
+        /** @brief getStartClock
+          * @return clock the current track started at (0 if none) **/
+        virtual unsigned long long getStartClock() { return (this->currentDeck != -1) ? this->startClocks[this->currentDeck] : 0; }
+        /** @brief getLoopLength
+          * @return clock samples one loop of the current track lasts (0 if unknown) **/
+        virtual unsigned long long getLoopLength();
+        /** @brief getEndClock
+          * @return clock the loop the current track is in ends at (0 if unknown) **/
+        virtual unsigned long long getEndClock();
+        /** @brief getLoopEndClock
+          * @param dspClock clock value to look from
+          * @return clock of the first loop end of the current track at or after dspClock (0 if unknown) **/
+        virtual unsigned long long getLoopEndClock(unsigned long long dspClock);
+        /** @brief getFadeLevel
+          * @param pChannel an FMOD Channel
+          * @param dspClock clock value of its parent
+          * @return level its fade points put it at on that clock (1.0 if it has none) **/
+        static float getFadeLevel(FMOD_CHANNEL* pChannel, unsigned long long dspClock);
+
+    protected:
+        /** @brief getIdleDeck
+          * @return the deck which is not current **/
+        inline int getIdleDeck() { return (this->currentDeck == 0) ? 1 : 0; }
+        /** @brief getLoopLength
+          * @param deck the deck
+          * @return clock samples one loop of the deck's track lasts (0 if unknown) **/
+        virtual unsigned long long getLoopLength(int deck) { return this->getLoopsLength(deck, 1); }
+        /** @brief getLoopsLength
+          * Worked out in one step so whole loops never drift by a rounded loop length
+          * @param deck the deck
+          * @param loops number of loops
+          * @return clock samples that many loops of the deck's track last (0 if unknown) **/
+        virtual unsigned long long getLoopsLength(int deck, unsigned long long loops);
+        /** @brief startDeck
+          * Start the cued deck at a clock value and make it current
+          * @param startClock clock value to start at
+          * @param fadeLength clock samples to fade in over
+          * @return false if it would not play **/
+        virtual bool startDeck(unsigned long long startClock, unsigned long long fadeLength);
+        /** @brief stopDeck
+          * Fade a deck out from the level it is at and stop it at a clock value
+          * @param deck the deck
+          * @param startClock clock value the fade starts at
+          * @param fadeLength clock samples to fade out over **/
+        virtual void stopDeck(int deck, unsigned long long startClock, unsigned long long fadeLength);
+
+    protected:
+        // The decks
+        Music decks[MUSICPLAYER_NUMBER_OF_DECKS];
+        // Clock each deck was started at
+        unsigned long long startClocks[MUSICPLAYER_NUMBER_OF_DECKS];
+        // Deck playing (-1 if none)
+        int currentDeck;
+        // A track is cued on the idle deck
+        bool cuedFlag;
+        // Clock the last switch finishes fading at
+        unsigned long long transitionEndClock;
+        // Volume
+        float volume;
+};
+
+#endif // MUSICPLAYER_H
@@ -0,0 +1,534 @@
+#include "MusicScheduler.h"
+
+MusicScheduler::MusicScheduler()
+{
+    // Lead
+    this->lead = MUSICSCHEDULER_DEFAULT_LEAD;
+}
+
+MusicScheduler::~MusicScheduler()
+{
+
+}
+
+bool MusicScheduler::setTempo(const std::string& filename, float bpm, int beatsPerBar, int beatUnit, float offset)
+{
+    // The tempo must make sense
+    if (bpm <= 0.0f || beatsPerBar < 1 || beatUnit < 1 || offset < 0.0f)
+    {
+        std::cout << "bool MusicScheduler::setTempo() failure. Bad tempo for: " << filename << std::endl;
+        return false;
+    }
+    // Fill in the tempo
+    MusicTempo tempo;
+    tempo.bpm = bpm;
+    tempo.beatsPerBar = beatsPerBar;
+    tempo.beatUnit = beatUnit;
+    tempo.offset = offset;
+    // Store it
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->tempos[filename] = tempo;
+    // Success
+    return true;
+}
+
+bool MusicScheduler::getTempo(const std::string& filename, MusicTempo& tempo)
+{
+    // Look it up
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::map<std::string, MusicTempo>::iterator i = this->tempos.find(filename);
+    if (i == this->tempos.end())
+        return false;
+    // Hand it over
+    tempo = i->second;
+    return true;
+}
+
+int MusicScheduler::addLayer(const std::string& filename, Music* pLayer, bool enabledFlag)
+{
+    // There must be a loaded layer
+    if (pLayer == 0 || pLayer->getFMODSound() == 0)
+    {
+        std::cout << "int MusicScheduler::addLayer() failure. No loaded Music for: " << filename << std::endl;
+        return -1;
+    }
+    // Fill in the layer (it plays on a channel of its own, the Music is never touched again)
+    MusicLayer layer;
+    layer.filename = filename;
+    layer.pFMODSound = pLayer->getFMODSound();
+    layer.pChannel = 0;
+    layer.volume = pLayer->getVolume();
+    layer.loopFlag = pLayer->isLoop();
+    layer.enabledFlag = enabledFlag;
+    // Store it
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->layers.push_back(layer);
+    // return its index
+    return (int)this->layers.size() - 1;
+}
+
+void MusicScheduler::removeLayer(int layer)
+{
+    // Grab the layer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (layer < 0 || layer >= (int)this->layers.size() || this->layers[layer].pFMODSound == 0)
+        return;
+    // Stop it and forget it (the index stays taken)
+    if (this->layers[layer].pChannel != 0)
+        FMOD_Channel_Stop(this->layers[layer].pChannel);
+    this->layers[layer].pChannel = 0;
+    this->layers[layer].pFMODSound = 0;
+}
+
+bool MusicScheduler::cue(const std::string& filename, bool loopFlag)
+{
+    // The section must be preloaded (opening it on the update thread would stall the mix)
+    if (FMODGlobals::pStreamPool == 0 || FMODGlobals::pStreamPool->getNumberOfReady(filename, MUSICSCHEDULER_SECTION_MODE) < 1)
+    {
+        std::cout << "bool MusicScheduler::cue() failure. Not preloaded with the StreamPool: " << filename << std::endl;
+        return false;
+    }
+    // Post a cue
+    MusicSchedulerRequest request;
+    request.type = MUSICSCHEDULER_REQUEST_CUE;
+    request.filename = filename;
+    request.flag = loopFlag;
+    request.layer = -1;
+    request.pChannel = 0;
+    request.sync = MUSICSYNC_NOW;
+    request.fadeTime = 0.0f;
+    this->post(request);
+    // Success
+    return true;
+}
+
+void MusicScheduler::transition(MUSICSYNC sync, float fadeTime)
+{
+    // Post a transition
+    MusicSchedulerRequest request;
+    request.type = MUSICSCHEDULER_REQUEST_TRANSITION;
+    request.flag = false;
+    request.layer = -1;
+    request.pChannel = 0;
+    request.sync = sync;
+    request.fadeTime = fadeTime;
+    this->post(request);
+}
+
+void MusicScheduler::playStinger(Channel* pStinger, MUSICSYNC sync)
+{
+    // There must be a stinger
+    if (pStinger == 0)
+        return;
+    // Start it here, paused so the hold is in place before a sample can be heard
+    pStinger->setPaused(true);
+    pStinger->play();
+    if (pStinger->isPlaying() == false || pStinger->getFMODChannel() == 0)
+    {
+        std::cout << "void MusicScheduler::playStinger() failure. Unable to play the stinger" << std::endl;
+        return;
+    }
+    // On the clock of the music channel group, held until update moves it onto the boundary
+    pStinger->setChannelGroup(FMODGlobals::pMusicChannelGroup);
+    pStinger->setDelay(MUSICSCHEDULER_HOLD_CLOCK, 0, false);
+    // Let it go
+    pStinger->resume();
+    // Post a stinger (update only touches its FMOD channel)
+    MusicSchedulerRequest request;
+    request.type = MUSICSCHEDULER_REQUEST_STINGER;
+    request.flag = false;
+    request.layer = -1;
+    request.pChannel = pStinger->getFMODChannel();
+    request.sync = sync;
+    request.fadeTime = 0.0f;
+    this->post(request);
+}
+
+void MusicScheduler::setLayerEnabled(int layer, bool enabledFlag, MUSICSYNC sync, float fadeTime)
+{
+    // Post a layer change
+    MusicSchedulerRequest request;
+    request.type = MUSICSCHEDULER_REQUEST_LAYER;
+    request.flag = enabledFlag;
+    request.layer = layer;
+    request.pChannel = 0;
+    request.sync = sync;
+    request.fadeTime = fadeTime;
+    this->post(request);
+}
+
+void MusicScheduler::stop(MUSICSYNC sync, float fadeTime)
+{
+    // Post a stop
+    MusicSchedulerRequest request;
+    request.type = MUSICSCHEDULER_REQUEST_STOP;
+    request.flag = false;
+    request.layer = -1;
+    request.pChannel = 0;
+    request.sync = sync;
+    request.fadeTime = fadeTime;
+    this->post(request);
+}
+
+void MusicScheduler::update()
+{
+    // We need an FMODSystem
+    if (FMODGlobals::pFMODSystem == 0)
+        return;
+    // Take the requests posted since the last update (the game can keep posting)
+    std::vector<MusicSchedulerRequest> pending;
+    {
+        std::lock_guard<std::mutex> lock(this->requestMutex);
+        pending.swap(this->requests);
+    }
+    // Schedule them in the order they were posted
+    unsigned int i = 0;
+    for (; i < pending.size(); i++)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->process(pending[i]) == false)
+            break;
+    }
+    // Put back the ones that have to wait (ahead of any posted meanwhile)
+    if (i < pending.size())
+    {
+        std::lock_guard<std::mutex> lock(this->requestMutex);
+        this->requests.insert(this->requests.begin(), pending.begin() + i, pending.end());
+    }
+}
+
+void MusicScheduler::free()
+{
+    // Take the requests
+    std::vector<MusicSchedulerRequest> pending;
+    {
+        std::lock_guard<std::mutex> lock(this->requestMutex);
+        pending.swap(this->requests);
+    }
+    // Stop the stingers still held
+    for (unsigned int i = 0; i < pending.size(); i++)
+    {
+        if (pending[i].type == MUSICSCHEDULER_REQUEST_STINGER)
+            FMOD_Channel_Stop(pending[i].pChannel);
+    }
+    // Stop the layers and forget them
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for (unsigned int i = 0; i < this->layers.size(); i++)
+    {
+        if (this->layers[i].pChannel != 0)
+            FMOD_Channel_Stop(this->layers[i].pChannel);
+    }
+    this->layers.clear();
+    // Forget the tempos
+    this->tempos.clear();
+    // Stop and free the sections
+    this->musicPlayer.free();
+}
+
+void MusicScheduler::setLead(float lead)
+{
+    // Never negative
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->lead = std::max(0.0f, lead);
+}
+
+float MusicScheduler::getBeatPosition()
+{
+    // Grab the tempo of the section playing
+    std::lock_guard<std::mutex> lock(this->mutex);
+    MusicTempo tempo;
+    double samplesPerBeat = this->getSamplesPerBeat(tempo);
+    if (samplesPerBeat <= 0.0)
+        return 0.0f;
+    // Not started yet
+    unsigned long long dspClock = this->musicPlayer.getClock();
+    unsigned long long startClock = this->musicPlayer.getStartClock();
+    if (dspClock < startClock)
+        return 0.0f;
+    // Clock samples into the loop it is in
+    unsigned long long position = dspClock - startClock;
+    unsigned long long loopLength = this->musicPlayer.getLoopLength();
+    if (loopLength > 0)
+        position = position % loopLength;
+    // Beats since the first beat
+    double beats = ((double)position - (double)tempo.offset * (double)this->musicPlayer.getSampleRate()) / samplesPerBeat;
+    return (float)std::max(0.0, beats);
+}
+
+int MusicScheduler::getBar()
+{
+    // Grab the tempo of the section playing
+    MusicTempo tempo;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->getSamplesPerBeat(tempo) <= 0.0)
+            return 0;
+    }
+    // Whole bars
+    return (int)(this->getBeatPosition() / (float)tempo.beatsPerBar);
+}
+
+int MusicScheduler::getBeat()
+{
+    // Grab the tempo of the section playing
+    MusicTempo tempo;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->getSamplesPerBeat(tempo) <= 0.0)
+            return 0;
+    }
+    // Whole beats into the bar
+    return (int)this->getBeatPosition() % tempo.beatsPerBar;
+}
+
+unsigned long long MusicScheduler::getNextBoundary(MUSICSYNC sync)
+{
+    // Work it out from the soonest clock a change could land on
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (FMODGlobals::pFMODSystem == 0)
+        return 0;
+    return this->findNextBoundary(sync, this->getEarliestClock());
+}
+
+void MusicScheduler::post(const MusicSchedulerRequest& request)
+{
+    // Queue it for update
+    std::lock_guard<std::mutex> lock(this->requestMutex);
+    this->requests.push_back(request);
+}
+
+bool MusicScheduler::process(const MusicSchedulerRequest& request)
+{
+    // Cue the next section
+    if (request.type == MUSICSCHEDULER_REQUEST_CUE)
+    {
+        // The idle deck is still fading out, wait for it
+        if (this->musicPlayer.isTransitioning() == true)
+            return false;
+        // Still preloaded (so loading it takes the pooled stream and doesn't open the file here)
+        if (FMODGlobals::pStreamPool == 0 || FMODGlobals::pStreamPool->getNumberOfReady(request.filename, MUSICSCHEDULER_SECTION_MODE) < 1)
+        {
+            std::cout << "bool MusicScheduler::process() failure. No longer preloaded: " << request.filename << std::endl;
+            return true;
+        }
+        this->musicPlayer.cue(request.filename, request.flag);
+        return true;
+    }
+    // Everything else lands on a boundary
+    unsigned long long dspClock = this->findNextBoundary(request.sync, this->getEarliestClock());
+    unsigned long long fadeLength = this->getFadeLength(request.fadeTime);
+    // Move to the cued section
+    if (request.type == MUSICSCHEDULER_REQUEST_TRANSITION)
+    {
+        // Something must be cued
+        Music* pCued = this->musicPlayer.getCued();
+        if (pCued == 0)
+        {
+            std::cout << "bool MusicScheduler::process() failure. Transition with nothing cued" << std::endl;
+            return true;
+        }
+        // Remember the sections either side
+        std::string nextFilename = pCued->getFilename();
+        Music* pCurrent = this->musicPlayer.getCurrent();
+        std::string previousFilename = (pCurrent != 0 && pCurrent->isPlaying() == true) ? pCurrent->getFilename() : "";
+        // Switch sections on the boundary
+        if (this->musicPlayer.crossfadeAt(dspClock, request.fadeTime) == false)
+            return true;
+        // The layers follow on the same sample
+        if (previousFilename.empty() == false && previousFilename != nextFilename)
+            this->stopLayers(previousFilename, dspClock, fadeLength);
+        this->startLayers(nextFilename, dspClock, fadeLength);
+        return true;
+    }
+    // Move a held stinger onto the boundary (gone if the game stopped it meanwhile)
+    if (request.type == MUSICSCHEDULER_REQUEST_STINGER)
+    {
+        FMOD_Channel_SetDelay(request.pChannel, dspClock, 0, false);
+        return true;
+    }
+    // Switch a layer on or off
+    if (request.type == MUSICSCHEDULER_REQUEST_LAYER)
+    {
+        // Grab the layer
+        if (request.layer < 0 || request.layer >= (int)this->layers.size() || this->layers[request.layer].pFMODSound == 0)
+        {
+            std::cout << "bool MusicScheduler::process() failure. No layer: " << request.layer << std::endl;
+            return true;
+        }
+        MusicLayer& layer = this->layers[request.layer];
+        // Nothing to do
+        if (layer.enabledFlag == request.flag)
+            return true;
+        layer.enabledFlag = request.flag;
+        // Fade it if its section is playing (otherwise it starts that way with the section)
+        if (this->isLayerPlaying(layer) == true)
+            this->fadeLayer(layer.pChannel, dspClock, fadeLength, (layer.enabledFlag == true) ? 1.0f : 0.0f);
+        return true;
+    }
+    // Stop the music
+    if (request.type == MUSICSCHEDULER_REQUEST_STOP)
+    {
+        // Nothing playing
+        Music* pCurrent = this->musicPlayer.getCurrent();
+        if (pCurrent == 0 || pCurrent->isPlaying() == false)
+            return true;
+        // Fade the section and its layers out from the boundary
+        std::string filename = pCurrent->getFilename();
+        this->musicPlayer.stopAt(dspClock, request.fadeTime);
+        this->stopLayers(filename, dspClock, fadeLength);
+        return true;
+    }
+    // Done
+    return true;
+}
+
+unsigned long long MusicScheduler::getEarliestClock()
+{
+    // Never inside the mixer blocks already being mixed, nor before the next update could see it
+    unsigned long long leadLength = std::max(this->musicPlayer.getLead(), this->getFadeLength(this->lead));
+    // return the clock
+    return this->musicPlayer.getClock() + leadLength;
+}
+
+unsigned long long MusicScheduler::findNextBoundary(MUSICSYNC sync, unsigned long long earliestClock)
+{
+    // As soon as it can be scheduled
+    if (sync == MUSICSYNC_NOW)
+        return earliestClock;
+    // The first end of a loop at or after the earliest
+    if (sync == MUSICSYNC_END)
+    {
+        unsigned long long endClock = this->musicPlayer.getLoopEndClock(earliestClock);
+        return (endClock != 0) ? endClock : earliestClock;
+    }
+    unsigned long long loopLength = this->musicPlayer.getLoopLength();
+    // Beats and bars need the tempo of the section playing
+    MusicTempo tempo;
+    double samplesPerBeat = this->getSamplesPerBeat(tempo);
+    if (samplesPerBeat <= 0.0)
+        return earliestClock;
+    double unitLength = (sync == MUSICSYNC_BAR) ? samplesPerBeat * (double)tempo.beatsPerBar : samplesPerBeat;
+    double offsetLength = (double)tempo.offset * (double)this->musicPlayer.getSampleRate();
+    // The loop the earliest clock falls in
+    unsigned long long loopClock = this->musicPlayer.getStartClock();
+    if (loopLength > 0 && earliestClock > loopClock)
+        loopClock += ((earliestClock - loopClock) / loopLength) * loopLength;
+    // The next beat or bar of that loop
+    double originClock = (double)loopClock + offsetLength;
+    double units = ((double)earliestClock > originClock) ? std::ceil(((double)earliestClock - originClock) / unitLength) : 0.0;
+    unsigned long long boundaryClock = (unsigned long long)(originClock + units * unitLength + 0.5);
+    // Past the end of the loop the grid starts again with the next one
+    if (loopLength > 0 && boundaryClock >= loopClock + loopLength)
+        boundaryClock = loopClock + loopLength + (unsigned long long)(offsetLength + 0.5);
+    // return the boundary
+    return boundaryClock;
+}
+
+double MusicScheduler::getSamplesPerBeat(MusicTempo& tempo)
+{
+    // Section playing (or scheduled to play)
+    Music* pCurrent = this->musicPlayer.getCurrent();
+    if (pCurrent == 0)
+        return 0.0;
+    // Its tempo
+    std::map<std::string, MusicTempo>::iterator i = this->tempos.find(pCurrent->getFilename());
+    if (i == this->tempos.end())
+        return 0.0;
+    tempo = i->second;
+    // Clock samples a beat
+    return (double)this->musicPlayer.getSampleRate() * 60.0 / (double)tempo.bpm;
+}
+
+unsigned long long MusicScheduler::getFadeLength(float fadeTime)
+{
+    // In samples of the mixer
+    return (unsigned long long)(std::max(0.0f, fadeTime) * (float)this->musicPlayer.getSampleRate());
+}
+
+void MusicScheduler::startLayers(const std::string& filename, unsigned long long dspClock, unsigned long long fadeLength)
+{
+    // Each layer of the section
+    for (unsigned int i = 0; i < this->layers.size(); i++)
+    {
+        MusicLayer& layer = this->layers[i];
+        if (layer.pFMODSound == 0 || layer.filename != filename)
+            continue;
+        // Restart it if it is still going (a section cued after itself)
+        if (layer.pChannel != 0)
+            FMOD_Channel_Stop(layer.pChannel);
+        layer.pChannel = 0;
+        // Start paused so the delay is in place before a sample can be heard
+        FMOD_CHANNEL* pChannel = 0;
+        FMOD_RESULT result = FMOD_System_PlaySound(FMODGlobals::pFMODSystem, layer.pFMODSound, FMODGlobals::pMusicChannelGroup, true, &pChannel);
+        if (result != FMOD_OK)
+        {
+            std::cout << "void MusicScheduler::startLayers() failure. Unable to play a layer of: " << layer.filename << std::endl;
+            std::cout << FMOD_ErrorString(result) << std::endl;
+            continue;
+        }
+        // As the Music was set up
+        FMOD_Channel_SetVolume(pChannel, layer.volume);
+        FMOD_Channel_SetLoopCount(pChannel, ((layer.loopFlag == true) ? -1 : 0));
+        // Start on the same sample as the section
+        FMOD_Channel_SetDelay(pChannel, dspClock, 0, false);
+        // Fade in with the section or hold silent
+        if (layer.enabledFlag == true && fadeLength > 0)
+        {
+            FMOD_Channel_AddFadePoint(pChannel, dspClock, 0.0f);
+            FMOD_Channel_AddFadePoint(pChannel, dspClock + fadeLength, 1.0f);
+        }
+        else if (layer.enabledFlag == false)
+        {
+            FMOD_Channel_AddFadePoint(pChannel, dspClock, 0.0f);
+        }
+        // Let it go
+        FMOD_Channel_SetPaused(pChannel, false);
+        layer.pChannel = pChannel;
+    }
+}
+
+void MusicScheduler::stopLayers(const std::string& filename, unsigned long long dspClock, unsigned long long fadeLength)
+{
+    // Each layer of the section
+    for (unsigned int i = 0; i < this->layers.size(); i++)
+    {
+        MusicLayer& layer = this->layers[i];
+        if (layer.pFMODSound == 0 || layer.filename != filename || this->isLayerPlaying(layer) == false)
+            continue;
+        // Keep the clock it started on
+        unsigned long long startClock = 0;
+        FMOD_Channel_GetDelay(layer.pChannel, &startClock, 0, 0);
+        // Fade out from the level it will be at (silent layers stay silent)
+        this->fadeLayer(layer.pChannel, dspClock, fadeLength, 0.0f);
+        // Stop on the clock once the fade is done
+        FMOD_Channel_SetDelay(layer.pChannel, startClock, dspClock + std::max(fadeLength, MUSICSCHEDULER_MIN_FADE_SAMPLES), true);
+    }
+}
+
+bool MusicScheduler::isLayerPlaying(MusicLayer& layer)
+{
+    // Never started
+    if (layer.pChannel == 0)
+        return false;
+    // Ask FMOD (the handle of a channel that stopped is no longer valid)
+    FMOD_BOOL playingFlag = false;
+    if (FMOD_Channel_IsPlaying(layer.pChannel, &playingFlag) != FMOD_OK)
+        return false;
+    // return the playing flag
+    return (playingFlag != 0);
+}
+
+void MusicScheduler::fadeLayer(FMOD_CHANNEL* pChannel, unsigned long long dspClock, unsigned long long fadeLength, float to)
+{
+    // Levels now and on the boundary (it may still be part way through the last fade)
+    unsigned long long nowClock = this->musicPlayer.getClock();
+    float level = MusicPlayer::getFadeLevel(pChannel, nowClock);
+    float from = MusicPlayer::getFadeLevel(pChannel, dspClock);
+    // Forget any fades still to come, keeping the level it is at
+    FMOD_Channel_RemoveFadePoints(pChannel, nowClock, (unsigned long long)-1);
+    FMOD_Channel_AddFadePoint(pChannel, nowClock, level);
+    // Fade from the boundary (never a hard step, it would click)
+    fadeLength = std::max(fadeLength, MUSICSCHEDULER_MIN_FADE_SAMPLES);
+    FMOD_Channel_AddFadePoint(pChannel, dspClock, from);
+    FMOD_Channel_AddFadePoint(pChannel, dspClock + fadeLength, to);
+}
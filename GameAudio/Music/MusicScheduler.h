@@ -0,0 +1,328 @@
+/**
+  * @file   MusicScheduler.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  MusicScheduler lines section changes, stingers and layers up
+  * with the beats and bars of the music on the DSP clock
+*/
+
+#ifndef MUSICSCHEDULER_H
+#define MUSICSCHEDULER_H
+
+// C++ Includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_codec.h>
+#include <fmod_common.h>
+#include <fmod_dsp.h>
+#include <fmod_dsp_effects.h>
+#include <fmod_errors.h>
+#include <fmod_output.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Channel/Channel.h"
+#include "Music/Music.h"
+#include "Music/MusicPlayer.h"
+
+// Where a change lands
+enum MUSICSYNC
+{
+    // As soon as it can be scheduled
+    MUSICSYNC_NOW = 0,
+    // The next beat
+    MUSICSYNC_BEAT,
+    // The next bar
+    MUSICSYNC_BAR,
+    // The end of the loop the section is in
+    MUSICSYNC_END
+};
+
+// Default time a change is scheduled ahead of now (seconds, covers a late update)
+const float MUSICSCHEDULER_DEFAULT_LEAD = 0.05f;
+// Shortest fade (clock samples) so layers switching on and off don't click
+const unsigned long long MUSICSCHEDULER_MIN_FADE_SAMPLES = 64;
+// Clock a stinger is held at until update moves it onto its boundary
+const unsigned long long MUSICSCHEDULER_HOLD_CLOCK = 0x4000000000000000ULL;
+// Mode sections are opened with (preload them with the StreamPool in this mode)
+const FMOD_MODE MUSICSCHEDULER_SECTION_MODE = FMOD_DEFAULT | FMOD_LOOP_NORMAL;
+
+/** The MusicTempo struct is the tempo of a section **/
+struct MusicTempo
+{
+    //! Constructor
+    MusicTempo()
+    {
+        this->bpm = 120.0f;
+        this->beatsPerBar = 4;
+        this->beatUnit = 4;
+        this->offset = 0.0f;
+    }
+
+    // Beats a minute (of the beat unit)
+    float bpm;
+    // Beats a bar (the top of the time signature)
+    int beatsPerBar;
+    // Note value of a beat (the bottom of the time signature)
+    int beatUnit;
+    // Seconds from the start of the file to the first beat
+    float offset;
+};
+
+/** Driving music by polling the game and switching when the right beat
+    comes round misses the beat by up to a frame. The MusicScheduler knows
+    the tempo of each section (set with setTempo) and where the section
+    started on the DSP clock of the music channel group, so it works out
+    the clock of the next beat, bar or loop end exactly. Section changes
+    (through a MusicPlayer), stingers and layers switching on and off are
+    scheduled for that clock with setDelay and fade points, so they land on
+    the sample. The game only posts requests; they are worked out and
+    scheduled in update, which is hooked to AudioSystem::addUpdateCallback
+    and so runs on the update thread when it is running. The update thread
+    never opens a file nor touches a Channel the game owns: a section must
+    be preloaded with the StreamPool before it can be cued, a stinger is
+    played on the game's thread held by a delay that update moves onto the
+    boundary, and a layer is the sound of a Music the game has loaded, which
+    the MusicScheduler plays on its own channel. Layers start with their
+    section on the same sample (silent while disabled) and are faded in and
+    out on the beat **/
+class MusicScheduler
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        MusicScheduler();
+        //! Destructor
+        virtual ~MusicScheduler();
+
+    protected:
+        //! MusicScheduler Copy constructor
+        MusicScheduler(const MusicScheduler& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! MusicScheduler Assignment operator
+        MusicScheduler& operator=(const MusicScheduler& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief setTempo
+          * @param filename file of the section
+          * @param bpm beats a minute
+          * @param beatsPerBar beats a bar
+          * @param beatUnit note value of a beat
+          * @param offset seconds from the start of the file to the first beat
+          * @return false if the tempo is bad **/
+        virtual bool setTempo(const std::string& filename, float bpm, int beatsPerBar, int beatUnit = 4, float offset = 0.0f);
+        /** @brief getTempo
+          * @param filename file of the section
+          * @param tempo receives the tempo
+          * @return false if the section has no tempo **/
+        virtual bool getTempo(const std::string& filename, MusicTempo& tempo);
+        /** @brief addLayer
+          * Play the sound of a Music with a section, starting on the same
+          * sample. Keep the Music loaded (and don't play it) until the layer
+          * is removed; its volume and loop mode are taken now
+          * @param filename file of the section
+          * @param pLayer a loaded Music
+          * @param enabledFlag true to be heard from the start
+          * @return index of the layer or -1 **/
+        virtual int addLayer(const std::string& filename, Music* pLayer, bool enabledFlag = false);
+        /** @brief removeLayer
+          * @param layer index of the layer (it is stopped) **/
+        virtual void removeLayer(int layer);
+
+    public:
+        /** @brief cue
+          * Ready the next section (before the transition to it). It must be
+          * preloaded with the StreamPool in MUSICSCHEDULER_SECTION_MODE. A cue
+          * posted during a crossfade waits for the crossfade to finish
+          * @param filename file of the section
+          * @param loopFlag true to loop the section until the next transition
+          * @return false if the section isn't preloaded **/
+        virtual bool cue(const std::string& filename, bool loopFlag = true);
+        /** @brief transition
+          * Move to the cued section
+          * @param sync where the new section starts
+          * @param fadeTime seconds to crossfade over (0.0 for a cut) **/
+        virtual void transition(MUSICSYNC sync, float fadeTime = 0.0f);
+        /** @brief playStinger
+          * Play a loaded Channel (a Sound or Stream) on the beat. It starts now
+          * on the music channel group, held silent until its boundary
+          * @param pStinger the stinger
+          * @param sync where it starts **/
+        virtual void playStinger(Channel* pStinger, MUSICSYNC sync);
+        /** @brief setLayerEnabled
+          * @param layer index of the layer
+          * @param enabledFlag true to fade it in, false to fade it out
+          * @param sync where the fade starts
+          * @param fadeTime seconds to fade over **/
+        virtual void setLayerEnabled(int layer, bool enabledFlag, MUSICSYNC sync, float fadeTime = 0.0f);
+        /** @brief stop
+          * @param sync where the music stops
+          * @param fadeTime seconds to fade out over **/
+        virtual void stop(MUSICSYNC sync, float fadeTime = 0.0f);
+        /** @brief update
+          * Work out and schedule the requests posted since the last update
+          * (a cue during a crossfade and those after it wait for the next) **/
+        virtual void update();
+        /** @brief updateCallback
+          * Hook for AudioSystem::addUpdateCallback (pass the MusicScheduler as pUserData) **/
+        static void updateCallback(void* pUserData) { ((MusicScheduler*)pUserData)->update(); }
+        /** @brief free
+          * Stop everything and forget the requests, layers and tempos **/
+        virtual void free();
+
+    public:
+        /** @brief Get Lead
+          * @return seconds a change is scheduled ahead of now **/
+        virtual float getLead() { return this->lead; }
+        /** @brief Set Lead
+          * @param lead seconds a change is scheduled ahead of now (at least the time between updates) **/
+        virtual void setLead(float lead);
+        /** @brief getBeatPosition
+          * @return beats since the first beat of the loop the section is in (0.0 if no tempo) **/
+        virtual float getBeatPosition();
+        /** @brief getBar
+          * @return bar of the loop the section is in (from 0) **/
+        virtual int getBar();
+        /** @brief getBeat
+          * @return beat of the bar (from 0) **/
+        virtual int getBeat();
+        /** @brief getNextBoundary
+          * @param sync beat, bar or loop end
+          * @return clock of the music channel group the next one is at **/
+        virtual unsigned long long getNextBoundary(MUSICSYNC sync);
+        /** @brief Get the Music Player
+          * Only touch it from the thread update runs on
+          * @return the MusicPlayer the sections play on **/
+        virtual MusicPlayer* getMusicPlayer() { return &(this->musicPlayer); }
+
+    protected:
+        // Requests
+        enum MUSICSCHEDULER_REQUEST
+        {
+            MUSICSCHEDULER_REQUEST_CUE = 0,
+            MUSICSCHEDULER_REQUEST_TRANSITION,
+            MUSICSCHEDULER_REQUEST_STINGER,
+            MUSICSCHEDULER_REQUEST_LAYER,
+            MUSICSCHEDULER_REQUEST_STOP
+        };
+        // A posted request
+        struct MusicSchedulerRequest
+        {
+            // Type
+            MUSICSCHEDULER_REQUEST type;
+            // Section (cue)
+            std::string filename;
+            // Loop (cue) or enable (layer)
+            bool flag;
+            // Layer
+            int layer;
+            // Stinger (playing, held at MUSICSCHEDULER_HOLD_CLOCK)
+            FMOD_CHANNEL* pChannel;
+            // Where it lands
+            MUSICSYNC sync;
+            // Seconds to fade over
+            float fadeTime;
+        };
+        // A layer
+        struct MusicLayer
+        {
+            // Section it plays with
+            std::string filename;
+            // Sound of the Music (0 once removed)
+            FMOD_SOUND* pFMODSound;
+            // Channel it plays on (owned by the MusicScheduler)
+            FMOD_CHANNEL* pChannel;
+            // Volume of the Music
+            float volume;
+            // Loop mode of the Music
+            bool loopFlag;
+            // Being heard (as of the last change scheduled)
+            bool enabledFlag;
+        };
+
+    protected:
+        /** @brief post
+          * @param request the request to queue **/
+        virtual void post(const MusicSchedulerRequest& request);
+        /** @brief process (lock must be held)
+          * @param request the request to schedule
+          * @return false if it has to wait for the next update **/
+        virtual bool process(const MusicSchedulerRequest& request);
+        /** @brief getEarliestClock (lock must be held)
+          * @return the soonest clock a change can be scheduled for **/
+        virtual unsigned long long getEarliestClock();
+        /** @brief findNextBoundary (lock must be held)
+          * @param sync beat, bar or loop end
+          * @param earliestClock the boundary is at or after this
+          * @return clock of the boundary **/
+        virtual unsigned long long findNextBoundary(MUSICSYNC sync, unsigned long long earliestClock);
+        /** @brief getSamplesPerBeat (lock must be held)
+          * @param tempo receives the tempo of the section playing
+          * @return clock samples a beat, 0.0 if the section has no tempo **/
+        virtual double getSamplesPerBeat(MusicTempo& tempo);
+        /** @brief getFadeLength
+          * @param fadeTime seconds
+          * @return clock samples **/
+        virtual unsigned long long getFadeLength(float fadeTime);
+        /** @brief startLayers (lock must be held)
+          * Start the layers of a section on a clock
+          * @param filename file of the section
+          * @param dspClock clock to start on
+          * @param fadeLength clock samples the section fades in over **/
+        virtual void startLayers(const std::string& filename, unsigned long long dspClock, unsigned long long fadeLength);
+        /** @brief stopLayers (lock must be held)
+          * Stop the layers of a section on a clock
+          * @param filename file of the section
+          * @param dspClock clock the fade out starts on
+          * @param fadeLength clock samples to fade out over **/
+        virtual void stopLayers(const std::string& filename, unsigned long long dspClock, unsigned long long fadeLength);
+        /** @brief isLayerPlaying (lock must be held)
+          * @param layer the layer
+          * @return true if its channel is playing **/
+        virtual bool isLayerPlaying(MusicLayer& layer);
+        /** @brief fadeLayer
+          * Fade a playing layer from the level it will be at on a clock
+          * @param pChannel channel of the layer
+          * @param dspClock clock the fade starts on
+          * @param fadeLength clock samples to fade over
+          * @param to volume after the fade **/
+        virtual void fadeLayer(FMOD_CHANNEL* pChannel, unsigned long long dspClock, unsigned long long fadeLength, float to);
+
+    protected:
+        // Sections play on this
+        MusicPlayer musicPlayer;
+        // Tempo of each section (by file)
+        std::map<std::string, MusicTempo> tempos;
+        // Layers (removed layers are left as 0 so indices stay put)
+        std::vector<MusicLayer> layers;
+        // Lead (seconds)
+        float lead;
+        // Guards everything above
+        std::mutex mutex;
+        // Requests waiting for update
+        std::vector<MusicSchedulerRequest> requests;
+        // Guards the requests (so posting never waits on scheduling)
+        std::mutex requestMutex;
+};
+
+#endif // MUSICSCHEDULER_H
@@ -10,6 +10,8 @@ Recording::Recording() : Channel()
 
 Recording::~Recording()
 {
+    // Leave the update thread before anything is torn down
+    this->unregisterChannel();
     // Don't do anything unless we have loaded a soundstream
     if (this->pFMODSound != 0)
     {
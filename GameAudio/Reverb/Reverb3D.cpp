@@ -17,7 +17,8 @@ Reverb3D::Reverb3D()
 
 Reverb3D::~Reverb3D()
 {
-
+    // Leave the SpatialGrid before anything is torn down
+    this->leaveSpatialGrid();
 }
 
 Reverb3D::Reverb3D(const Reverb3D& other)
@@ -57,19 +58,21 @@ bool Reverb3D::isActive()
 void Reverb3D::setActive(bool activeFlag)
 {
     // Set the Active Flag
-    FMOD_Reverb3D_SetActive(this->pFMODReverb3D, activeFlag);
+    this->activeFlag = activeFlag;
+    // Only switch on in FMOD when a listener is in range
+    FMOD_Reverb3D_SetActive(this->pFMODReverb3D, this->activeFlag && this->spatialActiveFlag);
 }
 
 void Reverb3D::activate()
 {
     // Set the Active Flag
-    FMOD_Reverb3D_SetActive(this->pFMODReverb3D, true);
+    this->setActive(true);
 }
 
 void Reverb3D::deactivate()
 {
     // Set the Active Flag
-    FMOD_Reverb3D_SetActive(this->pFMODReverb3D, false);
+    this->setActive(false);
 }
 
 float Reverb3D::getX()
@@ -98,6 +101,8 @@ void Reverb3D::setPosition(float x, float y, float z)
     this->y = y;
     // Set local z
     this->z = z;
+    // Move cell in the SpatialGrid
+    this->spatialMoved();
     // Position
     FMOD_VECTOR position;
         position.x = this->x;
@@ -125,6 +130,8 @@ void Reverb3D::setMinMaxDistance(float minDistance, float maxDistance)
     this->minDistance = minDistance;
     // Set local maxDistance
     this->maxDistance = maxDistance;
+    // The radius in the SpatialGrid is the max distance
+    this->spatialMoved();
     // Position
     FMOD_VECTOR position;
         position.x = this->x;
@@ -134,6 +141,28 @@ void Reverb3D::setMinMaxDistance(float minDistance, float maxDistance)
     FMOD_Reverb3D_Set3DAttributes(this->pFMODReverb3D, &position, this->minDistance, this->maxDistance);
 }
 
+FMOD_VECTOR Reverb3D::getSpatialPosition()
+{
+    // Position
+    FMOD_VECTOR position;
+        position.x = this->x;
+        position.y = this->y;
+        position.z = this->z;
+    // return position
+    return position;
+}
+
+void Reverb3D::setSpatialActive(bool spatialActiveFlag)
+{
+    // Nothing has changed
+    if (this->spatialActiveFlag == spatialActiveFlag)
+        return;
+    // Set the Spatial Active Flag
+    this->spatialActiveFlag = spatialActiveFlag;
+    // Switch the FMOD Reverb on only if the game wants it on too
+    FMOD_Reverb3D_SetActive(this->pFMODReverb3D, this->activeFlag && this->spatialActiveFlag);
+}
+
 //void Reverb3D::bindToLua(lua_State* pLuaState)
 //{
 //    // Bind functions to lua state
@@ -22,9 +22,10 @@
 
 // GAMEAUDIO Includes
 #include "FMODGlobals.h"
+#include "System/SpatialObject.h"
 
 /** A Reverb3D... TODO: Comment me **/
-class Reverb3D
+class Reverb3D : public SpatialObject
 {
     // *****************************
     // * CONSTRUCTORS / DESTRUCTOR *
@@ -96,6 +97,22 @@ class Reverb3D
           * @param maxDisance min distance the sound can be heard **/
         virtual void setMinMaxDistance(float minDistance, float maxDistance);
 
+    // *********************
+    // * SPATIAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief getSpatialPosition
+          * @return position of the Reverb **/
+        virtual FMOD_VECTOR getSpatialPosition();
+        /** @brief getSpatialRadius
+          * @return max distance of the Reverb **/
+        virtual float getSpatialRadius() { return this->maxDistance; }
+        /** @brief setSpatialActive (called by the SpatialGrid)
+          * Switch the FMOD Reverb off when no listener is within max distance
+          * (isActive still reports what the game asked for)
+          * @param spatialActiveFlag true to switch on, false to switch off **/
+        virtual void setSpatialActive(bool spatialActiveFlag);
+
     protected:
         // FMODRever3D Object
         FMOD_REVERB3D* pFMODReverb3D;
@@ -0,0 +1,141 @@
+#include "RolloffCurve.h"
+
+RolloffCurve::RolloffCurve()
+{
+    // Points
+    this->distances.clear();
+    this->volumes.clear();
+    this->tangents.clear();
+    // Interpolation
+    this->interpolation = ROLLOFFCURVE_LINEAR;
+    // Full volume everywhere until there are points
+    this->bake();
+}
+
+RolloffCurve::~RolloffCurve()
+{
+}
+
+void RolloffCurve::clear()
+{
+    // Forget the points
+    this->distances.clear();
+    this->volumes.clear();
+    this->tangents.clear();
+    // Bake
+    this->bake();
+}
+
+void RolloffCurve::addPoint(float distance, float volume)
+{
+    // Clamp the point
+    distance = std::min(std::max(distance, 0.0f), 1.0f);
+    volume = std::min(std::max(volume, 0.0f), 1.0f);
+    // Keep the points sorted by distance (a point at the same distance replaces the old one)
+    std::vector<float>::iterator iter = std::lower_bound(this->distances.begin(), this->distances.end(), distance);
+    int index = (int)(iter - this->distances.begin());
+    if (iter != this->distances.end() && *iter == distance)
+    {
+        this->volumes[index] = volume;
+    }
+    else
+    {
+        this->distances.insert(iter, distance);
+        this->volumes.insert(this->volumes.begin() + index, volume);
+    }
+    // Bake
+    this->bake();
+}
+
+void RolloffCurve::setPoints(const float* pDistances, const float* pVolumes, int numberOfPoints)
+{
+    // Forget the old points
+    this->distances.clear();
+    this->volumes.clear();
+    // Add the new ones
+    for (int i = 0; i < numberOfPoints; i++)
+        this->addPoint(pDistances[i], pVolumes[i]);
+    // Bake (in case there were none)
+    this->bake();
+}
+
+void RolloffCurve::setInterpolation(ROLLOFFCURVE_INTERPOLATION interpolation)
+{
+    // Set Interpolation
+    this->interpolation = interpolation;
+    // Bake
+    this->bake();
+}
+
+float RolloffCurve::sample(float distance)
+{
+    // No points is full volume
+    int numberOfPoints = (int)this->distances.size();
+    if (numberOfPoints == 0)
+        return 1.0f;
+    // Flat before the first point and after the last
+    if (distance <= this->distances[0])
+        return this->volumes[0];
+    if (distance >= this->distances[numberOfPoints - 1])
+        return this->volumes[numberOfPoints - 1];
+    // Find the segment
+    int segment = (int)(std::upper_bound(this->distances.begin(), this->distances.end(), distance) - this->distances.begin()) - 1;
+    float width = this->distances[segment + 1] - this->distances[segment];
+    float t = (distance - this->distances[segment]) / width;
+    // Linear
+    if (this->interpolation == ROLLOFFCURVE_LINEAR || (int)this->tangents.size() != numberOfPoints)
+        return this->volumes[segment] + (this->volumes[segment + 1] - this->volumes[segment]) * t;
+    // Cubic Hermite
+    float t2 = t * t;
+    float t3 = t2 * t;
+    float h00 = 2.0f * t3 - 3.0f * t2 + 1.0f;
+    float h10 = t3 - 2.0f * t2 + t;
+    float h01 = -2.0f * t3 + 3.0f * t2;
+    float h11 = t3 - t2;
+    float volume = h00 * this->volumes[segment] + h10 * width * this->tangents[segment] + h01 * this->volumes[segment + 1] + h11 * width * this->tangents[segment + 1];
+    // return volume
+    return std::min(std::max(volume, 0.0f), 1.0f);
+}
+
+void RolloffCurve::bake()
+{
+    // Work out monotone tangents (Fritsch-Carlson) so the cubic never overshoots a point
+    int numberOfPoints = (int)this->distances.size();
+    this->tangents.assign(numberOfPoints, 0.0f);
+    if (this->interpolation == ROLLOFFCURVE_CUBIC && numberOfPoints > 1)
+    {
+        // Slope of each segment
+        std::vector<float> slopes(numberOfPoints - 1);
+        for (int i = 0; i < numberOfPoints - 1; i++)
+            slopes[i] = (this->volumes[i + 1] - this->volumes[i]) / (this->distances[i + 1] - this->distances[i]);
+        // Tangents average the slopes either side (flat at a peak or a trough)
+        this->tangents[0] = slopes[0];
+        this->tangents[numberOfPoints - 1] = slopes[numberOfPoints - 2];
+        for (int i = 1; i < numberOfPoints - 1; i++)
+            this->tangents[i] = (slopes[i - 1] * slopes[i] <= 0.0f) ? 0.0f : (slopes[i - 1] + slopes[i]) * 0.5f;
+        // Pull in the tangents which would overshoot
+        for (int i = 0; i < numberOfPoints - 1; i++)
+        {
+            if (slopes[i] == 0.0f)
+            {
+                this->tangents[i] = 0.0f;
+                this->tangents[i + 1] = 0.0f;
+                continue;
+            }
+            float a = this->tangents[i] / slopes[i];
+            float b = this->tangents[i + 1] / slopes[i];
+            float length = a * a + b * b;
+            if (length > 9.0f)
+            {
+                float scale = 3.0f / std::sqrt(length);
+                this->tangents[i] = scale * a * slopes[i];
+                this->tangents[i + 1] = scale * b * slopes[i];
+            }
+        }
+    }
+    // Sample each step
+    for (int i = 0; i <= ROLLOFFCURVE_TABLE_SIZE; i++)
+        this->table[i] = this->sample((float)i / (float)ROLLOFFCURVE_TABLE_SIZE);
+    // Guard entry (read with a fraction of 0 at the very end)
+    this->table[ROLLOFFCURVE_TABLE_SIZE + 1] = this->table[ROLLOFFCURVE_TABLE_SIZE];
+}
@@ -0,0 +1,109 @@
+/**
+  * @file   RolloffCurve.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  RolloffCurve is a designer authored distance falloff sampled
+  * into a fixed size table
+*/
+
+#ifndef ROLLOFFCURVE_H
+#define ROLLOFFCURVE_H
+
+// C++ Includes
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Number of steps in the table (the table holds one more entry so the last step can be read past)
+const int ROLLOFFCURVE_TABLE_SIZE = 64;
+
+// How the points of a curve are joined
+enum ROLLOFFCURVE_INTERPOLATION
+{
+    // Straight lines between the points
+    ROLLOFFCURVE_LINEAR = 0,
+    // Monotone cubic through the points (smooth and never overshoots them)
+    ROLLOFFCURVE_CUBIC
+};
+
+/** A RolloffCurve is a list of (distance, volume) points over the
+    distance between a Channel's min distance (0) and max distance (1).
+    Once baked the curve is only ever read out of its table: clamp, scale,
+    truncate and one lerp, with no branches, no allocation and no locks.
+    The RolloffManager hands the table entries to FMOD as a Channel's
+    custom rolloff points, which FMOD joins with the same lerp **/
+class RolloffCurve
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        RolloffCurve();
+        //! Destructor
+        virtual ~RolloffCurve();
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief clear
+          * Forget the points (the curve becomes full volume at every distance) **/
+        virtual void clear();
+        /** @brief addPoint (the curve is baked again)
+          * @param distance between min distance (0) and max distance (1)
+          * @param volume at that distance (0 silent 1 fullblast) **/
+        virtual void addPoint(float distance, float volume);
+        /** @brief setPoints (the curve is baked again)
+          * @param pDistances distances between 0 and 1
+          * @param pVolumes volumes between 0 and 1
+          * @param numberOfPoints number of points **/
+        virtual void setPoints(const float* pDistances, const float* pVolumes, int numberOfPoints);
+        /** @brief Get Interpolation
+          * @return how the points are joined **/
+        virtual ROLLOFFCURVE_INTERPOLATION getInterpolation() { return this->interpolation; }
+        /** @brief Set Interpolation (the curve is baked again)
+          * @param interpolation how the points are joined **/
+        virtual void setInterpolation(ROLLOFFCURVE_INTERPOLATION interpolation);
+        /** @brief Get the number of points
+          * @return number of points **/
+        virtual int getNumberOfPoints() { return (int)this->distances.size(); }
+        /** @brief evaluate
+          * @param distance between min distance (0) and max distance (1), clamped
+          * @return volume out of the table **/
+        inline float evaluate(float distance) const
+        {
+            // Clamp (minss / maxss rather than branches)
+            float position = std::min(std::max(distance, 0.0f), 1.0f) * (float)ROLLOFFCURVE_TABLE_SIZE;
+            // Step and how far along it
+            int step = (int)position;
+            float fraction = position - (float)step;
+            // Lerp (at 1 the guard entry past the last step is read)
+            return this->table[step] + (this->table[step + 1] - this->table[step]) * fraction;
+        }
+        /** @brief sample
+          * Work a volume out from the points (what bake fills the table with)
+          * @param distance between 0 and 1
+          * @return volume **/
+        virtual float sample(float distance);
+
+    protected:
+        /** @brief bake
+          * Sample the points into the table **/
+        virtual void bake();
+
+    protected:
+        // Point distances (sorted)
+        std::vector<float> distances;
+        // Point volumes
+        std::vector<float> volumes;
+        // Cubic tangents at the points
+        std::vector<float> tangents;
+        // How the points are joined
+        ROLLOFFCURVE_INTERPOLATION interpolation;
+        // Volume at each step (plus a guard entry)
+        float table[ROLLOFFCURVE_TABLE_SIZE + 2];
+};
+
+#endif // ROLLOFFCURVE_H
@@ -0,0 +1,395 @@
+#include "RolloffManager.h"
+
+// Marks a binding slot whose Channel was unbound (lookups carry on past it)
+static FMOD_CHANNEL* const ROLLOFFMANAGER_TOMBSTONE = (FMOD_CHANNEL*)1;
+
+RolloffManager::RolloffManager()
+{
+    // Curves
+    this->numberOfCurves = 0;
+    // Bindings
+    this->bindings.resize(ROLLOFFMANAGER_MAX_BINDINGS);
+    for (int i = 0; i < ROLLOFFMANAGER_MAX_BINDINGS; i++)
+    {
+        this->bindings[i].pChannel = 0;
+        this->bindings[i].curve = -1;
+        this->bindings[i].minDistance = 1.0f;
+        this->bindings[i].maxDistance = 10000.0f;
+        this->bindings[i].rolloffMode = FMOD_3D_INVERSEROLLOFF;
+        this->bindings[i].current = 0;
+    }
+}
+
+RolloffManager::~RolloffManager()
+{
+    // Hand the Channels back to their own rolloff
+    this->clear();
+}
+
+void RolloffManager::clear()
+{
+    std::vector<RolloffUpdate> updates;
+    {
+        // Lock the Manager
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // Forget the bound Channels
+        for (int i = 0; i < ROLLOFFMANAGER_MAX_BINDINGS; i++)
+        {
+            if (this->bindings[i].pChannel != 0 && this->bindings[i].pChannel != ROLLOFFMANAGER_TOMBSTONE)
+                updates.push_back(this->releaseBinding(this->bindings[i]));
+            this->bindings[i].pChannel = 0;
+        }
+        // Forget the curves
+        for (int i = 0; i < this->numberOfCurves; i++)
+        {
+            this->curves[i].clear();
+            this->names[i].clear();
+        }
+        this->numberOfCurves = 0;
+    }
+    // Hand them back to their own rolloff (the points live as long as we do)
+    for (unsigned int i = 0; i < updates.size(); i++)
+        RolloffManager::commitUpdate(updates[i]);
+}
+
+int RolloffManager::addCurve(const std::string& name, const RolloffCurve& curve)
+{
+    std::vector<RolloffUpdate> updates;
+    // Lock the Manager
+    std::unique_lock<std::mutex> lock(this->mutex);
+    // Replace a curve with the same name in place
+    int index = -1;
+    for (int i = 0; i < this->numberOfCurves; i++)
+    {
+        if (this->names[i] == name)
+            index = i;
+    }
+    // Or take the next one
+    if (index == -1)
+    {
+        if (this->numberOfCurves == ROLLOFFMANAGER_MAX_CURVES)
+        {
+            std::cout << "int RolloffManager::addCurve() failure. No room for " << name << std::endl;
+            return -1;
+        }
+        index = this->numberOfCurves;
+        this->names[index] = name;
+        this->numberOfCurves++;
+    }
+    // Set the curve
+    this->curves[index] = curve;
+    // The Channels bound to the old curve pick up the new one
+    for (int i = 0; i < ROLLOFFMANAGER_MAX_BINDINGS; i++)
+    {
+        RolloffBinding& binding = this->bindings[i];
+        if (binding.pChannel != 0 && binding.pChannel != ROLLOFFMANAGER_TOMBSTONE && binding.curve == index)
+            updates.push_back(this->applyBinding(binding));
+    }
+    lock.unlock();
+    for (unsigned int i = 0; i < updates.size(); i++)
+        RolloffManager::commitUpdate(updates[i]);
+    // return the index
+    return index;
+}
+
+bool RolloffManager::loadCurves(const std::string& filename)
+{
+    // Open the file
+    std::ifstream file(filename.c_str());
+    if (file.is_open() == false)
+    {
+        std::cout << "bool RolloffManager::loadCurves() failure. Could not open " << filename << std::endl;
+        return false;
+    }
+    // Each line is a curve
+    std::string line;
+    int lineNumber = 0;
+    int numberOfCurves = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        // Strip comments
+        std::string::size_type comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        // Name and interpolation
+        std::istringstream stream(line);
+        std::string name;
+        std::string interpolation;
+        if (!(stream >> name))
+            continue;
+        if (!(stream >> interpolation) || (interpolation != "linear" && interpolation != "cubic"))
+        {
+            std::cout << "bool RolloffManager::loadCurves() failure. " << filename << " line " << lineNumber << " needs linear or cubic" << std::endl;
+            return false;
+        }
+        // Points
+        RolloffCurve curve;
+        curve.setInterpolation((interpolation == "cubic") ? ROLLOFFCURVE_CUBIC : ROLLOFFCURVE_LINEAR);
+        float distance = 0.0f;
+        float volume = 0.0f;
+        while (stream >> distance >> volume)
+            curve.addPoint(distance, volume);
+        if (curve.getNumberOfPoints() == 0 || stream.eof() == false)
+        {
+            std::cout << "bool RolloffManager::loadCurves() failure. " << filename << " line " << lineNumber << " needs distance volume pairs" << std::endl;
+            return false;
+        }
+        // Add it
+        if (this->addCurve(name, curve) == -1)
+            return false;
+        numberOfCurves++;
+    }
+    // Send a message to the console
+    std::cout << "Rolloff: " << filename << " Loaded with " << numberOfCurves << " curves." << std::endl;
+    // Success
+    return true;
+}
+
+int RolloffManager::findCurve(const std::string& name)
+{
+    // Lock the Manager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the curve
+    for (int i = 0; i < this->numberOfCurves; i++)
+    {
+        if (this->names[i] == name)
+            return i;
+    }
+    // Not found
+    return -1;
+}
+
+const RolloffCurve* RolloffManager::getCurve(int index)
+{
+    // Validate the index
+    if (index < 0 || index >= this->numberOfCurves)
+        return 0;
+    // return the curve
+    return &(this->curves[index]);
+}
+
+std::string RolloffManager::getCurveName(int index)
+{
+    // Lock the Manager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Validate the index
+    if (index < 0 || index >= this->numberOfCurves)
+        return std::string();
+    // return the name
+    return this->names[index];
+}
+
+bool RolloffManager::bindChannel(FMOD_CHANNEL* pChannel, int curve, float minDistance, float maxDistance)
+{
+    // Validate the Channel
+    if (pChannel == 0)
+        return false;
+    // Without a curve the Channel keeps its own rolloff
+    if (curve < 0)
+    {
+        this->unbindChannel(pChannel);
+        return true;
+    }
+    // Read the rolloff the Channel has so it can be handed back (FMOD is never called under the lock)
+    FMOD_MODE mode = 0;
+    FMOD_Channel_GetMode(pChannel, &mode);
+    FMOD_MODE rolloffMode = mode & ROLLOFFMANAGER_ROLLOFF_MODES & ~FMOD_3D_CUSTOMROLLOFF;
+    // Channels in the way which have finished without being unbound
+    FMOD_CHANNEL* finished[ROLLOFFMANAGER_MAX_PROBES];
+    int numberOfFinished = 0;
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        RolloffUpdate update;
+        update.pChannel = 0;
+        bool releasedFlag = false;
+        FMOD_CHANNEL* inTheWay[ROLLOFFMANAGER_MAX_PROBES];
+        int numberInTheWay = 0;
+        {
+            // Lock the Manager
+            std::lock_guard<std::mutex> lock(this->mutex);
+            // Not a curve so the Channel keeps its own rolloff
+            RolloffBinding* pBinding = 0;
+            if (curve >= this->numberOfCurves)
+            {
+                pBinding = this->findBinding(pChannel);
+                if (pBinding != 0)
+                    update = this->releaseBinding(*pBinding);
+                releasedFlag = true;
+            }
+            // Find the Channel or somewhere to put it
+            bool newFlag = false;
+            if (releasedFlag == false)
+                pBinding = this->findSlot(pChannel, finished, numberOfFinished, inTheWay, numberInTheWay, newFlag);
+            if (releasedFlag == false && pBinding != 0)
+            {
+                // Somewhere new
+                if (newFlag == true)
+                {
+                    pBinding->pChannel = pChannel;
+                    pBinding->rolloffMode = (rolloffMode != 0) ? rolloffMode : FMOD_3D_INVERSEROLLOFF;
+                }
+                // Fill in the binding
+                pBinding->curve = curve;
+                pBinding->minDistance = minDistance;
+                pBinding->maxDistance = maxDistance;
+                update = this->applyBinding(*pBinding);
+            }
+        }
+        // Hand FMOD the points
+        if (releasedFlag == true || update.pChannel != 0)
+        {
+            RolloffManager::commitUpdate(update);
+            return true;
+        }
+        // No room so find out which of the Channels in the way have finished and look again
+        numberOfFinished = 0;
+        for (int i = 0; i < numberInTheWay; i++)
+        {
+            FMOD_BOOL playingFlag = false;
+            if (FMOD_Channel_IsPlaying(inTheWay[i], &playingFlag) != FMOD_OK || playingFlag == false)
+                finished[numberOfFinished++] = inTheWay[i];
+        }
+        if (numberOfFinished == 0)
+            break;
+    }
+    std::cout << "bool RolloffManager::bindChannel() failure. The bindings are full" << std::endl;
+    return false;
+}
+
+void RolloffManager::unbindChannel(FMOD_CHANNEL* pChannel)
+{
+    // Validate the Channel
+    if (pChannel == 0)
+        return;
+    RolloffUpdate update;
+    {
+        // Lock the Manager
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // Find the Channel
+        RolloffBinding* pBinding = this->findBinding(pChannel);
+        if (pBinding == 0)
+            return;
+        update = this->releaseBinding(*pBinding);
+    }
+    // Hand it back to its own rolloff
+    RolloffManager::commitUpdate(update);
+}
+
+RolloffManager::RolloffBinding* RolloffManager::findBinding(FMOD_CHANNEL* pChannel)
+{
+    // Look in the slots the Channel hashes to
+    int start = RolloffManager::getSlot(pChannel);
+    for (int i = 0; i < ROLLOFFMANAGER_MAX_PROBES; i++)
+    {
+        RolloffBinding& binding = this->bindings[(start + i) & (ROLLOFFMANAGER_MAX_BINDINGS - 1)];
+        if (binding.pChannel == 0)
+            return 0;
+        if (binding.pChannel == pChannel)
+            return &binding;
+    }
+    // Not found
+    return 0;
+}
+
+RolloffManager::RolloffBinding* RolloffManager::findSlot(FMOD_CHANNEL* pChannel, FMOD_CHANNEL** ppFinished, int numberOfFinished, FMOD_CHANNEL** ppInTheWay, int& numberInTheWay, bool& newFlag)
+{
+    // Look in the slots the Channel hashes to
+    int start = RolloffManager::getSlot(pChannel);
+    RolloffBinding* pFree = 0;
+    RolloffBinding* pFinished = 0;
+    numberInTheWay = 0;
+    newFlag = true;
+    for (int i = 0; i < ROLLOFFMANAGER_MAX_PROBES; i++)
+    {
+        RolloffBinding* pSlot = &(this->bindings[(start + i) & (ROLLOFFMANAGER_MAX_BINDINGS - 1)]);
+        // Already bound
+        if (pSlot->pChannel == pChannel)
+        {
+            newFlag = false;
+            return pSlot;
+        }
+        // Unbound (the end of the Channels that hash here)
+        if (pSlot->pChannel == 0 || pSlot->pChannel == ROLLOFFMANAGER_TOMBSTONE)
+        {
+            if (pFree == 0)
+                pFree = pSlot;
+            if (pSlot->pChannel == 0)
+                break;
+            continue;
+        }
+        // A Channel known to have finished without being unbound
+        if (pFinished == 0 && std::find(ppFinished, ppFinished + numberOfFinished, pSlot->pChannel) != ppFinished + numberOfFinished)
+            pFinished = pSlot;
+        ppInTheWay[numberInTheWay++] = pSlot->pChannel;
+    }
+    // Somewhere new
+    return (pFree != 0) ? pFree : pFinished;
+}
+
+RolloffManager::RolloffUpdate RolloffManager::applyBinding(RolloffBinding& binding)
+{
+    // Write the set FMOD is not reading
+    int next = 1 - binding.current;
+    FMOD_VECTOR* pPoints = binding.points[next];
+    const RolloffCurve& curve = this->curves[binding.curve];
+    // The curve starts at min distance (and holds its first volume inside it)
+    float minDistance = std::max(binding.minDistance, 0.0f);
+    float range = std::max(binding.maxDistance - minDistance, 0.001f);
+    int numberOfPoints = 0;
+    if (minDistance > 0.0f)
+    {
+        pPoints[numberOfPoints].x = 0.0f;
+        pPoints[numberOfPoints].y = curve.evaluate(0.0f);
+        pPoints[numberOfPoints].z = 0.0f;
+        numberOfPoints++;
+    }
+    // One point per table step (FMOD joins them with the same lerp the table uses)
+    for (int i = 0; i <= ROLLOFFCURVE_TABLE_SIZE; i++)
+    {
+        float distance = (float)i / (float)ROLLOFFCURVE_TABLE_SIZE;
+        pPoints[numberOfPoints].x = minDistance + distance * range;
+        pPoints[numberOfPoints].y = curve.evaluate(distance);
+        pPoints[numberOfPoints].z = 0.0f;
+        numberOfPoints++;
+    }
+    binding.current = next;
+    // Hand FMOD the points and switch the Channel to them
+    RolloffUpdate update;
+    update.pChannel = binding.pChannel;
+    update.pPoints = pPoints;
+    update.numberOfPoints = numberOfPoints;
+    update.rolloffMode = FMOD_3D_CUSTOMROLLOFF;
+    return update;
+}
+
+RolloffManager::RolloffUpdate RolloffManager::releaseBinding(RolloffBinding& binding)
+{
+    // Hand the Channel back to the rolloff it had
+    RolloffUpdate update;
+    update.pChannel = binding.pChannel;
+    update.pPoints = 0;
+    update.numberOfPoints = 0;
+    update.rolloffMode = binding.rolloffMode;
+    // Leave a tombstone so the Channels after it are still found
+    binding.pChannel = ROLLOFFMANAGER_TOMBSTONE;
+    binding.curve = -1;
+    return update;
+}
+
+void RolloffManager::commitUpdate(const RolloffUpdate& update)
+{
+    // Nothing to do
+    if (update.pChannel == 0)
+        return;
+    // Hand FMOD the points first so the Channel never goes custom without them
+    if (update.pPoints != 0)
+        FMOD_Channel_Set3DCustomRolloff(update.pChannel, update.pPoints, update.numberOfPoints);
+    // Switch the rolloff (harmless if the Channel has finished)
+    FMOD_MODE mode = 0;
+    if (FMOD_Channel_GetMode(update.pChannel, &mode) == FMOD_OK && (mode & ROLLOFFMANAGER_ROLLOFF_MODES) != update.rolloffMode)
+        FMOD_Channel_SetMode(update.pChannel, (mode & ~ROLLOFFMANAGER_ROLLOFF_MODES) | update.rolloffMode);
+    // Back to its own rolloff so let go of the points
+    if (update.pPoints == 0)
+        FMOD_Channel_Set3DCustomRolloff(update.pChannel, 0, 0);
+}
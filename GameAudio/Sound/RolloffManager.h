@@ -0,0 +1,217 @@
+/**
+  * @file   RolloffManager.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  RolloffManager holds the named RolloffCurves and hands them to
+  * FMOD as each Channel's custom rolloff
+*/
+
+#ifndef ROLLOFFMANAGER_H
+#define ROLLOFFMANAGER_H
+
+// C++ Includes
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Sound/RolloffCurve.h"
+
+// Most curves (they live in a fixed array so an index stays good)
+const int ROLLOFFMANAGER_MAX_CURVES = 64;
+// Channel binding slots (a power of two)
+const int ROLLOFFMANAGER_MAX_BINDINGS = 1024;
+// Slots looked at for a Channel before giving up
+const int ROLLOFFMANAGER_MAX_PROBES = 16;
+// Custom rolloff points per Channel (one per table step, its end and one at distance 0)
+const int ROLLOFFMANAGER_MAX_POINTS = ROLLOFFCURVE_TABLE_SIZE + 2;
+// The rolloff flags of a mode
+const FMOD_MODE ROLLOFFMANAGER_ROLLOFF_MODES = FMOD_3D_INVERSEROLLOFF | FMOD_3D_LINEARROLLOFF | FMOD_3D_LINEARSQUAREROLLOFF | FMOD_3D_INVERSETAPEREDROLLOFF | FMOD_3D_CUSTOMROLLOFF;
+
+/** The RolloffManager owns the named RolloffCurves. Sound3Ds, Stream3Ds
+    and voices bind their Channel to a curve (their own, or their
+    SoundSample's) along with the min and max distance, and the curve's
+    table is laid out over those distances as the Channel's
+    FMOD_3D_CUSTOMROLLOFF points. FMOD then reads the points on the mixer
+    thread itself: nothing of ours runs there, nothing is allocated per
+    voice and a Channel without a curve keeps FMOD's own rolloff exactly
+    (a global FMOD_3D_ROLLOFF_CALLBACK would have replaced it for every
+    Channel). Since FMOD does not copy the points, each binding keeps them
+    in a fixed slot (found by hashing the Channel handle) with two sets so
+    the ones FMOD may be reading are never written over. Curves are baked
+    on the game thread and never removed one at a time so an index handed
+    out stays good until clear. The lock only guards the table: the FMOD
+    calls a binding needs are made once it is let go, since an END callback
+    unbinds from inside FMOD_System_Update while FMOD holds its own lock **/
+class RolloffManager
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        RolloffManager();
+        //! Destructor
+        virtual ~RolloffManager();
+
+    protected:
+        //! RolloffManager Copy constructor
+        RolloffManager(const RolloffManager& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! RolloffManager Assignment operator
+        RolloffManager& operator=(const RolloffManager& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief clear
+          * Hand every bound Channel back to its own rolloff and forget every curve and binding **/
+        virtual void clear();
+
+    public:
+        /** @brief addCurve
+          * Add a curve (a curve with the same name is replaced in place)
+          * @param name name of the curve
+          * @param curve the curve (Channels bound to the old one pick it up)
+          * @return index of the curve or -1 if there is no room **/
+        virtual int addCurve(const std::string& name, const RolloffCurve& curve);
+        /** @brief loadCurves
+          * Add the curves in a text file. Each line is a name, linear or
+          * cubic, then distance volume pairs (# starts a comment), e.g.
+          *     footsteps cubic 0 1 0.2 0.6 1 0
+          * @param filename the file
+          * @return true on success **/
+        virtual bool loadCurves(const std::string& filename);
+        /** @brief findCurve
+          * @param name name of the curve
+          * @return index of the curve or -1 **/
+        virtual int findCurve(const std::string& name);
+        /** @brief getCurve
+          * @param index index of the curve
+          * @return the curve or 0 **/
+        virtual const RolloffCurve* getCurve(int index);
+        /** @brief getCurveName
+          * @param index index of the curve
+          * @return name of the curve **/
+        virtual std::string getCurveName(int index);
+        /** @brief Get the number of curves
+          * @return number of curves **/
+        virtual int getNumberOfCurves() { return this->numberOfCurves; }
+
+    public:
+        /** @brief bindChannel
+          * Give a Channel a curve's rolloff (binding it again updates it)
+          * @param pChannel the Channel
+          * @param curve index of the curve or -1 to hand the Channel back to its own rolloff
+          * @param minDistance min distance of the Channel (where the curve starts)
+          * @param maxDistance max distance of the Channel (where the curve ends)
+          * @return false if there was no slot near the Channel's hash **/
+        virtual bool bindChannel(FMOD_CHANNEL* pChannel, int curve, float minDistance, float maxDistance);
+        /** @brief unbindChannel
+          * Hand a Channel back to its own rolloff
+          * @param pChannel the Channel **/
+        virtual void unbindChannel(FMOD_CHANNEL* pChannel);
+
+    protected:
+        // A Channel's curve and the custom rolloff points FMOD reads
+        struct RolloffBinding
+        {
+            // The Channel (0 if the slot was never used, a tombstone once unbound)
+            FMOD_CHANNEL* pChannel;
+            // Index of the curve
+            int curve;
+            // Min Distance
+            float minDistance;
+            // Max Distance
+            float maxDistance;
+            // The rolloff flags the Channel had before it was bound
+            FMOD_MODE rolloffMode;
+            // Which set of points FMOD was last given
+            int current;
+            // Two sets of points (FMOD may still be reading the other one)
+            FMOD_VECTOR points[2][ROLLOFFMANAGER_MAX_POINTS];
+        };
+        // The FMOD calls a binding change needs (made once the lock is let go)
+        struct RolloffUpdate
+        {
+            // The Channel (0 if there is nothing to do)
+            FMOD_CHANNEL* pChannel;
+            // Points to hand FMOD (0 to hand the Channel back to its own rolloff)
+            FMOD_VECTOR* pPoints;
+            // Number of points
+            int numberOfPoints;
+            // The rolloff flags to hand back
+            FMOD_MODE rolloffMode;
+        };
+
+    protected:
+        /** @brief getSlot
+          * @param pChannel a Channel
+          * @return first slot to look in for the Channel **/
+        static inline int getSlot(FMOD_CHANNEL* pChannel)
+        {
+            // Mix the handle (Fibonacci hashing) and keep the top bits
+            unsigned long long key = (unsigned long long)(size_t)pChannel * 0x9E3779B97F4A7C15ULL;
+            return (int)(key >> 32) & (ROLLOFFMANAGER_MAX_BINDINGS - 1);
+        }
+        /** @brief findBinding (lock must be held)
+          * @param pChannel a Channel
+          * @return the Channel's binding or 0 **/
+        virtual RolloffBinding* findBinding(FMOD_CHANNEL* pChannel);
+        /** @brief findSlot (lock must be held)
+          * Find the Channel's binding or somewhere to put it
+          * @param pChannel a Channel
+          * @param ppFinished Channels known to have finished (their slots may be taken)
+          * @param numberOfFinished number of finished Channels
+          * @param ppInTheWay receives the bound Channels looked past (up to ROLLOFFMANAGER_MAX_PROBES)
+          * @param numberInTheWay receives the number of them
+          * @param newFlag receives true if the slot holds some other Channel or none
+          * @return the slot or 0 if there is no room **/
+        virtual RolloffBinding* findSlot(FMOD_CHANNEL* pChannel, FMOD_CHANNEL** ppFinished, int numberOfFinished, FMOD_CHANNEL** ppInTheWay, int& numberInTheWay, bool& newFlag);
+        /** @brief applyBinding (lock must be held)
+          * Lay the curve out over the binding's distances in the set of
+          * points FMOD is not reading
+          * @param binding the binding
+          * @return the FMOD calls which hand that set to the Channel **/
+        virtual RolloffUpdate applyBinding(RolloffBinding& binding);
+        /** @brief releaseBinding (lock must be held)
+          * Leave a tombstone in the binding's slot
+          * @param binding the binding
+          * @return the FMOD calls which hand the Channel back to its own rolloff **/
+        virtual RolloffUpdate releaseBinding(RolloffBinding& binding);
+        /** @brief commitUpdate (lock must not be held)
+          * Make the FMOD calls of a binding change
+          * @param update the change **/
+        static void commitUpdate(const RolloffUpdate& update);
+
+    protected:
+        // Curves
+        RolloffCurve curves[ROLLOFFMANAGER_MAX_CURVES];
+        // Curve names
+        std::string names[ROLLOFFMANAGER_MAX_CURVES];
+        // Number of curves
+        int numberOfCurves;
+        // Channel bindings (sized once so a slot never moves while FMOD reads its points)
+        std::vector<RolloffBinding> bindings;
+        // Guards the curves and the bindings
+        std::mutex mutex;
+};
+
+#endif // ROLLOFFMANAGER_H
@@ -22,7 +22,10 @@ Sound::Sound()
 
 Sound::~Sound()
 {
-
+    // Leave the update thread before anything is torn down
+    this->unregisterChannel();
+    // Let go of the SoundSample
+    this->setSoundSample(0);
 }
 
 void Sound::think()
@@ -44,7 +47,7 @@ void Sound::clear()
     this->volume = 1.0f;
     this->volumeRampFlag = false;
     this->priority = 0;
-    this->pSoundSample = 0;
+    this->setSoundSample(0);
     this->pChannel = 0;
     this->filename.clear();
     this->name.clear();
@@ -59,7 +62,7 @@ void Sound::free()
     this->volume = 1.0f;
     this->volumeRampFlag = false;
     this->priority = 0;
-    this->pSoundSample = 0;
+    this->setSoundSample(0);
     this->pChannel = 0;
     this->filename.clear();
     this->name.clear();
@@ -78,8 +81,10 @@ void Sound::play()
         return;
     // Track result of FMOD Function calls
     FMOD_RESULT result;
+    /* NOTE: With deferred commands the channel starts paused and the
+        queue unpauses it once every property below has been applied */
     // Play the sound
-    result = FMOD_System_PlaySound(FMODGlobals::pFMODSystem, this->pSoundSample->getFMODSound(), FMODGlobals::pSoundEffectsChannelGroup, false, &(this->pChannel));
+    result = FMOD_System_PlaySound(FMODGlobals::pFMODSystem, this->pSoundSample->getFMODSound(), FMODGlobals::pSoundEffectsChannelGroup, this->isDeferred(), &(this->pChannel));
     // If playback failed return
     if (result != FMOD_OK)
         return;
@@ -147,6 +152,8 @@ void Sound::stop()
 {
     // Sound is no longer paused so set flag
     this->pausedFlag = false;
+    // Nor virtual (played again it starts from the beginning, not where the VoiceManager would resume it)
+    this->suspendFlags.fetch_and(~CHANNEL_SUSPEND_VIRTUAL);
     // Grab the channe; playing flag
     FMOD_BOOL playingFlag = false;
     FMOD_Channel_IsPlaying(this->pChannel, &playingFlag);
@@ -176,24 +183,33 @@ void Sound::setPaused(bool pausedFlag)
 {
     // Set local paused flag
     this->pausedFlag = pausedFlag;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PAUSED) == true)
+        return;
     // Set channel paused flag
-    FMOD_Channel_SetPaused(this->pChannel, this->pausedFlag);
+    FMOD_Channel_SetPaused(this->pChannel, this->isHeldPaused());
 }
 
 void Sound::pause()
 {
     // Set local paused flag
     this->pausedFlag = true;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PAUSED) == true)
+        return;
     // Set channel paused flag
-    FMOD_Channel_SetPaused(this->pChannel, this->pausedFlag);
+    FMOD_Channel_SetPaused(this->pChannel, this->isHeldPaused());
 }
 
 void Sound::resume()
 {
     // Set local paused flag
     this->pausedFlag = false;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_PAUSED) == true)
+        return;
     // Set channel paused flag
-    FMOD_Channel_SetPaused(this->pChannel, this->pausedFlag);
+    FMOD_Channel_SetPaused(this->pChannel, this->isHeldPaused());
 }
 
 bool Sound::isPlaying()
@@ -551,6 +567,13 @@ SoundSample* Sound::getSoundSample()
 
 void Sound::setSoundSample(SoundSample* pSoundSample)
 {
+    // Hold a reference to the new SoundSample so the AudioManager won't evict it
+    if (pSoundSample != 0)
+        pSoundSample->addReference();
+    // Let go of the old one
+    if (this->pSoundSample != 0)
+        this->pSoundSample->removeReference();
+    // Set local SoundSample
     this->pSoundSample = pSoundSample;
 }
 
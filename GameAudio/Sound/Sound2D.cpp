@@ -23,7 +23,8 @@ Sound2D::Sound2D()
 
 Sound2D::~Sound2D()
 {
-
+    // Leave the update thread before anything is torn down
+    this->unregisterChannel();
 }
 
 void Sound2D::think()
@@ -34,10 +35,20 @@ void Sound2D::think()
 
 void Sound2D::update(float dTime)
 {
-    // Call the base update  method
+    // Call the base update method
     Sound::update(dTime);
-    // Set Position
-    this->setPosition(this->x, this->y);
+    // Work out Velocity from how far we moved (auto velocity)
+    FMOD_VECTOR velocity;
+        velocity.x = this->xVelocity;
+        velocity.y = this->yVelocity;
+        velocity.z = 0.0f;
+    if (this->deriveVelocity(dTime, velocity) == true)
+    {
+        this->xVelocity = velocity.x;
+        this->yVelocity = velocity.y;
+    }
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
 }
 
 void Sound2D::clear()
@@ -89,44 +100,16 @@ void Sound2D::play()
 {
     // Call the base class Play Method
     Sound::play();
-    // Set Position
-    this->setPosition(this->x, this->y);
-    // Set Veocity
-    this->setVelocity(this->xVelocity, this->yVelocity);
-    // Set Min Max Distance
-    this->setMinMaxDistance(this->minDistance, this->maxDistance);
-    // Set Level
-    this->setLevel(this->level);
-    // Set Doppler Level
-    this->setDopplerLevel(this->dopplerLevel);
-    // Set DistanceFilterFlag
-    this->setDistanceFilter(this->distanceFilterFlag);;
-    // Set Custom Level
-    this->setDistanceFilterCustomLevel(this->customLevel);
-    // Set Centre Frequency
-    this->setDistanceFilterCentreFrequency(this->centreFrequency);
+    // Apply every 3D property to the new Channel once
+    this->apply3DProperties();
 }
 
 void Sound2D::playEx()
 {
     // Call the base class PlayEx Method
     Sound::playEx();
-    // Set Position
-    this->setPosition(this->x, this->y);
-    // Set Veocity
-    this->setVelocity(this->xVelocity, this->yVelocity);
-    // Set Min Max Distance
-    this->setMinMaxDistance(this->minDistance, this->maxDistance);
-    // Set Level
-    this->setLevel(this->level);
-    // Set Doppler Level
-    this->setDopplerLevel(this->dopplerLevel);
-    // Set DistanceFilterFlag
-    this->setDistanceFilter(this->distanceFilterFlag);;
-    // Set Custom Level
-    this->setDistanceFilterCustomLevel(this->customLevel);
-    // Set Centre Frequency
-    this->setDistanceFilterCentreFrequency(this->centreFrequency);
+    // Apply every 3D property to the new Channel once
+    this->apply3DProperties();
 }
 
 float Sound2D::getX()
@@ -147,26 +130,8 @@ void Sound2D::setPosition(float x, float y)
     this->x = x;
     // Set Local y
     this->y = y;
-    // Only set Channel Properties when we have a valid channel
-    if (this->pChannel == 0)
-        return;
-    // Position
-    FMOD_VECTOR position;
-        position.x = this->x;
-        position.y = this->y;
-        position.z = 0.0f;
-    // Velocity
-    FMOD_VECTOR velocity;
-        velocity.x = this->xVelocity;
-        velocity.y = this->yVelocity;
-        velocity.z = 0.0f;
-    // AltPanPos
-    FMOD_VECTOR altPanPos;
-        altPanPos.x = 0.0f;
-        altPanPos.y = 0.0f;
-        altPanPos.z = 0.0f;
-    // Set Position of the Channel
-    FMOD_Channel_Set3DAttributes(this->pChannel, &position, &velocity, &altPanPos);
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
 }
 
 float Sound2D::getStartX()
@@ -203,6 +168,12 @@ void Sound2D::setVelocity(float xVelocity, float yVelocity)
     this->xVelocity = xVelocity;
     // Set local yVelocity
     this->yVelocity = yVelocity;
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
+}
+
+void Sound2D::submit3DAttributes(bool forceFlag)
+{
     // Position
     FMOD_VECTOR position;
         position.x = this->x;
@@ -213,13 +184,37 @@ void Sound2D::setVelocity(float xVelocity, float yVelocity)
         velocity.x = this->xVelocity;
         velocity.y = this->yVelocity;
         velocity.z = 0.0f;
-    // AltPanPos
-    FMOD_VECTOR altPanPos;
-        altPanPos.x = 0.0f;
-        altPanPos.y = 0.0f;
-        altPanPos.z = 0.0f;
-    // Set Position of the Channel
-    FMOD_Channel_Set3DAttributes(this->pChannel, &position, &velocity, &altPanPos);
+    // Nothing has moved since FMOD was last told
+    if (forceFlag == false && this->has3DAttributesChanged(position, velocity) == false)
+        return;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DATTRIBUTES) == true)
+    {
+        this->mark3DAttributesSent(position, velocity);
+        return;
+    }
+    // Only set Channel Properties when we have a valid channel
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity of the Channel
+    this->send3DAttributes(position, velocity);
+}
+
+void Sound2D::apply3DProperties()
+{
+    // Only set Channel Properties when we have a valid channel
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity
+    this->submit3DAttributes(true);
+    // Set Min Max Distance
+    FMOD_Channel_Set3DMinMaxDistance(this->pChannel, this->minDistance, this->maxDistance);
+    // Set Level
+    FMOD_Channel_Set3DLevel(this->pChannel, this->level);
+    // Set Doppler Level
+    FMOD_Channel_Set3DDopplerLevel(this->pChannel, this->dopplerLevel);
+    // Set Distance Filter (flag, custom level and centre frequency in one call)
+    FMOD_Channel_Set3DDistanceFilter(this->pChannel, this->distanceFilterFlag, this->customLevel, this->centreFrequency);
 }
 
 float Sound2D::getStartXVelocity()
@@ -360,6 +355,71 @@ float Sound2D::getAudibility()
     return audibility;
 }
 
+float Sound2D::getEstimatedAudibility(const FMOD_VECTOR* pListenerPositions, int numberOfListeners)
+{
+    // Position
+    FMOD_VECTOR position;
+        position.x = this->x;
+        position.y = this->y;
+        position.z = 0.0f;
+    // Estimate volume times distance attenuation
+    return this->estimateAudibility(position, this->minDistance, this->maxDistance, pListenerPositions, numberOfListeners);
+}
+
+bool Sound2D::getEstimatePosition(FMOD_VECTOR& position, float& minDistance, float& maxDistance)
+{
+    // Position
+    position.x = this->x;
+    position.y = this->y;
+    position.z = 0.0f;
+    // Min and Max Distance
+    minDistance = this->minDistance;
+    maxDistance = this->maxDistance;
+    // We have a position
+    return true;
+}
+
+void Sound2D::storeCommand(unsigned int command, ChannelCommandBuffer& buffer)
+{
+    // Copy the local value for the command into the buffer
+    switch (command)
+    {
+        case CHANNEL_COMMAND_3DATTRIBUTES:
+        {
+            // Position
+            buffer.position.x = this->x;
+            buffer.position.y = this->y;
+            buffer.position.z = 0.0f;
+            // Velocity
+            buffer.velocity.x = this->xVelocity;
+            buffer.velocity.y = this->yVelocity;
+            buffer.velocity.z = 0.0f;
+        } break;
+        // Everything else belongs to the Channel
+        default: Channel::storeCommand(command, buffer); break;
+    }
+}
+
+void Sound2D::applyCommands(const ChannelCommandBuffer& buffer)
+{
+    // The channel may have been stopped since the commands were recorded
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity of the Channel
+    if ((buffer.commands & CHANNEL_COMMAND_3DATTRIBUTES) != 0)
+    {
+        // AltPanPos
+        FMOD_VECTOR altPanPos;
+            altPanPos.x = 0.0f;
+            altPanPos.y = 0.0f;
+            altPanPos.z = 0.0f;
+        // Set 3D Attributes
+        FMOD_Channel_Set3DAttributes(this->pChannel, &buffer.position, &buffer.velocity, &altPanPos);
+    }
+    // Apply the Channel commands (paused goes last)
+    Channel::applyCommands(buffer);
+}
+
 //void Sound2D::bindToLua(lua_State* pLuaState)
 //{
 //    // Bind functions to lua state
@@ -1,4 +1,6 @@
 #include "Sound3D.h"
+#include "Geometry/OcclusionService.h"
+#include "Sound/RolloffManager.h"
 
 Sound3D::Sound3D()
 {
@@ -27,11 +29,22 @@ Sound3D::Sound3D()
     this->distanceFilterFlag = false;
     this->customLevel = 1.0f;
     this->centreFrequency = 1500.0f;
+    // Rolloff Curve
+    this->rolloffCurve = -1;
 }
 
 Sound3D::~Sound3D()
 {
-
+    // Leave the update thread before anything is torn down
+    this->unregisterChannel();
+    // Leave the SpatialGrid
+    this->leaveSpatialGrid();
+    // Leave the OcclusionService too
+    if (FMODGlobals::pOcclusionService != 0)
+        FMODGlobals::pOcclusionService->removeChannel(this);
+    // Unbind the Channel from its rolloff curve
+    if (FMODGlobals::pRolloffManager != 0)
+        FMODGlobals::pRolloffManager->unbindChannel(this->pChannel);
 }
 
 void Sound3D::think()
@@ -42,10 +55,24 @@ void Sound3D::think()
 
 void Sound3D::update(float dTime)
 {
-    // Call the base update  method
+    // Call the base update method
     Sound::update(dTime);
-    // Set Position
-    this->setPosition(this->x, this->y, this->z);
+    // Work out Velocity from how far we moved (auto velocity)
+    FMOD_VECTOR velocity;
+        velocity.x = this->xVelocity;
+        velocity.y = this->yVelocity;
+        velocity.z = this->zVelocity;
+    if (this->deriveVelocity(dTime, velocity) == true)
+    {
+        this->xVelocity = velocity.x;
+        this->yVelocity = velocity.y;
+        this->zVelocity = velocity.z;
+    }
+    // Nothing to send while the SpatialGrid has us switched off
+    if (this->isSpatialActive() == false)
+        return;
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
 }
 
 void Sound3D::clear()
@@ -81,6 +108,7 @@ void Sound3D::free()
     this->distanceFilterFlag = false;
     this->customLevel = 1.0f;
     this->centreFrequency = 1500.0f;
+    this->rolloffCurve = -1;
     // Call the base free method
     Sound::free();
 }
@@ -117,80 +145,25 @@ void Sound3D::play()
 {
     // Call the base class Play Method
     Sound::play();
-    // Set Position
-    this->setPosition(this->x, this->y, this->z);
-    // Set Veocity
-    this->setVelocity(this->xVelocity, this->yVelocity, this->zVelocity);
-    // Set Min Max Distance
-    this->setMinMaxDistance(this->minDistance, this->maxDistance);
-    // Set Level
-    this->setLevel(this->level);
-    // Set Doppler Level
-    this->setDopplerLevel(this->dopplerLevel);
-    // Set DistanceFilterFlag
-    this->setDistanceFilter(this->distanceFilterFlag);;
-    // Set Custom Level
-    this->setDistanceFilterCustomLevel(this->customLevel);
-    // Set Centre Frequency
-    this->setDistanceFilterCentreFrequency(this->centreFrequency);
-    // Set 3D ConeSettings
-    this->set3DConeSettings(this->insideConeAngle, outsideConeAngle, outsideVolume);
-    // Set Rotation
-    this->setRotation(this->rotationX, this->rotationY, this->rotationZ);
-    // Set Direct Occlusion
-    this->setDirectOcclusion(this->directOcclusion);
-    // Set Reverb Occlusion
-    this->setReverbOcclusion(this->reverbOcclusion);
-    // Set Level
-    this->setLevel(this->level);
-    // Set Doppler Level
-    this->setDopplerLevel(this->dopplerLevel);
-    // Set Distance Filter
-    this->setDistanceFilter(this->distanceFilterFlag);
-    // Set Distance Filter Custom Level
-    this->setDistanceFilterCustomLevel(this->customLevel);
-    // Set Distance Filter Centre Frequency
-    this->setDistanceFilterCentreFrequency(this->centreFrequency);
+    // Apply every 3D property to the new Channel once
+    this->apply3DProperties();
 }
 
 void Sound3D::playEx()
 {
     // Call the base class PlayEx Method
     Sound::playEx();
-    // Set Position
-    this->setPosition(this->x, this->y, this->z);
-    // Set Veocity
-    this->setVelocity(this->xVelocity, this->yVelocity, this->zVelocity);
-    // Set Min Max Distance
-    this->setMinMaxDistance(this->minDistance, this->maxDistance);
-    // Set Level
-    this->setLevel(this->level);
-    // Set Doppler Level
-    this->setDopplerLevel(this->dopplerLevel);
-    // Set DistanceFilterFlag
-    this->setDistanceFilter(this->distanceFilterFlag);;
-    // Set Custom Level
-    this->setDistanceFilterCustomLevel(this->customLevel);
-    // Set Centre Frequency
-    this->setDistanceFilterCentreFrequency(this->centreFrequency);
-    // Set 3D ConeSettings
-    this->set3DConeSettings(this->insideConeAngle, outsideConeAngle, outsideVolume);
-    // Set Rotation
-    this->setRotation(this->rotationX, this->rotationY, this->rotationZ);
-    // Set Direct Occlusion
-    this->setDirectOcclusion(this->directOcclusion);
-    // Set Reverb Occlusion
-    this->setReverbOcclusion(this->reverbOcclusion);
-    // Set Level
-    this->setLevel(this->level);
-    // Set Doppler Level
-    this->setDopplerLevel(this->dopplerLevel);
-    // Set Distance Filter
-    this->setDistanceFilter(this->distanceFilterFlag);
-    // Set Distance Filter Custom Level
-    this->setDistanceFilterCustomLevel(this->customLevel);
-    // Set Distance Filter Centre Frequency
-    this->setDistanceFilterCentreFrequency(this->centreFrequency);
+    // Apply every 3D property to the new Channel once
+    this->apply3DProperties();
+}
+
+void Sound3D::stop()
+{
+    // Unbind the Channel from its rolloff curve
+    if (FMODGlobals::pRolloffManager != 0)
+        FMODGlobals::pRolloffManager->unbindChannel(this->pChannel);
+    // Call the base class Stop Method
+    Sound::stop();
 }
 
 float Sound3D::getX()
@@ -219,26 +192,10 @@ void Sound3D::setPosition(float x, float y, float z)
     this->y = y;
     // Set Local z
     this->z = z;
-    // Only set Channel Properties when we have a valid channel
-    if (this->pChannel == 0)
-        return;
-    // Position
-    FMOD_VECTOR position;
-        position.x = this->x;
-        position.y = this->y;
-        position.z = this->z;
-    // Velocity
-    FMOD_VECTOR velocity;
-        velocity.x = this->xVelocity;
-        velocity.y = this->yVelocity;
-        velocity.z = this->zVelocity;;
-    // AltPanPos
-    FMOD_VECTOR altPanPos;
-        altPanPos.x = 0.0f;
-        altPanPos.y = 0.0f;
-        altPanPos.z = 0.0f;
-    // Set Position of the Channel
-    FMOD_Channel_Set3DAttributes(this->pChannel, &position, &velocity, &altPanPos);
+    // Move cell in the SpatialGrid
+    this->spatialMoved();
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
 }
 
 float Sound3D::getStartX()
@@ -289,6 +246,12 @@ void Sound3D::setVelocity(float xVelocity, float yVelocity, float zVelocity)
     this->yVelocity = yVelocity;
     // Set local zVelocity
     this->zVelocity = zVelocity;
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
+}
+
+void Sound3D::submit3DAttributes(bool forceFlag)
+{
     // Position
     FMOD_VECTOR position;
         position.x = this->x;
@@ -299,13 +262,104 @@ void Sound3D::setVelocity(float xVelocity, float yVelocity, float zVelocity)
         velocity.x = this->xVelocity;
         velocity.y = this->yVelocity;
         velocity.z = this->zVelocity;
-    // AltPanPos
-    FMOD_VECTOR altPanPos;
-        altPanPos.x = 0.0f;
-        altPanPos.y = 0.0f;
-        altPanPos.z = 0.0f;
-    // Set Position of the Channel
-    FMOD_Channel_Set3DAttributes(this->pChannel, &position, &velocity, &altPanPos);
+    // Nothing has moved since FMOD was last told
+    if (forceFlag == false && this->has3DAttributesChanged(position, velocity) == false)
+        return;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DATTRIBUTES) == true)
+    {
+        this->mark3DAttributesSent(position, velocity);
+        return;
+    }
+    // Only set Channel Properties when we have a valid channel
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity of the Channel
+    this->send3DAttributes(position, velocity);
+}
+
+void Sound3D::apply3DProperties()
+{
+    // Only set Channel Properties when we have a valid channel
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity
+    this->submit3DAttributes(true);
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->isDeferred() == true)
+    {
+        this->deferCommand(CHANNEL_COMMAND_3DMINMAXDISTANCE);
+        this->deferCommand(CHANNEL_COMMAND_3DOCCLUSION);
+        this->deferCommand(CHANNEL_COMMAND_3DLEVEL);
+        this->deferCommand(CHANNEL_COMMAND_3DDOPPLERLEVEL);
+    }
+    else
+    {
+        // Set Min Max Distance
+        FMOD_Channel_Set3DMinMaxDistance(this->pChannel, this->minDistance, this->maxDistance);
+        // Set Direct and Reverb Occlusion
+        FMOD_Channel_Set3DOcclusion(this->pChannel, this->directOcclusion, this->reverbOcclusion);
+        // Set Level
+        FMOD_Channel_Set3DLevel(this->pChannel, this->level);
+        // Set Doppler Level
+        FMOD_Channel_Set3DDopplerLevel(this->pChannel, this->dopplerLevel);
+    }
+    // Set 3D Cone Settings
+    FMOD_Channel_Set3DConeSettings(this->pChannel, this->insideConeAngle, this->outsideConeAngle, this->outsideVolume);
+    // Set Rotation
+    FMOD_VECTOR rotation;
+        rotation.x = this->rotationX;
+        rotation.y = this->rotationY;
+        rotation.z = this->rotationZ;
+    FMOD_Channel_Set3DConeOrientation(this->pChannel, &rotation);
+    // Set Distance Filter (flag, custom level and centre frequency in one call)
+    FMOD_Channel_Set3DDistanceFilter(this->pChannel, this->distanceFilterFlag, this->customLevel, this->centreFrequency);
+    // Bind the new Channel to its rolloff curve
+    this->bindRolloff();
+}
+
+void Sound3D::bindRolloff()
+{
+    // Only bind a valid channel
+    if (this->pChannel == 0 || FMODGlobals::pRolloffManager == 0)
+        return;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DROLLOFF) == true)
+        return;
+    // Bind the Channel (no curve hands it back to the rolloff in mode)
+    FMODGlobals::pRolloffManager->bindChannel(this->pChannel, this->resolveRolloffCurve(), this->minDistance, this->maxDistance);
+}
+
+int Sound3D::resolveRolloffCurve()
+{
+    // Our own curve or the SoundSample's
+    int curve = this->rolloffCurve;
+    if (curve == -1 && this->pSoundSample != 0)
+        curve = this->pSoundSample->getRolloffCurve();
+    // return the curve
+    return curve;
+}
+
+FMOD_VECTOR Sound3D::getSpatialPosition()
+{
+    // Position
+    FMOD_VECTOR position;
+        position.x = this->x;
+        position.y = this->y;
+        position.z = this->z;
+    // return position
+    return position;
+}
+
+void Sound3D::setSpatialActive(bool spatialActiveFlag)
+{
+    // Nothing has changed
+    if (this->spatialActiveFlag == spatialActiveFlag)
+        return;
+    // Set the Spatial Active Flag
+    this->spatialActiveFlag = spatialActiveFlag;
+    // Hold it paused while out of earshot (the game's own pause is a separate flag so it is kept either way)
+    this->setSuspended(CHANNEL_SUSPEND_SPATIAL, (spatialActiveFlag == false));
 }
 
 float Sound3D::getStartXVelocity()
@@ -348,10 +402,38 @@ void Sound3D::setMinMaxDistance(float minDistance, float maxDistance)
     this->minDistance = minDistance;
     // return maxDistance
     this->maxDistance = maxDistance;
+    // The radius in the SpatialGrid is the max distance
+    this->spatialMoved();
+    // The rolloff curve spans the new distances
+    this->bindRolloff();
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DMINMAXDISTANCE) == true)
+        return;
     //  Set MinMax Distance
     FMOD_Channel_Set3DMinMaxDistance(this->pChannel, this->minDistance, this->maxDistance);
 }
 
+void Sound3D::setRolloffCurve(int rolloffCurve)
+{
+    // Set Rolloff Curve
+    this->rolloffCurve = rolloffCurve;
+    // Bind the Channel to the new curve
+    this->bindRolloff();
+}
+
+void Sound3D::setRolloffCurve(const std::string& name)
+{
+    // Find the curve
+    int rolloffCurve = (FMODGlobals::pRolloffManager != 0) ? FMODGlobals::pRolloffManager->findCurve(name) : -1;
+    if (rolloffCurve == -1)
+    {
+        std::cout << "void Sound3D::setRolloffCurve() failure. There is no rolloff curve called " << name << std::endl;
+        return;
+    }
+    // Set Rolloff Curve
+    this->setRolloffCurve(rolloffCurve);
+}
+
 float Sound3D::get3DConeInsideAngle()
 {
     // Return inside cone angle
@@ -425,6 +507,9 @@ void Sound3D::setDirectOcclusion(float directOcclusion)
 {
     // Set local Direct Occlusion
     this->directOcclusion = directOcclusion;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DOCCLUSION) == true)
+        return;
     // Set the Occlusion for the Channel
     FMOD_Channel_Set3DOcclusion(this->pChannel, this->directOcclusion, this->reverbOcclusion);
 }
@@ -439,6 +524,21 @@ void Sound3D::setReverbOcclusion(float reverbOcclusion)
 {
     // Set local Rever Occlusion
     this->reverbOcclusion = reverbOcclusion;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DOCCLUSION) == true)
+        return;
+    // Set the Occlusion for the Channel
+    FMOD_Channel_Set3DOcclusion(this->pChannel, this->directOcclusion, this->reverbOcclusion);
+}
+
+void Sound3D::setOcclusion(float directOcclusion, float reverbOcclusion)
+{
+    // Set local Direct and Reverb Occlusion
+    this->directOcclusion = directOcclusion;
+    this->reverbOcclusion = reverbOcclusion;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DOCCLUSION) == true)
+        return;
     // Set the Occlusion for the Channel
     FMOD_Channel_Set3DOcclusion(this->pChannel, this->directOcclusion, this->reverbOcclusion);
 }
@@ -453,6 +553,9 @@ void Sound3D::setLevel(float level)
 {
     // Set Local Level
     this->level = level;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DLEVEL) == true)
+        return;
     // Set the Level for the Channel
     FMOD_Channel_Set3DLevel(this->pChannel, this->level);
 }
@@ -467,6 +570,9 @@ void Sound3D::setDopplerLevel(float dopplerLevel)
 {
     // Set local doppler level
     this->dopplerLevel = dopplerLevel;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DDOPPLERLEVEL) == true)
+        return;
     // Set Doppler Level
     FMOD_Channel_Set3DDopplerLevel(this->pChannel, dopplerLevel);
 }
@@ -525,6 +631,107 @@ float Sound3D::getAudibility()
     return audibility;
 }
 
+float Sound3D::getEstimatedAudibility(const FMOD_VECTOR* pListenerPositions, int numberOfListeners)
+{
+    // Position
+    FMOD_VECTOR position;
+        position.x = this->x;
+        position.y = this->y;
+        position.z = this->z;
+    // Estimate volume times distance attenuation
+    return this->estimateAudibility(position, this->minDistance, this->maxDistance, pListenerPositions, numberOfListeners);
+}
+
+bool Sound3D::getEstimatePosition(FMOD_VECTOR& position, float& minDistance, float& maxDistance)
+{
+    // Position
+    position.x = this->x;
+    position.y = this->y;
+    position.z = this->z;
+    // Min and Max Distance
+    minDistance = this->minDistance;
+    maxDistance = this->maxDistance;
+    // We have a position
+    return true;
+}
+
+void Sound3D::storeCommand(unsigned int command, ChannelCommandBuffer& buffer)
+{
+    // Copy the local value for the command into the buffer
+    switch (command)
+    {
+        case CHANNEL_COMMAND_3DATTRIBUTES:
+        {
+            // Position
+            buffer.position.x = this->x;
+            buffer.position.y = this->y;
+            buffer.position.z = this->z;
+            // Velocity
+            buffer.velocity.x = this->xVelocity;
+            buffer.velocity.y = this->yVelocity;
+            buffer.velocity.z = this->zVelocity;
+        } break;
+        case CHANNEL_COMMAND_3DMINMAXDISTANCE:
+        {
+            // Min and Max Distance
+            buffer.minDistance = this->minDistance;
+            buffer.maxDistance = this->maxDistance;
+        } break;
+        case CHANNEL_COMMAND_3DOCCLUSION:
+        {
+            // Direct and Reverb Occlusion
+            buffer.directOcclusion = this->directOcclusion;
+            buffer.reverbOcclusion = this->reverbOcclusion;
+        } break;
+        case CHANNEL_COMMAND_3DLEVEL: buffer.level = this->level; break;
+        case CHANNEL_COMMAND_3DDOPPLERLEVEL: buffer.dopplerLevel = this->dopplerLevel; break;
+        case CHANNEL_COMMAND_3DROLLOFF:
+        {
+            // Rolloff Curve and the distances it spans
+            buffer.rolloffCurve = this->resolveRolloffCurve();
+            buffer.minDistance = this->minDistance;
+            buffer.maxDistance = this->maxDistance;
+        } break;
+        // Everything else belongs to the Channel
+        default: Channel::storeCommand(command, buffer); break;
+    }
+}
+
+void Sound3D::applyCommands(const ChannelCommandBuffer& buffer)
+{
+    // The channel may have been stopped since the commands were recorded
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity of the Channel
+    if ((buffer.commands & CHANNEL_COMMAND_3DATTRIBUTES) != 0)
+    {
+        // AltPanPos
+        FMOD_VECTOR altPanPos;
+            altPanPos.x = 0.0f;
+            altPanPos.y = 0.0f;
+            altPanPos.z = 0.0f;
+        // Set 3D Attributes
+        FMOD_Channel_Set3DAttributes(this->pChannel, &buffer.position, &buffer.velocity, &altPanPos);
+    }
+    //  Set MinMax Distance
+    if ((buffer.commands & CHANNEL_COMMAND_3DMINMAXDISTANCE) != 0)
+        FMOD_Channel_Set3DMinMaxDistance(this->pChannel, buffer.minDistance, buffer.maxDistance);
+    // Set the Occlusion for the Channel
+    if ((buffer.commands & CHANNEL_COMMAND_3DOCCLUSION) != 0)
+        FMOD_Channel_Set3DOcclusion(this->pChannel, buffer.directOcclusion, buffer.reverbOcclusion);
+    // Set the Level for the Channel
+    if ((buffer.commands & CHANNEL_COMMAND_3DLEVEL) != 0)
+        FMOD_Channel_Set3DLevel(this->pChannel, buffer.level);
+    // Set Doppler Level
+    if ((buffer.commands & CHANNEL_COMMAND_3DDOPPLERLEVEL) != 0)
+        FMOD_Channel_Set3DDopplerLevel(this->pChannel, buffer.dopplerLevel);
+    // Bind the Channel to its rolloff curve
+    if ((buffer.commands & CHANNEL_COMMAND_3DROLLOFF) != 0 && FMODGlobals::pRolloffManager != 0)
+        FMODGlobals::pRolloffManager->bindChannel(this->pChannel, buffer.rolloffCurve, buffer.minDistance, buffer.maxDistance);
+    // Apply the Channel commands (paused goes last)
+    Channel::applyCommands(buffer);
+}
+
 //void Sound3D::bindToLua(lua_State* pLuaState)
 //{
 //    // Bind functions to lua state
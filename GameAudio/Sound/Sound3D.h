@@ -35,10 +35,11 @@
 #include "Channel/Channel.h"
 #include "Sound/Sound.h"
 #include "Sound/SoundSample.h"
+#include "System/SpatialObject.h"
 
 /** The Sound class is used for a 3D sound source and is effectively a wrapper around a reserved channel
         for an instance of Sound (which is referered to as a channel) **/
-class Sound3D : public Sound
+class Sound3D : public Sound, public SpatialObject
 {
     // ******************************
     // * CONSTRUCTORS / DESTRUCTORS *
@@ -86,6 +87,40 @@ class Sound3D : public Sound
         virtual void play();
         /** @brief Play the sound paused **/
         virtual void playEx();
+        /** @brief Stop the sound **/
+        virtual void stop();
+
+    protected:
+        /** @brief submit3DAttributes
+          * Send Position and Velocity to FMOD if either has moved more than the
+          * 3D attribute epsilon since they were last sent
+          * @param forceFlag true to send whatever (a new Channel) **/
+        virtual void submit3DAttributes(bool forceFlag);
+        /** @brief apply3DProperties
+          * Send every 3D property to a Channel which has just been played, once each **/
+        virtual void apply3DProperties();
+        /** @brief bindRolloff
+          * Tell the RolloffManager which curve and distances the Channel uses **/
+        virtual void bindRolloff();
+        /** @brief resolveRolloffCurve
+          * @return our own curve or else the SoundSample's (-1 for none) **/
+        virtual int resolveRolloffCurve();
+
+    // *********************
+    // * SPATIAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief getSpatialPosition
+          * @return position of the Channel **/
+        virtual FMOD_VECTOR getSpatialPosition();
+        /** @brief getSpatialRadius
+          * @return max distance of the Channel **/
+        virtual float getSpatialRadius() { return this->maxDistance; }
+        /** @brief setSpatialActive (called by the SpatialGrid)
+          * Hold the Channel suspended (CHANNEL_SUSPEND_SPATIAL) while no
+          * listener is within max distance
+          * @param spatialActiveFlag true to switch on, false to switch off **/
+        virtual void setSpatialActive(bool spatialActiveFlag);
 
     // *****************************
     // * SPACIAL CHANNEL FUNCTIONS *
@@ -156,17 +191,15 @@ class Sound3D : public Sound
           * @param minDisance min distance the sound can be heard
           * @param maxDisance min distance the sound can be heard **/
         virtual void setMinMaxDistance(float minDistance, float maxDistance);
-//// NOTE: These functions only work with the FMOD_3D_CUSTOMROLLOFF flag. So I am leaving these unimplemented for now
-//        /** @brief Get 3D Custom RollOff Only works when you
-//            @return Custom Rolloff in conjunction with the FMOD_3D_CUSTOMROLLOFF flag **/
-//        virtual get3DCustomRolloff();
-//        FMOD_RESULT F_API FMOD_Channel_Get3DCustomRolloff(FMOD_CHANNEL *channel, FMOD_VECTOR **points, int *numpoints);
-//        /** @brief Set 3d Custom RollOff. Only works when you
-//          * in conjunction with the FMOD_3D_CUSTOMROLLOFF flag
-//          * @param ...
-//          * @param ... **/
-//        virtual set3DCustomRollOff(float distance, float volume);
-//        FMOD_RESULT F_API FMOD_Channel_Set3DCustomRolloff(FMOD_CHANNEL *channel, FMOD_VECTOR *points, int numpoints);
+        /** @brief Get Rolloff Curve
+          * @return index of the RolloffManager curve or -1 to use the SoundSample's **/
+        virtual int getRolloffCurve() { return this->rolloffCurve; }
+        /** @brief Set Rolloff Curve
+          * @param rolloffCurve index of a RolloffManager curve or -1 to use the SoundSample's **/
+        virtual void setRolloffCurve(int rolloffCurve);
+        /** @brief Set Rolloff Curve
+          * @param name name of a RolloffManager curve **/
+        virtual void setRolloffCurve(const std::string& name);
         /** @brief Get Inside Cone Angle
           * @return Inside Code Angle in degrees **/
         virtual float get3DConeInsideAngle();
@@ -207,6 +240,10 @@ class Sound3D : public Sound
         /** @brief Set Reverb Occlusion (0.0 not occluded 1.0 occluded; default 0.0)
           * @param reverbOcclusion **/
         virtual void setReverbOcclusion(float reverbOcclusion);
+        /** @brief Set Direct and Reverb Occlusion with one call (used by the OcclusionService)
+          * @param directOcclusion
+          * @param reverbOcclusion **/
+        virtual void setOcclusion(float directOcclusion, float reverbOcclusion);
         /** @brief getLevel Gets how much the 3D engine has an effect on the channel, versus that set by 2D panning functions.
           * @return level level from 0.0 (attenuation is ignored and panning as set by 2D panning functions) to 1.0 (pan and attenuate according to 3D position), default = 1.0**/
         virtual float getLevel();
@@ -244,6 +281,28 @@ class Sound3D : public Sound
           * @return returns the combined volume after 3D spatialization
           * and geometry occlusion calculations including any volumes set via the API **/
         virtual float getAudibility();
+        /** @brief getEstimatedAudibility
+          * @param pListenerPositions positions of the listeners
+          * @param numberOfListeners number of listeners
+          * @return audibility estimated from volume, distance and rolloff **/
+        virtual float getEstimatedAudibility(const FMOD_VECTOR* pListenerPositions, int numberOfListeners);
+        /** @brief getEstimatePosition
+          * @param position receives the position
+          * @param minDistance receives the min distance
+          * @param maxDistance receives the max distance
+          * @return true **/
+        virtual bool getEstimatePosition(FMOD_VECTOR& position, float& minDistance, float& maxDistance);
+
+    protected:
+        /** @brief storeCommand
+          * Copy the local value for a 3D command into a command buffer
+          * @param command one of the CHANNEL_COMMAND flags
+          * @param buffer the command buffer to write into **/
+        virtual void storeCommand(unsigned int command, ChannelCommandBuffer& buffer);
+        /** @brief applyCommands
+          * Send the 3D commands to FMOD then the Channel commands
+          * @param buffer the command buffer to apply **/
+        virtual void applyCommands(const ChannelCommandBuffer& buffer);
 
     protected:
         // x
@@ -300,6 +359,8 @@ class Sound3D : public Sound
         float customLevel;
         // centre frequency
         float centreFrequency;
+        // Rolloff Curve (-1 for the SoundSample's)
+        int rolloffCurve;
 
 //    // ****************
 //    // * LUA BINDINGS *
@@ -1,4 +1,5 @@
 #include "SoundSample.h"
+#include "Sound/RolloffManager.h"
 
 SoundSample::SoundSample()
 {
@@ -6,6 +7,14 @@ SoundSample::SoundSample()
     this->pFMODSound = 0;
     // Filename
     this->filename.clear();
+    // Rolloff Curve
+    this->rolloffCurve = -1;
+    // Reference Count
+    this->referenceCount.store(0);
+    // Pinned Flag
+    this->pinnedFlag = false;
+    // Last Used
+    this->lastUsed = 0;
 }
 
 SoundSample::~SoundSample()
@@ -121,6 +130,19 @@ void SoundSample::set3DConeSettings(float insideConeAngle, float outsideConeAngl
     FMOD_Sound_Set3DConeSettings(this->pFMODSound, insideConeAngle, outsideConeAngle, outsiderVolume);
 }
 
+void SoundSample::setRolloffCurve(const std::string& name)
+{
+    // Find the curve
+    int rolloffCurve = (FMODGlobals::pRolloffManager != 0) ? FMODGlobals::pRolloffManager->findCurve(name) : -1;
+    if (rolloffCurve == -1)
+    {
+        std::cout << "void SoundSample::setRolloffCurve() failure. There is no rolloff curve called " << name << std::endl;
+        return;
+    }
+    // Set Rolloff Curve
+    this->rolloffCurve = rolloffCurve;
+}
+
 FMOD_SOUND* SoundSample::getSubSound(int index)
 {
     // Grab FMOD_SOUND
@@ -175,6 +197,39 @@ unsigned int SoundSample::getSizeInBytes()
     return length;
 }
 
+unsigned int SoundSample::getMemoryUsage()
+{
+    // Compressed samples stay in their file format
+    if ((this->getMode() & FMOD_CREATECOMPRESSEDSAMPLE) != 0)
+        return this->getSizeInBytes();
+    // Streams only hold their decode buffers
+    if ((this->getMode() & FMOD_CREATESTREAM) != 0)
+        return 0;
+    // Everything else is decoded to PCM
+    unsigned int length = 0;
+    FMOD_Sound_GetLength(this->pFMODSound, &length, FMOD_TIMEUNIT_PCMBYTES);
+    // return length
+    return length;
+}
+
+FMOD_OPENSTATE SoundSample::getOpenState()
+{
+    // No sound means there is nothing to load
+    if (this->pFMODSound == 0)
+        return FMOD_OPENSTATE_ERROR;
+    // Grab Open State
+    FMOD_OPENSTATE openState = FMOD_OPENSTATE_ERROR;
+    FMOD_Sound_GetOpenState(this->pFMODSound, &openState, 0, 0, 0);
+    // return openState
+    return openState;
+}
+
+bool SoundSample::isReady()
+{
+    // Ready when FMOD has finished opening the sound
+    return (this->getOpenState() == FMOD_OPENSTATE_READY);
+}
+
 FMOD_SOUND_TYPE SoundSample::getType()
 {
     // Grab Type
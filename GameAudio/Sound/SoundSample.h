@@ -2,6 +2,7 @@
 #define SOUNDSAMPLE_H
 
 // C++ Includes
+#include <atomic>
 #include <iostream>
 
 // FMOD Includes
@@ -105,9 +106,15 @@ class SoundSample
           * @param outsideConeAngle angle of the outer cone in degrees
           * @param outsideVolume between 0.0 and 1.0 (default is 1.0) **/
         virtual void set3DConeSettings(float insideConeAngle, float outsideConeAngle, float outsiderVolume);
-        // These functions only work with the FMOD_3D_CUSTOMROLLOFF flag. So I am leaving these unimplemented for now
-        //FMOD_RESULT F_API FMOD_Sound_Set3DCustomRolloff         (FMOD_SOUND *sound, FMOD_VECTOR *points, int numpoints);
-        //FMOD_RESULT F_API FMOD_Sound_Get3DCustomRolloff         (FMOD_SOUND *sound, FMOD_VECTOR **points, int *numpoints);
+        /** @brief Get Rolloff Curve
+          * @return index of the RolloffManager curve the sound is played with or -1 **/
+        virtual int getRolloffCurve() { return this->rolloffCurve; }
+        /** @brief Set Rolloff Curve (Sound3Ds and voices started after this use it)
+          * @param rolloffCurve index of a RolloffManager curve or -1 for the rolloff in mode **/
+        virtual void setRolloffCurve(int rolloffCurve) { this->rolloffCurve = rolloffCurve; }
+        /** @brief Set Rolloff Curve
+          * @param name name of a RolloffManager curve **/
+        virtual void setRolloffCurve(const std::string& name);
         /** @brief getSubSound
           * @param index index of the subsound to get
           * @return subsound as an FMOD_SOUND object **/
@@ -150,8 +157,13 @@ class SoundSample
           * @param index of the Tag
           * @return FMOD_TAG associated with the index **/
         virtual FMOD_TAG getTag(int index);
-        // I don't think this function is necessary
-        //FMOD_RESULT F_API FMOD_Sound_GetOpenState               (FMOD_SOUND *sound, FMOD_OPENSTATE *openstate, unsigned int *percentbuffered, FMOD_BOOL *starving, FMOD_BOOL *diskbusy);
+        /** @brief getOpenState
+          * @return FMOD_OPENSTATE_READY once a sound created with FMOD_NONBLOCKING
+          * has finished loading, FMOD_OPENSTATE_ERROR if it failed **/
+        virtual FMOD_OPENSTATE getOpenState();
+        /** @brief isReady
+          * @return true if the sound has finished loading and can be played **/
+        virtual bool isReady();
         /** @brief readData
           * @param pBuffer
           * @param lengthBytes
@@ -234,6 +246,47 @@ class SoundSample
     protected:
         // Sound filename
         std::string filename;
+        // Rolloff Curve
+        int rolloffCurve;
+
+    // *****************************
+    // * CACHE AND REFERENCE COUNT *
+    // *****************************
+    public:
+        /** @brief addReference
+          * Tell the SoundSample something (a Sound, a voice) is using it. The
+          * AudioManager never evicts a SoundSample with references **/
+        virtual void addReference() { this->referenceCount.fetch_add(1); }
+        /** @brief removeReference
+          * Tell the SoundSample one of its users has finished with it **/
+        virtual void removeReference() { this->referenceCount.fetch_sub(1); }
+        /** @brief getReferenceCount
+          * @return the number of users of the SoundSample **/
+        virtual int getReferenceCount() { return this->referenceCount.load(); }
+        /** @brief isPinned
+          * @return true if the AudioManager must never evict this SoundSample **/
+        virtual bool isPinned() { return this->pinnedFlag; }
+        /** @brief setPinned
+          * @param pinnedFlag true to keep the SoundSample loaded whatever the memory budget **/
+        virtual void setPinned(bool pinnedFlag) { this->pinnedFlag = pinnedFlag; }
+        /** @brief getMemoryUsage
+          * @return bytes of sample memory the sound uses (decoded PCM size for
+          * samples, the compressed size for FMOD_CREATECOMPRESSEDSAMPLE) **/
+        virtual unsigned int getMemoryUsage();
+        /** @brief getLastUsed
+          * @return tick of the AudioManager when this SoundSample was last asked for **/
+        virtual unsigned long long getLastUsed() { return this->lastUsed; }
+        /** @brief setLastUsed
+          * @param lastUsed tick of the AudioManager **/
+        virtual void setLastUsed(unsigned long long lastUsed) { this->lastUsed = lastUsed; }
+
+    protected:
+        // Reference Count
+        std::atomic<int> referenceCount;
+        // Pinned Flag
+        bool pinnedFlag;
+        // Last Used (AudioManager tick)
+        unsigned long long lastUsed;
 
 //    // ****************
 //    // * LUA BINDINGS *
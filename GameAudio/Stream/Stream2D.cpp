@@ -23,7 +23,8 @@ Stream2D::Stream2D()
 
 Stream2D::~Stream2D()
 {
-
+    // Leave the update thread before anything is torn down
+    this->unregisterChannel();
 }
 
 Stream2D::Stream2D(const Stream2D& other) : Stream()
@@ -46,18 +47,25 @@ bool Stream2D::load(std::string filename)
         // Free any audio
         this->free();
     }
-    // Track Result of calling FMOD Functions
-    FMOD_RESULT result;
-    // Create the FMODSound
-    result = FMOD_System_CreateStream(FMODGlobals::pFMODSystem, filename.c_str(), FMOD_LOOP_NORMAL | FMOD_3D, 0, &(this->pFMODSound));
-    // If there was a problem
-    if (result != FMOD_OK)
+    // Take a pre-opened stream from the StreamPool if it has one
+    if (this->acquirePooledSound(filename, FMOD_LOOP_NORMAL | FMOD_3D) == false)
     {
-        // Send a message to the console
-        std::cout << "ERROR: Unable to load stream: " << filename.c_str() << std::endl;
-        std::cout << FMOD_ErrorString(result) << std::endl;
-        // Failure
-        return false;
+        // Track Result of calling FMOD Functions
+        FMOD_RESULT result;
+        // Tag the file as a stream (its async reads are refilled ahead of loads)
+        FMOD_CREATESOUNDEXINFO exinfo;
+        AudioFileSystem::getStreamExInfo(exinfo);
+        // Create the FMODSound
+        result = FMOD_System_CreateStream(FMODGlobals::pFMODSystem, filename.c_str(), FMOD_LOOP_NORMAL | FMOD_3D, &exinfo, &(this->pFMODSound));
+        // If there was a problem
+        if (result != FMOD_OK)
+        {
+            // Send a message to the console
+            std::cout << "ERROR: Unable to load stream: " << filename.c_str() << std::endl;
+            std::cout << FMOD_ErrorString(result) << std::endl;
+            // Failure
+            return false;
+        }
     }
     // Send a message to the console
     std::cout << "bool Stream::load((" << filename.c_str() << ")" << std::endl;
@@ -78,8 +86,18 @@ void Stream2D::update(float dTime)
 {
     // Call the base update method
     Stream::update(dTime);
-    // Set Position
-    this->setPosition(this->x, this->y);
+    // Work out Velocity from how far we moved (auto velocity)
+    FMOD_VECTOR velocity;
+        velocity.x = this->xVelocity;
+        velocity.y = this->yVelocity;
+        velocity.z = 0.0f;
+    if (this->deriveVelocity(dTime, velocity) == true)
+    {
+        this->xVelocity = velocity.x;
+        this->yVelocity = velocity.y;
+    }
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
 }
 
 void Stream2D::clear()
@@ -131,44 +149,16 @@ void Stream2D::play()
 {
     // Call the base class Play Method
     Stream::play();
-    // Set Position
-    this->setPosition(this->x, this->y);
-    // Set Veocity
-    this->setVelocity(this->xVelocity, this->yVelocity);
-    // Set Min Max Distance
-    this->setMinMaxDistance(this->minDistance, this->maxDistance);
-    // Set Level
-    this->setLevel(this->level);
-    // Set Doppler Level
-    this->setDopplerLevel(this->dopplerLevel);
-    // Set DistanceFilterFlag
-    this->setDistanceFilter(this->distanceFilterFlag);;
-    // Set Custom Level
-    this->setDistanceFilterCustomLevel(this->customLevel);
-    // Set Centre Frequency
-    this->setDistanceFilterCentreFrequency(this->centreFrequency);
+    // Apply every 3D property to the new Channel once
+    this->apply3DProperties();
 }
 
 void Stream2D::playEx()
 {
-    // Call the base class Play Method
+    // Call the base class PlayEx Method
     Stream::playEx();
-    // Set Position
-    this->setPosition(this->x, this->y);
-    // Set Veocity
-    this->setVelocity(this->xVelocity, this->yVelocity);
-    // Set Min Max Distance
-    this->setMinMaxDistance(this->minDistance, this->maxDistance);
-    // Set Level
-    this->setLevel(this->level);
-    // Set Doppler Level
-    this->setDopplerLevel(this->dopplerLevel);
-    // Set DistanceFilterFlag
-    this->setDistanceFilter(this->distanceFilterFlag);;
-    // Set Custom Level
-    this->setDistanceFilterCustomLevel(this->customLevel);
-    // Set Centre Frequency
-    this->setDistanceFilterCentreFrequency(this->centreFrequency);
+    // Apply every 3D property to the new Channel once
+    this->apply3DProperties();
 }
 
 float Stream2D::getX()
@@ -189,26 +179,8 @@ void Stream2D::setPosition(float x, float y)
     this->x = x;
     // Set Local y
     this->y = y;
-    // Only set Channel Properties when we have a valid channel
-    if (this->pChannel == 0)
-        return;
-    // Position
-    FMOD_VECTOR position;
-        position.x = this->x;
-        position.y = this->y;
-        position.z = 0.0f;
-    // Velocity
-    FMOD_VECTOR velocity;
-        velocity.x = this->xVelocity;
-        velocity.y = this->yVelocity;
-        velocity.z = 0.0f;
-    // AltPanPos
-    FMOD_VECTOR altPanPos;
-        altPanPos.x = 0.0f;
-        altPanPos.y = 0.0f;
-        altPanPos.z = 0.0f;
-    // Set Position of the Channel
-    FMOD_Channel_Set3DAttributes(this->pChannel, &position, &velocity, &altPanPos);
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
 }
 
 float Stream2D::getStartX()
@@ -245,6 +217,12 @@ void Stream2D::setVelocity(float xVelocity, float yVelocity)
     this->xVelocity = xVelocity;
     // Set local yVelocity
     this->yVelocity = yVelocity;
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
+}
+
+void Stream2D::submit3DAttributes(bool forceFlag)
+{
     // Position
     FMOD_VECTOR position;
         position.x = this->x;
@@ -255,13 +233,37 @@ void Stream2D::setVelocity(float xVelocity, float yVelocity)
         velocity.x = this->xVelocity;
         velocity.y = this->yVelocity;
         velocity.z = 0.0f;
-    // AltPanPos
-    FMOD_VECTOR altPanPos;
-        altPanPos.x = 0.0f;
-        altPanPos.y = 0.0f;
-        altPanPos.z = 0.0f;
-    // Set Position of the Channel
-    FMOD_Channel_Set3DAttributes(this->pChannel, &position, &velocity, &altPanPos);
+    // Nothing has moved since FMOD was last told
+    if (forceFlag == false && this->has3DAttributesChanged(position, velocity) == false)
+        return;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DATTRIBUTES) == true)
+    {
+        this->mark3DAttributesSent(position, velocity);
+        return;
+    }
+    // Only set Channel Properties when we have a valid channel
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity of the Channel
+    this->send3DAttributes(position, velocity);
+}
+
+void Stream2D::apply3DProperties()
+{
+    // Only set Channel Properties when we have a valid channel
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity
+    this->submit3DAttributes(true);
+    // Set Min Max Distance
+    FMOD_Channel_Set3DMinMaxDistance(this->pChannel, this->minDistance, this->maxDistance);
+    // Set Level
+    FMOD_Channel_Set3DLevel(this->pChannel, this->level);
+    // Set Doppler Level
+    FMOD_Channel_Set3DDopplerLevel(this->pChannel, this->dopplerLevel);
+    // Set Distance Filter (flag, custom level and centre frequency in one call)
+    FMOD_Channel_Set3DDistanceFilter(this->pChannel, this->distanceFilterFlag, this->customLevel, this->centreFrequency);
 }
 
 float Stream2D::getStartXVelocity()
@@ -400,6 +402,71 @@ float Stream2D::getAudibility()
     return audibility;
 }
 
+float Stream2D::getEstimatedAudibility(const FMOD_VECTOR* pListenerPositions, int numberOfListeners)
+{
+    // Position
+    FMOD_VECTOR position;
+        position.x = this->x;
+        position.y = this->y;
+        position.z = 0.0f;
+    // Estimate volume times distance attenuation
+    return this->estimateAudibility(position, this->minDistance, this->maxDistance, pListenerPositions, numberOfListeners);
+}
+
+bool Stream2D::getEstimatePosition(FMOD_VECTOR& position, float& minDistance, float& maxDistance)
+{
+    // Position
+    position.x = this->x;
+    position.y = this->y;
+    position.z = 0.0f;
+    // Min and Max Distance
+    minDistance = this->minDistance;
+    maxDistance = this->maxDistance;
+    // We have a position
+    return true;
+}
+
+void Stream2D::storeCommand(unsigned int command, ChannelCommandBuffer& buffer)
+{
+    // Copy the local value for the command into the buffer
+    switch (command)
+    {
+        case CHANNEL_COMMAND_3DATTRIBUTES:
+        {
+            // Position
+            buffer.position.x = this->x;
+            buffer.position.y = this->y;
+            buffer.position.z = 0.0f;
+            // Velocity
+            buffer.velocity.x = this->xVelocity;
+            buffer.velocity.y = this->yVelocity;
+            buffer.velocity.z = 0.0f;
+        } break;
+        // Everything else belongs to the Channel
+        default: Channel::storeCommand(command, buffer); break;
+    }
+}
+
+void Stream2D::applyCommands(const ChannelCommandBuffer& buffer)
+{
+    // The channel may have been stopped since the commands were recorded
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity of the Channel
+    if ((buffer.commands & CHANNEL_COMMAND_3DATTRIBUTES) != 0)
+    {
+        // AltPanPos
+        FMOD_VECTOR altPanPos;
+            altPanPos.x = 0.0f;
+            altPanPos.y = 0.0f;
+            altPanPos.z = 0.0f;
+        // Set 3D Attributes
+        FMOD_Channel_Set3DAttributes(this->pChannel, &buffer.position, &buffer.velocity, &altPanPos);
+    }
+    // Apply the Channel commands (paused goes last)
+    Channel::applyCommands(buffer);
+}
+
 //void Stream2D::bindToLua(lua_State* pLuaState)
 //{
 //    // Bind functions to lua state
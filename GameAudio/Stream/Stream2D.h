@@ -92,6 +92,16 @@ class Stream2D : public Stream
     protected:
         // members and methods
 
+    protected:
+        /** @brief submit3DAttributes
+          * Send Position and Velocity to FMOD if either has moved more than the
+          * 3D attribute epsilon since they were last sent
+          * @param forceFlag true to send whatever (a new Channel) **/
+        virtual void submit3DAttributes(bool forceFlag);
+        /** @brief apply3DProperties
+          * Send every 3D property to a Channel which has just been played, once each **/
+        virtual void apply3DProperties();
+
     // *****************************
     // * SPACIAL CHANNEL FUNCTIONS *
     // *****************************
@@ -200,6 +210,28 @@ class Stream2D : public Stream
           * @return returns the combined volume after 3D spatialization
           * and geometry occlusion calculations including any volumes set via the API **/
         virtual float getAudibility();
+        /** @brief getEstimatedAudibility
+          * @param pListenerPositions positions of the listeners
+          * @param numberOfListeners number of listeners
+          * @return audibility estimated from volume, distance and rolloff **/
+        virtual float getEstimatedAudibility(const FMOD_VECTOR* pListenerPositions, int numberOfListeners);
+        /** @brief getEstimatePosition
+          * @param position receives the position
+          * @param minDistance receives the min distance
+          * @param maxDistance receives the max distance
+          * @return true **/
+        virtual bool getEstimatePosition(FMOD_VECTOR& position, float& minDistance, float& maxDistance);
+
+    protected:
+        /** @brief storeCommand
+          * Copy the local value for a 3D command into a command buffer
+          * @param command one of the CHANNEL_COMMAND flags
+          * @param buffer the command buffer to write into **/
+        virtual void storeCommand(unsigned int command, ChannelCommandBuffer& buffer);
+        /** @brief applyCommands
+          * Send the 3D commands to FMOD then the Channel commands
+          * @param buffer the command buffer to apply **/
+        virtual void applyCommands(const ChannelCommandBuffer& buffer);
         //FMOD_RESULT F_API FMOD_Channel_GetAudibility            (FMOD_CHANNEL *channel, float *audibility);
 
     protected:
@@ -1,4 +1,6 @@
 #include "Stream3D.h"
+#include "Geometry/OcclusionService.h"
+#include "Sound/RolloffManager.h"
 
 Stream3D::Stream3D()
 {
@@ -27,11 +29,22 @@ Stream3D::Stream3D()
     this->distanceFilterFlag = false;
     this->customLevel = 1.0f;
     this->centreFrequency = 1500.0f;
+    // Rolloff Curve
+    this->rolloffCurve = -1;
 }
 
 Stream3D::~Stream3D()
 {
-
+    // Leave the update thread before anything is torn down
+    this->unregisterChannel();
+    // Leave the SpatialGrid
+    this->leaveSpatialGrid();
+    // Leave the OcclusionService too
+    if (FMODGlobals::pOcclusionService != 0)
+        FMODGlobals::pOcclusionService->removeChannel(this);
+    // Unbind the Channel from its rolloff curve
+    if (FMODGlobals::pRolloffManager != 0)
+        FMODGlobals::pRolloffManager->unbindChannel(this->pChannel);
 }
 
 Stream3D::Stream3D(const Stream3D& other)  : Stream()
@@ -54,18 +67,25 @@ bool Stream3D::load(std::string filename)
         // Free any audio
         this->free();
     }
-    // Track Result of calling FMOD Functions
-    FMOD_RESULT result;
-    // Create the FMODSound
-    result = FMOD_System_CreateStream(FMODGlobals::pFMODSystem, filename.c_str(), FMOD_LOOP_NORMAL | FMOD_3D, 0, &(this->pFMODSound));
-    // If there was a problem
-    if (result != FMOD_OK)
+    // Take a pre-opened stream from the StreamPool if it has one
+    if (this->acquirePooledSound(filename, FMOD_LOOP_NORMAL | FMOD_3D) == false)
     {
-        // Send a message to the console
-        std::cout << "ERROR: Unable to load stream: " << filename.c_str() << std::endl;
-        std::cout << FMOD_ErrorString(result) << std::endl;
-        // Failure
-        return false;
+        // Track Result of calling FMOD Functions
+        FMOD_RESULT result;
+        // Tag the file as a stream (its async reads are refilled ahead of loads)
+        FMOD_CREATESOUNDEXINFO exinfo;
+        AudioFileSystem::getStreamExInfo(exinfo);
+        // Create the FMODSound
+        result = FMOD_System_CreateStream(FMODGlobals::pFMODSystem, filename.c_str(), FMOD_LOOP_NORMAL | FMOD_3D, &exinfo, &(this->pFMODSound));
+        // If there was a problem
+        if (result != FMOD_OK)
+        {
+            // Send a message to the console
+            std::cout << "ERROR: Unable to load stream: " << filename.c_str() << std::endl;
+            std::cout << FMOD_ErrorString(result) << std::endl;
+            // Failure
+            return false;
+        }
     }
     // Send a message to the console
     std::cout << "bool Stream::load((" << filename.c_str() << ")" << std::endl;
@@ -86,8 +106,22 @@ void Stream3D::update(float dTime)
 {
     // Call the base update method
     Stream::update(dTime);
-    // Set Position
-    this->setPosition(this->x, this->y, this->z);
+    // Work out Velocity from how far we moved (auto velocity)
+    FMOD_VECTOR velocity;
+        velocity.x = this->xVelocity;
+        velocity.y = this->yVelocity;
+        velocity.z = this->zVelocity;
+    if (this->deriveVelocity(dTime, velocity) == true)
+    {
+        this->xVelocity = velocity.x;
+        this->yVelocity = velocity.y;
+        this->zVelocity = velocity.z;
+    }
+    // Nothing to send while the SpatialGrid has us switched off
+    if (this->isSpatialActive() == false)
+        return;
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
 }
 
 void Stream3D::clear()
@@ -123,6 +157,7 @@ void Stream3D::free()
     this->distanceFilterFlag = false;
     this->customLevel = 1.0f;
     this->centreFrequency = 1500.0f;
+    this->rolloffCurve = -1;
     // Call free from the base Class
     Stream::free();
 }
@@ -159,60 +194,25 @@ void Stream3D::play()
 {
     // Call the base class Play Method
     Stream::play();
-    // Set Position
-    this->setPosition(this->x, this->y, this->z);
-    // Set Veocity
-    this->setVelocity(this->xVelocity, this->yVelocity, this->zVelocity);
-    // Set Min Max Distance
-    this->setMinMaxDistance(this->minDistance, this->maxDistance);
-    // Set 3D ConeSettings
-    this->set3DConeSettings(this->insideConeAngle, outsideConeAngle, outsideVolume);
-    // Set Rotation
-    this->setRotation(this->rotationX, this->rotationY, this->rotationZ);
-    // Set Direct Occlusion
-    this->setDirectOcclusion(this->directOcclusion);
-    // Set Reverb Occlusion
-    this->setReverbOcclusion(this->reverbOcclusion);
-    // Set Level
-    this->setLevel(this->level);
-    // Set Doppler Level
-    this->setDopplerLevel(this->dopplerLevel);
-    // Set Distance Filter
-    this->setDistanceFilter(this->distanceFilterFlag);
-    // Set Distance Filter Custom Level
-    this->setDistanceFilterCustomLevel(this->customLevel);
-    // Set Distance Filter Centre Frequency
-    this->setDistanceFilterCentreFrequency(this->centreFrequency);
+    // Apply every 3D property to the new Channel once
+    this->apply3DProperties();
 }
 
 void Stream3D::playEx()
 {
     // Call the base class PlayEx Method
     Stream::playEx();
-    // Set Position
-    this->setPosition(this->x, this->y, this->z);
-    // Set Veocity
-    this->setVelocity(this->xVelocity, this->yVelocity, this->zVelocity);
-    // Set Min Max Distance
-    this->setMinMaxDistance(this->minDistance, this->maxDistance);
-    // Set 3D ConeSettings
-    this->set3DConeSettings(this->insideConeAngle, outsideConeAngle, outsideVolume);
-    // Set Rotation
-    this->setRotation(this->rotationX, this->rotationY, this->rotationZ);
-    // Set Direct Occlusion
-    this->setDirectOcclusion(this->directOcclusion);
-    // Set Reverb Occlusion
-    this->setReverbOcclusion(this->reverbOcclusion);
-    // Set Level
-    this->setLevel(this->level);
-    // Set Doppler Level
-    this->setDopplerLevel(this->dopplerLevel);
-    // Set Distance Filter
-    this->setDistanceFilter(this->distanceFilterFlag);
-    // Set Distance Filter Custom Level
-    this->setDistanceFilterCustomLevel(this->customLevel);
-    // Set Distance Filter Centre Frequency
-    this->setDistanceFilterCentreFrequency(this->centreFrequency);
+    // Apply every 3D property to the new Channel once
+    this->apply3DProperties();
+}
+
+void Stream3D::stop()
+{
+    // Unbind the Channel from its rolloff curve
+    if (FMODGlobals::pRolloffManager != 0)
+        FMODGlobals::pRolloffManager->unbindChannel(this->pChannel);
+    // Call the base class Stop Method
+    Stream::stop();
 }
 
 float Stream3D::getX()
@@ -241,26 +241,10 @@ void Stream3D::setPosition(float x, float y, float z)
     this->y = y;
     // Set Local z
     this->z = z;
-    // Only set Channel Properties when we have a valid channel
-    if (this->pChannel == 0)
-        return;
-    // Position
-    FMOD_VECTOR position;
-        position.x = this->x;
-        position.y = this->y;
-        position.z = 0.0f;
-    // Velocity
-    FMOD_VECTOR velocity;
-        velocity.x = this->xVelocity;
-        velocity.y = this->yVelocity;
-        velocity.z = 0.0f;
-    // AltPanPos
-    FMOD_VECTOR altPanPos;
-        altPanPos.x = 0.0f;
-        altPanPos.y = 0.0f;
-        altPanPos.z = 0.0f;
-    // Set Position of the Channel
-    FMOD_Channel_Set3DAttributes(this->pChannel, &position, &velocity, &altPanPos);
+    // Move cell in the SpatialGrid
+    this->spatialMoved();
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
 }
 
 float Stream3D::getStartX()
@@ -309,6 +293,14 @@ void Stream3D::setVelocity(float xVelocity, float yVelocity, float zVelocity)
     this->xVelocity = xVelocity;
     // Set local yVelocity
     this->yVelocity = yVelocity;
+    // Set local zVelocity
+    this->zVelocity = zVelocity;
+    // Send Position and Velocity if they have changed
+    this->submit3DAttributes(false);
+}
+
+void Stream3D::submit3DAttributes(bool forceFlag)
+{
     // Position
     FMOD_VECTOR position;
         position.x = this->x;
@@ -319,13 +311,80 @@ void Stream3D::setVelocity(float xVelocity, float yVelocity, float zVelocity)
         velocity.x = this->xVelocity;
         velocity.y = this->yVelocity;
         velocity.z = this->zVelocity;
-    // AltPanPos
-    FMOD_VECTOR altPanPos;
-        altPanPos.x = 0.0f;
-        altPanPos.y = 0.0f;
-        altPanPos.z = 0.0f;
-    // Set Position of the Channel
-    FMOD_Channel_Set3DAttributes(this->pChannel, &position, &velocity, &altPanPos);
+    // Nothing has moved since FMOD was last told
+    if (forceFlag == false && this->has3DAttributesChanged(position, velocity) == false)
+        return;
+    // Defer to the next AudioSystem::update() when the command queue is on
+    if (this->deferCommand(CHANNEL_COMMAND_3DATTRIBUTES) == true)
+    {
+        this->mark3DAttributesSent(position, velocity);
+        return;
+    }
+    // Only set Channel Properties when we have a valid channel
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity of the Channel
+    this->send3DAttributes(position, velocity);
+}
+
+void Stream3D::apply3DProperties()
+{
+    // Only set Channel Properties when we have a valid channel
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity
+    this->submit3DAttributes(true);
+    // Set Min Max Distance
+    FMOD_Channel_Set3DMinMaxDistance(this->pChannel, this->minDistance, this->maxDistance);
+    // Set Direct and Reverb Occlusion
+    FMOD_Channel_Set3DOcclusion(this->pChannel, this->directOcclusion, this->reverbOcclusion);
+    // Set Level
+    FMOD_Channel_Set3DLevel(this->pChannel, this->level);
+    // Set Doppler Level
+    FMOD_Channel_Set3DDopplerLevel(this->pChannel, this->dopplerLevel);
+    // Set 3D Cone Settings
+    FMOD_Channel_Set3DConeSettings(this->pChannel, this->insideConeAngle, this->outsideConeAngle, this->outsideVolume);
+    // Set Rotation
+    FMOD_VECTOR rotation;
+        rotation.x = this->rotationX;
+        rotation.y = this->rotationY;
+        rotation.z = this->rotationZ;
+    FMOD_Channel_Set3DConeOrientation(this->pChannel, &rotation);
+    // Set Distance Filter (flag, custom level and centre frequency in one call)
+    FMOD_Channel_Set3DDistanceFilter(this->pChannel, this->distanceFilterFlag, this->customLevel, this->centreFrequency);
+    // Bind the new Channel to its rolloff curve
+    this->bindRolloff();
+}
+
+void Stream3D::bindRolloff()
+{
+    // Only bind a valid channel
+    if (this->pChannel == 0 || FMODGlobals::pRolloffManager == 0)
+        return;
+    // Bind the Channel (no curve hands it back to the rolloff in mode)
+    FMODGlobals::pRolloffManager->bindChannel(this->pChannel, this->rolloffCurve, this->minDistance, this->maxDistance);
+}
+
+FMOD_VECTOR Stream3D::getSpatialPosition()
+{
+    // Position
+    FMOD_VECTOR position;
+        position.x = this->x;
+        position.y = this->y;
+        position.z = this->z;
+    // return position
+    return position;
+}
+
+void Stream3D::setSpatialActive(bool spatialActiveFlag)
+{
+    // Nothing has changed
+    if (this->spatialActiveFlag == spatialActiveFlag)
+        return;
+    // Set the Spatial Active Flag
+    this->spatialActiveFlag = spatialActiveFlag;
+    // Hold it paused while out of earshot (the game's own pause is a separate flag so it is kept either way)
+    this->setSuspended(CHANNEL_SUSPEND_SPATIAL, (spatialActiveFlag == false));
 }
 
 float Stream3D::getStartXVelocity()
@@ -366,6 +425,8 @@ void Stream3D::setMinDistance(float minDistance)
 {
     // Set local minDistance
     this->minDistance = minDistance;
+    // The rolloff curve spans the new distances
+    this->bindRolloff();
     // Set 3d min distance and max distance
     FMOD_Channel_Set3DMinMaxDistance(this->pChannel, this->minDistance, this->maxDistance);
 }
@@ -374,6 +435,8 @@ void Stream3D::setMaxDistance(float maxDistance)
 {
     // Set local maxDistance
     this->maxDistance = maxDistance;
+    // The rolloff curve spans the new distances
+    this->bindRolloff();
     // Set 3d min distance and max distance
     FMOD_Channel_Set3DMinMaxDistance(this->pChannel, this->minDistance, this->maxDistance);
 }
@@ -384,10 +447,35 @@ void Stream3D::setMinMaxDistance(float minDistance, float maxDistance)
     this->minDistance = minDistance;
     // Set local maxDistance
     this->maxDistance = maxDistance;
+    // The radius in the SpatialGrid is the max distance
+    this->spatialMoved();
+    // The rolloff curve spans the new distances
+    this->bindRolloff();
     // Set 3d min distance and max distance
     FMOD_Channel_Set3DMinMaxDistance(this->pChannel, this->minDistance, this->maxDistance);
 }
 
+void Stream3D::setRolloffCurve(int rolloffCurve)
+{
+    // Set Rolloff Curve
+    this->rolloffCurve = rolloffCurve;
+    // Bind the Channel to the new curve
+    this->bindRolloff();
+}
+
+void Stream3D::setRolloffCurve(const std::string& name)
+{
+    // Find the curve
+    int rolloffCurve = (FMODGlobals::pRolloffManager != 0) ? FMODGlobals::pRolloffManager->findCurve(name) : -1;
+    if (rolloffCurve == -1)
+    {
+        std::cout << "void Stream3D::setRolloffCurve() failure. There is no rolloff curve called " << name << std::endl;
+        return;
+    }
+    // Set Rolloff Curve
+    this->setRolloffCurve(rolloffCurve);
+}
+
 float Stream3D::get3DConeInsideAngle()
 {
     // Return inside cone angle
@@ -479,6 +567,15 @@ void Stream3D::setReverbOcclusion(float reverbOcclusion)
     FMOD_Channel_Set3DOcclusion(this->pChannel, this->directOcclusion, this->reverbOcclusion);
 }
 
+void Stream3D::setOcclusion(float directOcclusion, float reverbOcclusion)
+{
+    // Set local Direct and Reverb Occlusion
+    this->directOcclusion = directOcclusion;
+    this->reverbOcclusion = reverbOcclusion;
+    // Set the Occlusion for the Channel
+    FMOD_Channel_Set3DOcclusion(this->pChannel, this->directOcclusion, this->reverbOcclusion);
+}
+
 float Stream3D::getLevel()
 {
     // return level
@@ -561,6 +658,71 @@ float Stream3D::getAudibility()
     return audibility;
 }
 
+float Stream3D::getEstimatedAudibility(const FMOD_VECTOR* pListenerPositions, int numberOfListeners)
+{
+    // Position
+    FMOD_VECTOR position;
+        position.x = this->x;
+        position.y = this->y;
+        position.z = this->z;
+    // Estimate volume times distance attenuation
+    return this->estimateAudibility(position, this->minDistance, this->maxDistance, pListenerPositions, numberOfListeners);
+}
+
+bool Stream3D::getEstimatePosition(FMOD_VECTOR& position, float& minDistance, float& maxDistance)
+{
+    // Position
+    position.x = this->x;
+    position.y = this->y;
+    position.z = this->z;
+    // Min and Max Distance
+    minDistance = this->minDistance;
+    maxDistance = this->maxDistance;
+    // We have a position
+    return true;
+}
+
+void Stream3D::storeCommand(unsigned int command, ChannelCommandBuffer& buffer)
+{
+    // Copy the local value for the command into the buffer
+    switch (command)
+    {
+        case CHANNEL_COMMAND_3DATTRIBUTES:
+        {
+            // Position
+            buffer.position.x = this->x;
+            buffer.position.y = this->y;
+            buffer.position.z = this->z;
+            // Velocity
+            buffer.velocity.x = this->xVelocity;
+            buffer.velocity.y = this->yVelocity;
+            buffer.velocity.z = this->zVelocity;
+        } break;
+        // Everything else belongs to the Channel
+        default: Channel::storeCommand(command, buffer); break;
+    }
+}
+
+void Stream3D::applyCommands(const ChannelCommandBuffer& buffer)
+{
+    // The channel may have been stopped since the commands were recorded
+    if (this->pChannel == 0)
+        return;
+    // Set Position and Velocity of the Channel
+    if ((buffer.commands & CHANNEL_COMMAND_3DATTRIBUTES) != 0)
+    {
+        // AltPanPos
+        FMOD_VECTOR altPanPos;
+            altPanPos.x = 0.0f;
+            altPanPos.y = 0.0f;
+            altPanPos.z = 0.0f;
+        // Set 3D Attributes
+        FMOD_Channel_Set3DAttributes(this->pChannel, &buffer.position, &buffer.velocity, &altPanPos);
+    }
+    // Apply the Channel commands (paused goes last)
+    Channel::applyCommands(buffer);
+}
+
 //void Stream3D::bindToLua(lua_State* pLuaState)
 //{
 //    // Bind functions to lua state
@@ -0,0 +1,398 @@
+#include "StreamPool.h"
+
+StreamPool::StreamPool()
+{
+    // Counters
+    this->hits.store(0);
+    this->misses.store(0);
+}
+
+StreamPool::~StreamPool()
+{
+    /* NOTE: The AudioSystem clears the pool before it releases the
+        FMODSystem, the streams can't be released after that */
+}
+
+bool StreamPool::preload(const std::string& filename, FMOD_MODE mode, int count)
+{
+    // We need an FMODSystem
+    if (FMODGlobals::pFMODSystem == 0)
+    {
+        std::cout << "bool StreamPool::preload() failure. AudioSystem has not been initialised" << std::endl;
+        return false;
+    }
+    // Validate the count
+    if (count < 1)
+    {
+        std::cout << "bool StreamPool::preload() failure. count must be at least 1" << std::endl;
+        return false;
+    }
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Preloaded already so take the new count
+    FMOD_MODE poolMode = StreamPool::getPoolMode(mode);
+    int index = this->findPreload(filename, poolMode);
+    if (index != -1)
+    {
+        this->preloads[index].count = count;
+    }
+    else
+    {
+        StreamPoolPreload preload;
+        preload.filename = filename;
+        preload.mode = poolMode;
+        preload.count = count;
+        this->preloads.push_back(preload);
+    }
+    // Start opening them now (update primes them once they are open)
+    for (int i = this->getNumberOfIdle(filename, poolMode); i < count; i++)
+    {
+        if (this->openEntry(filename, poolMode) == false)
+            return false;
+    }
+    // Success
+    return true;
+}
+
+void StreamPool::unload(const std::string& filename, FMOD_MODE mode)
+{
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Forget the preload
+    FMOD_MODE poolMode = StreamPool::getPoolMode(mode);
+    int index = this->findPreload(filename, poolMode);
+    if (index == -1)
+        return;
+    this->preloads.erase(this->preloads.begin() + index);
+    // Release the streams not in use (a stream still opening holds this up until it is open)
+    for (int i = (int)this->entries.size() - 1; i >= 0; i--)
+    {
+        StreamPoolEntry& entry = this->entries[i];
+        if (entry.state != STREAMPOOL_STATE_IN_USE && entry.mode == poolMode && entry.filename == filename)
+            this->releaseEntry(i);
+    }
+}
+
+void StreamPool::update()
+{
+    // Don't update unless we have an FMODSystem
+    if (FMODGlobals::pFMODSystem == 0)
+        return;
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Move each stream on
+    for (int i = 0; i < (int)this->entries.size(); i++)
+    {
+        StreamPoolEntry& entry = this->entries[i];
+        // Streams in use belong to their Stream or Music
+        if (entry.state == STREAMPOOL_STATE_IN_USE)
+            continue;
+        // A primed Channel can be stolen by a more important sound
+        if (entry.state == STREAMPOOL_STATE_READY)
+        {
+            FMOD_BOOL playingFlag = false;
+            if (FMOD_Channel_IsPlaying(entry.pChannel, &playingFlag) != FMOD_OK || playingFlag == false)
+            {
+                entry.pChannel = 0;
+                entry.state = STREAMPOOL_STATE_RETURNED;
+            }
+            else
+            {
+                continue;
+            }
+        }
+        // Grab the Open State
+        FMOD_OPENSTATE openState = FMOD_OPENSTATE_READY;
+        FMOD_BOOL starvingFlag = false;
+        FMOD_RESULT result = FMOD_Sound_GetOpenState(entry.pFMODSound, &openState, 0, &starvingFlag, 0);
+        // Failed to open (stop asking for more of this file)
+        if (result != FMOD_OK || openState == FMOD_OPENSTATE_ERROR)
+        {
+            std::cout << "void StreamPool::update() failure. Unable to open stream: " << entry.filename << std::endl;
+            int index = this->findPreload(entry.filename, entry.mode);
+            if (index != -1)
+                this->preloads.erase(this->preloads.begin() + index);
+            this->releaseEntry(i);
+            i--;
+            continue;
+        }
+        // Open (or handed back) so fill its buffer
+        if (entry.state == STREAMPOOL_STATE_OPENING || entry.state == STREAMPOOL_STATE_RETURNED)
+        {
+            if (openState == FMOD_OPENSTATE_READY)
+                this->primeEntry(entry);
+            continue;
+        }
+        // Only a priming stream has more to wait for
+        if (entry.state != STREAMPOOL_STATE_PRIMING)
+            continue;
+        // Still seeking to the start and filling the buffer
+        if (openState == FMOD_OPENSTATE_SETPOSITION)
+        {
+            entry.seekedFlag = true;
+            entry.settledUpdates = 0;
+            continue;
+        }
+        if ((openState != FMOD_OPENSTATE_READY && openState != FMOD_OPENSTATE_PLAYING) || starvingFlag == true)
+        {
+            entry.settledUpdates = 0;
+            continue;
+        }
+        /* NOTE: The seek PlaySound starts may not have begun the first time
+            the state is read, and a quick one can be over before an update
+            sees it. So the buffer counts as full once the seek has been seen
+            and finished, or once the stream has read ready two updates running */
+        entry.settledUpdates++;
+        if (entry.seekedFlag == true || entry.settledUpdates >= 2)
+            entry.state = STREAMPOOL_STATE_READY;
+    }
+    // Open more where there are fewer than asked for
+    for (unsigned int i = 0; i < this->preloads.size(); i++)
+    {
+        StreamPoolPreload& preload = this->preloads[i];
+        for (int j = this->getNumberOfIdle(preload.filename, preload.mode); j < preload.count; j++)
+        {
+            if (this->openEntry(preload.filename, preload.mode) == false)
+                break;
+        }
+    }
+}
+
+void StreamPool::clear()
+{
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Release every stream
+    for (int i = (int)this->entries.size() - 1; i >= 0; i--)
+        this->releaseEntry(i);
+    // Forget the preloads
+    this->preloads.clear();
+}
+
+bool StreamPool::acquire(const std::string& filename, FMOD_MODE mode, FMOD_SOUND** ppFMODSound, FMOD_CHANNEL** ppPrimedChannel)
+{
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Only preloaded files
+    FMOD_MODE poolMode = StreamPool::getPoolMode(mode);
+    if (this->findPreload(filename, poolMode) == -1)
+        return false;
+    // Find the best stream
+    int index = this->findPrimed(filename, poolMode);
+    if (index == -1)
+    {
+        this->misses++;
+        return false;
+    }
+    StreamPoolEntry& entry = this->entries[index];
+    if (entry.state == STREAMPOOL_STATE_READY)
+        this->hits++;
+    else
+        this->misses++;
+    // Hand it over with its Channel
+    *ppFMODSound = entry.pFMODSound;
+    *ppPrimedChannel = entry.pChannel;
+    entry.pChannel = 0;
+    entry.state = STREAMPOOL_STATE_IN_USE;
+    // Success
+    return true;
+}
+
+bool StreamPool::recycle(FMOD_SOUND** ppFMODSound, FMOD_CHANNEL** ppPrimedChannel)
+{
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the stream
+    int index = this->findEntry(*ppFMODSound);
+    if (index == -1)
+        return false;
+    // Find a primed one of the same file
+    int primed = this->findPrimed(this->entries[index].filename, this->entries[index].mode);
+    if (primed == -1 || this->entries[primed].state != STREAMPOOL_STATE_READY)
+    {
+        this->misses++;
+        return false;
+    }
+    this->hits++;
+    // The played stream goes back to be primed again
+    StreamPoolEntry& entry = this->entries[index];
+    FMOD_Sound_SetMode(entry.pFMODSound, entry.mode);
+    entry.pChannel = 0;
+    entry.state = STREAMPOOL_STATE_RETURNED;
+    // Hand over the primed one
+    StreamPoolEntry& primedEntry = this->entries[primed];
+    *ppFMODSound = primedEntry.pFMODSound;
+    *ppPrimedChannel = primedEntry.pChannel;
+    primedEntry.pChannel = 0;
+    primedEntry.state = STREAMPOOL_STATE_IN_USE;
+    // Success
+    return true;
+}
+
+bool StreamPool::release(FMOD_SOUND* pFMODSound, FMOD_CHANNEL* pPrimedChannel)
+{
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the stream
+    int index = this->findEntry(pFMODSound);
+    if (index == -1)
+        return false;
+    StreamPoolEntry& entry = this->entries[index];
+    // Release it if the file is no longer wanted or there are enough without it
+    int preload = this->findPreload(entry.filename, entry.mode);
+    if (preload == -1 || this->getNumberOfIdle(entry.filename, entry.mode) >= this->preloads[preload].count)
+    {
+        entry.pChannel = pPrimedChannel;
+        this->releaseEntry(index);
+        return true;
+    }
+    // Put back the loop mode the Stream may have changed
+    FMOD_Sound_SetMode(entry.pFMODSound, entry.mode);
+    // Never played so it is still primed, otherwise prime it again
+    entry.pChannel = pPrimedChannel;
+    entry.state = (pPrimedChannel != 0) ? STREAMPOOL_STATE_PRIMING : STREAMPOOL_STATE_RETURNED;
+    entry.seekedFlag = false;
+    entry.settledUpdates = 0;
+    // Success
+    return true;
+}
+
+int StreamPool::getNumberOfReady(const std::string& filename, FMOD_MODE mode)
+{
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Count the primed streams
+    FMOD_MODE poolMode = StreamPool::getPoolMode(mode);
+    int count = 0;
+    for (unsigned int i = 0; i < this->entries.size(); i++)
+    {
+        const StreamPoolEntry& entry = this->entries[i];
+        if (entry.state == STREAMPOOL_STATE_READY && entry.mode == poolMode && entry.filename == filename)
+            count++;
+    }
+    // return the count
+    return count;
+}
+
+int StreamPool::getNumberOfStreams()
+{
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of streams
+    return (int)this->entries.size();
+}
+
+int StreamPool::findPreload(const std::string& filename, FMOD_MODE mode)
+{
+    // Find the preload
+    for (unsigned int i = 0; i < this->preloads.size(); i++)
+    {
+        if (this->preloads[i].mode == mode && this->preloads[i].filename == filename)
+            return (int)i;
+    }
+    // Not found
+    return -1;
+}
+
+int StreamPool::findEntry(FMOD_SOUND* pFMODSound)
+{
+    // Find the stream
+    for (unsigned int i = 0; i < this->entries.size(); i++)
+    {
+        if (this->entries[i].pFMODSound == pFMODSound)
+            return (int)i;
+    }
+    // Not found
+    return -1;
+}
+
+int StreamPool::findPrimed(const std::string& filename, FMOD_MODE mode)
+{
+    // Ready beats priming beats returned (opening streams can't be played yet)
+    int best = -1;
+    for (unsigned int i = 0; i < this->entries.size(); i++)
+    {
+        const StreamPoolEntry& entry = this->entries[i];
+        if (entry.state == STREAMPOOL_STATE_OPENING || entry.state == STREAMPOOL_STATE_IN_USE)
+            continue;
+        if (entry.mode != mode || entry.filename != filename)
+            continue;
+        if (entry.state == STREAMPOOL_STATE_READY)
+            return (int)i;
+        if (best == -1 || (entry.state == STREAMPOOL_STATE_PRIMING && this->entries[best].state == STREAMPOOL_STATE_RETURNED))
+            best = (int)i;
+    }
+    // return the best
+    return best;
+}
+
+int StreamPool::getNumberOfIdle(const std::string& filename, FMOD_MODE mode)
+{
+    // Count the streams not in use
+    int count = 0;
+    for (unsigned int i = 0; i < this->entries.size(); i++)
+    {
+        const StreamPoolEntry& entry = this->entries[i];
+        if (entry.state != STREAMPOOL_STATE_IN_USE && entry.mode == mode && entry.filename == filename)
+            count++;
+    }
+    // return the count
+    return count;
+}
+
+bool StreamPool::openEntry(const std::string& filename, FMOD_MODE mode)
+{
+    // Tag the file as a stream (its async reads are refilled ahead of loads)
+    FMOD_CREATESOUNDEXINFO exinfo;
+    AudioFileSystem::getStreamExInfo(exinfo);
+    // Start opening the stream (FMOD opens it on its own thread)
+    FMOD_SOUND* pFMODSound = 0;
+    FMOD_RESULT result = FMOD_System_CreateSound(FMODGlobals::pFMODSystem, filename.c_str(), mode | FMOD_CREATESTREAM | FMOD_NONBLOCKING, &exinfo, &pFMODSound);
+    if (result != FMOD_OK)
+    {
+        std::cout << "ERROR:" << FMOD_ErrorString(result) << std::endl;
+        std::cout << "bool StreamPool::openEntry() failure. Unable to open stream: " << filename << std::endl;
+        return false;
+    }
+    // Add it
+    StreamPoolEntry entry;
+    entry.filename = filename;
+    entry.mode = mode;
+    entry.pFMODSound = pFMODSound;
+    entry.pChannel = 0;
+    entry.state = STREAMPOOL_STATE_OPENING;
+    entry.seekedFlag = false;
+    entry.settledUpdates = 0;
+    this->entries.push_back(entry);
+    // Success
+    return true;
+}
+
+void StreamPool::primeEntry(StreamPoolEntry& entry)
+{
+    // Play it paused, FMOD seeks to the start and fills the buffer (try again next update if it can't)
+    FMOD_CHANNEL* pChannel = 0;
+    if (FMOD_System_PlaySound(FMODGlobals::pFMODSystem, entry.pFMODSound, 0, true, &pChannel) != FMOD_OK)
+        return;
+    // Keep the Channel from being stolen while it waits
+    FMOD_Channel_SetPriority(pChannel, 0);
+    entry.pChannel = pChannel;
+    entry.state = STREAMPOOL_STATE_PRIMING;
+    // Ready only once the seek has been and gone
+    FMOD_OPENSTATE openState = FMOD_OPENSTATE_READY;
+    FMOD_Sound_GetOpenState(entry.pFMODSound, &openState, 0, 0, 0);
+    entry.seekedFlag = (openState == FMOD_OPENSTATE_SETPOSITION);
+    entry.settledUpdates = 0;
+}
+
+void StreamPool::releaseEntry(int index)
+{
+    // Stop the primed Channel
+    StreamPoolEntry& entry = this->entries[index];
+    if (entry.pChannel != 0)
+        FMOD_Channel_Stop(entry.pChannel);
+    // Release the stream
+    FMOD_Sound_Release(entry.pFMODSound);
+    // Forget it
+    this->entries.erase(this->entries.begin() + index);
+}
@@ -0,0 +1,227 @@
+/**
+  * @file   StreamPool.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  StreamPool keeps streams opened and prebuffered ahead of use
+  * so Streams and Music can start straight away
+*/
+
+#ifndef STREAMPOOL_H
+#define STREAMPOOL_H
+
+// C++ Includes
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_codec.h>
+#include <fmod_common.h>
+#include <fmod_dsp.h>
+#include <fmod_dsp_effects.h>
+#include <fmod_errors.h>
+#include <fmod_output.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "System/AudioFileSystem.h"
+
+// State of a pooled stream
+enum STREAMPOOL_STATE
+{
+    // Being opened (FMOD_NONBLOCKING)
+    STREAMPOOL_STATE_OPENING = 0,
+    // Handed back and waiting to be primed
+    STREAMPOOL_STATE_RETURNED,
+    // Playing paused while FMOD seeks to the start and fills its buffer
+    STREAMPOOL_STATE_PRIMING,
+    // Paused with a full buffer
+    STREAMPOOL_STATE_READY,
+    // Handed to a Stream or Music
+    STREAMPOOL_STATE_IN_USE
+};
+
+/** Stream::load and Music::load open their stream at the moment of use,
+    and opening, probing the codec and filling the first buffer costs tens
+    of milliseconds before the first sample plays. Preload a file and the
+    StreamPool opens the streams with FMOD_NONBLOCKING in the background,
+    then plays each one paused so FMOD fills its buffer. A Stream or Music
+    loading that file takes one of these with its paused Channel, and play
+    only has to unpause it, so it starts in the next mixer block. A stream
+    handed back is primed again and reused instead of being released, and
+    the pool opens more in the background to keep the number asked for
+    ready. The file and the mode together pick the streams, so preload with
+    the mode the class loads with (FMOD_DEFAULT for Stream, FMOD_LOOP_NORMAL
+    for Music and FMOD_LOOP_NORMAL | FMOD_3D for Stream2D and Stream3D) **/
+class StreamPool
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        StreamPool();
+        //! Destructor
+        virtual ~StreamPool();
+
+    protected:
+        //! StreamPool Copy constructor
+        StreamPool(const StreamPool& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! StreamPool Assignment operator
+        StreamPool& operator=(const StreamPool& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief preload
+          * Keep streams of a file open and primed (opened over the next updates)
+          * @param filename file to stream
+          * @param mode FMOD_MODE the class loads the file with
+          * @param count number of streams to keep ready (one per instance playing at once)
+          * @return false if there is no FMODSystem or count is below 1 **/
+        virtual bool preload(const std::string& filename, FMOD_MODE mode, int count);
+        /** @brief unload
+          * Stop keeping streams of a file ready (streams in use are released when handed back)
+          * @param filename file to stream
+          * @param mode FMOD_MODE it was preloaded with **/
+        virtual void unload(const std::string& filename, FMOD_MODE mode);
+        /** @brief update
+          * Check on the streams being opened and primed and open more where
+          * there are fewer ready than asked for. Called by the AudioSystem **/
+        virtual void update();
+        /** @brief clear
+          * Release every stream (those in use included) and forget the preloads **/
+        virtual void clear();
+
+    public:
+        /** @brief acquire
+          * Take a stream of a file (a primed one when there is one)
+          * @param filename file to stream
+          * @param mode FMOD_MODE the class loads the file with
+          * @param ppFMODSound receives the stream
+          * @param ppPrimedChannel receives its paused Channel (0 if it is not primed)
+          * @return false if the file was not preloaded or no stream is open yet **/
+        virtual bool acquire(const std::string& filename, FMOD_MODE mode, FMOD_SOUND** ppFMODSound, FMOD_CHANNEL** ppPrimedChannel);
+        /** @brief recycle
+          * Swap a stream which has been played for a primed one of the same file
+          * @param ppFMODSound the stream (receives the primed one)
+          * @param ppPrimedChannel receives its paused Channel
+          * @return false if none is primed (the stream is kept) **/
+        virtual bool recycle(FMOD_SOUND** ppFMODSound, FMOD_CHANNEL** ppPrimedChannel);
+        /** @brief release
+          * Hand a stream back (its Channel must be stopped)
+          * @param pFMODSound the stream
+          * @param pPrimedChannel its paused Channel if it was never played (kept primed)
+          * @return false if the stream is not from the pool **/
+        virtual bool release(FMOD_SOUND* pFMODSound, FMOD_CHANNEL* pPrimedChannel = 0);
+
+    public:
+        /** @brief Get the number of streams ready
+          * @param filename file to stream
+          * @param mode FMOD_MODE it was preloaded with
+          * @return primed streams of the file **/
+        virtual int getNumberOfReady(const std::string& filename, FMOD_MODE mode);
+        /** @brief Get the number of streams
+          * @return streams open, opening or in use **/
+        virtual int getNumberOfStreams();
+        /** @brief Get the number of hits
+          * @return acquires and recycles answered with a primed stream **/
+        virtual long long getNumberOfHits() { return this->hits.load(); }
+        /** @brief Get the number of misses
+          * @return acquires of a preloaded file with no primed stream **/
+        virtual long long getNumberOfMisses() { return this->misses.load(); }
+
+    protected:
+        // A pooled stream
+        struct StreamPoolEntry
+        {
+            // File
+            std::string filename;
+            // Mode (without FMOD_CREATESTREAM and FMOD_NONBLOCKING)
+            FMOD_MODE mode;
+            // The stream
+            FMOD_SOUND* pFMODSound;
+            // Its paused Channel while primed
+            FMOD_CHANNEL* pChannel;
+            // State
+            STREAMPOOL_STATE state;
+            // Has the seek to the start been seen while priming
+            bool seekedFlag;
+            // Updates in a row the primed stream has read ready
+            int settledUpdates;
+        };
+        // A preloaded file
+        struct StreamPoolPreload
+        {
+            // File
+            std::string filename;
+            // Mode (without FMOD_CREATESTREAM and FMOD_NONBLOCKING)
+            FMOD_MODE mode;
+            // Streams to keep ready
+            int count;
+        };
+
+    protected:
+        /** @brief getPoolMode
+          * @param mode FMOD_MODE
+          * @return mode without the flags the pool adds itself **/
+        static inline FMOD_MODE getPoolMode(FMOD_MODE mode) { return mode & ~(FMOD_CREATESTREAM | FMOD_NONBLOCKING); }
+        /** @brief findPreload (lock must be held)
+          * @param filename file to stream
+          * @param mode pool mode
+          * @return index of the preload or -1 **/
+        virtual int findPreload(const std::string& filename, FMOD_MODE mode);
+        /** @brief findEntry (lock must be held)
+          * @param pFMODSound the stream
+          * @return index of the entry or -1 **/
+        virtual int findEntry(FMOD_SOUND* pFMODSound);
+        /** @brief findPrimed (lock must be held)
+          * @param filename file to stream
+          * @param mode pool mode
+          * @return index of the best stream to hand out (ready, then priming, then returned) or -1 **/
+        virtual int findPrimed(const std::string& filename, FMOD_MODE mode);
+        /** @brief getNumberOfIdle (lock must be held)
+          * @param filename file to stream
+          * @param mode pool mode
+          * @return streams of the file not in use **/
+        virtual int getNumberOfIdle(const std::string& filename, FMOD_MODE mode);
+        /** @brief openEntry (lock must be held)
+          * Start opening another stream of a file
+          * @param filename file to stream
+          * @param mode pool mode
+          * @return false if FMOD would not open it **/
+        virtual bool openEntry(const std::string& filename, FMOD_MODE mode);
+        /** @brief primeEntry (lock must be held)
+          * Play the stream paused so FMOD fills its buffer
+          * @param entry the stream **/
+        virtual void primeEntry(StreamPoolEntry& entry);
+        /** @brief releaseEntry (lock must be held)
+          * Stop and release the stream and forget it
+          * @param index index of the entry **/
+        virtual void releaseEntry(int index);
+
+    protected:
+        // Streams
+        std::vector<StreamPoolEntry> entries;
+        // Preloaded files
+        std::vector<StreamPoolPreload> preloads;
+        // Counters
+        std::atomic<long long> hits;
+        std::atomic<long long> misses;
+        // Guards everything above (Streams load on game threads, update runs on the update thread)
+        std::mutex mutex;
+};
+
+#endif // STREAMPOOL_H
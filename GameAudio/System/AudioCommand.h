@@ -0,0 +1,55 @@
+/**
+  * @file   AudioCommand.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  AudioCommand is a small fixed size message a game thread
+  * posts to the AudioSystem's update thread
+*/
+
+#ifndef AUDIOCOMMAND_H
+#define AUDIOCOMMAND_H
+
+class Channel;
+
+/** The AUDIO_COMMAND values say what the update thread should do
+    with the Channel an AudioCommand targets **/
+enum AUDIO_COMMAND
+{
+    AUDIO_COMMAND_NONE = 0,
+    AUDIO_COMMAND_PLAY,
+    AUDIO_COMMAND_STOP,
+    AUDIO_COMMAND_PAUSE,
+    AUDIO_COMMAND_RESUME,
+    AUDIO_COMMAND_VOLUME,
+    AUDIO_COMMAND_PITCH,
+    AUDIO_COMMAND_MUTE,
+    AUDIO_COMMAND_BALANCE,
+    AUDIO_COMMAND_POSITION,
+    AUDIO_COMMAND_VELOCITY
+};
+
+/** The AudioCommand struct is copied by value through the AudioCommandQueue
+    so it has no constructor side effects and no heap memory. values holds
+    the arguments (volume, pitch, balance, mute as 0/1, x/y/z for position
+    and velocity) **/
+struct AudioCommand
+{
+    //! Constructor
+    AudioCommand()
+    {
+        this->type = AUDIO_COMMAND_NONE;
+        this->pChannel = 0;
+        this->values[0] = 0.0f;
+        this->values[1] = 0.0f;
+        this->values[2] = 0.0f;
+    }
+
+    // One of the AUDIO_COMMAND values
+    int type;
+    // The Channel (Sound, Stream, Music etc) the command is for
+    Channel* pChannel;
+    // Command arguments
+    float values[3];
+};
+
+#endif // AUDIOCOMMAND_H
@@ -0,0 +1,105 @@
+#include "AudioCommandQueue.h"
+
+AudioCommandQueue::AudioCommandQueue(unsigned int capacity)
+{
+    // Round capacity up to a power of two so we can wrap with a mask
+    this->capacity = 2;
+    while (this->capacity < capacity)
+        this->capacity <<= 1;
+    // Mask
+    this->mask = this->capacity - 1;
+    // Create the Cells
+    this->pCells = new Cell[this->capacity];
+    // Each cell starts out free for the producer at its own position
+    for (unsigned int i = 0; i < this->capacity; i++)
+        this->pCells[i].sequence.store(i, std::memory_order_relaxed);
+    // Positions
+    this->enqueuePosition.store(0, std::memory_order_relaxed);
+    this->dequeuePosition = 0;
+    // Dropped Commands
+    this->droppedCommands.store(0, std::memory_order_relaxed);
+}
+
+AudioCommandQueue::~AudioCommandQueue()
+{
+    // Free the Cells
+    delete[] this->pCells;
+    this->pCells = 0;
+}
+
+bool AudioCommandQueue::push(const AudioCommand& command)
+{
+    // Claim a cell
+    Cell* pCell = 0;
+    unsigned int position = this->enqueuePosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        // Look at the cell for this position
+        pCell = &(this->pCells[position & this->mask]);
+        unsigned int sequence = pCell->sequence.load(std::memory_order_acquire);
+        int difference = (int)(sequence - position);
+        // The cell is free so try and take the position
+        if (difference == 0)
+        {
+            if (this->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed) == true)
+                break;
+        }
+        // The consumer hasn't freed the cell yet so the queue is full
+        else if (difference < 0)
+        {
+            this->droppedCommands.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // Another producer beat us to it so try the next position
+        else
+        {
+            position = this->enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+    // Copy the command
+    pCell->command = command;
+    // Hand the cell to the consumer
+    pCell->sequence.store(position + 1, std::memory_order_release);
+    // Success
+    return true;
+}
+
+bool AudioCommandQueue::pop(AudioCommand& command)
+{
+    // Look at the cell for the next position
+    Cell* pCell = &(this->pCells[this->dequeuePosition & this->mask]);
+    unsigned int sequence = pCell->sequence.load(std::memory_order_acquire);
+    // Nothing has been published into this cell yet
+    if ((int)(sequence - (this->dequeuePosition + 1)) < 0)
+        return false;
+    // Copy the command out
+    command = pCell->command;
+    // Hand the cell back to the producers for the next lap
+    pCell->sequence.store(this->dequeuePosition + this->mask + 1, std::memory_order_release);
+    // Advance
+    this->dequeuePosition++;
+    // Success
+    return true;
+}
+
+unsigned int AudioCommandQueue::forget(Channel* pChannel)
+{
+    // Look at every cell between the consumer and the producers
+    unsigned int forgotten = 0;
+    unsigned int enqueuePosition = this->enqueuePosition.load(std::memory_order_acquire);
+    for (unsigned int position = this->dequeuePosition; position != enqueuePosition; position++)
+    {
+        Cell* pCell = &(this->pCells[position & this->mask]);
+        // Only published cells (a producer may still be writing a claimed one)
+        if (pCell->sequence.load(std::memory_order_acquire) != position + 1)
+            continue;
+        // Blank the command
+        if (pCell->command.pChannel == pChannel)
+        {
+            pCell->command.pChannel = 0;
+            forgotten++;
+        }
+    }
+    // return the number of commands blanked
+    return forgotten;
+}
@@ -0,0 +1,102 @@
+/**
+  * @file   AudioCommandQueue.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  AudioCommandQueue is a bounded lock free queue which many
+  * game threads push AudioCommands into and the audio update thread pops
+*/
+
+#ifndef AUDIOCOMMANDQUEUE_H
+#define AUDIOCOMMANDQUEUE_H
+
+// C++ Includes
+#include <atomic>
+
+// GAMEAUDIO Includes
+#include "System/AudioCommand.h"
+
+/** The AudioCommandQueue is a fixed size ring of cells, each with a sequence
+    number. Producers claim a cell with a compare and swap on the enqueue
+    position and publish it by bumping the cell's sequence, so push never
+    blocks and never allocates. There must only ever be one consumer (the
+    audio update thread). When the ring is full push returns false and the
+    command is counted as dropped. A Channel being destroyed has forget
+    blank out the commands still waiting for it, so forget counts as the
+    consumer and must never run alongside pop **/
+class AudioCommandQueue
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Constructor
+        AudioCommandQueue(unsigned int capacity = 1024);
+        //! Destructor
+        virtual ~AudioCommandQueue();
+
+    protected:
+        //! AudioCommandQueue Copy constructor
+        AudioCommandQueue(const AudioCommandQueue& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! AudioCommandQueue Assignment operator
+        AudioCommandQueue& operator=(const AudioCommandQueue& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief push (any thread)
+          * @param command the command to copy into the queue
+          * @return true on success, false if the queue was full **/
+        virtual bool push(const AudioCommand& command);
+        /** @brief pop (consumer thread only)
+          * @param command receives the oldest command
+          * @return true if a command was popped, false if the queue was empty **/
+        virtual bool pop(AudioCommand& command);
+        /** @brief forget (consumer side, never alongside pop)
+          * Blank the published commands for a Channel (they pop with no Channel)
+          * @param pChannel the Channel
+          * @return number of commands blanked **/
+        virtual unsigned int forget(Channel* pChannel);
+
+    public:
+        /** @brief Get Capacity
+          * @return the number of commands the queue can hold (a power of two) **/
+        virtual unsigned int getCapacity() { return this->capacity; }
+        /** @brief Get the number of commands dropped because the queue was full
+          * @return dropped commands **/
+        virtual unsigned int getDroppedCommands() { return this->droppedCommands.load(); }
+
+    protected:
+        // A slot in the ring
+        struct Cell
+        {
+            // Sequence number telling producers and the consumer who owns the cell
+            std::atomic<unsigned int> sequence;
+            // The command
+            AudioCommand command;
+        };
+
+    protected:
+        // Ring of cells
+        Cell* pCells;
+        // Capacity (a power of two)
+        unsigned int capacity;
+        // Capacity - 1
+        unsigned int mask;
+        // Next position to push (shared by producers)
+        std::atomic<unsigned int> enqueuePosition;
+        // Next position to pop (consumer only)
+        unsigned int dequeuePosition;
+        // Commands dropped because the queue was full
+        std::atomic<unsigned int> droppedCommands;
+};
+
+#endif // AUDIOCOMMANDQUEUE_H
@@ -0,0 +1,107 @@
+/**
+  * @file   AudioFileStats.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  AudioFileStats are the I/O counters the AudioFileSystem
+  * keeps for each file and each category of file
+*/
+
+#ifndef AUDIOFILESTATS_H
+#define AUDIOFILESTATS_H
+
+// C++ Includes
+#include <algorithm>
+#include <string>
+
+/** The AudioFileStats struct counts what FMOD asked the AudioFileSystem
+    for and what it cost: how many bytes came off the disk against how
+    many were handed over, how often the block cache answered, and how
+    long the disk took (the longest single disk read is what starves a
+    stream). The same struct is used for a file and for a category **/
+struct AudioFileStats
+{
+    //! Constructor
+    AudioFileStats()
+    {
+        this->reset();
+    }
+
+    /** @brief reset
+      * Zero the counters (the name and category are kept) **/
+    void reset()
+    {
+        this->numberOfOpens = 0;
+        this->numberOfReads = 0;
+        this->numberOfSeeks = 0;
+        this->numberOfDiskReads = 0;
+        this->bytesRequested = 0;
+        this->bytesRead = 0;
+        this->bytesFromDisk = 0;
+        this->cacheHits = 0;
+        this->cacheMisses = 0;
+        this->readAheadBlocks = 0;
+        this->diskTime = 0.0f;
+        this->longestDiskRead = 0.0f;
+    }
+
+    /** @brief add
+      * @param other counters to add to these **/
+    void add(const AudioFileStats& other)
+    {
+        this->numberOfOpens += other.numberOfOpens;
+        this->numberOfReads += other.numberOfReads;
+        this->numberOfSeeks += other.numberOfSeeks;
+        this->numberOfDiskReads += other.numberOfDiskReads;
+        this->bytesRequested += other.bytesRequested;
+        this->bytesRead += other.bytesRead;
+        this->bytesFromDisk += other.bytesFromDisk;
+        this->cacheHits += other.cacheHits;
+        this->cacheMisses += other.cacheMisses;
+        this->readAheadBlocks += other.readAheadBlocks;
+        this->diskTime += other.diskTime;
+        this->longestDiskRead = std::max(this->longestDiskRead, other.longestDiskRead);
+    }
+
+    /** @brief getCacheHitRate
+      * @return fraction of block lookups the cache answered (0.0 to 1.0) **/
+    float getCacheHitRate() const
+    {
+        // No lookups yet
+        long long lookups = this->cacheHits + this->cacheMisses;
+        if (lookups == 0)
+            return 0.0f;
+        // return the hit rate
+        return (float)((double)this->cacheHits / (double)lookups);
+    }
+
+    // Name of the file (or the category)
+    std::string name;
+    // Name of the category
+    std::string category;
+    // Times the file was opened
+    long long numberOfOpens;
+    // Reads FMOD asked for
+    long long numberOfReads;
+    // Seeks FMOD asked for which moved the file position
+    long long numberOfSeeks;
+    // Reads which went to the disk
+    long long numberOfDiskReads;
+    // Bytes FMOD asked for
+    long long bytesRequested;
+    // Bytes handed to FMOD
+    long long bytesRead;
+    // Bytes read off the disk (read-ahead included)
+    long long bytesFromDisk;
+    // Blocks found in the cache
+    long long cacheHits;
+    // Blocks which had to be read
+    long long cacheMisses;
+    // Blocks read beyond what was asked for
+    long long readAheadBlocks;
+    // Microseconds spent reading the disk
+    float diskTime;
+    // Microseconds the longest disk read took
+    float longestDiskRead;
+};
+
+#endif // AUDIOFILESTATS_H
@@ -0,0 +1,689 @@
+#include "AudioFileSystem.h"
+
+// Tags the files opened through getStreamExInfo (only its address is used)
+static char streamTag = 0;
+
+AudioFileSystem::AudioFileSystem()
+{
+    // Not attached
+    this->attachedFlag = false;
+    // Cache (created on attach)
+    this->blockSize = AUDIOFILESYSTEM_DEFAULT_BLOCK_SIZE;
+    this->numberOfBlocks = 0;
+    this->mostRecentBlock = -1;
+    this->leastRecentBlock = -1;
+    // Read Ahead Blocks
+    this->readAheadBlocks = AUDIOFILESYSTEM_DEFAULT_READ_AHEAD_BLOCKS;
+    // Everything starts in the default category
+    AudioFileCategory category;
+    category.stats.name = "default";
+    category.stats.category = "default";
+    this->categories.push_back(category);
+}
+
+AudioFileSystem::~AudioFileSystem()
+{
+    // Close every file
+    this->clear();
+}
+
+bool AudioFileSystem::create(unsigned int blockSize, int numberOfBlocks)
+{
+    // Validate the sizes
+    if (blockSize == 0 || numberOfBlocks <= 0)
+    {
+        std::cout << "bool AudioFileSystem::create() failure. blockSize and numberOfBlocks must be above 0" << std::endl;
+        return false;
+    }
+    // The blocks of open files would be lost
+    std::lock_guard<std::mutex> fileLock(this->fileMutex);
+    if (this->files.empty() == false)
+    {
+        std::cout << "bool AudioFileSystem::create() failure. Files are open" << std::endl;
+        return false;
+    }
+    // Lock the Cache
+    std::lock_guard<std::mutex> cacheLock(this->cacheMutex);
+    // Allocate the blocks
+    this->blockSize = blockSize;
+    this->numberOfBlocks = numberOfBlocks;
+    this->blockData.assign((size_t)blockSize * (size_t)numberOfBlocks, 0);
+    this->blocks.resize(numberOfBlocks);
+    this->blockIndices.clear();
+    // Chain them into the recently used list
+    for (int i = 0; i < numberOfBlocks; i++)
+    {
+        this->blocks[i].key = 0;
+        this->blocks[i].size = 0;
+        this->blocks[i].previous = i - 1;
+        this->blocks[i].next = (i + 1 < numberOfBlocks) ? i + 1 : -1;
+    }
+    this->mostRecentBlock = 0;
+    this->leastRecentBlock = numberOfBlocks - 1;
+    // Success
+    return true;
+}
+
+bool AudioFileSystem::attach(bool asyncFlag)
+{
+    // We need an FMODSystem
+    if (FMODGlobals::pFMODSystem == 0)
+    {
+        std::cout << "bool AudioFileSystem::attach() failure. AudioSystem has not been initialised" << std::endl;
+        return false;
+    }
+    // Create the cache with the defaults
+    if (this->blocks.empty() == true && this->create(this->blockSize, AUDIOFILESYSTEM_DEFAULT_NUMBER_OF_BLOCKS) == false)
+        return false;
+    // Hand FMOD our callbacks (FMOD uses the async ones in place of read and seek when they are given)
+    FMOD_RESULT result = FMOD_System_SetFileSystem(FMODGlobals::pFMODSystem,
+                                                   AudioFileSystem::openCallback,
+                                                   AudioFileSystem::closeCallback,
+                                                   (asyncFlag == true) ? 0 : AudioFileSystem::readCallback,
+                                                   (asyncFlag == true) ? 0 : AudioFileSystem::seekCallback,
+                                                   (asyncFlag == true) ? AudioFileSystem::asyncReadCallback : 0,
+                                                   (asyncFlag == true) ? AudioFileSystem::asyncCancelCallback : 0,
+                                                   AUDIOFILESYSTEM_BLOCK_ALIGN);
+    if (result != FMOD_OK)
+    {
+        std::cout << "ERROR:" << FMOD_ErrorString(result) << std::endl;
+        std::cout << "bool AudioFileSystem::attach() failure. " << std::endl;
+        return false;
+    }
+    // Start the threads the async reads are done on
+    if (asyncFlag == true && this->ioScheduler.isRunning() == false)
+        this->ioScheduler.start(AUDIOIOSCHEDULER_DEFAULT_THREADS, AudioFileSystem::scheduledReadCallback, (void*)this);
+    // Attached
+    this->attachedFlag = true;
+    // Success
+    return true;
+}
+
+void AudioFileSystem::detach()
+{
+    // Not attached
+    if (this->attachedFlag == false)
+        return;
+    // Hand file I/O back to FMOD
+    if (FMODGlobals::pFMODSystem != 0)
+        FMOD_System_SetFileSystem(FMODGlobals::pFMODSystem, 0, 0, 0, 0, 0, 0, AUDIOFILESYSTEM_BLOCK_ALIGN);
+    this->attachedFlag = false;
+}
+
+void AudioFileSystem::clear()
+{
+    // Hand file I/O back to FMOD
+    this->detach();
+    // Finish the queued reads before the files go
+    this->ioScheduler.stop();
+    {
+        // Lock the Files
+        std::lock_guard<std::mutex> lock(this->fileMutex);
+        // Close every file (FMOD should have closed them already)
+        for (unsigned int i = 0; i < this->files.size(); i++)
+        {
+            fclose(this->files[i]->pFile);
+            delete this->files[i];
+        }
+        this->files.clear();
+    }
+    {
+        // Lock the Cache
+        std::lock_guard<std::mutex> lock(this->cacheMutex);
+        // Forget the cache
+        this->blockData.clear();
+        this->blocks.clear();
+        this->blockIndices.clear();
+        this->numberOfBlocks = 0;
+        this->mostRecentBlock = -1;
+        this->leastRecentBlock = -1;
+    }
+    {
+        // Lock the Stats
+        std::lock_guard<std::mutex> lock(this->statsMutex);
+        // Forget the files and zero the categories
+        this->fileStats.clear();
+        this->fileIds.clear();
+        for (unsigned int i = 0; i < this->categories.size(); i++)
+            this->categories[i].stats.reset();
+    }
+}
+
+void AudioFileSystem::setReadAheadBlocks(int readAheadBlocks)
+{
+    // Validate the number of blocks
+    if (readAheadBlocks < 0)
+    {
+        std::cout << "void AudioFileSystem::setReadAheadBlocks() failure. readAheadBlocks must not be negative" << std::endl;
+        return;
+    }
+    // Set Read Ahead Blocks
+    this->readAheadBlocks = readAheadBlocks;
+}
+
+int AudioFileSystem::getNumberOfOpenFiles()
+{
+    // Lock the Files
+    std::lock_guard<std::mutex> lock(this->fileMutex);
+    // return the number of open files
+    return (int)this->files.size();
+}
+
+void AudioFileSystem::getStreamExInfo(FMOD_CREATESOUNDEXINFO& exinfo)
+{
+    // Clear the info
+    memset(&exinfo, 0, sizeof(FMOD_CREATESOUNDEXINFO));
+    exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+    // FMOD hands the file user data to openCallback
+    exinfo.fileuserdata = (void*)&streamTag;
+}
+
+int AudioFileSystem::addCategory(const std::string& name, const std::string& pathPrefix)
+{
+    // Lock the Stats
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    // A category with the same name takes the new prefix
+    for (unsigned int i = 1; i < this->categories.size(); i++)
+    {
+        if (this->categories[i].stats.name == name)
+        {
+            this->categories[i].pathPrefix = pathPrefix;
+            return (int)i;
+        }
+    }
+    // Room for another
+    if ((int)this->categories.size() >= AUDIOFILESYSTEM_MAX_CATEGORIES)
+    {
+        std::cout << "int AudioFileSystem::addCategory() failure. No room for " << name << std::endl;
+        return -1;
+    }
+    // Add the category
+    AudioFileCategory category;
+    category.pathPrefix = pathPrefix;
+    category.stats.name = name;
+    category.stats.category = name;
+    this->categories.push_back(category);
+    // return the index
+    return (int)this->categories.size() - 1;
+}
+
+int AudioFileSystem::findCategory(const std::string& name)
+{
+    // Lock the Stats
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    // Find the category
+    for (unsigned int i = 0; i < this->categories.size(); i++)
+    {
+        if (this->categories[i].stats.name == name)
+            return (int)i;
+    }
+    // Not found
+    return -1;
+}
+
+int AudioFileSystem::getNumberOfCategories()
+{
+    // Lock the Stats
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    // return the number of categories
+    return (int)this->categories.size();
+}
+
+AudioFileStats AudioFileSystem::getCategoryStats(int category)
+{
+    // Lock the Stats
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    // Validate the category
+    if (category < 0 || category >= (int)this->categories.size())
+        return AudioFileStats();
+    // return the counters
+    return this->categories[category].stats;
+}
+
+bool AudioFileSystem::getFileStats(const std::string& filename, AudioFileStats& stats)
+{
+    // Lock the Stats
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    // Find the file
+    std::map<std::string, AudioFileStats>::iterator iter = this->fileStats.find(filename);
+    if (iter == this->fileStats.end())
+        return false;
+    // Copy the counters
+    stats = iter->second;
+    // Success
+    return true;
+}
+
+void AudioFileSystem::getAllFileStats(std::vector<AudioFileStats>& stats)
+{
+    // Lock the Stats
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    // Copy the counters of every file
+    stats.clear();
+    stats.reserve(this->fileStats.size());
+    for (std::map<std::string, AudioFileStats>::iterator iter = this->fileStats.begin(); iter != this->fileStats.end(); iter++)
+        stats.push_back(iter->second);
+}
+
+AudioFileStats AudioFileSystem::getTotalStats()
+{
+    // Lock the Stats
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    // Every file is in one category so add the categories up
+    AudioFileStats total;
+    total.name = "total";
+    for (unsigned int i = 0; i < this->categories.size(); i++)
+        total.add(this->categories[i].stats);
+    // return the total
+    return total;
+}
+
+void AudioFileSystem::resetStats()
+{
+    // Lock the Stats
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    // Zero the files
+    for (std::map<std::string, AudioFileStats>::iterator iter = this->fileStats.begin(); iter != this->fileStats.end(); iter++)
+        iter->second.reset();
+    // Zero the categories
+    for (unsigned int i = 0; i < this->categories.size(); i++)
+        this->categories[i].stats.reset();
+}
+
+FMOD_RESULT AudioFileSystem::openFile(const char* filename, unsigned int* pFileSize, void** ppHandle, bool streamFlag)
+{
+    // Open the file
+    FILE* pFile = fopen(filename, "rb");
+    if (pFile == 0)
+        return FMOD_ERR_FILE_NOTFOUND;
+    // Find its size (FMOD takes file sizes as 32 bits)
+    long long size = -1;
+    if (fseek(pFile, 0, SEEK_END) == 0)
+        size = AudioFileSystem::tellFile(pFile);
+    if (size < 0 || size > 0xFFFFFFFFLL || AudioFileSystem::seekFile(pFile, 0) == false)
+    {
+        fclose(pFile);
+        return FMOD_ERR_FILE_BAD;
+    }
+    // Make the file
+    AudioFile* pAudioFile = new AudioFile();
+    pAudioFile->pFile = pFile;
+    pAudioFile->size = (unsigned int)size;
+    pAudioFile->position = 0;
+    pAudioFile->diskPosition = 0;
+    pAudioFile->nextOffset = 0;
+    pAudioFile->sequentialReads = 0;
+    pAudioFile->streamFlag = streamFlag;
+    {
+        // Lock the Stats
+        std::lock_guard<std::mutex> lock(this->statsMutex);
+        // Category
+        std::string name(filename);
+        pAudioFile->category = this->getCategory(name);
+        // Cache id (kept by name so a file opened again finds its blocks)
+        std::map<std::string, unsigned int>::iterator iter = this->fileIds.find(name);
+        if (iter == this->fileIds.end())
+            iter = this->fileIds.insert(std::make_pair(name, (unsigned int)this->fileIds.size() + 1)).first;
+        pAudioFile->id = iter->second;
+        // Counters
+        AudioFileStats& stats = this->fileStats[name];
+        stats.name = name;
+        stats.category = this->categories[pAudioFile->category].stats.name;
+        stats.numberOfOpens++;
+        this->categories[pAudioFile->category].stats.numberOfOpens++;
+        pAudioFile->pStats = &stats;
+    }
+    {
+        // Lock the Files
+        std::lock_guard<std::mutex> lock(this->fileMutex);
+        // Add it
+        this->files.push_back(pAudioFile);
+    }
+    // Hand the file to FMOD
+    *pFileSize = pAudioFile->size;
+    *ppHandle = (void*)pAudioFile;
+    // Success
+    return FMOD_OK;
+}
+
+FMOD_RESULT AudioFileSystem::closeFile(AudioFile* pAudioFile)
+{
+    {
+        // Lock the Files
+        std::lock_guard<std::mutex> lock(this->fileMutex);
+        // Forget the file (its blocks stay in the cache)
+        std::vector<AudioFile*>::iterator iter = std::find(this->files.begin(), this->files.end(), pAudioFile);
+        if (iter == this->files.end())
+            return FMOD_ERR_INVALID_HANDLE;
+        this->files.erase(iter);
+    }
+    // Close the file
+    fclose(pAudioFile->pFile);
+    delete pAudioFile;
+    // Success
+    return FMOD_OK;
+}
+
+FMOD_RESULT AudioFileSystem::readFile(AudioFile* pAudioFile, void* pBuffer, unsigned int offset, unsigned int sizeBytes, unsigned int* pBytesRead)
+{
+    // Counters for this read
+    AudioFileStats stats;
+    stats.numberOfReads = 1;
+    stats.bytesRequested = sizeBytes;
+    FMOD_RESULT result = FMOD_OK;
+    unsigned int done = 0;
+    {
+        // Lock the File
+        std::lock_guard<std::mutex> lock(pAudioFile->mutex);
+        // Reading on from where the last read finished is streaming
+        if (offset == pAudioFile->nextOffset)
+            pAudioFile->sequentialReads++;
+        else
+            pAudioFile->sequentialReads = 0;
+        // Nothing past the end of the file
+        unsigned int available = (offset < pAudioFile->size) ? pAudioFile->size - offset : 0;
+        unsigned int toRead = std::min(sizeBytes, available);
+        // Most blocks read in one go (leaving the rest of the cache to the other files)
+        int maxBlocks = std::max(1, std::min(AUDIOFILESYSTEM_MAX_COALESCE_BLOCKS, this->numberOfBlocks / 4));
+        // Copy block by block
+        char* pDestination = (char*)pBuffer;
+        while (done < toRead)
+        {
+            // Where in which block
+            unsigned int position = offset + done;
+            unsigned int block = position / this->blockSize;
+            unsigned int blockOffset = position % this->blockSize;
+            unsigned int chunk = std::min(this->blockSize - blockOffset, toRead - done);
+            // In the cache
+            if (this->copyBlock(AudioFileSystem::makeKey(pAudioFile->id, block), blockOffset, pDestination + done, chunk) == true)
+            {
+                stats.cacheHits++;
+                done += chunk;
+                continue;
+            }
+            stats.cacheMisses++;
+            // Read the rest of the request in one go and, when streaming, the blocks after it
+            unsigned int lastRequestBlock = (offset + toRead - 1) / this->blockSize;
+            unsigned int lastBlock = lastRequestBlock;
+            if (pAudioFile->sequentialReads >= AUDIOFILESYSTEM_SEQUENTIAL_READS)
+                lastBlock += (unsigned int)this->readAheadBlocks;
+            lastBlock = std::min(lastBlock, (pAudioFile->size - 1) / this->blockSize);
+            int count = 1;
+            while (count < maxBlocks && block + count <= lastBlock && this->hasBlock(AudioFileSystem::makeKey(pAudioFile->id, block + count)) == false)
+                count++;
+            long long bytes = this->readBlocks(pAudioFile, block, count, stats);
+            if (block + count - 1 > lastRequestBlock)
+                stats.readAheadBlocks += (long long)(block + count - 1 - lastRequestBlock);
+            // The disk gave us less than the file size said
+            if (bytes < (long long)(blockOffset + chunk))
+            {
+                result = FMOD_ERR_FILE_BAD;
+                break;
+            }
+            // Copy out of what was read
+            memcpy(pDestination + done, &(pAudioFile->buffer[blockOffset]), chunk);
+            done += chunk;
+        }
+        // The next sequential read starts here
+        pAudioFile->nextOffset = offset + done;
+    }
+    // Hand back the bytes read
+    if (pBytesRead != 0)
+        *pBytesRead = done;
+    stats.bytesRead = done;
+    // Count the read
+    this->addStats(pAudioFile, stats);
+    // Reading less than asked for is the end of the file
+    if (result == FMOD_OK && done < sizeBytes)
+        result = FMOD_ERR_FILE_EOF;
+    // return the result
+    return result;
+}
+
+long long AudioFileSystem::readBlocks(AudioFile* pAudioFile, unsigned int firstBlock, int numberOfBlocks, AudioFileStats& stats)
+{
+    // Bytes to read (the last block may be short)
+    long long start = (long long)firstBlock * (long long)this->blockSize;
+    if (start >= (long long)pAudioFile->size)
+        return 0;
+    unsigned int bytes = (unsigned int)std::min((long long)numberOfBlocks * (long long)this->blockSize, (long long)pAudioFile->size - start);
+    if (pAudioFile->buffer.size() < bytes)
+        pAudioFile->buffer.resize(bytes);
+    // Read off the disk (no seek when the disk is already there)
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    if (pAudioFile->diskPosition != start && AudioFileSystem::seekFile(pAudioFile->pFile, start) == false)
+    {
+        pAudioFile->diskPosition = -1;
+        return -1;
+    }
+    size_t bytesRead = fread(&(pAudioFile->buffer[0]), 1, bytes, pAudioFile->pFile);
+    pAudioFile->diskPosition = (bytesRead == bytes) ? start + (long long)bytesRead : -1;
+    float time = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - begin).count();
+    // Count the disk read
+    stats.numberOfDiskReads++;
+    stats.bytesFromDisk += (long long)bytesRead;
+    stats.diskTime += time;
+    stats.longestDiskRead = std::max(stats.longestDiskRead, time);
+    // Put the blocks in the cache
+    for (int i = 0; i < numberOfBlocks; i++)
+    {
+        unsigned int blockStart = (unsigned int)i * this->blockSize;
+        if (blockStart >= bytesRead)
+            break;
+        this->storeBlock(AudioFileSystem::makeKey(pAudioFile->id, firstBlock + i), &(pAudioFile->buffer[blockStart]), std::min(this->blockSize, (unsigned int)bytesRead - blockStart));
+    }
+    // return the bytes read
+    return (long long)bytesRead;
+}
+
+int AudioFileSystem::getCategory(const std::string& filename)
+{
+    // The first category whose prefix starts the path
+    for (unsigned int i = 1; i < this->categories.size(); i++)
+    {
+        const std::string& pathPrefix = this->categories[i].pathPrefix;
+        if (filename.compare(0, pathPrefix.size(), pathPrefix) == 0)
+            return (int)i;
+    }
+    // Default
+    return 0;
+}
+
+void AudioFileSystem::addStats(AudioFile* pAudioFile, const AudioFileStats& stats)
+{
+    // Lock the Stats
+    std::lock_guard<std::mutex> lock(this->statsMutex);
+    // Add to the file and its category
+    pAudioFile->pStats->add(stats);
+    this->categories[pAudioFile->category].stats.add(stats);
+}
+
+bool AudioFileSystem::copyBlock(unsigned long long key, unsigned int offset, char* pBuffer, unsigned int sizeBytes)
+{
+    // Lock the Cache
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+    // Find the block
+    std::unordered_map<unsigned long long, int>::iterator iter = this->blockIndices.find(key);
+    if (iter == this->blockIndices.end())
+        return false;
+    CacheBlock& block = this->blocks[iter->second];
+    if (offset + sizeBytes > block.size)
+        return false;
+    // Copy the bytes
+    memcpy(pBuffer, &(this->blockData[(size_t)iter->second * (size_t)this->blockSize + offset]), sizeBytes);
+    // Recently used
+    this->touchBlock(iter->second);
+    // Success
+    return true;
+}
+
+bool AudioFileSystem::hasBlock(unsigned long long key)
+{
+    // Lock the Cache
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+    // Find the block
+    return (this->blockIndices.find(key) != this->blockIndices.end());
+}
+
+void AudioFileSystem::storeBlock(unsigned long long key, const char* pData, unsigned int size)
+{
+    // Lock the Cache
+    std::lock_guard<std::mutex> lock(this->cacheMutex);
+    // No cache
+    if (this->numberOfBlocks == 0)
+        return;
+    // Already cached or take the least recently used block
+    int index = -1;
+    std::unordered_map<unsigned long long, int>::iterator iter = this->blockIndices.find(key);
+    if (iter != this->blockIndices.end())
+    {
+        index = iter->second;
+    }
+    else
+    {
+        index = this->leastRecentBlock;
+        if (this->blocks[index].key != 0)
+            this->blockIndices.erase(this->blocks[index].key);
+        this->blockIndices[key] = index;
+    }
+    // Fill the block
+    this->blocks[index].key = key;
+    this->blocks[index].size = size;
+    memcpy(&(this->blockData[(size_t)index * (size_t)this->blockSize]), pData, size);
+    // Recently used
+    this->touchBlock(index);
+}
+
+void AudioFileSystem::touchBlock(int index)
+{
+    // Already at the front
+    if (index == this->mostRecentBlock)
+        return;
+    // Take it out of the list
+    CacheBlock& block = this->blocks[index];
+    if (block.previous != -1)
+        this->blocks[block.previous].next = block.next;
+    if (block.next != -1)
+        this->blocks[block.next].previous = block.previous;
+    else
+        this->leastRecentBlock = block.previous;
+    // Put it at the front
+    block.previous = -1;
+    block.next = this->mostRecentBlock;
+    this->blocks[this->mostRecentBlock].previous = index;
+    this->mostRecentBlock = index;
+}
+
+bool AudioFileSystem::seekFile(FILE* pFile, long long offset)
+{
+    #ifdef _WIN32
+        return (_fseeki64(pFile, offset, SEEK_SET) == 0);
+    #else
+        return (fseeko(pFile, (off_t)offset, SEEK_SET) == 0);
+    #endif
+}
+
+long long AudioFileSystem::tellFile(FILE* pFile)
+{
+    #ifdef _WIN32
+        return (long long)_ftelli64(pFile);
+    #else
+        return (long long)ftello(pFile);
+    #endif
+}
+
+FMOD_RESULT F_CALLBACK AudioFileSystem::openCallback(const char* name, unsigned int* pFileSize, void** ppHandle, void* pUserData)
+{
+    // Grab the File System
+    AudioFileSystem* pAudioFileSystem = FMODGlobals::pAudioFileSystem;
+    if (pAudioFileSystem == 0 || name == 0)
+        return FMOD_ERR_FILE_NOTFOUND;
+    // Open the file
+    return pAudioFileSystem->openFile(name, pFileSize, ppHandle, (pUserData == (void*)&streamTag));
+}
+
+FMOD_RESULT F_CALLBACK AudioFileSystem::closeCallback(void* pHandle, void* /*pUserData*/)
+{
+    // Grab the File System
+    AudioFileSystem* pAudioFileSystem = FMODGlobals::pAudioFileSystem;
+    if (pAudioFileSystem == 0 || pHandle == 0)
+        return FMOD_ERR_INVALID_HANDLE;
+    // Close the file
+    return pAudioFileSystem->closeFile((AudioFile*)pHandle);
+}
+
+FMOD_RESULT F_CALLBACK AudioFileSystem::readCallback(void* pHandle, void* pBuffer, unsigned int sizeBytes, unsigned int* pBytesRead, void* /*pUserData*/)
+{
+    // Grab the File System
+    AudioFileSystem* pAudioFileSystem = FMODGlobals::pAudioFileSystem;
+    if (pAudioFileSystem == 0 || pHandle == 0)
+        return FMOD_ERR_INVALID_HANDLE;
+    // Read from the file position (FMOD never reads and seeks a file at the same time)
+    AudioFile* pAudioFile = (AudioFile*)pHandle;
+    unsigned int bytesRead = 0;
+    FMOD_RESULT result = pAudioFileSystem->readFile(pAudioFile, pBuffer, pAudioFile->position, sizeBytes, &bytesRead);
+    pAudioFile->position += bytesRead;
+    // Hand back the bytes read
+    if (pBytesRead != 0)
+        *pBytesRead = bytesRead;
+    // return the result
+    return result;
+}
+
+FMOD_RESULT F_CALLBACK AudioFileSystem::seekCallback(void* pHandle, unsigned int position, void* /*pUserData*/)
+{
+    // Grab the File System
+    AudioFileSystem* pAudioFileSystem = FMODGlobals::pAudioFileSystem;
+    if (pAudioFileSystem == 0 || pHandle == 0)
+        return FMOD_ERR_INVALID_HANDLE;
+    // Count seeks which move
+    AudioFile* pAudioFile = (AudioFile*)pHandle;
+    if (position != pAudioFile->position)
+    {
+        AudioFileStats stats;
+        stats.numberOfSeeks = 1;
+        pAudioFileSystem->addStats(pAudioFile, stats);
+    }
+    // Move the file position (the disk only moves when a block is missing)
+    pAudioFile->position = position;
+    // Success
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALLBACK AudioFileSystem::asyncReadCallback(FMOD_ASYNCREADINFO* pInfo, void* /*pUserData*/)
+{
+    // Grab the File System
+    AudioFileSystem* pAudioFileSystem = FMODGlobals::pAudioFileSystem;
+    if (pAudioFileSystem == 0 || pInfo == 0 || pInfo->handle == 0)
+        return FMOD_ERR_INVALID_HANDLE;
+    // Queue it (streams ahead of loads)
+    AudioFile* pAudioFile = (AudioFile*)pInfo->handle;
+    if (pAudioFileSystem->ioScheduler.submit(pInfo, (pAudioFile->streamFlag == true) ? AUDIOIO_LANE_STREAM : AUDIOIO_LANE_LOAD) == true)
+        return FMOD_OK;
+    // No threads so read straight away (the cache makes most of these a copy)
+    pInfo->bytesread = 0;
+    FMOD_RESULT result = pAudioFileSystem->readFile((AudioFile*)pInfo->handle, pInfo->buffer, pInfo->offset, pInfo->sizebytes, &(pInfo->bytesread));
+    // Tell FMOD the read is done
+    pInfo->done(pInfo, result);
+    // Success
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALLBACK AudioFileSystem::asyncCancelCallback(FMOD_ASYNCREADINFO* pInfo, void* /*pUserData*/)
+{
+    // Grab the File System
+    AudioFileSystem* pAudioFileSystem = FMODGlobals::pAudioFileSystem;
+    if (pAudioFileSystem == 0 || pInfo == 0)
+        return FMOD_OK;
+    // Take it out of the queue (or wait for it if it is being read)
+    return pAudioFileSystem->ioScheduler.cancel(pInfo);
+}
+
+FMOD_RESULT AudioFileSystem::scheduledReadCallback(FMOD_ASYNCREADINFO* pInfo, void* pUserData)
+{
+    // Grab the File System
+    AudioFileSystem* pAudioFileSystem = (AudioFileSystem*)pUserData;
+    // Read through the cache
+    pInfo->bytesread = 0;
+    return pAudioFileSystem->readFile((AudioFile*)pInfo->handle, pInfo->buffer, pInfo->offset, pInfo->sizebytes, &(pInfo->bytesread));
+}
@@ -0,0 +1,353 @@
+/**
+  * @file   AudioFileSystem.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  AudioFileSystem gives FMOD file callbacks which read through
+  * a shared block cache with read-ahead and keep I/O stats
+*/
+
+#ifndef AUDIOFILESYSTEM_H
+#define AUDIOFILESYSTEM_H
+
+// C++ Includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+#include <fmod_errors.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "System/AudioFileStats.h"
+#include "System/AudioIOScheduler.h"
+
+// Default size of a cache block in bytes
+const unsigned int AUDIOFILESYSTEM_DEFAULT_BLOCK_SIZE = 64 * 1024;
+// Default number of cache blocks
+const int AUDIOFILESYSTEM_DEFAULT_NUMBER_OF_BLOCKS = 256;
+// Default number of blocks read ahead of a sequential reader
+const int AUDIOFILESYSTEM_DEFAULT_READ_AHEAD_BLOCKS = 4;
+// Most blocks read off the disk in one go
+const int AUDIOFILESYSTEM_MAX_COALESCE_BLOCKS = 16;
+// Sequential reads in a row before a file counts as streaming
+const int AUDIOFILESYSTEM_SEQUENTIAL_READS = 2;
+// Byte alignment FMOD reads at through the callbacks
+const int AUDIOFILESYSTEM_BLOCK_ALIGN = 2048;
+// Most categories
+const int AUDIOFILESYSTEM_MAX_CATEGORIES = 16;
+
+/** Without file callbacks FMOD reads every sample and stream with its own
+    blocking file I/O in 2KB chunks; with half a dozen streams on a
+    spinning disk the head spends its time seeking between them and the
+    streams starve. The AudioFileSystem is attached in place of that. Every
+    read goes through one block cache shared by all files (least recently
+    used blocks are thrown out first), so the small reads FMOD makes become
+    one block sized read from the disk. Where blocks are missing several are
+    read in one go, and a file read sequentially (a stream) has the blocks
+    after the request read along with it, so each stream goes to the disk
+    once every few blocks instead of once every few kilobytes. Blocks are
+    keyed by file name so a stream closed and opened again finds its
+    blocks still there. Counters are kept for every file and for every
+    category (files are put in a category by the start of their path) and
+    can be read at any time. Attached async the reads are handed to an
+    AudioIOScheduler, with files opened through getStreamExInfo refilled
+    in its stream lane ahead of everything else **/
+class AudioFileSystem
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        AudioFileSystem();
+        //! Destructor
+        virtual ~AudioFileSystem();
+
+    protected:
+        //! AudioFileSystem Copy constructor
+        AudioFileSystem(const AudioFileSystem& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! AudioFileSystem Assignment operator
+        AudioFileSystem& operator=(const AudioFileSystem& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief create
+          * Size the block cache (the cache is created with the defaults on attach otherwise)
+          * @param blockSize size of a block in bytes
+          * @param numberOfBlocks number of blocks
+          * @return false if files are open or the sizes are bad **/
+        virtual bool create(unsigned int blockSize, int numberOfBlocks);
+        /** @brief attach
+          * Hand FMOD's file I/O to the AudioFileSystem. Sounds and streams
+          * created after this read through it
+          * @param asyncFlag true to give FMOD the async read callbacks (read on the IOScheduler's threads) instead of read and seek
+          * @return true on success **/
+        virtual bool attach(bool asyncFlag = false);
+        /** @brief detach
+          * Hand file I/O back to FMOD (files already open keep reading through us) **/
+        virtual void detach();
+        /** @brief isAttached
+          * @return true while FMOD reads through the AudioFileSystem **/
+        virtual bool isAttached() { return this->attachedFlag; }
+        /** @brief clear
+          * Close every file and forget the cache and the counters **/
+        virtual void clear();
+
+    public:
+        /** @brief Get Block Size
+          * @return size of a cache block in bytes **/
+        virtual unsigned int getBlockSize() { return this->blockSize; }
+        /** @brief Get Number of Blocks
+          * @return number of cache blocks **/
+        virtual int getNumberOfBlocks() { return this->numberOfBlocks; }
+        /** @brief Get Read Ahead Blocks
+          * @return blocks read ahead of a sequential reader **/
+        virtual int getReadAheadBlocks() { return this->readAheadBlocks; }
+        /** @brief Set Read Ahead Blocks
+          * @param readAheadBlocks blocks read ahead of a sequential reader (0 for none) **/
+        virtual void setReadAheadBlocks(int readAheadBlocks);
+        /** @brief Get the number of open files
+          * @return open files **/
+        virtual int getNumberOfOpenFiles();
+        /** @brief Get the IO Scheduler
+          * @return the scheduler async reads are queued on **/
+        virtual AudioIOScheduler* getIOScheduler() { return &(this->ioScheduler); }
+        /** @brief getStreamExInfo
+          * Fill exinfo so a stream opened with it is refilled in the stream lane
+          * @param exinfo receives the info to pass to FMOD_System_CreateSound **/
+        static void getStreamExInfo(FMOD_CREATESOUNDEXINFO& exinfo);
+
+    // **********************
+    // * CATEGORY FUNCTIONS *
+    // **********************
+    public:
+        /** @brief addCategory
+          * Files whose path starts with the prefix are counted in the category
+          * (the first category added which matches wins, the rest are "default")
+          * @param name name of the category
+          * @param pathPrefix start of the path of the files in the category
+          * @return index of the category or -1 if there is no room **/
+        virtual int addCategory(const std::string& name, const std::string& pathPrefix);
+        /** @brief findCategory
+          * @param name name of the category
+          * @return index of the category or -1 **/
+        virtual int findCategory(const std::string& name);
+        /** @brief Get the number of categories
+          * @return categories (including "default") **/
+        virtual int getNumberOfCategories();
+
+    // *******************
+    // * STATS FUNCTIONS *
+    // *******************
+    public:
+        /** @brief getCategoryStats
+          * @param category index of the category (0 is "default")
+          * @return counters of the files in the category **/
+        virtual AudioFileStats getCategoryStats(int category);
+        /** @brief getFileStats
+          * @param filename name of the file (as FMOD opened it)
+          * @param stats receives the counters of the file
+          * @return false if the file was never opened **/
+        virtual bool getFileStats(const std::string& filename, AudioFileStats& stats);
+        /** @brief getAllFileStats
+          * @param stats receives the counters of every file ever opened **/
+        virtual void getAllFileStats(std::vector<AudioFileStats>& stats);
+        /** @brief getTotalStats
+          * @return counters of every file added together **/
+        virtual AudioFileStats getTotalStats();
+        /** @brief resetStats
+          * Zero every counter **/
+        virtual void resetStats();
+
+    protected:
+        // An open file
+        struct AudioFile
+        {
+            // The file
+            FILE* pFile;
+            // Size of the file in bytes
+            unsigned int size;
+            // Read position (read and seek callbacks)
+            unsigned int position;
+            // Where the disk is after the last disk read (-1 if unknown)
+            long long diskPosition;
+            // Identifies the file's blocks in the cache
+            unsigned int id;
+            // Category of the file
+            int category;
+            // Counters of the file
+            AudioFileStats* pStats;
+            // Offset a sequential read would start at next
+            unsigned int nextOffset;
+            // Sequential reads in a row
+            int sequentialReads;
+            // Opened as a stream (async reads go in the stream lane)
+            bool streamFlag;
+            // Blocks read off the disk
+            std::vector<char> buffer;
+            // Guards the file (FMOD may read from more than one thread)
+            std::mutex mutex;
+        };
+        // A cache block
+        struct CacheBlock
+        {
+            // File id and block index (0 while the block is unused)
+            unsigned long long key;
+            // Bytes in the block (less than the block size at the end of a file)
+            unsigned int size;
+            // Recently used list (more recent, less recent)
+            int previous;
+            int next;
+        };
+        // A category
+        struct AudioFileCategory
+        {
+            // Start of the path
+            std::string pathPrefix;
+            // Counters
+            AudioFileStats stats;
+        };
+
+    protected:
+        /** @brief openFile
+          * @param filename name of the file
+          * @param pFileSize receives the size of the file
+          * @param ppHandle receives the AudioFile
+          * @param streamFlag true if the file was opened as a stream
+          * @return FMOD_OK or FMOD_ERR_FILE_NOTFOUND **/
+        virtual FMOD_RESULT openFile(const char* filename, unsigned int* pFileSize, void** ppHandle, bool streamFlag);
+        /** @brief closeFile
+          * @param pAudioFile the file **/
+        virtual FMOD_RESULT closeFile(AudioFile* pAudioFile);
+        /** @brief readFile
+          * Read through the cache
+          * @param pAudioFile the file
+          * @param pBuffer receives the bytes
+          * @param offset where to read from
+          * @param sizeBytes bytes to read
+          * @param pBytesRead receives the bytes read
+          * @return FMOD_OK, FMOD_ERR_FILE_EOF if the end was reached or FMOD_ERR_FILE_BAD **/
+        virtual FMOD_RESULT readFile(AudioFile* pAudioFile, void* pBuffer, unsigned int offset, unsigned int sizeBytes, unsigned int* pBytesRead);
+        /** @brief readBlocks (the file lock must be held)
+          * Read blocks off the disk into the file's buffer and the cache
+          * @param pAudioFile the file
+          * @param firstBlock first block
+          * @param numberOfBlocks blocks to read
+          * @param stats receives the disk counters
+          * @return bytes read or -1 on error **/
+        virtual long long readBlocks(AudioFile* pAudioFile, unsigned int firstBlock, int numberOfBlocks, AudioFileStats& stats);
+        /** @brief getCategory
+          * @param filename name of the file
+          * @return category of the file **/
+        virtual int getCategory(const std::string& filename);
+        /** @brief addStats
+          * @param pAudioFile the file
+          * @param stats counters to add to the file and its category **/
+        virtual void addStats(AudioFile* pAudioFile, const AudioFileStats& stats);
+
+    protected:
+        /** @brief makeKey
+          * @param id id of the file
+          * @param block index of the block
+          * @return cache key **/
+        static inline unsigned long long makeKey(unsigned int id, unsigned int block) { return ((unsigned long long)id << 32) | (unsigned long long)block; }
+        /** @brief copyBlock
+          * @param key cache key
+          * @param offset offset in the block
+          * @param pBuffer receives the bytes
+          * @param sizeBytes bytes to copy
+          * @return false if the block is not in the cache (or is short) **/
+        virtual bool copyBlock(unsigned long long key, unsigned int offset, char* pBuffer, unsigned int sizeBytes);
+        /** @brief hasBlock
+          * @param key cache key
+          * @return true if the block is in the cache **/
+        virtual bool hasBlock(unsigned long long key);
+        /** @brief storeBlock
+          * Put a block in the cache in place of the least recently used one
+          * @param key cache key
+          * @param pData the bytes
+          * @param size number of bytes **/
+        virtual void storeBlock(unsigned long long key, const char* pData, unsigned int size);
+        /** @brief touchBlock (the cache lock must be held)
+          * Move a block to the front of the recently used list
+          * @param index index of the block **/
+        virtual void touchBlock(int index);
+        /** @brief seekFile
+          * Move a file with a 64 bit offset (fseek takes a long, 32 bits on Windows)
+          * @param pFile the file
+          * @param offset bytes from the start
+          * @return true on success **/
+        static bool seekFile(FILE* pFile, long long offset);
+        /** @brief tellFile
+          * @param pFile the file
+          * @return the 64 bit file position or -1 on failure **/
+        static long long tellFile(FILE* pFile);
+
+    protected:
+        /** @brief The callbacks FMOD calls (they find us through FMODGlobals) **/
+        static FMOD_RESULT F_CALLBACK openCallback(const char* name, unsigned int* pFileSize, void** ppHandle, void* pUserData);
+        static FMOD_RESULT F_CALLBACK closeCallback(void* pHandle, void* pUserData);
+        static FMOD_RESULT F_CALLBACK readCallback(void* pHandle, void* pBuffer, unsigned int sizeBytes, unsigned int* pBytesRead, void* pUserData);
+        static FMOD_RESULT F_CALLBACK seekCallback(void* pHandle, unsigned int position, void* pUserData);
+        static FMOD_RESULT F_CALLBACK asyncReadCallback(FMOD_ASYNCREADINFO* pInfo, void* pUserData);
+        static FMOD_RESULT F_CALLBACK asyncCancelCallback(FMOD_ASYNCREADINFO* pInfo, void* pUserData);
+        /** @brief The read the IOScheduler's threads do **/
+        static FMOD_RESULT scheduledReadCallback(FMOD_ASYNCREADINFO* pInfo, void* pUserData);
+
+    protected:
+        // Attached Flag
+        bool attachedFlag;
+        // Block Size
+        unsigned int blockSize;
+        // Number of Blocks
+        int numberOfBlocks;
+        // Read Ahead Blocks
+        int readAheadBlocks;
+        // Open files
+        std::vector<AudioFile*> files;
+        // Guards files
+        std::mutex fileMutex;
+        // Block memory
+        std::vector<char> blockData;
+        // Blocks
+        std::vector<CacheBlock> blocks;
+        // Where each cached block is
+        std::unordered_map<unsigned long long, int> blockIndices;
+        // Most and least recently used blocks
+        int mostRecentBlock;
+        int leastRecentBlock;
+        // Guards the cache
+        std::mutex cacheMutex;
+        // Categories
+        std::vector<AudioFileCategory> categories;
+        // Counters of every file ever opened (by name)
+        std::map<std::string, AudioFileStats> fileStats;
+        // Cache ids of the files (by name)
+        std::map<std::string, unsigned int> fileIds;
+        // Guards categories, fileStats and fileIds
+        std::mutex statsMutex;
+        // Async reads
+        AudioIOScheduler ioScheduler;
+};
+
+#endif // AUDIOFILESYSTEM_H
@@ -0,0 +1,269 @@
+#include "AudioIOScheduler.h"
+
+AudioIOScheduler::AudioIOScheduler()
+{
+    // Not running
+    this->runningFlag.store(false);
+    this->stopFlag = false;
+    // Read Callback
+    this->pReadCallBack = 0;
+    this->pUserData = 0;
+    // Loads
+    this->activeLoads = 0;
+    this->maxActiveLoads = 1;
+    // Sequence
+    this->sequence = 0;
+    // Stream Deadline
+    this->streamDeadline = AUDIOIOSCHEDULER_DEFAULT_STREAM_DEADLINE;
+    // Counters
+    this->resetStats();
+}
+
+AudioIOScheduler::~AudioIOScheduler()
+{
+    // Never leave the threads running past the scheduler
+    this->stop();
+}
+
+bool AudioIOScheduler::start(int numberOfThreads, AUDIOIOSCHEDULER_READ_CALLBACK pReadCallBack, void* pUserData)
+{
+    // Already running
+    if (this->runningFlag.load() == true)
+    {
+        std::cout << "bool AudioIOScheduler::start() failure. Already running" << std::endl;
+        return false;
+    }
+    // Validate the parameters
+    if (numberOfThreads < 1 || pReadCallBack == 0)
+    {
+        std::cout << "bool AudioIOScheduler::start() failure. numberOfThreads must be at least 1 and pReadCallBack must be set" << std::endl;
+        return false;
+    }
+    // Read Callback
+    this->pReadCallBack = pReadCallBack;
+    this->pUserData = pUserData;
+    // Keep a thread back for stream refills (unless there is only one)
+    this->stopFlag = false;
+    this->activeLoads = 0;
+    this->maxActiveLoads = std::max(1, numberOfThreads - 1);
+    // Start the threads
+    for (int i = 0; i < numberOfThreads; i++)
+        this->threads.push_back(std::thread(&AudioIOScheduler::threadFunction, this));
+    this->runningFlag.store(true);
+    // Success
+    return true;
+}
+
+void AudioIOScheduler::stop()
+{
+    // Not running
+    if (this->runningFlag.load() == false)
+        return;
+    {
+        // Lock the Scheduler
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // Ask the threads to finish the queue and stop
+        this->stopFlag = true;
+    }
+    this->workCondition.notify_all();
+    // Wait for them
+    for (unsigned int i = 0; i < this->threads.size(); i++)
+        this->threads[i].join();
+    this->threads.clear();
+    this->runningFlag.store(false);
+}
+
+bool AudioIOScheduler::submit(FMOD_ASYNCREADINFO* pInfo, AUDIOIO_LANE lane)
+{
+    // Not running
+    if (this->runningFlag.load() == false || pInfo == 0)
+        return false;
+    // Validate the lane
+    if (lane < 0 || lane >= AUDIOIO_NUMBER_OF_LANES)
+        lane = AUDIOIO_LANE_LOAD;
+    // Make the request
+    AudioIORequest request;
+    request.pInfo = pInfo;
+    request.queued = std::chrono::steady_clock::now();
+    // The more important FMOD says it is the sooner it is due (priority 100 is due now)
+    float urgency = (float)std::max(0, std::min(100, pInfo->priority)) / 100.0f;
+    float deadline = this->streamDeadline * (1.0f - urgency);
+    request.deadline = request.queued + std::chrono::microseconds((long long)(deadline * 1000.0f));
+    {
+        // Lock the Scheduler
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // Queue it
+        request.sequence = this->sequence++;
+        this->lanes[lane].push_back(request);
+    }
+    // Wake a thread
+    this->workCondition.notify_one();
+    // Success
+    return true;
+}
+
+FMOD_RESULT AudioIOScheduler::cancel(FMOD_ASYNCREADINFO* pInfo)
+{
+    // Lock the Scheduler
+    std::unique_lock<std::mutex> lock(this->mutex);
+    // Still queued so take it out and tell FMOD
+    for (int lane = 0; lane < AUDIOIO_NUMBER_OF_LANES; lane++)
+    {
+        std::vector<AudioIORequest>& requests = this->lanes[lane];
+        for (unsigned int i = 0; i < requests.size(); i++)
+        {
+            if (requests[i].pInfo != pInfo)
+                continue;
+            requests.erase(requests.begin() + i);
+            this->cancelled++;
+            lock.unlock();
+            pInfo->done(pInfo, FMOD_ERR_FILE_DISKEJECTED);
+            return FMOD_ERR_FILE_DISKEJECTED;
+        }
+    }
+    // Being read so wait for it (FMOD must not hear about it after cancel returns)
+    std::vector<FMOD_ASYNCREADINFO*>& reading = this->reading;
+    this->doneCondition.wait(lock, [&reading, pInfo]() { return std::find(reading.begin(), reading.end(), pInfo) == reading.end(); });
+    // Already done
+    return FMOD_OK;
+}
+
+void AudioIOScheduler::setStreamDeadline(float streamDeadline)
+{
+    // Validate the deadline
+    if (streamDeadline < 0.0f)
+    {
+        std::cout << "void AudioIOScheduler::setStreamDeadline() failure. streamDeadline must not be negative" << std::endl;
+        return;
+    }
+    // Lock the Scheduler
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Set Stream Deadline
+    this->streamDeadline = streamDeadline;
+}
+
+int AudioIOScheduler::getNumberOfPending(AUDIOIO_LANE lane)
+{
+    // Validate the lane
+    if (lane < 0 || lane >= AUDIOIO_NUMBER_OF_LANES)
+        return 0;
+    // Lock the Scheduler
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of queued reads
+    return (int)this->lanes[lane].size();
+}
+
+long long AudioIOScheduler::getNumberOfCompleted(AUDIOIO_LANE lane)
+{
+    // Validate the lane
+    if (lane < 0 || lane >= AUDIOIO_NUMBER_OF_LANES)
+        return 0;
+    // Lock the Scheduler
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of reads done
+    return this->completed[lane];
+}
+
+float AudioIOScheduler::getLongestWait(AUDIOIO_LANE lane)
+{
+    // Validate the lane
+    if (lane < 0 || lane >= AUDIOIO_NUMBER_OF_LANES)
+        return 0.0f;
+    // Lock the Scheduler
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the longest wait
+    return this->longestWait[lane];
+}
+
+void AudioIOScheduler::resetStats()
+{
+    // Lock the Scheduler
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Zero the counters
+    for (int lane = 0; lane < AUDIOIO_NUMBER_OF_LANES; lane++)
+    {
+        this->completed[lane] = 0;
+        this->longestWait[lane] = 0.0f;
+    }
+    this->missedDeadlines.store(0);
+    this->cancelled.store(0);
+}
+
+void AudioIOScheduler::threadFunction()
+{
+    while (true)
+    {
+        // Wait for a read this thread may take
+        AudioIORequest request;
+        int lane = 0;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            bool takenFlag = false;
+            this->workCondition.wait(lock, [this, &request, &lane, &takenFlag]()
+            {
+                takenFlag = this->takeRequest(request, lane);
+                return (takenFlag == true || (this->stopFlag == true && this->lanes[AUDIOIO_LANE_STREAM].empty() == true && this->lanes[AUDIOIO_LANE_LOAD].empty() == true));
+            });
+            // Stopped with nothing left
+            if (takenFlag == false)
+                return;
+            // Reading it
+            this->reading.push_back(request.pInfo);
+            if (lane == AUDIOIO_LANE_LOAD)
+                this->activeLoads++;
+            // How long it waited
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            this->longestWait[lane] = std::max(this->longestWait[lane], std::chrono::duration<float, std::milli>(now - request.queued).count());
+            if (lane == AUDIOIO_LANE_STREAM && now > request.deadline)
+                this->missedDeadlines++;
+        }
+        // Read it and tell FMOD
+        FMOD_RESULT result = this->pReadCallBack(request.pInfo, this->pUserData);
+        request.pInfo->done(request.pInfo, result);
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            // Done
+            this->reading.erase(std::find(this->reading.begin(), this->reading.end(), request.pInfo));
+            if (lane == AUDIOIO_LANE_LOAD)
+                this->activeLoads--;
+            this->completed[lane]++;
+        }
+        // Wake cancel and a thread waiting for a load slot
+        this->doneCondition.notify_all();
+        this->workCondition.notify_one();
+    }
+}
+
+bool AudioIOScheduler::takeRequest(AudioIORequest& request, int& lane)
+{
+    // Stream refills first, the earliest deadline
+    std::vector<AudioIORequest>& streams = this->lanes[AUDIOIO_LANE_STREAM];
+    if (streams.empty() == false)
+    {
+        unsigned int best = 0;
+        for (unsigned int i = 1; i < streams.size(); i++)
+        {
+            if (streams[i].deadline < streams[best].deadline || (streams[i].deadline == streams[best].deadline && streams[i].sequence < streams[best].sequence))
+                best = i;
+        }
+        request = streams[best];
+        streams.erase(streams.begin() + best);
+        lane = AUDIOIO_LANE_STREAM;
+        return true;
+    }
+    // Then loads (while a thread is left for the streams)
+    std::vector<AudioIORequest>& loads = this->lanes[AUDIOIO_LANE_LOAD];
+    if (loads.empty() == true || this->activeLoads >= this->maxActiveLoads)
+        return false;
+    // The most important, then the oldest
+    unsigned int best = 0;
+    for (unsigned int i = 1; i < loads.size(); i++)
+    {
+        if (loads[i].pInfo->priority > loads[best].pInfo->priority || (loads[i].pInfo->priority == loads[best].pInfo->priority && loads[i].sequence < loads[best].sequence))
+            best = i;
+    }
+    request = loads[best];
+    loads.erase(loads.begin() + best);
+    lane = AUDIOIO_LANE_LOAD;
+    return true;
+}
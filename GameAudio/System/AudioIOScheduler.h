@@ -0,0 +1,198 @@
+/**
+  * @file   AudioIOScheduler.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  AudioIOScheduler services FMOD's async file reads on a small
+  * pool of threads with stream refills ahead of loads
+*/
+
+#ifndef AUDIOIOSCHEDULER_H
+#define AUDIOIOSCHEDULER_H
+
+// C++ Includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// Lanes a read can be queued in
+enum AUDIOIO_LANE
+{
+    // Stream refills (earliest deadline first)
+    AUDIOIO_LANE_STREAM = 0,
+    // Sample loads and everything else (most important first, then oldest)
+    AUDIOIO_LANE_LOAD,
+    // Number of lanes
+    AUDIOIO_NUMBER_OF_LANES
+};
+
+// Default number of threads
+const int AUDIOIOSCHEDULER_DEFAULT_THREADS = 2;
+// Default time a stream refill of priority 0 has to be done in (milliseconds)
+const float AUDIOIOSCHEDULER_DEFAULT_STREAM_DEADLINE = 100.0f;
+
+/** Does a read for the scheduler (on one of its threads)
+    @param pInfo the read FMOD asked for
+    @param pUserData user data given to start
+    @return the result to hand FMOD **/
+typedef FMOD_RESULT (*AUDIOIOSCHEDULER_READ_CALLBACK)(FMOD_ASYNCREADINFO* pInfo, void* pUserData);
+
+/** With the async read callbacks FMOD hands its reads over and carries on
+    until they are done, so they can be done in any order. The scheduler
+    keeps two lanes. A stream refill has a deadline (the sooner the more
+    important FMOD says it is) and the refill with the earliest deadline
+    is always done next. Sample loads wait in the load lane and are only
+    started when no refill is waiting, and never on every thread at once,
+    so one thread is always free for a stream while a level load has the
+    disk busy. A read FMOD cancels while it is still queued is taken out
+    and finished as cancelled; one being read is waited for **/
+class AudioIOScheduler
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        AudioIOScheduler();
+        //! Destructor
+        virtual ~AudioIOScheduler();
+
+    protected:
+        //! AudioIOScheduler Copy constructor
+        AudioIOScheduler(const AudioIOScheduler& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! AudioIOScheduler Assignment operator
+        AudioIOScheduler& operator=(const AudioIOScheduler& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief start
+          * @param numberOfThreads number of threads reading
+          * @param pReadCallBack does a read
+          * @param pUserData passed to the read callback
+          * @return true on success **/
+        virtual bool start(int numberOfThreads, AUDIOIOSCHEDULER_READ_CALLBACK pReadCallBack, void* pUserData);
+        /** @brief stop
+          * Finish every queued read and stop the threads **/
+        virtual void stop();
+        /** @brief isRunning
+          * @return true while the threads are running **/
+        virtual bool isRunning() { return this->runningFlag.load(); }
+        /** @brief submit
+          * Queue a read (FMOD is told when it is done)
+          * @param pInfo the read FMOD asked for
+          * @param lane AUDIOIO_LANE_STREAM or AUDIOIO_LANE_LOAD
+          * @return false if the scheduler is not running **/
+        virtual bool submit(FMOD_ASYNCREADINFO* pInfo, AUDIOIO_LANE lane);
+        /** @brief cancel
+          * @param pInfo the read FMOD wants cancelled
+          * @return FMOD_ERR_FILE_DISKEJECTED if it was taken out of the queue, FMOD_OK otherwise **/
+        virtual FMOD_RESULT cancel(FMOD_ASYNCREADINFO* pInfo);
+
+    public:
+        /** @brief Get the Stream Deadline
+          * @return milliseconds a stream refill of priority 0 has to be done in **/
+        virtual float getStreamDeadline() { return this->streamDeadline; }
+        /** @brief Set the Stream Deadline (a refill of priority 100 is due straight away)
+          * @param streamDeadline milliseconds a stream refill of priority 0 has to be done in **/
+        virtual void setStreamDeadline(float streamDeadline);
+        /** @brief Get the number of reads waiting
+          * @param lane the lane
+          * @return reads waiting in the lane **/
+        virtual int getNumberOfPending(AUDIOIO_LANE lane);
+        /** @brief Get the number of reads done
+          * @param lane the lane
+          * @return reads done in the lane **/
+        virtual long long getNumberOfCompleted(AUDIOIO_LANE lane);
+        /** @brief Get the number of stream refills started after their deadline
+          * @return missed deadlines **/
+        virtual long long getNumberOfMissedDeadlines() { return this->missedDeadlines.load(); }
+        /** @brief Get the number of reads cancelled while queued
+          * @return cancelled reads **/
+        virtual long long getNumberOfCancelled() { return this->cancelled.load(); }
+        /** @brief Get the longest a read has waited
+          * @param lane the lane
+          * @return milliseconds **/
+        virtual float getLongestWait(AUDIOIO_LANE lane);
+        /** @brief resetStats
+          * Zero the counters **/
+        virtual void resetStats();
+
+    protected:
+        // A queued read
+        struct AudioIORequest
+        {
+            // The read FMOD asked for
+            FMOD_ASYNCREADINFO* pInfo;
+            // When it was queued
+            std::chrono::steady_clock::time_point queued;
+            // When it should be done by (stream lane)
+            std::chrono::steady_clock::time_point deadline;
+            // Order it was queued in
+            unsigned long long sequence;
+        };
+
+    protected:
+        /** @brief threadFunction
+          * Take reads off the lanes until stopped **/
+        virtual void threadFunction();
+        /** @brief takeRequest (lock must be held)
+          * @param request receives the next read
+          * @param lane receives the lane it came from
+          * @return false if there is nothing this thread may take **/
+        virtual bool takeRequest(AudioIORequest& request, int& lane);
+
+    protected:
+        // Threads
+        std::vector<std::thread> threads;
+        // Running Flag
+        std::atomic<bool> runningFlag;
+        // Stop Flag
+        bool stopFlag;
+        // Read Callback
+        AUDIOIOSCHEDULER_READ_CALLBACK pReadCallBack;
+        // Read Callback User Data
+        void* pUserData;
+        // Queued reads for each lane
+        std::vector<AudioIORequest> lanes[AUDIOIO_NUMBER_OF_LANES];
+        // Reads being read right now
+        std::vector<FMOD_ASYNCREADINFO*> reading;
+        // Loads being read right now
+        int activeLoads;
+        // Most loads read at once
+        int maxActiveLoads;
+        // Next sequence number
+        unsigned long long sequence;
+        // Stream Deadline (milliseconds)
+        float streamDeadline;
+        // Counters
+        long long completed[AUDIOIO_NUMBER_OF_LANES];
+        float longestWait[AUDIOIO_NUMBER_OF_LANES];
+        std::atomic<long long> missedDeadlines;
+        std::atomic<long long> cancelled;
+        // Guards everything above
+        std::mutex mutex;
+        // Wakes the threads when there is a read
+        std::condition_variable workCondition;
+        // Wakes cancel when a read is done
+        std::condition_variable doneCondition;
+};
+
+#endif // AUDIOIOSCHEDULER_H
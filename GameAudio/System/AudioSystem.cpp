@@ -6,6 +6,17 @@ FMOD_CHANNELGROUP* FMODGlobals::pSoundEffectsChannelGroup = 0;
 
 FMOD_CHANNELGROUP* FMODGlobals::pMusicChannelGroup = 0;
 
+ChannelCommandQueue* FMODGlobals::pChannelCommandQueue = 0;
+
+VoiceManager* FMODGlobals::pVoiceManager = 0;
+SpatialGrid* FMODGlobals::pSpatialGrid = 0;
+OcclusionService* FMODGlobals::pOcclusionService = 0;
+OcclusionTracer* FMODGlobals::pOcclusionTracer = 0;
+RolloffManager* FMODGlobals::pRolloffManager = 0;
+AudioFileSystem* FMODGlobals::pAudioFileSystem = 0;
+StreamPool* FMODGlobals::pStreamPool = 0;
+AudioSystem* FMODGlobals::pAudioSystem = 0;
+
 AudioSystem::AudioSystem()
 {
     // Paused Flag
@@ -24,11 +35,20 @@ AudioSystem::AudioSystem()
     this->muteMusicFlag = false;
     // Max World Size
     this->maxWorldSize = 100000;
+    // Number of Listeners
+    this->numberOfListeners = 1;
+    // Update Thread Running Flag
+    this->updateThreadRunningFlag.store(false);
+    // Update Rate
+    this->updateRate = 60.0f;
+    // Front Voice State Buffer
+    this->frontVoiceStates = 0;
 }
 
 AudioSystem::~AudioSystem()
 {
-
+    // Never leave the update thread running past the AudioSystem
+    this->stopUpdateThread();
 }
 
 bool AudioSystem::init(int maxChannels)
@@ -62,6 +82,34 @@ bool AudioSystem::init(int maxChannels)
     FMOD_System_CreateChannelGroup(FMODGlobals::pFMODSystem, "MUSIC", &(FMODGlobals::pMusicChannelGroup));
     // Set our local reference to max software channels
     this->maxSoftwareChannels = maxChannels;
+    // Make sure the listeners are sent on the first update
+    for (int i = 0; i < FMOD_MAX_LISTENERS; i++)
+        this->listenerStates[i].dirtyFlag = true;
+    // Set the Number of Listeners
+    FMOD_System_Set3DNumListeners(FMODGlobals::pFMODSystem, this->numberOfListeners);
+    // Let the Channels find the Command Queue
+    FMODGlobals::pChannelCommandQueue = &(this->channelCommandQueue);
+    // Create the Voice Pool
+    this->voicePool.create(256);
+    // Let the Emitter System play on the Voice Pool
+    this->emitterSystem.setVoicePool(&(this->voicePool));
+    // Let the Channels find the Voice Manager
+    FMODGlobals::pVoiceManager = &(this->voiceManager);
+    // Size the Spatial Grid to the world and let the SpatialObjects find it
+    this->spatialGrid.create(this->maxWorldSize, this->spatialGrid.getCellSize());
+    FMODGlobals::pSpatialGrid = &(this->spatialGrid);
+    // Let the 3D Channels and Geometry find the Occlusion Service
+    FMODGlobals::pOcclusionService = &(this->occlusionService);
+    // Let Geometry find the Occlusion Tracer
+    FMODGlobals::pOcclusionTracer = &(this->occlusionTracer);
+    // Let the 3D Channels find the Rolloff Manager
+    FMODGlobals::pRolloffManager = &(this->rolloffManager);
+    // Let the file callbacks find the Audio File System
+    FMODGlobals::pAudioFileSystem = &(this->audioFileSystem);
+    // Let Streams and Music find the Stream Pool
+    FMODGlobals::pStreamPool = &(this->streamPool);
+    // Let the Channels find the AudioSystem
+    FMODGlobals::pAudioSystem = this;
     // Success
     return true;
 }
@@ -81,212 +129,328 @@ void AudioSystem::setOutputByPlugin(unsigned int handle)
     //FMOD_RESULT F_API FMOD_System_SetOutputByPlugin         (FMOD_SYSTEM *system, unsigned int handle);
 }
 
-float AudioSystem::getListenerX()
+float AudioSystem::getListenerX(int listener)
 {
-    // Position Vector
-    FMOD_VECTOR position;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, &position, 0, 0, 0);
-    // Return x position
-    return position.x;
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached x position of the Listener
+    return this->listenerStates[listener].position.x;
 }
 
-float AudioSystem::getListenerY()
+float AudioSystem::getListenerY(int listener)
 {
-    // Position Vector
-    FMOD_VECTOR position;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, &position, 0, 0, 0);
-    // Return y position
-    return position.y;
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached y position of the Listener
+    return this->listenerStates[listener].position.y;
 }
 
-float AudioSystem::getListenerZ()
+float AudioSystem::getListenerZ(int listener)
 {
-    // Position Vector
-    FMOD_VECTOR position;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, &position, 0, 0, 0);
-    // Return z position
-    return position.z;
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached z position of the Listener
+    return this->listenerStates[listener].position.z;
 }
 
 void AudioSystem::setListenerPosition(float positionX, float positionY)
 {
-    // Position Vector
-    FMOD_VECTOR position;
-        position.x = positionX;
-        position.y = positionY;
-        position.z = 0.0f;
-    // Set the Attributes for Listener 0 (default listener)
-    FMOD_System_Set3DListenerAttributes(FMODGlobals::pFMODSystem, 0, &position, 0, 0, 0);
+    // Set the position for Listener 0 (default listener)
+    this->setListenerPosition(positionX, positionY, 0.0f);
 }
 
 void AudioSystem::setListenerPosition(float positionX, float positionY, float positionZ)
 {
-    // Position Vector
-    FMOD_VECTOR position;
-        position.x = positionX;
-        position.y = positionY;
-        position.z = positionZ;
-    // Set the Attributes for Listener 0 (default listener)
-    FMOD_System_Set3DListenerAttributes(FMODGlobals::pFMODSystem, 0, &position, 0, 0, 0);
+    // Set the position for Listener 0 (default listener)
+    this->setListenerPosition(0, positionX, positionY, positionZ);
 }
 
-float AudioSystem::getListenerUpVectorX()
+void AudioSystem::setListenerPosition(int listener, float positionX, float positionY, float positionZ)
 {
-    // Up Vector
-    FMOD_VECTOR up;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, 0, 0, 0, &up);
-    // Return up x
-    return up.x;
+    // Validate the listener index
+    if (this->isValidListener(listener) == false)
+        return;
+    // Lock the Listeners (the update thread may be reading them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Grab the Listener
+    ListenerState& state = this->listenerStates[listener];
+    // Set Position
+    state.position.x = positionX;
+    state.position.y = positionY;
+    state.position.z = positionZ;
+    // Flag the listener for the next update
+    state.dirtyFlag = true;
 }
 
-float AudioSystem::getListenerUpVectorY()
+float AudioSystem::getListenerUpVectorX(int listener)
 {
-    // Up Vector
-    FMOD_VECTOR up;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, 0, 0, 0, &up);
-    // Return up y
-    return up.y;
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached up x of the Listener
+    return this->listenerStates[listener].up.x;
 }
 
-float AudioSystem::getListenerUpVectorZ()
+float AudioSystem::getListenerUpVectorY(int listener)
 {
-    // Up Vector
-    FMOD_VECTOR up;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, 0, 0, 0, &up);
-    // Return up z
-    return up.z;
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached up y of the Listener
+    return this->listenerStates[listener].up.y;
+}
+
+float AudioSystem::getListenerUpVectorZ(int listener)
+{
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached up z of the Listener
+    return this->listenerStates[listener].up.z;
 }
 
 void AudioSystem::setListenerUpVector(float upX, float upY)
 {
-    // Up Vector
-    FMOD_VECTOR up;
-        up.x = upX;
-        up.y = upY;
-        up.z = 0.0f;
-    // Set the Attributes for Listener 0 (default listener)
-    FMOD_System_Set3DListenerAttributes(FMODGlobals::pFMODSystem, 0, 0, 0, 0, &up);
+    // Set the up vector for Listener 0 (default listener)
+    this->setListenerUpVector(upX, upY, 0.0f);
 }
 
 void AudioSystem::setListenerUpVector(float upX, float upY, float upZ)
 {
-    // Up Vector
-    FMOD_VECTOR up;
-        up.x = upX;
-        up.y = upY;
-        up.z = upZ;
-    // Set the Attributes for Listener 0 (default listener)
-    FMOD_System_Set3DListenerAttributes(FMODGlobals::pFMODSystem, 0, 0, 0, 0, &up);
+    // Set the up vector for Listener 0 (default listener)
+    this->setListenerUpVector(0, upX, upY, upZ);
 }
 
-float AudioSystem::getListenerForwardVectorX()
+void AudioSystem::setListenerUpVector(int listener, float upX, float upY, float upZ)
 {
-    // Forward Vector
-    FMOD_VECTOR forward;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, 0, 0, &forward, 0);
-    // Return forward x
-    return forward.x;
+    // Validate the listener index
+    if (this->isValidListener(listener) == false)
+        return;
+    // Lock the Listeners (the update thread may be reading them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Grab the Listener
+    ListenerState& state = this->listenerStates[listener];
+    // Set Up Vector
+    state.up.x = upX;
+    state.up.y = upY;
+    state.up.z = upZ;
+    // Flag the listener for the next update
+    state.dirtyFlag = true;
 }
 
-float AudioSystem::getListenerForwardVectorY()
+float AudioSystem::getListenerForwardVectorX(int listener)
 {
-    // Forward Vector
-    FMOD_VECTOR forward;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, 0, 0, &forward, 0);
-    // Return forward y
-    return forward.y;
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached forward x of the Listener
+    return this->listenerStates[listener].forward.x;
 }
 
-float AudioSystem::getListenerForwardVectorZ()
+float AudioSystem::getListenerForwardVectorY(int listener)
 {
-    // Forward Vector
-    FMOD_VECTOR forward;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, 0, 0, &forward, 0);
-    // Return forward z
-    return forward.z;
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached forward y of the Listener
+    return this->listenerStates[listener].forward.y;
+}
+
+float AudioSystem::getListenerForwardVectorZ(int listener)
+{
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached forward z of the Listener
+    return this->listenerStates[listener].forward.z;
 }
 
 void AudioSystem::setListenerForwardVector(float forwardX, float forwardY)
 {
-    // Forward Vector
-    FMOD_VECTOR forward;
-        forward.x = forwardX;
-        forward.y = forwardY;
-        forward.z = 0.0f;
-    // Set the Attributes for Listener 0 (default listener)
-    FMOD_System_Set3DListenerAttributes(FMODGlobals::pFMODSystem, 0, 0, 0, &forward, 0);
+    // Set the forward vector for Listener 0 (default listener)
+    this->setListenerForwardVector(forwardX, forwardY, 0.0f);
 }
 
 void AudioSystem::setListenerForwardVector(float forwardX, float forwardY, float forwardZ)
 {
-    // Forward Vector
-    FMOD_VECTOR forward;
-        forward.x = forwardX;
-        forward.y = forwardY;
-        forward.z = forwardZ;
-    // Set the Attributes for Listener 0 (default listener)
-    FMOD_System_Set3DListenerAttributes(FMODGlobals::pFMODSystem, 0, 0, 0, &forward, 0);
+    // Set the forward vector for Listener 0 (default listener)
+    this->setListenerForwardVector(0, forwardX, forwardY, forwardZ);
+}
+
+void AudioSystem::setListenerForwardVector(int listener, float forwardX, float forwardY, float forwardZ)
+{
+    // Validate the listener index
+    if (this->isValidListener(listener) == false)
+        return;
+    // Lock the Listeners (the update thread may be reading them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Grab the Listener
+    ListenerState& state = this->listenerStates[listener];
+    // Set Forward Vector
+    state.forward.x = forwardX;
+    state.forward.y = forwardY;
+    state.forward.z = forwardZ;
+    // Flag the listener for the next update
+    state.dirtyFlag = true;
 }
 
-float AudioSystem::getListenerXVelocity()
+float AudioSystem::getListenerXVelocity(int listener)
 {
-    // Velocity Vector
-    FMOD_VECTOR velocity;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, &velocity, 0, 0, 0);
-    // Return velocity x
-    return velocity.x;
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached x velocity of the Listener
+    return this->listenerStates[listener].velocity.x;
 }
 
-float AudioSystem::getListenerYVelocity()
+float AudioSystem::getListenerYVelocity(int listener)
 {
-    // Velocity Vector
-    FMOD_VECTOR velocity;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, &velocity, 0, 0, 0);
-    // Return velocity y
-    return velocity.y;
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached y velocity of the Listener
+    return this->listenerStates[listener].velocity.y;
 }
 
-float AudioSystem::getListenerZVelocity()
+float AudioSystem::getListenerZVelocity(int listener)
 {
-    // Velocity Vector
-    FMOD_VECTOR velocity;
-    // Get the Attributes for Listener 0 (default listener)
-    FMOD_System_Get3DListenerAttributes(FMODGlobals::pFMODSystem, 0, &velocity, 0, 0, 0);
-    // Return velocity z
-    return velocity.z;
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return cached z velocity of the Listener
+    return this->listenerStates[listener].velocity.z;
 }
 
 void AudioSystem::setListenerVelocity(float velocityX, float velocityY)
 {
-    // Velocity Vector
-    FMOD_VECTOR velocity;
-        velocity.x = velocityX;
-        velocity.y = velocityY;
-        velocity.z = 0.0f;
-    // Set the Attributes for Listener 0 (default listener)
-    FMOD_System_Set3DListenerAttributes(FMODGlobals::pFMODSystem, 0, &velocity, 0, 0, 0);
+    // Set the velocity for Listener 0 (default listener)
+    this->setListenerVelocity(velocityX, velocityY, 0.0f);
 }
 
 void AudioSystem::setListenerVelocity(float velocityX, float velocityY, float velocityZ)
 {
-    // Velocity Vector
-    FMOD_VECTOR velocity;
-        velocity.x = velocityX;
-        velocity.y = velocityY;
-        velocity.z = velocityZ;
-    // Set the Attributes for Listener 0 (default listener)
-    FMOD_System_Set3DListenerAttributes(FMODGlobals::pFMODSystem, 0, &velocity, 0, 0, 0);
+    // Set the velocity for Listener 0 (default listener)
+    this->setListenerVelocity(0, velocityX, velocityY, velocityZ);
+}
+
+void AudioSystem::setListenerVelocity(int listener, float velocityX, float velocityY, float velocityZ)
+{
+    // Validate the listener index
+    if (this->isValidListener(listener) == false)
+        return;
+    // Lock the Listeners (the update thread may be reading them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Grab the Listener
+    ListenerState& state = this->listenerStates[listener];
+    // Set Velocity
+    state.velocity.x = velocityX;
+    state.velocity.y = velocityY;
+    state.velocity.z = velocityZ;
+    // Flag the listener for the next update
+    state.dirtyFlag = true;
+}
+
+ListenerState AudioSystem::getListenerState(int listener)
+{
+    // Fall back to the default listener for a bad index
+    if (this->isValidListener(listener) == false)
+        listener = 0;
+    // Lock the Listeners (the update thread may be writing them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Return a copy of the cached state
+    return this->listenerStates[listener];
+}
+
+void AudioSystem::setListenerState(int listener, const ListenerState& state)
+{
+    // Validate the listener index
+    if (this->isValidListener(listener) == false)
+        return;
+    // Lock the Listeners (the update thread may be reading them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Copy the state
+    this->listenerStates[listener] = state;
+    // Flag the listener for the next update
+    this->listenerStates[listener].dirtyFlag = true;
+}
+
+void AudioSystem::setListenerAttributes(int listener, const FMOD_VECTOR& position, const FMOD_VECTOR& velocity, const FMOD_VECTOR& forward, const FMOD_VECTOR& up)
+{
+    // Validate the listener index
+    if (this->isValidListener(listener) == false)
+        return;
+    // Lock the Listeners (the update thread may be reading them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Grab the Listener
+    ListenerState& state = this->listenerStates[listener];
+    // Set Attributes
+    state.position = position;
+    state.velocity = velocity;
+    state.forward = forward;
+    state.up = up;
+    // Flag the listener for the next update
+    state.dirtyFlag = true;
+}
+
+int AudioSystem::getNearestListener(const FMOD_VECTOR& position, float* pDistance)
+{
+    // Grab the listener positions
+    FMOD_VECTOR listenerPositions[FMOD_MAX_LISTENERS];
+    int numberOfListeners = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->listenerMutex);
+        numberOfListeners = this->numberOfListeners;
+        for (int i = 0; i < numberOfListeners; i++)
+            listenerPositions[i] = this->listenerStates[i].position;
+    }
+    // return the closest listener
+    return NearestListener::find(position, listenerPositions, numberOfListeners, pDistance);
+}
+
+void AudioSystem::updateListeners()
+{
+    // Lock the Listeners
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Send every listener which has changed since the last update
+    for (int i = 0; i < this->numberOfListeners; i++)
+    {
+        // Grab the Listener
+        ListenerState& state = this->listenerStates[i];
+        // Skip listeners which haven't changed
+        if (state.dirtyFlag == false)
+            continue;
+        // Set all the Attributes for the Listener in one call
+        FMOD_System_Set3DListenerAttributes(FMODGlobals::pFMODSystem, i, &(state.position), &(state.velocity), &(state.forward), &(state.up));
+        // Listener is now in sync with FMOD
+        state.dirtyFlag = false;
+    }
 }
 
 float AudioSystem::getDopplerScale()
@@ -345,15 +509,24 @@ void AudioSystem::setRollOffCallBack(FMOD_3D_ROLLOFF_CALLBACK pCallBack)
 
 int AudioSystem::getNumberOfListeners()
 {
-    // Grab Number of Listeners
-    int numListeners = 0;
-    FMOD_System_Get3DNumListeners(FMODGlobals::pFMODSystem, &numListeners);
+    // Lock the Listeners
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
     // Return number of listeners
-    return numListeners;
+    return this->numberOfListeners;
 }
 
 void AudioSystem::setNumberOfListeners(int numListeners)
 {
+    // FMOD supports between 1 and FMOD_MAX_LISTENERS listeners
+    if (numListeners < 1 || numListeners > FMOD_MAX_LISTENERS)
+        return;
+    // Lock the Listeners (the update thread may be reading them)
+    std::lock_guard<std::mutex> lock(this->listenerMutex);
+    // Set local number of listeners
+    this->numberOfListeners = numListeners;
+    // Listeners which have just been switched on need to be sent on the next update
+    for (int i = 0; i < this->numberOfListeners; i++)
+        this->listenerStates[i].dirtyFlag = true;
     // Set the Number of Listeners
     FMOD_System_Set3DNumListeners(FMODGlobals::pFMODSystem, numListeners);
 }
@@ -394,6 +567,14 @@ float AudioSystem::getGeometryOcclusionReverb(float xStart, float yStart, float
     return reverbOcclusion;
 }
 
+void AudioSystem::getGeometryOcclusion(const FMOD_VECTOR& start, const FMOD_VECTOR& finish, float& directOcclusion, float& reverbOcclusion)
+{
+    // Grab Occlusion Information (both from one ray)
+    directOcclusion = 1.0f;
+    reverbOcclusion = 1.0f;
+    FMOD_System_GetGeometryOcclusion(FMODGlobals::pFMODSystem, &start, &finish, &directOcclusion, &reverbOcclusion);
+}
+
 void AudioSystem::think()
 {
     // Don't update unless we have an FMODSystem
@@ -407,14 +588,68 @@ void AudioSystem::update()
     // Don't update unless we have an FMODSystem
     if (FMODGlobals::pFMODSystem == 0)
         return;
-    // Update Sound System
-    FMOD_System_Update(FMODGlobals::pFMODSystem);
+    // The update thread owns updating while it is running
+    if (this->updateThreadRunningFlag.load() == true)
+        return;
+    // Update
+    this->updateFrame();
 }
 
 void AudioSystem::shutdown()
 {
+    // Stop the update thread before anything it uses goes away
+    this->stopUpdateThread();
+    // Throw away any posted commands
+    {
+        std::lock_guard<std::mutex> lock(this->commandMutex);
+        AudioCommand command;
+        while (this->audioCommandQueue.pop(command) == true) {}
+    }
+    // Forget the watched Channels
+    {
+        std::lock_guard<std::mutex> lock(this->watchMutex);
+        this->watchedChannels.clear();
+    }
+    FMODGlobals::pAudioSystem = 0;
+    // Switch everything in the Spatial Grid back on and forget it
+    this->spatialGrid.clear();
+    FMODGlobals::pSpatialGrid = 0;
+    // Forget the occluded Channels
+    this->occlusionService.clear();
+    FMODGlobals::pOcclusionService = 0;
+    // Forget the traced polygons
+    this->occlusionTracer.clear();
+    FMODGlobals::pOcclusionTracer = 0;
+    // Hand the bound Channels back to their own rolloff and forget the curves
+    this->rolloffManager.clear();
+    FMODGlobals::pRolloffManager = 0;
+    // Stop the emitters (before the voices they play on go)
+    this->emitterSystem.clear();
+    // Stop and release the pooled voices
+    this->voicePool.free();
+    // Forget the managed voices
+    this->voiceManager.clear();
+    FMODGlobals::pVoiceManager = 0;
+    {
+        // Lock the Voice States
+        std::lock_guard<std::mutex> lock(this->voiceStateMutex);
+        // Clear both Voice State Buffers
+        this->voiceStates[0].clear();
+        this->voiceStates[1].clear();
+    }
+    // Release the pre-opened streams
+    this->streamPool.clear();
+    FMODGlobals::pStreamPool = 0;
+    // Throw away any deferred Channel commands
+    this->channelCommandQueue.clear();
+    // Channels talk to FMOD directly again
+    FMODGlobals::pChannelCommandQueue = 0;
     // Maximum number of software channels
     this->maxSoftwareChannels = 4093;
+    // Reset the Listeners
+    for (int i = 0; i < FMOD_MAX_LISTENERS; i++)
+        this->listenerStates[i].reset();
+    this->numberOfListeners = 1;
     // Release the Sound Effects Channel group
     FMOD_ChannelGroup_Release(FMODGlobals::pSoundEffectsChannelGroup);
     // Clear the sound channel group pointer
@@ -429,6 +664,413 @@ void AudioSystem::shutdown()
     FMOD_System_Release(FMODGlobals::pFMODSystem);
     // Clear the FMODSystem pointer
     FMODGlobals::pFMODSystem = 0;
+    // Close anything FMOD left open and forget the cache (FMOD closes its files during release)
+    this->audioFileSystem.clear();
+    FMODGlobals::pAudioFileSystem = 0;
+}
+
+bool AudioSystem::startUpdateThread(float updateRate)
+{
+    // We need an FMODSystem to update
+    if (FMODGlobals::pFMODSystem == 0)
+    {
+        std::cout << "bool AudioSystem::startUpdateThread() failure. AudioSystem has not been initialised" << std::endl;
+        return false;
+    }
+    // Validate the update rate
+    if (updateRate <= 0.0f)
+    {
+        std::cout << "bool AudioSystem::startUpdateThread() failure. updateRate must be greater than 0" << std::endl;
+        return false;
+    }
+    // Already running
+    if (this->updateThreadRunningFlag.load() == true)
+        return true;
+    // Set the update rate
+    this->updateRate = updateRate;
+    // Flag the thread as running
+    this->updateThreadRunningFlag.store(true);
+    // Start the thread
+    this->updateThread = std::thread(&AudioSystem::updateThreadMain, this);
+    // Success
+    return true;
+}
+
+void AudioSystem::stopUpdateThread()
+{
+    // Tell the thread to finish
+    this->updateThreadRunningFlag.store(false);
+    // Wait for it
+    if (this->updateThread.joinable() == true)
+        this->updateThread.join();
+}
+
+void AudioSystem::updateThreadMain()
+{
+    // Time between updates
+    std::chrono::steady_clock::duration period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.0f / this->updateRate));
+    // Time of the next update
+    std::chrono::steady_clock::time_point nextUpdate = std::chrono::steady_clock::now();
+    // Keep updating until we are told to stop
+    while (this->updateThreadRunningFlag.load() == true)
+    {
+        // Update
+        this->updateFrame();
+        // Work out when the next update is due
+        nextUpdate += period;
+        /* NOTE: If we fell more than a frame behind (the process was
+            suspended for example) don't try and catch up with a burst
+            of updates, just carry on from now */
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (nextUpdate < now)
+            nextUpdate = now;
+        // Sleep until then
+        std::this_thread::sleep_until(nextUpdate);
+    }
+}
+
+void AudioSystem::updateFrame()
+{
+    // Run the commands posted from game threads
+    this->processCommands();
+    // Grab the listener positions for the Voice Manager
+    FMOD_VECTOR listenerPositions[FMOD_MAX_LISTENERS];
+    int numberOfListeners = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->listenerMutex);
+        numberOfListeners = this->numberOfListeners;
+        for (int i = 0; i < numberOfListeners; i++)
+            listenerPositions[i] = this->listenerStates[i].position;
+    }
+    // Switch the 3D Channels and Reverbs near the listeners on and the rest off
+    this->spatialGrid.update(listenerPositions, numberOfListeners);
+    // Trace the occlusion of what is still on (within the time budget)
+    this->occlusionService.update(listenerPositions, numberOfListeners);
+    // Cull the emitters and give the best of them voices
+    this->emitterSystem.update(listenerPositions, numberOfListeners);
+    {
+        // Keep the real voices inside the budget (reading the last published Voice States)
+        std::lock_guard<std::mutex> lock(this->voiceStateMutex);
+        std::vector<VoiceState>& frontVoiceStates = this->voiceStates[this->frontVoiceStates];
+        this->voiceManager.update(listenerPositions, numberOfListeners, (frontVoiceStates.empty() == true) ? 0 : &(frontVoiceStates[0]), (int)frontVoiceStates.size());
+    }
+    // Check on the streams being opened and primed
+    this->streamPool.update();
+    // Send the deferred Channel commands
+    this->channelCommandQueue.flush();
+    // Send any listeners which have changed
+    this->updateListeners();
+    // Update Sound System
+    FMOD_System_Update(FMODGlobals::pFMODSystem);
+    // Publish the state of the watched Channels
+    this->publishVoiceStates();
+    // Copy the Update Callbacks (a callback may add or remove callbacks)
+    std::vector< std::pair<AUDIOSYSTEM_UPDATE_CALLBACK, void*> > updateCallbacks;
+    {
+        std::lock_guard<std::mutex> lock(this->updateCallbackMutex);
+        updateCallbacks = this->updateCallbacks;
+    }
+    // Call the Update Callbacks
+    for (unsigned int i = 0; i < updateCallbacks.size(); i++)
+        updateCallbacks[i].first(updateCallbacks[i].second);
+}
+
+void AudioSystem::processCommands()
+{
+    // Hold the queue so no Channel can be destroyed while its command runs
+    std::lock_guard<std::mutex> lock(this->commandMutex);
+    // Run every command which is waiting
+    AudioCommand command;
+    while (this->audioCommandQueue.pop(command) == true)
+        this->processCommand(command);
+}
+
+void AudioSystem::processCommand(const AudioCommand& command)
+{
+    // Every command needs a Channel (forgotten ones have none)
+    Channel* pChannel = command.pChannel;
+    if (pChannel == 0)
+        return;
+    // Run the command
+    switch (command.type)
+    {
+        case AUDIO_COMMAND_PLAY: pChannel->play(); break;
+        case AUDIO_COMMAND_STOP: pChannel->stop(); break;
+        case AUDIO_COMMAND_PAUSE: pChannel->pause(); break;
+        case AUDIO_COMMAND_RESUME: pChannel->resume(); break;
+        case AUDIO_COMMAND_VOLUME: pChannel->setVolume(command.values[0]); break;
+        case AUDIO_COMMAND_PITCH: pChannel->setPitch(command.values[0]); break;
+        case AUDIO_COMMAND_MUTE: pChannel->setMute(command.values[0] != 0.0f); break;
+        case AUDIO_COMMAND_BALANCE: pChannel->setBalance(command.values[0]); break;
+        case AUDIO_COMMAND_POSITION:
+        {
+            // Position only means something to 3D Channels
+            if (Sound3D* pSound3D = dynamic_cast<Sound3D*>(pChannel))
+                pSound3D->setPosition(command.values[0], command.values[1], command.values[2]);
+            else if (Stream3D* pStream3D = dynamic_cast<Stream3D*>(pChannel))
+                pStream3D->setPosition(command.values[0], command.values[1], command.values[2]);
+        } break;
+        case AUDIO_COMMAND_VELOCITY:
+        {
+            // Velocity only means something to 3D Channels
+            if (Sound3D* pSound3D = dynamic_cast<Sound3D*>(pChannel))
+                pSound3D->setVelocity(command.values[0], command.values[1], command.values[2]);
+            else if (Stream3D* pStream3D = dynamic_cast<Stream3D*>(pChannel))
+                pStream3D->setVelocity(command.values[0], command.values[1], command.values[2]);
+        } break;
+        default: break;
+    }
+}
+
+void AudioSystem::publishVoiceStates()
+{
+    // The back buffer is only ever touched by this thread
+    std::vector<VoiceState>& backVoiceStates = this->voiceStates[1 - this->frontVoiceStates];
+    // Hold the watch list so no watched Channel can be destroyed while it is read
+    std::unique_lock<std::mutex> watchLock(this->watchMutex);
+    // Fill the back buffer (keeps its capacity so there are no allocations once warm)
+    backVoiceStates.resize(this->watchedChannels.size());
+    for (unsigned int i = 0; i < this->watchedChannels.size(); i++)
+    {
+        // Grab the Channel
+        Channel* pChannel = this->watchedChannels[i];
+        // Grab the VoiceState
+        VoiceState& voiceState = backVoiceStates[i];
+        // Fill in the state
+        voiceState.pChannel = pChannel;
+        voiceState.playingFlag = pChannel->isPlaying();
+        voiceState.pausedFlag = pChannel->isPaused();
+        voiceState.virtualFlag = (voiceState.playingFlag == true) ? pChannel->isChannelVirtual() : false;
+        voiceState.audibility = (voiceState.playingFlag == true) ? pChannel->getAudibility() : 0.0f;
+        voiceState.dspClock = (voiceState.playingFlag == true) ? pChannel->getDSPClock() : 0;
+    }
+    watchLock.unlock();
+    // Lock the Voice States
+    std::lock_guard<std::mutex> lock(this->voiceStateMutex);
+    // Swap the back buffer to the front
+    this->frontVoiceStates = 1 - this->frontVoiceStates;
+}
+
+bool AudioSystem::postCommand(const AudioCommand& command)
+{
+    // Push the command into the queue
+    return this->audioCommandQueue.push(command);
+}
+
+bool AudioSystem::postPlay(Channel* pChannel)
+{
+    // Build the command
+    AudioCommand command;
+    command.type = AUDIO_COMMAND_PLAY;
+    command.pChannel = pChannel;
+    // Post the command
+    return this->postCommand(command);
+}
+
+bool AudioSystem::postStop(Channel* pChannel)
+{
+    // Build the command
+    AudioCommand command;
+    command.type = AUDIO_COMMAND_STOP;
+    command.pChannel = pChannel;
+    // Post the command
+    return this->postCommand(command);
+}
+
+bool AudioSystem::postPaused(Channel* pChannel, bool pausedFlag)
+{
+    // Build the command
+    AudioCommand command;
+    command.type = (pausedFlag == true) ? AUDIO_COMMAND_PAUSE : AUDIO_COMMAND_RESUME;
+    command.pChannel = pChannel;
+    // Post the command
+    return this->postCommand(command);
+}
+
+bool AudioSystem::postVolume(Channel* pChannel, float volume)
+{
+    // Build the command
+    AudioCommand command;
+    command.type = AUDIO_COMMAND_VOLUME;
+    command.pChannel = pChannel;
+    command.values[0] = volume;
+    // Post the command
+    return this->postCommand(command);
+}
+
+bool AudioSystem::postPitch(Channel* pChannel, float pitch)
+{
+    // Build the command
+    AudioCommand command;
+    command.type = AUDIO_COMMAND_PITCH;
+    command.pChannel = pChannel;
+    command.values[0] = pitch;
+    // Post the command
+    return this->postCommand(command);
+}
+
+bool AudioSystem::postMute(Channel* pChannel, bool muteFlag)
+{
+    // Build the command
+    AudioCommand command;
+    command.type = AUDIO_COMMAND_MUTE;
+    command.pChannel = pChannel;
+    command.values[0] = (muteFlag == true) ? 1.0f : 0.0f;
+    // Post the command
+    return this->postCommand(command);
+}
+
+bool AudioSystem::postBalance(Channel* pChannel, float balance)
+{
+    // Build the command
+    AudioCommand command;
+    command.type = AUDIO_COMMAND_BALANCE;
+    command.pChannel = pChannel;
+    command.values[0] = balance;
+    // Post the command
+    return this->postCommand(command);
+}
+
+bool AudioSystem::postPosition(Channel* pChannel, float x, float y, float z)
+{
+    // Build the command
+    AudioCommand command;
+    command.type = AUDIO_COMMAND_POSITION;
+    command.pChannel = pChannel;
+    command.values[0] = x;
+    command.values[1] = y;
+    command.values[2] = z;
+    // Post the command
+    return this->postCommand(command);
+}
+
+bool AudioSystem::postVelocity(Channel* pChannel, float xVelocity, float yVelocity, float zVelocity)
+{
+    // Build the command
+    AudioCommand command;
+    command.type = AUDIO_COMMAND_VELOCITY;
+    command.pChannel = pChannel;
+    command.values[0] = xVelocity;
+    command.values[1] = yVelocity;
+    command.values[2] = zVelocity;
+    // Post the command
+    return this->postCommand(command);
+}
+
+void AudioSystem::forgetCommands(Channel* pChannel)
+{
+    // Validate the Channel
+    if (pChannel == 0)
+        return;
+    // Wait for any command running now and blank the rest
+    std::lock_guard<std::mutex> lock(this->commandMutex);
+    this->audioCommandQueue.forget(pChannel);
+}
+
+bool AudioSystem::watchChannel(Channel* pChannel)
+{
+    // Validate the Channel
+    if (pChannel == 0)
+        return false;
+    // Lock the watch list
+    std::lock_guard<std::mutex> lock(this->watchMutex);
+    // Only watch a Channel once
+    if (std::find(this->watchedChannels.begin(), this->watchedChannels.end(), pChannel) == this->watchedChannels.end())
+        this->watchedChannels.push_back(pChannel);
+    // Success
+    return true;
+}
+
+bool AudioSystem::unwatchChannel(Channel* pChannel)
+{
+    {
+        // Lock the watch list (waits for a publish reading the Channel to finish)
+        std::lock_guard<std::mutex> lock(this->watchMutex);
+        // Remove the Channel from the watch list
+        std::vector<Channel*>::iterator i = std::find(this->watchedChannels.begin(), this->watchedChannels.end(), pChannel);
+        if (i == this->watchedChannels.end())
+            return false;
+        this->watchedChannels.erase(i);
+    }
+    // Lock the Voice States
+    std::lock_guard<std::mutex> lock(this->voiceStateMutex);
+    // Drop it from the front buffer so a new Channel at the same address doesn't find it
+    std::vector<VoiceState>& frontVoiceStates = this->voiceStates[this->frontVoiceStates];
+    for (unsigned int i = 0; i < frontVoiceStates.size(); i++)
+    {
+        if (frontVoiceStates[i].pChannel == pChannel)
+        {
+            frontVoiceStates.erase(frontVoiceStates.begin() + i);
+            break;
+        }
+    }
+    // Success
+    return true;
+}
+
+bool AudioSystem::getVoiceState(Channel* pChannel, VoiceState& voiceState)
+{
+    // Lock the Voice States
+    std::lock_guard<std::mutex> lock(this->voiceStateMutex);
+    // Grab the front buffer
+    std::vector<VoiceState>& frontVoiceStates = this->voiceStates[this->frontVoiceStates];
+    // Look for the Channel
+    for (unsigned int i = 0; i < frontVoiceStates.size(); i++)
+    {
+        if (frontVoiceStates[i].pChannel == pChannel)
+        {
+            // Copy the state out
+            voiceState = frontVoiceStates[i];
+            // Found
+            return true;
+        }
+    }
+    // Not watched (or not published yet)
+    return false;
+}
+
+void AudioSystem::getVoiceStates(std::vector<VoiceState>& voiceStates)
+{
+    // Lock the Voice States
+    std::lock_guard<std::mutex> lock(this->voiceStateMutex);
+    // Copy the front buffer
+    voiceStates = this->voiceStates[this->frontVoiceStates];
+}
+
+void AudioSystem::addUpdateCallback(AUDIOSYSTEM_UPDATE_CALLBACK pCallBack, void* pUserData)
+{
+    // Validate the Callback
+    if (pCallBack == 0)
+        return;
+    // Lock the Update Callbacks
+    std::lock_guard<std::mutex> lock(this->updateCallbackMutex);
+    // Add the Callback
+    this->updateCallbacks.push_back(std::make_pair(pCallBack, pUserData));
+}
+
+void AudioSystem::removeUpdateCallback(AUDIOSYSTEM_UPDATE_CALLBACK pCallBack, void* pUserData)
+{
+    // Lock the Update Callbacks
+    std::lock_guard<std::mutex> lock(this->updateCallbackMutex);
+    // Remove the Callback
+    std::vector< std::pair<AUDIOSYSTEM_UPDATE_CALLBACK, void*> >::iterator i = std::find(this->updateCallbacks.begin(), this->updateCallbacks.end(), std::make_pair(pCallBack, pUserData));
+    if (i != this->updateCallbacks.end())
+        this->updateCallbacks.erase(i);
+}
+
+bool AudioSystem::isDeferredCommands()
+{
+    // return the enabled flag of the Command Queue
+    return this->channelCommandQueue.isEnabled();
+}
+
+void AudioSystem::setDeferredCommands(bool deferredCommandsFlag)
+{
+    // Send anything still waiting before we stop deferring
+    if (deferredCommandsFlag == false && FMODGlobals::pFMODSystem != 0)
+        this->channelCommandQueue.flush();
+    // Set the enabled flag of the Command Queue
+    this->channelCommandQueue.setEnabled(deferredCommandsFlag);
 }
 
 void AudioSystem::pause()
@@ -1061,6 +1703,8 @@ void AudioSystem::setMaxWorldSize(float maxWorldSize)
     // Set local maxWorldSize
     this->maxWorldSize = maxWorldSize;
     FMOD_System_SetGeometrySettings(FMODGlobals::pFMODSystem, this->maxWorldSize);
+    // Resize the Spatial Grid to match
+    this->spatialGrid.create(this->maxWorldSize, this->spatialGrid.getCellSize());
 }
 
 std::string AudioSystem::getNetworkProxy()
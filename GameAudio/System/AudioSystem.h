@@ -19,6 +19,10 @@
 #include <sstream>
 #include <vector>
 #include <map>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 
 // FMOD Includes
 #include <fmod.h>
@@ -41,6 +45,19 @@
 
 // GAMEAUDIO Includes
 #include "FMODGlobals.h"
+#include "Channel/ChannelCommandQueue.h"
+#include "Geometry/OcclusionService.h"
+#include "Geometry/OcclusionTracer.h"
+#include "System/AudioCommandQueue.h"
+#include "System/AudioFileSystem.h"
+#include "System/ListenerState.h"
+#include "System/NearestListener.h"
+#include "System/SpatialGrid.h"
+#include "System/VoiceState.h"
+#include "Voice/EmitterSystem.h"
+#include "Voice/VoiceManager.h"
+#include "Voice/VoicePool.h"
+#include "Sound/RolloffManager.h"
 #include "Sound/SoundSample.h"
 #include "Sound/Sound.h"
 #include "Sound/Sound2D.h"
@@ -48,9 +65,13 @@
 #include "Stream/Stream.h"
 #include "Stream/Stream2D.h"
 #include "Stream/Stream3D.h"
+#include "Stream/StreamPool.h"
 #include "Music/Music.h"
 //#include "DSP/IDSPEffect.h"
 
+/** Function called once per AudioSystem update after FMOD_System_Update **/
+typedef void (*AUDIOSYSTEM_UPDATE_CALLBACK)(void* pUserData);
+
 /** The AudioSystem class intialises and shutdowns the audio system along with
     setting important things like volume, balance, allowing you to mute audio,
     get important information about the driver, record audio, play cds and
@@ -106,11 +127,251 @@ class AudioSystem
         /** @brief Stop the audiosystem **/
         virtual void stop();
 
+    public:
+        /** @brief Is Deferred Commands
+          * @return true if Channel setters are recorded and sent to FMOD during update **/
+        virtual bool isDeferredCommands();
+        /** @brief Set Deferred Commands
+          * When on, Channel setters (volume, pitch, paused, 3D position etc) only
+          * record their value and update() sends the last value of each property
+          * once per frame. Turning it off flushes anything still waiting
+          * @param deferredCommandsFlag true to defer, false to call FMOD straight away **/
+        virtual void setDeferredCommands(bool deferredCommandsFlag);
+        /** @brief Get the Channel Command Queue
+          * @return the ChannelCommandQueue owned by the AudioSystem **/
+        virtual ChannelCommandQueue* getChannelCommandQueue() { return &(this->channelCommandQueue); }
+        /** @brief Get the Voice Pool
+          * The pool is created by init with 256 voices, call
+          * getVoicePool()->create(n) after init to change that
+          * @return the VoicePool owned by the AudioSystem **/
+        virtual VoicePool* getVoicePool() { return &(this->voicePool); }
+        /** @brief Get the Voice Manager
+          * Channels added to the manager are kept inside its real voice
+          * budget every update, the rest become virtual
+          * @return the VoiceManager owned by the AudioSystem **/
+        virtual VoiceManager* getVoiceManager() { return &(this->voiceManager); }
+        /** @brief Get the Emitter System
+          * Emitters are culled and ranked every update and the best play
+          * on the Voice Pool
+          * @return the EmitterSystem owned by the AudioSystem **/
+        virtual EmitterSystem* getEmitterSystem() { return &(this->emitterSystem); }
+        /** @brief Get the Spatial Grid
+          * Sound3Ds, Stream3Ds and Reverb3Ds added to the grid are switched
+          * off while no listener is within their max distance
+          * @return the SpatialGrid owned by the AudioSystem **/
+        virtual SpatialGrid* getSpatialGrid() { return &(this->spatialGrid); }
+        /** @brief Get the Occlusion Service
+          * Sound3Ds and Stream3Ds added to the service have their geometry
+          * occlusion traced within a time budget every update and eased in
+          * @return the OcclusionService owned by the AudioSystem **/
+        virtual OcclusionService* getOcclusionService() { return &(this->occlusionService); }
+        /** @brief Get the Occlusion Tracer
+          * An optional replacement for FMOD's geometry engine with its own
+          * bounding volume hierarchy (hand it to the Occlusion Service with
+          * setOcclusionTracer to use it there)
+          * @return the OcclusionTracer owned by the AudioSystem **/
+        virtual OcclusionTracer* getOcclusionTracer() { return &(this->occlusionTracer); }
+        /** @brief Get the Rolloff Manager
+          * Named rolloff curves for SoundSamples, Sound3Ds and Stream3Ds,
+          * handed to FMOD as each Channel's custom rolloff
+          * @return the RolloffManager owned by the AudioSystem **/
+        virtual RolloffManager* getRolloffManager() { return &(this->rolloffManager); }
+        /** @brief Get the Audio File System
+          * File callbacks with a shared block cache, read-ahead for streams
+          * and I/O counters (attach it before creating sounds to use it)
+          * @return the AudioFileSystem owned by the AudioSystem **/
+        virtual AudioFileSystem* getAudioFileSystem() { return &(this->audioFileSystem); }
+        /** @brief Get the Stream Pool
+          * Streams opened and primed ahead of use so Streams and Music
+          * loading a preloaded file start straight away
+          * @return the StreamPool owned by the AudioSystem **/
+        virtual StreamPool* getStreamPool() { return &(this->streamPool); }
+        /** @brief addUpdateCallback
+          * Have a function called at the end of every update (on the update
+          * thread if it is running). Used by the AudioManager to poll loads
+          * @param pCallBack the function
+          * @param pUserData passed to the function **/
+        virtual void addUpdateCallback(AUDIOSYSTEM_UPDATE_CALLBACK pCallBack, void* pUserData);
+        /** @brief removeUpdateCallback
+          * @param pCallBack the function
+          * @param pUserData the user data it was added with **/
+        virtual void removeUpdateCallback(AUDIOSYSTEM_UPDATE_CALLBACK pCallBack, void* pUserData);
+
     protected:
         // pausedFlag
         bool pausedFlag;
         // MaxSoftwareChannels
         int maxSoftwareChannels;
+        // Deferred Channel Commands
+        ChannelCommandQueue channelCommandQueue;
+        // Fire and forget voices
+        VoicePool voicePool;
+        // Real and virtual voice management
+        VoiceManager voiceManager;
+        // Positional sounds played on the Voice Pool
+        EmitterSystem emitterSystem;
+        // Spatial index of the 3D Channels and Reverbs
+        SpatialGrid spatialGrid;
+        // Budgeted and cached geometry occlusion of the 3D Channels
+        OcclusionService occlusionService;
+        // Ray tracer over the Geometry polygons
+        OcclusionTracer occlusionTracer;
+        // Named rolloff curves
+        RolloffManager rolloffManager;
+        // File callbacks with a block cache
+        AudioFileSystem audioFileSystem;
+        // Pre-opened streams
+        StreamPool streamPool;
+        // Update Callbacks
+        std::vector< std::pair<AUDIOSYSTEM_UPDATE_CALLBACK, void*> > updateCallbacks;
+        // Guards updateCallbacks
+        std::mutex updateCallbackMutex;
+
+    // ***************************
+    // * UPDATE THREAD FUNCTIONS *
+    // ***************************
+    public:
+        /** @brief startUpdateThread
+          * Start a background thread which calls FMOD_System_Update (and flushes
+          * commands, listeners and voice states) at a fixed rate. While it runs
+          * update() does nothing so the main loop can keep calling it safely
+          * @param updateRate updates per second (eg 60.0f)
+          * @return true on success false otherwise **/
+        virtual bool startUpdateThread(float updateRate);
+        /** @brief stopUpdateThread
+          * Stop the background thread and wait for it to finish **/
+        virtual void stopUpdateThread();
+        /** @brief isUpdateThreadRunning
+          * @return true if the background thread is running **/
+        virtual bool isUpdateThreadRunning() { return this->updateThreadRunningFlag.load(); }
+        /** @brief getUpdateRate
+          * @return updates per second of the background thread **/
+        virtual float getUpdateRate() { return this->updateRate; }
+
+    public:
+        /* NOTE: The post functions are safe to call from any thread. They
+            never block, they copy a small AudioCommand into a lock free
+            queue which is emptied at the start of the next update (on the
+            update thread if it is running, otherwise in update()). The
+            Channel must stay alive until the command has been processed */
+        /** @brief postCommand
+          * @param command the command to send to the update thread
+          * @return true on success, false if the queue was full **/
+        virtual bool postCommand(const AudioCommand& command);
+        /** @brief postPlay
+          * @param pChannel Sound, Stream or Music to play
+          * @return true on success, false if the queue was full **/
+        virtual bool postPlay(Channel* pChannel);
+        /** @brief postStop
+          * @param pChannel Sound, Stream or Music to stop
+          * @return true on success, false if the queue was full **/
+        virtual bool postStop(Channel* pChannel);
+        /** @brief postPaused
+          * @param pChannel Sound, Stream or Music to pause or resume
+          * @param pausedFlag true to pause, false to resume
+          * @return true on success, false if the queue was full **/
+        virtual bool postPaused(Channel* pChannel, bool pausedFlag);
+        /** @brief postVolume
+          * @param pChannel Sound, Stream or Music
+          * @param volume (0.0 silent 1.0 fullblast)
+          * @return true on success, false if the queue was full **/
+        virtual bool postVolume(Channel* pChannel, float volume);
+        /** @brief postPitch
+          * @param pChannel Sound, Stream or Music
+          * @param pitch (0.5 half pitch, 2.0 double pitch, 1.0 default pitch)
+          * @return true on success, false if the queue was full **/
+        virtual bool postPitch(Channel* pChannel, float pitch);
+        /** @brief postMute
+          * @param pChannel Sound, Stream or Music
+          * @param muteFlag true to mute false to unmute
+          * @return true on success, false if the queue was full **/
+        virtual bool postMute(Channel* pChannel, bool muteFlag);
+        /** @brief postBalance
+          * @param pChannel Sound, Stream or Music
+          * @param balance (-1.0 full left 1.0 full right)
+          * @return true on success, false if the queue was full **/
+        virtual bool postBalance(Channel* pChannel, float balance);
+        /** @brief postPosition
+          * @param pChannel a Sound3D or Stream3D
+          * @param x x position
+          * @param y y position
+          * @param z z position
+          * @return true on success, false if the queue was full **/
+        virtual bool postPosition(Channel* pChannel, float x, float y, float z);
+        /** @brief postVelocity
+          * @param pChannel a Sound3D or Stream3D
+          * @param xVelocity x velocity
+          * @param yVelocity y velocity
+          * @param zVelocity z velocity
+          * @return true on success, false if the queue was full **/
+        virtual bool postVelocity(Channel* pChannel, float xVelocity, float yVelocity, float zVelocity);
+        /** @brief watchChannel
+          * Ask the update thread to publish a VoiceState for a Channel every update
+          * @param pChannel Sound, Stream or Music to watch
+          * @return false if pChannel is 0 **/
+        virtual bool watchChannel(Channel* pChannel);
+        /** @brief unwatchChannel
+          * Stop publishing a VoiceState for a Channel (the update thread is
+          * done with it on return, Channels call this when destroyed)
+          * @param pChannel Sound, Stream or Music to stop watching
+          * @return false if it was not watched **/
+        virtual bool unwatchChannel(Channel* pChannel);
+        /** @brief forgetCommands
+          * Blank the posted AudioCommands still waiting for a Channel (the
+          * update thread is done with it on return, Channels call this when destroyed)
+          * @param pChannel Sound, Stream or Music being destroyed **/
+        virtual void forgetCommands(Channel* pChannel);
+        /** @brief getVoiceState
+          * Read the last published state of a watched Channel (any thread)
+          * @param pChannel the watched Channel
+          * @param voiceState receives the state
+          * @return true if the Channel was found in the snapshot **/
+        virtual bool getVoiceState(Channel* pChannel, VoiceState& voiceState);
+        /** @brief getVoiceStates
+          * Copy the whole last published snapshot (any thread)
+          * @param voiceStates receives a VoiceState for every watched Channel **/
+        virtual void getVoiceStates(std::vector<VoiceState>& voiceStates);
+        /** @brief Get the AudioCommandQueue
+          * @return the AudioCommandQueue owned by the AudioSystem **/
+        virtual AudioCommandQueue* getAudioCommandQueue() { return &(this->audioCommandQueue); }
+
+    protected:
+        /** @brief The body of the background update thread **/
+        virtual void updateThreadMain();
+        /** @brief One audio frame (commands, listeners, FMOD update, voice states) **/
+        virtual void updateFrame();
+        /** @brief Run every AudioCommand waiting in the AudioCommandQueue **/
+        virtual void processCommands();
+        /** @brief Run a single AudioCommand
+          * @param command the command **/
+        virtual void processCommand(const AudioCommand& command);
+        /** @brief Fill the back VoiceState buffer and swap it to the front **/
+        virtual void publishVoiceStates();
+
+    protected:
+        // Update Thread
+        std::thread updateThread;
+        // Update Thread Running Flag
+        std::atomic<bool> updateThreadRunningFlag;
+        // Updates per second of the Update Thread
+        float updateRate;
+        // Commands posted from game threads
+        AudioCommandQueue audioCommandQueue;
+        // Held while commands are run or forgotten (the queue has one consumer)
+        std::mutex commandMutex;
+        // Channels the update thread publishes a VoiceState for
+        std::vector<Channel*> watchedChannels;
+        // Guards watchedChannels (held while the update thread reads them)
+        std::mutex watchMutex;
+        /* NOTE: voiceStates is double buffered. The update thread fills the
+            back buffer without a lock and only takes voiceStateMutex to swap
+            it to the front, readers take it to copy out of the front */
+        // Voice State Buffers
+        std::vector<VoiceState> voiceStates[2];
+        // Index of the front Voice State Buffer
+        int frontVoiceStates;
+        // Guards frontVoiceStates and the front buffer
+        std::mutex voiceStateMutex;
 
     // ****************************************
     // * DEBUG VERSION ONLY FUNCTIONS (fmodL) *
@@ -301,14 +562,17 @@ class AudioSystem
         your camera reusable */
     public:
         /** @brief get ListernerX
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return Listerner X **/
-        virtual float getListenerX();
+        virtual float getListenerX(int listener = 0);
         /** @brief get ListernerY
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return Listerner Y **/
-        virtual float getListenerY();
+        virtual float getListenerY(int listener = 0);
         /** @brief get ListernerZ
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return Listerner Z **/
-        virtual float getListenerZ();
+        virtual float getListenerZ(int listener = 0);
         /** @brief Set the listeners position
           * @param positionX x position of the listener
           * @param positionY y position of the listener **/
@@ -318,15 +582,24 @@ class AudioSystem
           * @param positionY y position of the listener
           * @param positionZ z position of the listener **/
         virtual void setListenerPosition(float x, float y, float z);
+        /** @brief Set the listeners position
+          * @param listener index of the listener (0 to FMOD_MAX_LISTENERS - 1)
+          * @param positionX x position of the listener
+          * @param positionY y position of the listener
+          * @param positionZ z position of the listener **/
+        virtual void setListenerPosition(int listener, float positionX, float positionY, float positionZ);
         /** @brief getListenerUpVectorX
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return x part of the Listenerup vector **/
-        virtual float getListenerUpVectorX();
+        virtual float getListenerUpVectorX(int listener = 0);
         /** @brief getListenerUpVectorY
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return y part of the Listener up vector **/
-        virtual float getListenerUpVectorY();
+        virtual float getListenerUpVectorY(int listener = 0);
         /** @brief getListenerUpVectorZ
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return z part of the Listener up vector **/
-        virtual float getListenerUpVectorZ();
+        virtual float getListenerUpVectorZ(int listener = 0);
         /** @brief setListenerUpVector
           * @param xUp x part of the Listener up vector
           * @param yUp y part of the Listener up vector **/
@@ -336,15 +609,24 @@ class AudioSystem
           * @param upY y part of the Listener up vector
           * @param upZ z part of the Listener up vector **/
         virtual void setListenerUpVector(float upX, float upY, float upZ);
+        /** @brief setListenerUpVector
+          * @param listener index of the listener (0 to FMOD_MAX_LISTENERS - 1)
+          * @param upX x part of the Listener up vector
+          * @param upY y part of the Listener up vector
+          * @param upZ z part of the Listener up vector **/
+        virtual void setListenerUpVector(int listener, float upX, float upY, float upZ);
         /** @brief getListenerForwardVectorX
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return x part of the Listener Forward vector **/
-        virtual float getListenerForwardVectorX();
+        virtual float getListenerForwardVectorX(int listener = 0);
         /** @brief getListenerForwardVectorY
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return y part of the Listener Forward vector **/
-        virtual float getListenerForwardVectorY();
+        virtual float getListenerForwardVectorY(int listener = 0);
         /** @brief getListenerForwardVectorZ
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return z part of the Listener Forward vector **/
-        virtual float getListenerForwardVectorZ();
+        virtual float getListenerForwardVectorZ(int listener = 0);
         /** @brief setListenerForwardVector
           * @param forwardX x part of the Listener Forward vector
           * @param forwardY y part of the Listener Forward vector **/
@@ -354,15 +636,24 @@ class AudioSystem
           * @param forwardY y part of the Forward vector
           * @param forwardZ z part of the Forward vector **/
         virtual void setListenerForwardVector(float forwardX, float forwardY, float forwardZ);
+        /** @brief setListenerForwardVector
+          * @param listener index of the listener (0 to FMOD_MAX_LISTENERS - 1)
+          * @param forwardX x part of the Forward vector
+          * @param forwardY y part of the Forward vector
+          * @param forwardZ z part of the Forward vector **/
+        virtual void setListenerForwardVector(int listener, float forwardX, float forwardY, float forwardZ);
         /** @brief get ListernerXVelocity
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return Listerner X Velocity**/
-        virtual float getListenerXVelocity();
+        virtual float getListenerXVelocity(int listener = 0);
         /** @brief get ListernerYVelocity
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return Listerner YVelocity **/
-        virtual float getListenerYVelocity();
+        virtual float getListenerYVelocity(int listener = 0);
         /** @brief get ListernerZVelocity
+          * @param listener index of the listener (listener 0 if the index is invalid)
           * @return Listerner Z Velocity **/
-        virtual float getListenerZVelocity();
+        virtual float getListenerZVelocity(int listener = 0);
         /** @brief Set the listeners Velocity
           * @param x x Velocity of the listener
           * @param y y Velocity of the listener **/
@@ -372,6 +663,56 @@ class AudioSystem
           * @param velocityY y Velocity of the listener
           * @param velocityZ z Velocity of the listener **/
         virtual void setListenerVelocity(float velocityX, float velocityY, float velocityZ);
+        /** @brief Set the listeners Velocity
+          * @param listener index of the listener (0 to FMOD_MAX_LISTENERS - 1)
+          * @param velocityX x Velocity of the listener
+          * @param velocityY y Velocity of the listener
+          * @param velocityZ z Velocity of the listener **/
+        virtual void setListenerVelocity(int listener, float velocityX, float velocityY, float velocityZ);
+        /** @brief getListenerState
+          * Read the cached attributes of a listener without calling into FMOD
+          * @param listener index of the listener (0 to FMOD_MAX_LISTENERS - 1)
+          * @return a copy of the ListenerState for the listener (listener 0 if the index is invalid) **/
+        virtual ListenerState getListenerState(int listener);
+        /** @brief setListenerState
+          * Replace every attribute of a listener in one go. FMOD is told about
+          * the change on the next call to update
+          * @param listener index of the listener (0 to FMOD_MAX_LISTENERS - 1)
+          * @param state the new position, velocity, forward and up vectors **/
+        virtual void setListenerState(int listener, const ListenerState& state);
+        /** @brief setListenerAttributes
+          * @param listener index of the listener (0 to FMOD_MAX_LISTENERS - 1)
+          * @param position position of the listener
+          * @param velocity velocity of the listener (units per second)
+          * @param forward forward vector of the listener (unit length)
+          * @param up up vector of the listener (unit length) **/
+        virtual void setListenerAttributes(int listener, const FMOD_VECTOR& position, const FMOD_VECTOR& velocity, const FMOD_VECTOR& forward, const FMOD_VECTOR& up);
+        /** @brief getNearestListener
+          * Find the listener closest to a position (the lowest index wins a tie)
+          * @param position a position
+          * @param pDistance receives the distance to the listener (may be 0)
+          * @return index of the closest listener **/
+        virtual int getNearestListener(const FMOD_VECTOR& position, float* pDistance = 0);
+
+    protected:
+        /** @brief Send every dirty ListenerState to FMOD with
+          * one FMOD_System_Set3DListenerAttributes per listener **/
+        virtual void updateListeners();
+        /** @brief isValidListener
+          * @param listener index of the listener
+          * @return true if the index is inside 0 to FMOD_MAX_LISTENERS - 1 **/
+        virtual bool isValidListener(int listener) { return (listener >= 0 && listener < FMOD_MAX_LISTENERS); }
+
+    protected:
+        /* NOTE: The listeners are cached here so reading them never
+            touches FMOD and writing them only marks them dirty. They
+            are flushed to FMOD once per update */
+        // Cached Listener Attributes
+        ListenerState listenerStates[FMOD_MAX_LISTENERS];
+        // Guards the Listener cache (setters may be called while the update thread runs)
+        std::mutex listenerMutex;
+        // Number of Listeners
+        int numberOfListeners;
 
     public:
         /* Not necessary to implement these functions*/
@@ -391,7 +732,7 @@ class AudioSystem
           * @param distanceFactor DistanceFactor
           * @param rollOffScale **/
         virtual void set3DSettings(float dopplerScale, float distanceFactor, float rollOffScale);
-        /** @brief Set the RollOffCallBack
+        /** @brief Set the RollOffCallBack (it overrides every rolloff, the Rolloff Manager's curves included)
           * @param pCallback a callback function with the signature FMOD_3D_ROLLOFF_CALLBACK **/
         virtual void setRollOffCallBack(FMOD_3D_ROLLOFF_CALLBACK pCallBack);
         /** @brief Get Number of Listeners
@@ -425,6 +766,14 @@ class AudioSystem
           * @param yFinish vertical start position
           * @param zFinish depth start position  **/
           virtual float getGeometryOcclusionReverb(float xStart, float yStart, float zStart, float xFinish, float yFinish, float zFinish);
+        /** @brief getGeometryOcclusion
+          * Direct and reverb occlusion from a single ray (the two functions
+          * above each trace the same ray and throw half of it away)
+          * @param start start position
+          * @param finish finish position
+          * @param directOcclusion receives the direct occlusion
+          * @param reverbOcclusion receives the reverb occlusion **/
+        virtual void getGeometryOcclusion(const FMOD_VECTOR& start, const FMOD_VECTOR& finish, float& directOcclusion, float& reverbOcclusion);
 
     protected:
         // methods and members
@@ -0,0 +1,56 @@
+#include "AutoVelocity.h"
+
+float AutoVelocity::getBlend(float dTime, float smoothing)
+{
+    // No smoothing takes the new velocity straight away
+    if (smoothing <= 0.0f)
+        return 1.0f;
+    // return the blend for this time step
+    return 1.0f - std::exp(-dTime / smoothing);
+}
+
+void AutoVelocity::derive(const float* pX, const float* pY, const float* pZ, float* pPreviousX, float* pPreviousY, float* pPreviousZ, float* pXVelocity, float* pYVelocity, float* pZVelocity, const float* pWeights, int numberOfPositions, float dTime, float smoothing, float teleportSpeed)
+{
+    // No time has passed (the movement is picked up next update)
+    if (dTime <= 0.0f)
+        return;
+    // The same for every position
+    float inverseTime = 1.0f / dTime;
+    float blend = AutoVelocity::getBlend(dTime, smoothing);
+    // Furthest a position can move at the teleport speed in this time step
+    float teleportDistance = teleportSpeed * dTime;
+    float teleportDistanceSquared = (teleportSpeed > 0.0f) ? teleportDistance * teleportDistance : -1.0f;
+    for (int i = 0; i < numberOfPositions; i++)
+    {
+        // How far the position moved
+        float dx = pX[i] - pPreviousX[i];
+        float dy = pY[i] - pPreviousY[i];
+        float dz = pZ[i] - pPreviousZ[i];
+        // Remember the position
+        pPreviousX[i] = pX[i];
+        pPreviousY[i] = pY[i];
+        pPreviousZ[i] = pZ[i];
+        // Leave the velocities which are not derived alone
+        float weight = (pWeights != 0) ? pWeights[i] : 1.0f;
+        if (weight == 0.0f)
+            continue;
+        // A teleport (faster than the teleport speed) stops dead
+        if (teleportDistanceSquared >= 0.0f && dx * dx + dy * dy + dz * dz > teleportDistanceSquared)
+        {
+            pXVelocity[i] = 0.0f;
+            pYVelocity[i] = 0.0f;
+            pZVelocity[i] = 0.0f;
+            continue;
+        }
+        // Move towards the new velocity
+        pXVelocity[i] += blend * (dx * inverseTime - pXVelocity[i]);
+        pYVelocity[i] += blend * (dy * inverseTime - pYVelocity[i]);
+        pZVelocity[i] += blend * (dz * inverseTime - pZVelocity[i]);
+    }
+}
+
+void AutoVelocity::derive(const FMOD_VECTOR& position, FMOD_VECTOR& previousPosition, FMOD_VECTOR& velocity, float dTime, float smoothing, float teleportSpeed)
+{
+    // Derive the one position
+    AutoVelocity::derive(&(position.x), &(position.y), &(position.z), &(previousPosition.x), &(previousPosition.y), &(previousPosition.z), &(velocity.x), &(velocity.y), &(velocity.z), 0, 1, dTime, smoothing, teleportSpeed);
+}
@@ -0,0 +1,70 @@
+/**
+  * @file   AutoVelocity.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  AutoVelocity works out velocities from how far positions
+  * moved between updates so doppler works without feeding velocities
+*/
+
+#ifndef AUTOVELOCITY_H
+#define AUTOVELOCITY_H
+
+// C++ Includes
+#include <cmath>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// Default time the velocity takes to settle on a new speed (seconds)
+const float AUTOVELOCITY_DEFAULT_SMOOTHING = 0.1f;
+// Default speed (world units a second) above which a move counts as a teleport
+const float AUTOVELOCITY_DEFAULT_TELEPORT_SPEED = 500.0f;
+
+/** Most game code only ever sets positions, which leaves FMOD with a
+    velocity of zero and no doppler. Instead the velocity is the distance
+    moved since the last update over the time between them. Frame times
+    jitter so the raw velocity is smoothed towards with an exponential
+    filter whose blend comes from the time step (1 - e^(-dTime/smoothing))
+    which settles the same way at 30 and 144 updates a second, as though
+    it were stepped at a fixed rate. Anything whose move works out faster
+    than the teleport speed (a respawn, a cut) has its velocity zeroed
+    instead of producing a doppler shriek; it is a speed rather than a
+    distance so the same move counts as a teleport at any frame rate. The positions are laid
+    out as flat arrays so a whole EmitterSystem is done in one pass **/
+namespace AutoVelocity
+{
+    /** @brief getBlend
+      * @param dTime time since the last update (seconds)
+      * @param smoothing time the velocity takes to settle (0 for none)
+      * @return how far to move towards the new velocity (0.0 to 1.0) **/
+    float getBlend(float dTime, float smoothing);
+    /** @brief derive
+      * Work out the velocity of each position and remember the positions
+      * for the next update. Nothing changes when dTime is not above 0
+      * @param pX horizontal positions
+      * @param pY vertical positions
+      * @param pZ depth positions
+      * @param pPreviousX receives the horizontal positions (holds the last ones)
+      * @param pPreviousY receives the vertical positions (holds the last ones)
+      * @param pPreviousZ receives the depth positions (holds the last ones)
+      * @param pXVelocity horizontal velocities (smoothed in place)
+      * @param pYVelocity vertical velocities (smoothed in place)
+      * @param pZVelocity depth velocities (smoothed in place)
+      * @param pWeights 1 where the velocity is derived and 0 where it is left alone (0 for all of them)
+      * @param numberOfPositions number of positions
+      * @param dTime time since the last update (seconds)
+      * @param smoothing time the velocity takes to settle (0 for none)
+      * @param teleportSpeed speed (distance moved over dTime) which zeroes the velocity (0 for never) **/
+    void derive(const float* pX, const float* pY, const float* pZ, float* pPreviousX, float* pPreviousY, float* pPreviousZ, float* pXVelocity, float* pYVelocity, float* pZVelocity, const float* pWeights, int numberOfPositions, float dTime, float smoothing, float teleportSpeed);
+    /** @brief derive
+      * @param position a position
+      * @param previousPosition holds the last position and receives this one
+      * @param velocity the velocity (smoothed in place)
+      * @param dTime time since the last update (seconds)
+      * @param smoothing time the velocity takes to settle (0 for none)
+      * @param teleportSpeed speed (distance moved over dTime) which zeroes the velocity (0 for never) **/
+    void derive(const FMOD_VECTOR& position, FMOD_VECTOR& previousPosition, FMOD_VECTOR& velocity, float dTime, float smoothing, float teleportSpeed);
+}
+
+#endif // AUTOVELOCITY_H
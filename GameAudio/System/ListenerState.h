@@ -0,0 +1,63 @@
+/**
+  * @file   ListenerState.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  ListenerState is a cached copy of the 3D attributes
+  * of a single FMOD listener (position, velocity, forward and up)
+*/
+
+#ifndef LISTENERSTATE_H
+#define LISTENERSTATE_H
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+/** The ListenerState struct holds everything FMOD needs to know about a
+    listener. The AudioSystem keeps one of these per listener index and
+    only pushes it to FMOD (with a single FMOD_System_Set3DListenerAttributes)
+    during AudioSystem::update() when the dirtyFlag is set **/
+struct ListenerState
+{
+    //! Constructor (FMOD's default listener orientation)
+    ListenerState()
+    {
+        this->reset();
+    }
+
+    /** @brief Reset to FMOD's default listener attributes **/
+    void reset()
+    {
+        // Position
+        this->position.x = 0.0f;
+        this->position.y = 0.0f;
+        this->position.z = 0.0f;
+        // Velocity
+        this->velocity.x = 0.0f;
+        this->velocity.y = 0.0f;
+        this->velocity.z = 0.0f;
+        // Forward (FMOD default is +z)
+        this->forward.x = 0.0f;
+        this->forward.y = 0.0f;
+        this->forward.z = 1.0f;
+        // Up (FMOD default is +y)
+        this->up.x = 0.0f;
+        this->up.y = 1.0f;
+        this->up.z = 0.0f;
+        // Needs to be sent to FMOD
+        this->dirtyFlag = true;
+    }
+
+    // Position of the listener
+    FMOD_VECTOR position;
+    // Velocity of the listener (units per second)
+    FMOD_VECTOR velocity;
+    // Forward vector (unit length, perpendicular to up)
+    FMOD_VECTOR forward;
+    // Up vector (unit length, perpendicular to forward)
+    FMOD_VECTOR up;
+    // true when the state has changed since it was last sent to FMOD
+    bool dirtyFlag;
+};
+
+#endif // LISTENERSTATE_H
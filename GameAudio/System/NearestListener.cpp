@@ -0,0 +1,80 @@
+#include "NearestListener.h"
+
+void NearestListener::find(const float* pX, const float* pY, const float* pZ, int numberOfPositions, const FMOD_VECTOR* pListenerPositions, int numberOfListeners, float* pDistances, int* pListeners)
+{
+    // No listeners means everything is right on top of listener 0
+    if (pListenerPositions == 0)
+        numberOfListeners = 0;
+    int i = 0;
+    #ifdef NEARESTLISTENER_SSE
+    // Four positions at a time
+    for (; i + 4 <= numberOfPositions; i += 4)
+    {
+        // Positions
+        __m128 x = _mm_loadu_ps(&(pX[i]));
+        __m128 y = _mm_loadu_ps(&(pY[i]));
+        __m128 z = _mm_loadu_ps(&(pZ[i]));
+        // Closest listener (squared distances until the end, the index kept as a float)
+        __m128 closest = (numberOfListeners > 0) ? _mm_set1_ps(FLT_MAX) : _mm_setzero_ps();
+        __m128 closestListener = _mm_setzero_ps();
+        for (int l = 0; l < numberOfListeners; l++)
+        {
+            __m128 dx = _mm_sub_ps(x, _mm_set1_ps(pListenerPositions[l].x));
+            __m128 dy = _mm_sub_ps(y, _mm_set1_ps(pListenerPositions[l].y));
+            __m128 dz = _mm_sub_ps(z, _mm_set1_ps(pListenerPositions[l].z));
+            __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            // Strictly closer replaces (so the lowest index wins a tie)
+            __m128 closerMask = _mm_cmplt_ps(distanceSquared, closest);
+            closest = _mm_min_ps(closest, distanceSquared);
+            closestListener = _mm_or_ps(_mm_and_ps(closerMask, _mm_set1_ps((float)l)), _mm_andnot_ps(closerMask, closestListener));
+        }
+        // Store the results
+        _mm_storeu_ps(&(pDistances[i]), _mm_sqrt_ps(closest));
+        if (pListeners != 0)
+        {
+            float listeners[4];
+            _mm_storeu_ps(listeners, closestListener);
+            pListeners[i + 0] = (int)listeners[0];
+            pListeners[i + 1] = (int)listeners[1];
+            pListeners[i + 2] = (int)listeners[2];
+            pListeners[i + 3] = (int)listeners[3];
+        }
+    }
+    #endif
+    // One position at a time (whatever is left over)
+    for (; i < numberOfPositions; i++)
+    {
+        // Closest listener (squared distances until the end)
+        float closest = (numberOfListeners > 0) ? FLT_MAX : 0.0f;
+        int closestListener = 0;
+        for (int l = 0; l < numberOfListeners; l++)
+        {
+            float dx = pX[i] - pListenerPositions[l].x;
+            float dy = pY[i] - pListenerPositions[l].y;
+            float dz = pZ[i] - pListenerPositions[l].z;
+            float distanceSquared = dx * dx + dy * dy + dz * dz;
+            if (distanceSquared < closest)
+            {
+                closest = distanceSquared;
+                closestListener = l;
+            }
+        }
+        // Store the results
+        pDistances[i] = std::sqrt(closest);
+        if (pListeners != 0)
+            pListeners[i] = closestListener;
+    }
+}
+
+int NearestListener::find(const FMOD_VECTOR& position, const FMOD_VECTOR* pListenerPositions, int numberOfListeners, float* pDistance)
+{
+    // Find the closest listener to the one position
+    float distance = 0.0f;
+    int listener = 0;
+    NearestListener::find(&(position.x), &(position.y), &(position.z), 1, pListenerPositions, numberOfListeners, &distance, &listener);
+    // Hand back the distance
+    if (pDistance != 0)
+        *pDistance = distance;
+    // return the listener
+    return listener;
+}
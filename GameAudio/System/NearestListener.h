@@ -0,0 +1,54 @@
+/**
+  * @file   NearestListener.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  NearestListener finds the closest listener to a batch of
+  * positions in one pass
+*/
+
+#ifndef NEARESTLISTENER_H
+#define NEARESTLISTENER_H
+
+// C++ Includes
+#include <cfloat>
+#include <cmath>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define NEARESTLISTENER_SSE
+    #include <xmmintrin.h>
+#endif
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+/** Split screen runs up to FMOD_MAX_LISTENERS listeners and culling, voice
+    ranking and LOD all want the listener closest to each sound. Rather
+    than have every sound loop over the listeners itself, the positions are
+    laid out as flat x, y and z arrays and handed over in one go: four
+    positions are compared against every listener per step and the closest
+    distance and its listener index kept (the lowest index wins a tie, so
+    the answer never depends on the batch). The cost is one pass over the
+    positions with a listener loop of at most FMOD_MAX_LISTENERS inside,
+    rather than one function call and listener loop per sound **/
+namespace NearestListener
+{
+    /** @brief find
+      * @param pX horizontal positions
+      * @param pY vertical positions
+      * @param pZ depth positions
+      * @param numberOfPositions number of positions
+      * @param pListenerPositions positions of the listeners
+      * @param numberOfListeners number of listeners
+      * @param pDistances receives the distance to the closest listener (0 with no listeners)
+      * @param pListeners receives the index of the closest listener (0 with no listeners; may be 0) **/
+    void find(const float* pX, const float* pY, const float* pZ, int numberOfPositions, const FMOD_VECTOR* pListenerPositions, int numberOfListeners, float* pDistances, int* pListeners);
+    /** @brief find
+      * @param position a position
+      * @param pListenerPositions positions of the listeners
+      * @param numberOfListeners number of listeners
+      * @param pDistance receives the distance to the closest listener (may be 0)
+      * @return index of the closest listener (0 with no listeners) **/
+    int find(const FMOD_VECTOR& position, const FMOD_VECTOR* pListenerPositions, int numberOfListeners, float* pDistance);
+}
+
+#endif // NEARESTLISTENER_H
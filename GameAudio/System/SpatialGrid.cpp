@@ -0,0 +1,421 @@
+#include "SpatialGrid.h"
+
+SpatialGrid::SpatialGrid()
+{
+    // Size (AudioSystem::init sizes the grid from the max world size)
+    this->worldSize = 100000.0f;
+    this->cellSize = 100.0f;
+    this->cellsPerAxis.clear();
+    this->levels.clear();
+    // Entries
+    this->entries.clear();
+    this->freeEntries.clear();
+    this->activeEntries.clear();
+    this->nextActiveEntries.clear();
+    // Levels
+    this->create(this->worldSize, this->cellSize);
+    // Updates
+    this->updateCount = 0;
+    this->numberOfActiveObjects = 0;
+}
+
+SpatialGrid::~SpatialGrid()
+{
+    // Switch everything back on and forget it
+    this->clear();
+}
+
+bool SpatialGrid::create(float worldSize, float cellSize)
+{
+    // Validate the sizes
+    if (worldSize <= 0.0f || cellSize <= 0.0f)
+    {
+        std::cout << "bool SpatialGrid::create() failure. worldSize and cellSize must be above 0" << std::endl;
+        return false;
+    }
+    // The cell on each axis has to fit in 21 bits
+    float cellsPerAxis = std::ceil((2.0f * worldSize) / cellSize);
+    if (cellsPerAxis > (float)(1 << 21))
+    {
+        std::cout << "bool SpatialGrid::create() failure. cellSize is too small for the world" << std::endl;
+        return false;
+    }
+    // Lock the Grid
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Set the size
+    this->worldSize = worldSize;
+    this->cellSize = cellSize;
+    // Add levels until one cell covers the world
+    this->cellsPerAxis.clear();
+    this->cellsPerAxis.push_back(std::max(1u, (unsigned int)cellsPerAxis));
+    while (this->cellsPerAxis.back() > 1)
+        this->cellsPerAxis.push_back((this->cellsPerAxis.back() + 1) / 2);
+    // Move everything into the new cells
+    this->levels.clear();
+    this->levels.resize(this->cellsPerAxis.size());
+    for (unsigned int i = 0; i < this->entries.size(); i++)
+    {
+        if (this->entries[i].pSpatialObject != 0)
+        {
+            this->entries[i].level = this->getLevel(this->entries[i].radius);
+            this->insertEntry((int)i);
+        }
+    }
+    // Success
+    return true;
+}
+
+void SpatialGrid::update(const FMOD_VECTOR* pListenerPositions, int numberOfListeners)
+{
+    // Without listeners leave everything as it is
+    if (pListenerPositions == 0 || numberOfListeners < 1)
+        return;
+    // Lock the Grid
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // A new update
+    this->updateCount++;
+    this->nextActiveEntries.clear();
+    // Visit the occupied levels around each listener
+    for (int l = 0; l < numberOfListeners; l++)
+    {
+        for (unsigned int level = 0; level < this->levels.size(); level++)
+        {
+            if (this->levels[level].empty() == false)
+                this->visitLevel((int)level, pListenerPositions[l]);
+        }
+    }
+    // Switch off whatever was on and was not found this time
+    for (unsigned int i = 0; i < this->activeEntries.size(); i++)
+    {
+        SpatialEntry& entry = this->entries[this->activeEntries[i]];
+        if (entry.visitedUpdate != this->updateCount && entry.activeFlag == true)
+        {
+            entry.activeFlag = false;
+            entry.pSpatialObject->setSpatialActive(false);
+        }
+    }
+    // Remember what is on
+    this->activeEntries.swap(this->nextActiveEntries);
+    this->numberOfActiveObjects = (int)this->activeEntries.size();
+}
+
+void SpatialGrid::clear()
+{
+    // Lock the Grid
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Switch everything back on and let it go
+    for (unsigned int i = 0; i < this->entries.size(); i++)
+    {
+        SpatialEntry& entry = this->entries[i];
+        if (entry.pSpatialObject == 0)
+            continue;
+        if (entry.activeFlag == false)
+            entry.pSpatialObject->setSpatialActive(true);
+        entry.pSpatialObject->setSpatialIndex(-1);
+    }
+    // Forget everything
+    this->entries.clear();
+    this->freeEntries.clear();
+    for (unsigned int level = 0; level < this->levels.size(); level++)
+        this->levels[level].clear();
+    this->activeEntries.clear();
+    this->nextActiveEntries.clear();
+    this->numberOfActiveObjects = 0;
+}
+
+void SpatialGrid::add(SpatialObject* pSpatialObject)
+{
+    // Validate the object
+    if (pSpatialObject == 0)
+        return;
+    // Lock the Grid
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Only add an object once
+    if (pSpatialObject->getSpatialIndex() >= 0)
+        return;
+    // Take a free entry or make one
+    int index = 0;
+    if (this->freeEntries.empty() == false)
+    {
+        index = this->freeEntries.back();
+        this->freeEntries.pop_back();
+    }
+    else
+    {
+        index = (int)this->entries.size();
+        this->entries.push_back(SpatialEntry());
+    }
+    // Fill in the entry
+    SpatialEntry& entry = this->entries[index];
+    entry.pSpatialObject = pSpatialObject;
+    entry.position = pSpatialObject->getSpatialPosition();
+    entry.radius = pSpatialObject->getSpatialRadius();
+    entry.level = this->getLevel(entry.radius);
+    entry.visitedUpdate = this->updateCount;
+    entry.activeFlag = pSpatialObject->isSpatialActive();
+    // The next update decides whether it stays on
+    if (entry.activeFlag == true)
+        this->activeEntries.push_back(index);
+    // Put it in its cell
+    this->insertEntry(index);
+    pSpatialObject->setSpatialIndex(index);
+}
+
+void SpatialGrid::remove(SpatialObject* pSpatialObject)
+{
+    // Validate the object
+    if (pSpatialObject == 0)
+        return;
+    // Lock the Grid
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the entry
+    int index = pSpatialObject->getSpatialIndex();
+    if (index < 0 || index >= (int)this->entries.size() || this->entries[index].pSpatialObject != pSpatialObject)
+        return;
+    // Take it out of its cell
+    this->removeEntry(index);
+    // No longer on
+    std::vector<int>::iterator active = std::find(this->activeEntries.begin(), this->activeEntries.end(), index);
+    if (active != this->activeEntries.end())
+    {
+        *active = this->activeEntries.back();
+        this->activeEntries.pop_back();
+    }
+    // Free the entry
+    this->entries[index].pSpatialObject = 0;
+    this->freeEntries.push_back(index);
+    pSpatialObject->setSpatialIndex(-1);
+}
+
+void SpatialGrid::move(SpatialObject* pSpatialObject)
+{
+    // Validate the object
+    if (pSpatialObject == 0)
+        return;
+    // Lock the Grid
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the entry
+    int index = pSpatialObject->getSpatialIndex();
+    if (index < 0 || index >= (int)this->entries.size() || this->entries[index].pSpatialObject != pSpatialObject)
+        return;
+    SpatialEntry& entry = this->entries[index];
+    // Update the position and radius
+    entry.position = pSpatialObject->getSpatialPosition();
+    entry.radius = pSpatialObject->getSpatialRadius();
+    // Change cell only when it has left the old one (or its radius belongs on another level)
+    int level = this->getLevel(entry.radius);
+    if (level != entry.level || this->getCellKey(entry.position, level) != entry.cellKey)
+    {
+        this->removeEntry(index);
+        entry.level = level;
+        this->insertEntry(index);
+    }
+}
+
+void SpatialGrid::query(const FMOD_VECTOR& position, float radius, std::vector<SpatialObject*>& results)
+{
+    // Start with nothing
+    results.clear();
+    // Lock the Grid
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Search every occupied level
+    for (unsigned int level = 0; level < this->levels.size(); level++)
+    {
+        if (this->levels[level].empty() == true)
+            continue;
+        // Cells the search covers
+        unsigned int firstX = this->getCellCoordinate(position.x - radius, (int)level);
+        unsigned int lastX = this->getCellCoordinate(position.x + radius, (int)level);
+        unsigned int firstY = this->getCellCoordinate(position.y - radius, (int)level);
+        unsigned int lastY = this->getCellCoordinate(position.y + radius, (int)level);
+        unsigned int firstZ = this->getCellCoordinate(position.z - radius, (int)level);
+        unsigned int lastZ = this->getCellCoordinate(position.z + radius, (int)level);
+        for (unsigned int cellZ = firstZ; cellZ <= lastZ; cellZ++)
+        {
+            for (unsigned int cellY = firstY; cellY <= lastY; cellY++)
+            {
+                for (unsigned int cellX = firstX; cellX <= lastX; cellX++)
+                {
+                    // Find the cell
+                    unsigned long long cellKey = (unsigned long long)cellX | ((unsigned long long)cellY << 21) | ((unsigned long long)cellZ << 42);
+                    std::unordered_map< unsigned long long, std::vector<int> >::iterator cell = this->levels[level].find(cellKey);
+                    if (cell == this->levels[level].end())
+                        continue;
+                    // Keep everything inside the radius
+                    for (unsigned int i = 0; i < cell->second.size(); i++)
+                    {
+                        const SpatialEntry& entry = this->entries[cell->second[i]];
+                        float dx = entry.position.x - position.x;
+                        float dy = entry.position.y - position.y;
+                        float dz = entry.position.z - position.z;
+                        if (dx * dx + dy * dy + dz * dz <= radius * radius)
+                            results.push_back(entry.pSpatialObject);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int SpatialGrid::getNumberOfObjects()
+{
+    // Lock the Grid
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Everything not on the free list is in the grid
+    return (int)(this->entries.size() - this->freeEntries.size());
+}
+
+int SpatialGrid::getNumberOfCells()
+{
+    // Lock the Grid
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Add up the occupied cells of every level
+    int numberOfCells = 0;
+    for (unsigned int level = 0; level < this->levels.size(); level++)
+        numberOfCells += (int)this->levels[level].size();
+    // return the number of occupied cells
+    return numberOfCells;
+}
+
+unsigned int SpatialGrid::getCellCoordinate(float value, int level)
+{
+    // Cell from the edge of the world (cells double in width each level)
+    float cell = std::floor((value + this->worldSize) / std::ldexp(this->cellSize, level));
+    // Anything outside the world goes in the edge cells (NaN included)
+    if ((cell >= 0.0f) == false)
+        return 0;
+    if (cell >= (float)this->cellsPerAxis[level])
+        return this->cellsPerAxis[level] - 1;
+    // return the cell
+    return (unsigned int)cell;
+}
+
+unsigned long long SpatialGrid::getCellKey(const FMOD_VECTOR& position, int level)
+{
+    // Pack the cell on each axis into 21 bits
+    unsigned long long cellX = this->getCellCoordinate(position.x, level);
+    unsigned long long cellY = this->getCellCoordinate(position.y, level);
+    unsigned long long cellZ = this->getCellCoordinate(position.z, level);
+    return cellX | (cellY << 21) | (cellZ << 42);
+}
+
+int SpatialGrid::getLevel(float radius)
+{
+    // Go up while the cells are narrower than the radius (the top level covers the world)
+    int level = 0;
+    float levelCellSize = this->cellSize;
+    while (level + 1 < (int)this->cellsPerAxis.size() && levelCellSize < radius)
+    {
+        level++;
+        levelCellSize *= 2.0f;
+    }
+    // return the level
+    return level;
+}
+
+void SpatialGrid::insertEntry(int index)
+{
+    // Find the cell for the position on the level of the radius
+    SpatialEntry& entry = this->entries[index];
+    entry.cellKey = this->getCellKey(entry.position, entry.level);
+    // Add the entry to the cell (making the cell if it is new)
+    this->levels[entry.level][entry.cellKey].push_back(index);
+}
+
+void SpatialGrid::removeEntry(int index)
+{
+    // Find the cell
+    std::unordered_map< unsigned long long, std::vector<int> >& cells = this->levels[this->entries[index].level];
+    std::unordered_map< unsigned long long, std::vector<int> >::iterator cell = cells.find(this->entries[index].cellKey);
+    if (cell == cells.end())
+        return;
+    // Swap with the last entry of the cell and remove
+    std::vector<int>& cellEntries = cell->second;
+    std::vector<int>::iterator i = std::find(cellEntries.begin(), cellEntries.end(), index);
+    if (i != cellEntries.end())
+    {
+        *i = cellEntries.back();
+        cellEntries.pop_back();
+    }
+    // Empty cells go
+    if (cellEntries.empty() == true)
+        cells.erase(cell);
+}
+
+void SpatialGrid::visitLevel(int level, const FMOD_VECTOR& listenerPosition)
+{
+    // Everything on this level has a radius no wider than a cell (or sits on the top level, one cell wide)
+    float reach = std::ldexp(this->cellSize, level);
+    std::unordered_map< unsigned long long, std::vector<int> >& cells = this->levels[level];
+    // Cells within reach of the listener
+    unsigned int firstX = this->getCellCoordinate(listenerPosition.x - reach, level);
+    unsigned int lastX = this->getCellCoordinate(listenerPosition.x + reach, level);
+    unsigned int firstY = this->getCellCoordinate(listenerPosition.y - reach, level);
+    unsigned int lastY = this->getCellCoordinate(listenerPosition.y + reach, level);
+    unsigned int firstZ = this->getCellCoordinate(listenerPosition.z - reach, level);
+    unsigned int lastZ = this->getCellCoordinate(listenerPosition.z + reach, level);
+    // Visit every occupied cell of the level instead when that is less work
+    double numberOfCells = (double)(lastX - firstX + 1) * (double)(lastY - firstY + 1) * (double)(lastZ - firstZ + 1);
+    bool visitAllFlag = (numberOfCells > (double)cells.size());
+    std::unordered_map< unsigned long long, std::vector<int> >::iterator cell = cells.begin();
+    unsigned int cellX = firstX;
+    unsigned int cellY = firstY;
+    unsigned int cellZ = firstZ;
+    while (true)
+    {
+        // Find the next cell
+        const std::vector<int>* pCell = 0;
+        if (visitAllFlag == true)
+        {
+            if (cell == cells.end())
+                break;
+            pCell = &(cell->second);
+            cell++;
+        }
+        else
+        {
+            if (cellZ > lastZ)
+                break;
+            unsigned long long cellKey = (unsigned long long)cellX | ((unsigned long long)cellY << 21) | ((unsigned long long)cellZ << 42);
+            std::unordered_map< unsigned long long, std::vector<int> >::iterator found = cells.find(cellKey);
+            if (found != cells.end())
+                pCell = &(found->second);
+            // Step through x, then y, then z
+            if (++cellX > lastX)
+            {
+                cellX = firstX;
+                if (++cellY > lastY)
+                {
+                    cellY = firstY;
+                    cellZ++;
+                }
+            }
+            if (pCell == 0)
+                continue;
+        }
+        // Switch on everything in the cell with the listener inside its radius
+        for (unsigned int i = 0; i < pCell->size(); i++)
+        {
+            // Grab the Entry
+            int index = (*pCell)[i];
+            SpatialEntry& entry = this->entries[index];
+            // Already found by another listener
+            if (entry.visitedUpdate == this->updateCount)
+                continue;
+            // Is the listener inside the radius
+            float dx = entry.position.x - listenerPosition.x;
+            float dy = entry.position.y - listenerPosition.y;
+            float dz = entry.position.z - listenerPosition.z;
+            if (dx * dx + dy * dy + dz * dz > entry.radius * entry.radius)
+                continue;
+            // On
+            entry.visitedUpdate = this->updateCount;
+            this->nextActiveEntries.push_back(index);
+            if (entry.activeFlag == false)
+            {
+                entry.activeFlag = true;
+                entry.pSpatialObject->setSpatialActive(true);
+            }
+        }
+    }
+}
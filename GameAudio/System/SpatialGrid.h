@@ -0,0 +1,197 @@
+/**
+  * @file   SpatialGrid.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  SpatialGrid is a uniform grid over the world that finds the
+  * SpatialObjects near each listener
+*/
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+// C++ Includes
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "System/SpatialObject.h"
+
+/** The SpatialGrid covers the world (-maxWorldSize to +maxWorldSize on
+    each axis, the same extent FMOD's geometry engine uses) with cubic
+    cells. Only cells with something in them exist (they are hashed by
+    cell coordinate) so a large world with small cells costs nothing until
+    it is populated. The grid has levels, each with cells twice as wide as
+    the one below, and a SpatialObject sits in the cell holding its
+    position on the lowest level whose cells are at least as wide as its
+    radius. It moves cell when it tells the grid it has moved. Each update
+    the cells of every occupied level within one cell of each listener are
+    visited, objects with a listener inside their radius are switched on
+    and everything which was on and is not any more is switched off. One
+    loud sound only makes its own level coarse, so the work done depends
+    on how many objects are near the listeners rather than how many are in
+    the world or how far the loudest one carries **/
+class SpatialGrid
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        SpatialGrid();
+        //! Destructor
+        virtual ~SpatialGrid();
+
+    protected:
+        //! SpatialGrid Copy constructor
+        SpatialGrid(const SpatialGrid& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! SpatialGrid Assignment operator
+        SpatialGrid& operator=(const SpatialGrid& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief create
+          * Size the grid (objects already in the grid are moved into the new cells)
+          * @param worldSize distance from the centre of the world to its edge (AudioSystem::getMaxWorldSize)
+          * @param cellSize width of a cell on the lowest level (around the radius of the quietest sounds works well)
+          * @return true on success false otherwise **/
+        virtual bool create(float worldSize, float cellSize = 100.0f);
+        /** @brief update
+          * Switch objects on and off depending on where the listeners are
+          * @param pListenerPositions positions of the listeners
+          * @param numberOfListeners number of listeners **/
+        virtual void update(const FMOD_VECTOR* pListenerPositions, int numberOfListeners);
+        /** @brief clear
+          * Switch everything back on and remove it from the grid **/
+        virtual void clear();
+
+    public:
+        /** @brief add
+          * @param pSpatialObject a Sound3D, Stream3D or Reverb3D **/
+        virtual void add(SpatialObject* pSpatialObject);
+        /** @brief remove (called by the SpatialObject destructor)
+          * @param pSpatialObject the object to remove **/
+        virtual void remove(SpatialObject* pSpatialObject);
+        /** @brief move (called by a SpatialObject when its position or radius changes)
+          * @param pSpatialObject the object which moved **/
+        virtual void move(SpatialObject* pSpatialObject);
+        /** @brief query
+          * Find every object within a radius of a point
+          * @param position centre of the search
+          * @param radius radius of the search
+          * @param results receives the objects (cleared first) **/
+        virtual void query(const FMOD_VECTOR& position, float radius, std::vector<SpatialObject*>& results);
+
+    public:
+        /** @brief Get World Size
+          * @return distance from the centre of the world to its edge **/
+        virtual float getWorldSize() { return this->worldSize; }
+        /** @brief Get Cell Size
+          * @return width of a cell on the lowest level **/
+        virtual float getCellSize() { return this->cellSize; }
+        /** @brief Get the number of objects in the grid
+          * @return objects **/
+        virtual int getNumberOfObjects();
+        /** @brief Get the number of objects switched on after the last update
+          * @return active objects **/
+        virtual int getNumberOfActiveObjects() { return this->numberOfActiveObjects; }
+        /** @brief Get the number of cells with something in them
+          * @return occupied cells on every level **/
+        virtual int getNumberOfCells();
+
+    protected:
+        // An object in the grid
+        struct SpatialEntry
+        {
+            // The object (0 while the entry is free)
+            SpatialObject* pSpatialObject;
+            // Position
+            FMOD_VECTOR position;
+            // Radius
+            float radius;
+            // Level of the grid the object is in
+            int level;
+            // Key of the cell holding the object
+            unsigned long long cellKey;
+            // Update the object was last found near a listener
+            unsigned int visitedUpdate;
+            // Is the object switched on
+            bool activeFlag;
+        };
+
+    protected:
+        /** @brief getCellCoordinate
+          * @param value position on one axis
+          * @param level level of the grid
+          * @return cell on that axis (clamped to the world) **/
+        virtual unsigned int getCellCoordinate(float value, int level);
+        /** @brief getCellKey
+          * @param position a position
+          * @param level level of the grid
+          * @return key of the cell holding the position **/
+        virtual unsigned long long getCellKey(const FMOD_VECTOR& position, int level);
+        /** @brief getLevel
+          * @param radius radius of an object
+          * @return the lowest level whose cells are at least as wide as the radius **/
+        virtual int getLevel(float radius);
+        /** @brief insertEntry (lock must be held)
+          * @param index entry to put in the cell for its position **/
+        virtual void insertEntry(int index);
+        /** @brief removeEntry (lock must be held)
+          * @param index entry to take out of its cell **/
+        virtual void removeEntry(int index);
+        /** @brief visitLevel (lock must be held)
+          * Switch on the objects of one level with a listener inside their radius
+          * @param level level of the grid
+          * @param listenerPosition position of the listener **/
+        virtual void visitLevel(int level, const FMOD_VECTOR& listenerPosition);
+
+    protected:
+        /* NOTE: Cell keys pack the cell on each axis into 21 bits so the
+            grid can be up to 2097152 cells wide (at the lowest level, each
+            level up is half as wide). The SpatialObjects are
+            only called while the lock is held, which is why a derived
+            destructor must leave the grid before it tears anything down */
+        // Distance from the centre of the world to its edge
+        float worldSize;
+        // Width of a cell (on the lowest level)
+        float cellSize;
+        // Cells across the world on each level
+        std::vector<unsigned int> cellsPerAxis;
+        // Entries
+        std::vector<SpatialEntry> entries;
+        // Indices of the free Entries (used as a stack)
+        std::vector<int> freeEntries;
+        // Occupied cells of each level
+        std::vector< std::unordered_map< unsigned long long, std::vector<int> > > levels;
+        // Entries switched on after the last update
+        std::vector<int> activeEntries;
+        // Kept to avoid reallocating each update
+        std::vector<int> nextActiveEntries;
+        // Update counter
+        unsigned int updateCount;
+        // Objects switched on after the last update
+        int numberOfActiveObjects;
+        // Guards everything (objects can move from any thread)
+        std::mutex mutex;
+};
+
+#endif // SPATIALGRID_H
@@ -0,0 +1,34 @@
+#include "SpatialObject.h"
+#include "System/SpatialGrid.h"
+
+SpatialObject::SpatialObject()
+{
+    // Not in the SpatialGrid
+    this->spatialIndex = -1;
+    // Active until the SpatialGrid says otherwise
+    this->spatialActiveFlag = true;
+}
+
+SpatialObject::~SpatialObject()
+{
+    // Leave the SpatialGrid
+    this->leaveSpatialGrid();
+}
+
+void SpatialObject::spatialMoved()
+{
+    // Only objects in the SpatialGrid need to tell it
+    if (this->spatialIndex < 0 || FMODGlobals::pSpatialGrid == 0)
+        return;
+    // Move to the right cell
+    FMODGlobals::pSpatialGrid->move(this);
+}
+
+void SpatialObject::leaveSpatialGrid()
+{
+    // Only objects in the SpatialGrid need to leave it
+    if (this->spatialIndex < 0 || FMODGlobals::pSpatialGrid == 0)
+        return;
+    // Remove from the SpatialGrid
+    FMODGlobals::pSpatialGrid->remove(this);
+}
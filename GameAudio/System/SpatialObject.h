@@ -0,0 +1,76 @@
+/**
+  * @file   SpatialObject.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  SpatialObject is the interface an object implements to be
+  * kept in the SpatialGrid
+*/
+
+#ifndef SPATIALOBJECT_H
+#define SPATIALOBJECT_H
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+
+/** A SpatialObject has a position and a radius it can be heard (or felt)
+    within. Sound3D, Stream3D and Reverb3D are SpatialObjects. Once added
+    to the SpatialGrid the object tells the grid whenever it moves and the
+    grid tells the object when no listener is inside its radius any more
+    (and when one comes back) so it can stop costing anything while it is
+    out of earshot **/
+class SpatialObject
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        SpatialObject();
+        //! Destructor (leaves the SpatialGrid)
+        virtual ~SpatialObject();
+
+    // *********************
+    // * SPATIAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief getSpatialPosition
+          * @return position of the object **/
+        virtual FMOD_VECTOR getSpatialPosition() = 0;
+        /** @brief getSpatialRadius
+          * @return distance from a listener beyond which the object is inactive **/
+        virtual float getSpatialRadius() = 0;
+        /** @brief setSpatialActive (called by the SpatialGrid)
+          * @param spatialActiveFlag true when a listener comes inside the radius,
+          * false when the last one leaves **/
+        virtual void setSpatialActive(bool spatialActiveFlag) = 0;
+        /** @brief isSpatialActive
+          * @return false while the SpatialGrid has the object switched off **/
+        virtual bool isSpatialActive() { return this->spatialActiveFlag; }
+        /** @brief getSpatialIndex
+          * @return index of the object in the SpatialGrid (-1 when not in it) **/
+        virtual int getSpatialIndex() { return this->spatialIndex; }
+        /** @brief setSpatialIndex (called by the SpatialGrid)
+          * @param spatialIndex index of the object in the SpatialGrid **/
+        virtual void setSpatialIndex(int spatialIndex) { this->spatialIndex = spatialIndex; }
+
+    protected:
+        /** @brief spatialMoved
+          * Tell the SpatialGrid the position or radius has changed **/
+        virtual void spatialMoved();
+        /** @brief leaveSpatialGrid
+          * Remove the object from the SpatialGrid (derived destructors call
+          * this first so the grid never calls a half destroyed object) **/
+        virtual void leaveSpatialGrid();
+
+    protected:
+        // Index in the SpatialGrid
+        int spatialIndex;
+        // Has the SpatialGrid left the object switched on
+        bool spatialActiveFlag;
+};
+
+#endif // SPATIALOBJECT_H
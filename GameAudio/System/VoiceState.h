@@ -0,0 +1,44 @@
+/**
+  * @file   VoiceState.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  VoiceState is a read only copy of a Channel's playback
+  * state published by the AudioSystem's update thread
+*/
+
+#ifndef VOICESTATE_H
+#define VOICESTATE_H
+
+class Channel;
+
+/** The VoiceState struct is written by the audio update thread for every
+    watched Channel and read by game threads through AudioSystem::getVoiceState
+    so they never have to call FMOD (or touch the Channel) themselves **/
+struct VoiceState
+{
+    //! Constructor
+    VoiceState()
+    {
+        this->pChannel = 0;
+        this->playingFlag = false;
+        this->pausedFlag = false;
+        this->virtualFlag = false;
+        this->audibility = 0.0f;
+        this->dspClock = 0;
+    }
+
+    // The Channel this state belongs to
+    Channel* pChannel;
+    // Is the Channel playing
+    bool playingFlag;
+    // Is the Channel paused
+    bool pausedFlag;
+    // Has FMOD made the Channel virtual
+    bool virtualFlag;
+    // Combined volume after 3D and occlusion
+    float audibility;
+    // DSP clock of the Channel's head DSP node
+    unsigned long long dspClock;
+};
+
+#endif // VOICESTATE_H
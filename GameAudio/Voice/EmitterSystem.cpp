@@ -0,0 +1,675 @@
+#include "EmitterSystem.h"
+
+EmitterSystem::EmitterSystem()
+{
+    // Voice Pool
+    this->pVoicePool = 0;
+    // Emitters
+    this->slots.clear();
+    this->freeSlots.clear();
+    this->numberOfEmitters = 0;
+    // Real Voice Budget
+    this->realVoiceBudget = 32;
+    // Audibility Threshold
+    this->audibilityThreshold = 0.001f;
+    // Hysteresis
+    this->hysteresis = 1.1f;
+    // Auto Velocity
+    this->velocitySmoothing = AUTOVELOCITY_DEFAULT_SMOOTHING;
+    this->teleportSpeed = AUTOVELOCITY_DEFAULT_TELEPORT_SPEED;
+    // Stats
+    this->numberOfRealEmitters = 0;
+    this->lastUpdateTime = 0.0f;
+    // Not updated yet
+    this->updatedFlag = false;
+}
+
+EmitterSystem::~EmitterSystem()
+{
+    // Stop every voice and release the SoundSamples
+    this->clear();
+}
+
+void EmitterSystem::update(const FMOD_VECTOR* pListenerPositions, int numberOfListeners)
+{
+    // Time of this update
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Time since the last update
+    float dTime = (this->updatedFlag == true) ? std::chrono::duration<float>(now - this->lastUpdate).count() : 0.0f;
+    this->lastUpdate = now;
+    this->updatedFlag = true;
+    // Velocity of every emitter with auto velocity from how far it moved
+    if (this->numberOfEmitters > 0)
+        AutoVelocity::derive(&(this->x[0]), &(this->y[0]), &(this->z[0]), &(this->previousX[0]), &(this->previousY[0]), &(this->previousZ[0]), &(this->xVelocity[0]), &(this->yVelocity[0]), &(this->zVelocity[0]), &(this->autoVelocityWeight[0]), this->numberOfEmitters, dTime, this->velocitySmoothing, this->teleportSpeed);
+    // Distance, attenuation and range of every emitter
+    this->computeAudibility(pListenerPositions, numberOfListeners);
+    // Move every emitter through its sound and find the ones which could have a voice
+    this->candidates.clear();
+    this->scores.resize(this->numberOfEmitters);
+    this->realFlags.assign(this->numberOfEmitters, 0);
+    for (int i = 0; i < this->numberOfEmitters; i++)
+    {
+        // Grab the State
+        EmitterState& state = this->states[i];
+        // Finished emitters stay silent until they are removed
+        if (state.finishedFlag == true)
+            continue;
+        // A derived velocity is sent while moving and once more when it stops
+        if (this->autoVelocityWeight[i] != 0.0f)
+        {
+            bool movingFlag = (this->xVelocity[i] * this->xVelocity[i] + this->yVelocity[i] * this->yVelocity[i] + this->zVelocity[i] * this->zVelocity[i] > 0.0001f);
+            if (movingFlag == true || state.movingFlag == true)
+                state.dirtyFlag = true;
+            state.movingFlag = movingFlag;
+        }
+        // A real emitter takes its playback position from the voice (the wall clock drifts from it with pitch)
+        unsigned int position = 0;
+        if (state.voiceHandle != INVALID_VOICE_HANDLE && this->pVoicePool != 0 && this->pVoicePool->getPlaybackPosition(state.voiceHandle, position) == true)
+        {
+            state.playbackPosition = (float)position;
+        }
+        else
+        {
+            /* NOTE: A voice which has gone either reached the end or was
+                stolen. Either way the emitter is virtual from here and moves
+                on from the last position the voice had, so a stolen sound
+                which does not loop carries on until it would have ended */
+            state.voiceHandle = INVALID_VOICE_HANDLE;
+            // Move the playback position on
+            state.playbackPosition += dTime * 1000.0f;
+        }
+        if (state.length > 0 && state.playbackPosition >= (float)state.length)
+        {
+            // A looping sound wraps around
+            if (state.loopFlag == true)
+            {
+                state.playbackPosition = std::fmod(state.playbackPosition, (float)state.length);
+            }
+            // A virtual one which does not loop would have finished by now
+            else if (state.voiceHandle == INVALID_VOICE_HANDLE)
+            {
+                state.finishedFlag = true;
+                continue;
+            }
+        }
+        // Out of range or too quiet to bother with
+        if (this->inRangeFlags[i] == 0 || this->audibility[i] < this->audibilityThreshold)
+            continue;
+        // Priority 0 is the most important and 256 the least
+        int priority = std::max(0, std::min(256, state.priority));
+        float priorityWeight = (float)(257 - priority) / 257.0f;
+        // Score
+        this->scores[i] = priorityWeight * this->audibility[i];
+        // Favour emitters which already have a voice
+        if (state.voiceHandle != INVALID_VOICE_HANDLE)
+            this->scores[i] *= this->hysteresis;
+        // This emitter could have a voice
+        this->candidates.push_back(i);
+    }
+    // Keep the best candidates up to the budget (no need to sort the rest)
+    if ((int)this->candidates.size() > this->realVoiceBudget)
+    {
+        std::vector<float>& scores = this->scores;
+        std::nth_element(this->candidates.begin(), this->candidates.begin() + this->realVoiceBudget, this->candidates.end(), [&scores](int a, int b) { return scores[a] > scores[b]; });
+        this->candidates.resize(this->realVoiceBudget);
+    }
+    for (unsigned int i = 0; i < this->candidates.size(); i++)
+        this->realFlags[this->candidates[i]] = 1;
+    // Start, move and stop the voices
+    this->numberOfRealEmitters = 0;
+    for (int i = 0; i < this->numberOfEmitters; i++)
+    {
+        // Grab the State
+        EmitterState& state = this->states[i];
+        // Not chosen so make it virtual
+        if (this->realFlags[i] == 0)
+        {
+            this->stopVoice(state);
+            continue;
+        }
+        // Chosen and already playing so just pass on any changes
+        if (state.voiceHandle != INVALID_VOICE_HANDLE)
+        {
+            if (state.dirtyFlag == true)
+            {
+                this->pVoicePool->setPosition(state.voiceHandle, this->x[i], this->y[i], this->z[i]);
+                this->pVoicePool->setVelocity(state.voiceHandle, this->xVelocity[i], this->yVelocity[i], this->zVelocity[i]);
+                this->pVoicePool->setVolume(state.voiceHandle, this->volume[i]);
+                this->pVoicePool->set3DMinMaxDistance(state.voiceHandle, this->minDistance[i], this->maxDistance[i]);
+                state.dirtyFlag = false;
+            }
+            this->numberOfRealEmitters++;
+            continue;
+        }
+        // Chosen and virtual so give it a voice
+        if (this->pVoicePool == 0)
+            continue;
+        VoiceHandle voiceHandle = this->pVoicePool->play3D(state.pSoundSample, this->x[i], this->y[i], this->z[i], this->volume[i]);
+        // Every voice is busy, try again next update
+        if (voiceHandle == INVALID_VOICE_HANDLE)
+            continue;
+        // Pick up where the emitter would have been
+        this->pVoicePool->set3DMinMaxDistance(voiceHandle, this->minDistance[i], this->maxDistance[i]);
+        this->pVoicePool->setVelocity(voiceHandle, this->xVelocity[i], this->yVelocity[i], this->zVelocity[i]);
+        if (state.playbackPosition >= 1.0f)
+            this->pVoicePool->setPlaybackPosition(voiceHandle, (unsigned int)state.playbackPosition);
+        // Real
+        state.voiceHandle = voiceHandle;
+        state.dirtyFlag = false;
+        this->numberOfRealEmitters++;
+    }
+    // Time the update
+    this->lastUpdateTime = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - now).count();
+}
+
+void EmitterSystem::clear()
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Stop every voice and release every SoundSample
+    for (int i = 0; i < this->numberOfEmitters; i++)
+    {
+        this->stopVoice(this->states[i]);
+        this->states[i].pSoundSample->removeReference();
+    }
+    // Forget the emitters
+    this->slots.clear();
+    this->freeSlots.clear();
+    this->numberOfEmitters = 0;
+    this->x.clear();
+    this->y.clear();
+    this->z.clear();
+    this->minDistance.clear();
+    this->maxDistance.clear();
+    this->volume.clear();
+    this->linearWeight.clear();
+    this->squareWeight.clear();
+    this->previousX.clear();
+    this->previousY.clear();
+    this->previousZ.clear();
+    this->xVelocity.clear();
+    this->yVelocity.clear();
+    this->zVelocity.clear();
+    this->autoVelocityWeight.clear();
+    this->distance.clear();
+    this->audibility.clear();
+    this->inRangeFlags.clear();
+    this->states.clear();
+    this->candidates.clear();
+    this->scores.clear();
+    this->realFlags.clear();
+    // Reset Stats
+    this->numberOfRealEmitters = 0;
+    this->updatedFlag = false;
+}
+
+void EmitterSystem::setRealVoiceBudget(int realVoiceBudget)
+{
+    // Validate the budget
+    if (realVoiceBudget < 0)
+    {
+        std::cout << "void EmitterSystem::setRealVoiceBudget() failure. realVoiceBudget must not be negative" << std::endl;
+        return;
+    }
+    // Set Real Voice Budget
+    this->realVoiceBudget = realVoiceBudget;
+}
+
+int EmitterSystem::getNumberOfEmitters()
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of emitters
+    return this->numberOfEmitters;
+}
+
+EmitterHandle EmitterSystem::addEmitter(SoundSample* pSoundSample, float x, float y, float z, float volume, int priority)
+{
+    // There must be a SoundSample to play
+    if (pSoundSample == 0 || pSoundSample->getFMODSound() == 0)
+    {
+        std::cout << "EmitterHandle EmitterSystem::addEmitter() failure. No SoundSample" << std::endl;
+        return INVALID_EMITTER_HANDLE;
+    }
+    // Read what FMOD will do to the voice (keeping the rolloff maths away from dividing by zero)
+    FMOD_MODE mode = pSoundSample->getMode();
+    float minDistance = std::max(pSoundSample->getMinDistance(), FLT_EPSILON);
+    float maxDistance = std::max(pSoundSample->getMaxDistance(), minDistance);
+    unsigned int length = pSoundSample->getLengthInMilliseconds();
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Make a slot when none are free (the index has to fit in 16 bits)
+    if (this->freeSlots.empty() == true)
+    {
+        if (this->slots.size() >= 0xFFFF)
+        {
+            std::cout << "EmitterHandle EmitterSystem::addEmitter() failure. Too many emitters" << std::endl;
+            return INVALID_EMITTER_HANDLE;
+        }
+        EmitterSlot slot;
+        slot.generation = 1;
+        slot.index = -1;
+        this->slots.push_back(slot);
+        this->freeSlots.push_back((unsigned int)this->slots.size() - 1);
+    }
+    // Take a slot
+    unsigned int slot = this->freeSlots.back();
+    this->freeSlots.pop_back();
+    // Grow the arrays four silent emitters at a time
+    int index = this->numberOfEmitters;
+    if (index >= (int)this->x.size())
+    {
+        unsigned int size = (unsigned int)this->x.size() + 4;
+        this->x.resize(size, 0.0f);
+        this->y.resize(size, 0.0f);
+        this->z.resize(size, 0.0f);
+        this->minDistance.resize(size, 1.0f);
+        this->maxDistance.resize(size, 1.0f);
+        this->volume.resize(size, 0.0f);
+        this->linearWeight.resize(size, 0.0f);
+        this->squareWeight.resize(size, 0.0f);
+        this->previousX.resize(size, 0.0f);
+        this->previousY.resize(size, 0.0f);
+        this->previousZ.resize(size, 0.0f);
+        this->xVelocity.resize(size, 0.0f);
+        this->yVelocity.resize(size, 0.0f);
+        this->zVelocity.resize(size, 0.0f);
+        this->autoVelocityWeight.resize(size, 0.0f);
+        this->distance.resize(size, 0.0f);
+        this->audibility.resize(size, 0.0f);
+        this->inRangeFlags.resize(size, 0);
+        this->states.resize(size);
+    }
+    // Fill in the emitter
+    this->x[index] = x;
+    this->y[index] = y;
+    this->z[index] = z;
+    this->minDistance[index] = minDistance;
+    this->maxDistance[index] = maxDistance;
+    this->volume[index] = volume;
+    this->linearWeight[index] = ((mode & (FMOD_3D_LINEARROLLOFF | FMOD_3D_LINEARSQUAREROLLOFF)) != 0) ? 1.0f : 0.0f;
+    this->squareWeight[index] = ((mode & FMOD_3D_LINEARSQUAREROLLOFF) != 0) ? 1.0f : 0.0f;
+    this->previousX[index] = x;
+    this->previousY[index] = y;
+    this->previousZ[index] = z;
+    this->xVelocity[index] = 0.0f;
+    this->yVelocity[index] = 0.0f;
+    this->zVelocity[index] = 0.0f;
+    this->autoVelocityWeight[index] = 0.0f;
+    this->distance[index] = 0.0f;
+    this->audibility[index] = 0.0f;
+    this->inRangeFlags[index] = 0;
+    EmitterState& state = this->states[index];
+    state.slot = slot;
+    state.pSoundSample = pSoundSample;
+    state.voiceHandle = INVALID_VOICE_HANDLE;
+    state.priority = priority;
+    state.length = length;
+    state.playbackPosition = 0.0f;
+    state.loopFlag = ((mode & (FMOD_LOOP_NORMAL | FMOD_LOOP_BIDI)) != 0);
+    state.finishedFlag = false;
+    state.dirtyFlag = false;
+    state.movingFlag = false;
+    // Hold a reference so the AudioManager does not evict the SoundSample
+    pSoundSample->addReference();
+    // Point the slot at the emitter
+    this->slots[slot].index = index;
+    this->numberOfEmitters++;
+    // return the handle
+    return VoiceHandles::make(slot, this->slots[slot].generation);
+}
+
+void EmitterSystem::removeEmitter(EmitterHandle handle)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return;
+    // Stop the voice and release the SoundSample
+    this->stopVoice(this->states[index]);
+    this->states[index].pSoundSample->removeReference();
+    // Free the slot (a new generation makes old handles stale, 0 is never valid)
+    EmitterSlot& slot = this->slots[this->states[index].slot];
+    slot.generation = (slot.generation + 1) & 0xFFFF;
+    if (slot.generation == 0)
+        slot.generation = 1;
+    slot.index = -1;
+    this->freeSlots.push_back(this->states[index].slot);
+    // Move the last emitter into the hole
+    int last = this->numberOfEmitters - 1;
+    if (index != last)
+    {
+        this->x[index] = this->x[last];
+        this->y[index] = this->y[last];
+        this->z[index] = this->z[last];
+        this->minDistance[index] = this->minDistance[last];
+        this->maxDistance[index] = this->maxDistance[last];
+        this->volume[index] = this->volume[last];
+        this->linearWeight[index] = this->linearWeight[last];
+        this->squareWeight[index] = this->squareWeight[last];
+        this->previousX[index] = this->previousX[last];
+        this->previousY[index] = this->previousY[last];
+        this->previousZ[index] = this->previousZ[last];
+        this->xVelocity[index] = this->xVelocity[last];
+        this->yVelocity[index] = this->yVelocity[last];
+        this->zVelocity[index] = this->zVelocity[last];
+        this->autoVelocityWeight[index] = this->autoVelocityWeight[last];
+        this->distance[index] = this->distance[last];
+        this->audibility[index] = this->audibility[last];
+        this->inRangeFlags[index] = this->inRangeFlags[last];
+        this->states[index] = this->states[last];
+        this->slots[this->states[index].slot].index = index;
+    }
+    // The last place becomes a silent emitter
+    this->x[last] = 0.0f;
+    this->y[last] = 0.0f;
+    this->z[last] = 0.0f;
+    this->minDistance[last] = 1.0f;
+    this->maxDistance[last] = 1.0f;
+    this->volume[last] = 0.0f;
+    this->linearWeight[last] = 0.0f;
+    this->squareWeight[last] = 0.0f;
+    this->previousX[last] = 0.0f;
+    this->previousY[last] = 0.0f;
+    this->previousZ[last] = 0.0f;
+    this->xVelocity[last] = 0.0f;
+    this->yVelocity[last] = 0.0f;
+    this->zVelocity[last] = 0.0f;
+    this->autoVelocityWeight[last] = 0.0f;
+    this->numberOfEmitters--;
+}
+
+bool EmitterSystem::isValid(EmitterHandle handle)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // The handle is valid if it still resolves to an emitter
+    return (this->resolve(handle) >= 0);
+}
+
+bool EmitterSystem::isReal(EmitterHandle handle)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return false;
+    // Real if it has a voice
+    return (this->states[index].voiceHandle != INVALID_VOICE_HANDLE);
+}
+
+bool EmitterSystem::isFinished(EmitterHandle handle)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return false;
+    // return finishedFlag
+    return this->states[index].finishedFlag;
+}
+
+void EmitterSystem::setPosition(EmitterHandle handle, float x, float y, float z)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return;
+    // Set Position
+    this->x[index] = x;
+    this->y[index] = y;
+    this->z[index] = z;
+    // Tell the voice on the next update
+    this->states[index].dirtyFlag = true;
+}
+
+void EmitterSystem::setVelocity(EmitterHandle handle, float xVelocity, float yVelocity, float zVelocity)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return;
+    // The update works out the velocity with auto velocity on
+    if (this->autoVelocityWeight[index] != 0.0f)
+        return;
+    // Set Velocity
+    this->xVelocity[index] = xVelocity;
+    this->yVelocity[index] = yVelocity;
+    this->zVelocity[index] = zVelocity;
+    // Tell the voice on the next update
+    this->states[index].dirtyFlag = true;
+}
+
+FMOD_VECTOR EmitterSystem::getVelocity(EmitterHandle handle)
+{
+    // Velocity
+    FMOD_VECTOR velocity;
+        velocity.x = 0.0f;
+        velocity.y = 0.0f;
+        velocity.z = 0.0f;
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return velocity;
+    // return velocity
+    velocity.x = this->xVelocity[index];
+    velocity.y = this->yVelocity[index];
+    velocity.z = this->zVelocity[index];
+    return velocity;
+}
+
+void EmitterSystem::setAutoVelocity(EmitterHandle handle, bool autoVelocityFlag)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return;
+    // Set Auto Velocity
+    this->autoVelocityWeight[index] = (autoVelocityFlag == true) ? 1.0f : 0.0f;
+    // Start from rest where the emitter is now
+    this->previousX[index] = this->x[index];
+    this->previousY[index] = this->y[index];
+    this->previousZ[index] = this->z[index];
+    this->xVelocity[index] = 0.0f;
+    this->yVelocity[index] = 0.0f;
+    this->zVelocity[index] = 0.0f;
+    // Tell the voice on the next update
+    this->states[index].dirtyFlag = true;
+}
+
+void EmitterSystem::setVolume(EmitterHandle handle, float volume)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return;
+    // Set Volume
+    this->volume[index] = volume;
+    // Tell the voice on the next update
+    this->states[index].dirtyFlag = true;
+}
+
+void EmitterSystem::setMinMaxDistance(EmitterHandle handle, float minDistance, float maxDistance)
+{
+    // Validate the distances
+    if (minDistance <= 0.0f || maxDistance < minDistance)
+    {
+        std::cout << "void EmitterSystem::setMinMaxDistance() failure. minDistance must be above 0 and no more than maxDistance" << std::endl;
+        return;
+    }
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return;
+    // Set Min and Max Distance
+    this->minDistance[index] = minDistance;
+    this->maxDistance[index] = maxDistance;
+    // Tell the voice on the next update
+    this->states[index].dirtyFlag = true;
+}
+
+void EmitterSystem::setPriority(EmitterHandle handle, int priority)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return;
+    // Set Priority
+    this->states[index].priority = priority;
+}
+
+float EmitterSystem::getDistance(EmitterHandle handle)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return 0.0f;
+    // return distance
+    return this->distance[index];
+}
+
+float EmitterSystem::getAudibility(EmitterHandle handle)
+{
+    // Lock the System
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Resolve the handle
+    int index = this->resolve(handle);
+    if (index < 0)
+        return 0.0f;
+    // return audibility
+    return this->audibility[index];
+}
+
+int EmitterSystem::resolve(EmitterHandle handle)
+{
+    // Find the slot
+    unsigned int slot = VoiceHandles::getIndex(handle);
+    if (slot >= this->slots.size())
+        return -1;
+    // A different generation means the emitter was removed
+    if (this->slots[slot].generation != VoiceHandles::getGeneration(handle))
+        return -1;
+    // return the index
+    return this->slots[slot].index;
+}
+
+void EmitterSystem::computeAudibility(const FMOD_VECTOR* pListenerPositions, int numberOfListeners)
+{
+    // No listeners means no attenuation
+    if (pListenerPositions == 0)
+        numberOfListeners = 0;
+    // The arrays are padded to a multiple of four
+    int size = (this->numberOfEmitters + 3) & ~3;
+    #ifdef EMITTERSYSTEM_SSE
+    // Constants
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 smallest = _mm_set1_ps(FLT_EPSILON);
+    // Four emitters at a time
+    for (int i = 0; i < size; i += 4)
+    {
+        // Positions
+        __m128 x = _mm_loadu_ps(&(this->x[i]));
+        __m128 y = _mm_loadu_ps(&(this->y[i]));
+        __m128 z = _mm_loadu_ps(&(this->z[i]));
+        // Closest listener (squared distances until the end)
+        __m128 closest = (numberOfListeners > 0) ? _mm_set1_ps(FLT_MAX) : zero;
+        for (int l = 0; l < numberOfListeners; l++)
+        {
+            __m128 dx = _mm_sub_ps(x, _mm_set1_ps(pListenerPositions[l].x));
+            __m128 dy = _mm_sub_ps(y, _mm_set1_ps(pListenerPositions[l].y));
+            __m128 dz = _mm_sub_ps(z, _mm_set1_ps(pListenerPositions[l].z));
+            __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            closest = _mm_min_ps(closest, distanceSquared);
+        }
+        __m128 distance = _mm_sqrt_ps(closest);
+        // No attenuation inside min distance and none further beyond max distance
+        __m128 minDistance = _mm_loadu_ps(&(this->minDistance[i]));
+        __m128 maxDistance = _mm_loadu_ps(&(this->maxDistance[i]));
+        __m128 clamped = _mm_min_ps(_mm_max_ps(distance, minDistance), maxDistance);
+        // Inverse (min / distance)
+        __m128 inverse = _mm_div_ps(minDistance, clamped);
+        // Linear from 1 at min distance to 0 at max distance
+        __m128 range = _mm_max_ps(_mm_sub_ps(maxDistance, minDistance), smallest);
+        __m128 linear = _mm_sub_ps(one, _mm_div_ps(_mm_sub_ps(clamped, minDistance), range));
+        // Linear Square
+        __m128 squareWeight = _mm_loadu_ps(&(this->squareWeight[i]));
+        linear = _mm_mul_ps(linear, _mm_add_ps(_mm_sub_ps(one, squareWeight), _mm_mul_ps(squareWeight, linear)));
+        // Pick inverse or linear
+        __m128 linearWeight = _mm_loadu_ps(&(this->linearWeight[i]));
+        __m128 attenuation = _mm_add_ps(inverse, _mm_mul_ps(linearWeight, _mm_sub_ps(linear, inverse)));
+        // Store the results
+        _mm_storeu_ps(&(this->distance[i]), distance);
+        _mm_storeu_ps(&(this->audibility[i]), _mm_mul_ps(_mm_loadu_ps(&(this->volume[i])), attenuation));
+        int inRangeMask = _mm_movemask_ps(_mm_cmple_ps(distance, maxDistance));
+        this->inRangeFlags[i + 0] = (unsigned char)((inRangeMask >> 0) & 1);
+        this->inRangeFlags[i + 1] = (unsigned char)((inRangeMask >> 1) & 1);
+        this->inRangeFlags[i + 2] = (unsigned char)((inRangeMask >> 2) & 1);
+        this->inRangeFlags[i + 3] = (unsigned char)((inRangeMask >> 3) & 1);
+    }
+    #else
+    // One emitter at a time
+    for (int i = 0; i < size; i++)
+    {
+        // Closest listener (squared distances until the end)
+        float closest = (numberOfListeners > 0) ? FLT_MAX : 0.0f;
+        for (int l = 0; l < numberOfListeners; l++)
+        {
+            float dx = this->x[i] - pListenerPositions[l].x;
+            float dy = this->y[i] - pListenerPositions[l].y;
+            float dz = this->z[i] - pListenerPositions[l].z;
+            closest = std::min(closest, dx * dx + dy * dy + dz * dz);
+        }
+        float distance = std::sqrt(closest);
+        // No attenuation inside min distance and none further beyond max distance
+        float minDistance = this->minDistance[i];
+        float maxDistance = this->maxDistance[i];
+        float clamped = std::min(std::max(distance, minDistance), maxDistance);
+        // Inverse (min / distance)
+        float inverse = minDistance / clamped;
+        // Linear from 1 at min distance to 0 at max distance
+        float linear = 1.0f - (clamped - minDistance) / std::max(maxDistance - minDistance, FLT_EPSILON);
+        // Linear Square
+        linear *= (1.0f - this->squareWeight[i]) + this->squareWeight[i] * linear;
+        // Pick inverse or linear
+        float attenuation = inverse + this->linearWeight[i] * (linear - inverse);
+        // Store the results
+        this->distance[i] = distance;
+        this->audibility[i] = this->volume[i] * attenuation;
+        this->inRangeFlags[i] = (distance <= maxDistance) ? 1 : 0;
+    }
+    #endif
+}
+
+void EmitterSystem::stopVoice(EmitterState& state)
+{
+    // Nothing to stop
+    if (state.voiceHandle == INVALID_VOICE_HANDLE)
+        return;
+    // Stop the voice (the emitter keeps its playback position moving while virtual)
+    if (this->pVoicePool != 0)
+        this->pVoicePool->stop(state.voiceHandle);
+    state.voiceHandle = INVALID_VOICE_HANDLE;
+}
@@ -0,0 +1,338 @@
+/**
+  * @file   EmitterSystem.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  EmitterSystem keeps thousands of positional sounds in flat
+  * arrays and decides which of them get a voice from the VoicePool
+*/
+
+#ifndef EMITTERSYSTEM_H
+#define EMITTERSYSTEM_H
+
+// C++ Includes
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define EMITTERSYSTEM_SSE
+    #include <xmmintrin.h>
+#endif
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Sound/SoundSample.h"
+#include "System/AutoVelocity.h"
+#include "Voice/VoiceHandle.h"
+#include "Voice/VoicePool.h"
+
+/** An EmitterHandle is built the same way as a VoiceHandle (slot index
+    and generation) so a handle to a removed emitter stops resolving **/
+typedef unsigned int EmitterHandle;
+
+// The handle returned when an emitter could not be added
+const EmitterHandle INVALID_EMITTER_HANDLE = 0;
+
+/** The EmitterSystem is for the sounds a level is full of (torches,
+    machinery, water, crowds) where a Sound3D per source would mean a
+    virtual call per source just to find out it is too far away to hear.
+    Positions, ranges, volumes and rolloffs are kept as one float array
+    each (structure of arrays) and every update the distance to the
+    closest listener, the rolloff attenuation and an in range flag are
+    worked out four emitters at a time with SSE (plain C++ without it).
+    Emitters inside max distance and above the audibility threshold are
+    ranked by audibility x priority and the best, up to the real voice
+    budget, play on the VoicePool. The rest are virtual: they have no
+    voice but keep their playback position moving so they pick up where
+    they would have been when they come back. An emitter which is not
+    looping finishes when its sound reaches the end (losing its voice to
+    a steal only makes it virtual). Emitters with auto
+    velocity switched on have their velocity (for doppler) worked out
+    from how far they moved, all of them in one pass at the start of the
+    update **/
+class EmitterSystem
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        EmitterSystem();
+        //! Destructor
+        virtual ~EmitterSystem();
+
+    protected:
+        //! EmitterSystem Copy constructor
+        EmitterSystem(const EmitterSystem& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! EmitterSystem Assignment operator
+        EmitterSystem& operator=(const EmitterSystem& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief update
+          * Cull and rank the emitters and start, move or stop their voices
+          * @param pListenerPositions positions of the listeners
+          * @param numberOfListeners number of listeners **/
+        virtual void update(const FMOD_VECTOR* pListenerPositions, int numberOfListeners);
+        /** @brief clear
+          * Stop every voice and remove every emitter **/
+        virtual void clear();
+
+    public:
+        /** @brief Get the Voice Pool
+          * @return the VoicePool emitters play on **/
+        virtual VoicePool* getVoicePool() { return this->pVoicePool; }
+        /** @brief Set the Voice Pool (the AudioSystem sets its own during init)
+          * @param pVoicePool the VoicePool emitters play on **/
+        virtual void setVoicePool(VoicePool* pVoicePool) { this->pVoicePool = pVoicePool; }
+        /** @brief Get the Real Voice Budget
+          * @return the maximum number of emitters playing on a voice **/
+        virtual int getRealVoiceBudget() { return this->realVoiceBudget; }
+        /** @brief Set the Real Voice Budget
+          * @param realVoiceBudget the maximum number of emitters playing on a voice **/
+        virtual void setRealVoiceBudget(int realVoiceBudget);
+        /** @brief Get the Audibility Threshold
+          * @return emitters quieter than this at the closest listener are virtual **/
+        virtual float getAudibilityThreshold() { return this->audibilityThreshold; }
+        /** @brief Set the Audibility Threshold
+          * @param audibilityThreshold (0.0 to 1.0, default 0.001) **/
+        virtual void setAudibilityThreshold(float audibilityThreshold) { this->audibilityThreshold = audibilityThreshold; }
+        /** @brief Get Hysteresis
+          * @return score multiplier given to emitters which already have a voice **/
+        virtual float getHysteresis() { return this->hysteresis; }
+        /** @brief Set Hysteresis
+          * @param hysteresis score multiplier for emitters which already have a voice (1.0 for none) **/
+        virtual void setHysteresis(float hysteresis) { this->hysteresis = hysteresis; }
+        /** @brief Get Velocity Smoothing
+          * @return time a derived velocity takes to settle in seconds **/
+        virtual float getVelocitySmoothing() { return this->velocitySmoothing; }
+        /** @brief Set Velocity Smoothing
+          * @param velocitySmoothing time a derived velocity takes to settle in seconds (default 0.1, 0 for none) **/
+        virtual void setVelocitySmoothing(float velocitySmoothing) { this->velocitySmoothing = velocitySmoothing; }
+        /** @brief Get Teleport Speed
+          * @return speed at which a move zeroes a derived velocity instead **/
+        virtual float getTeleportSpeed() { return this->teleportSpeed; }
+        /** @brief Set Teleport Speed
+          * @param teleportSpeed speed in world units a second at which a move zeroes a derived velocity instead (default 500, 0 for never) **/
+        virtual void setTeleportSpeed(float teleportSpeed) { this->teleportSpeed = teleportSpeed; }
+        /** @brief Get the number of emitters
+          * @return emitters **/
+        virtual int getNumberOfEmitters();
+        /** @brief Get the number of emitters playing on a voice after the last update
+          * @return real emitters **/
+        virtual int getNumberOfRealEmitters() { return this->numberOfRealEmitters; }
+        /** @brief Get the time the last update took
+          * @return microseconds **/
+        virtual float getLastUpdateTime() { return this->lastUpdateTime; }
+
+    // *********************
+    // * EMITTER FUNCTIONS *
+    // *********************
+    public:
+        /** @brief addEmitter
+          * Min and max distance and rolloff come from the SoundSample so the
+          * culling agrees with what FMOD does to the voice
+          * @param pSoundSample a 3D SoundSample (the emitter holds a reference to it)
+          * @param x x position
+          * @param y y position
+          * @param z z position
+          * @param volume (0.0 silent 1.0 fullblast)
+          * @param priority (0 most important to 256 least important)
+          * @return a handle to the emitter or INVALID_EMITTER_HANDLE **/
+        virtual EmitterHandle addEmitter(SoundSample* pSoundSample, float x, float y, float z, float volume = 1.0f, int priority = 128);
+        /** @brief removeEmitter
+          * @param handle the emitter (its voice is stopped) **/
+        virtual void removeEmitter(EmitterHandle handle);
+        /** @brief isValid
+          * @param handle the emitter
+          * @return true if the handle still refers to an emitter **/
+        virtual bool isValid(EmitterHandle handle);
+        /** @brief isReal
+          * @param handle the emitter
+          * @return true if the emitter is playing on a voice **/
+        virtual bool isReal(EmitterHandle handle);
+        /** @brief isFinished
+          * @param handle the emitter
+          * @return true if the emitter does not loop and has reached the end of its sound **/
+        virtual bool isFinished(EmitterHandle handle);
+        /** @brief setPosition
+          * @param handle the emitter
+          * @param x x position
+          * @param y y position
+          * @param z z position **/
+        virtual void setPosition(EmitterHandle handle, float x, float y, float z);
+        /** @brief setVelocity
+          * Ignored while the emitter has auto velocity on
+          * @param handle the emitter
+          * @param xVelocity x velocity
+          * @param yVelocity y velocity
+          * @param zVelocity z velocity **/
+        virtual void setVelocity(EmitterHandle handle, float xVelocity, float yVelocity, float zVelocity);
+        /** @brief getVelocity
+          * @param handle the emitter
+          * @return velocity of the emitter (derived at the last update with auto velocity on) **/
+        virtual FMOD_VECTOR getVelocity(EmitterHandle handle);
+        /** @brief setAutoVelocity
+          * @param handle the emitter
+          * @param autoVelocityFlag true to work out the velocity from how far the emitter moves **/
+        virtual void setAutoVelocity(EmitterHandle handle, bool autoVelocityFlag);
+        /** @brief setVolume
+          * @param handle the emitter
+          * @param volume (0.0 silent 1.0 fullblast) **/
+        virtual void setVolume(EmitterHandle handle, float volume);
+        /** @brief setMinMaxDistance
+          * Override the distances of the SoundSample for this emitter
+          * @param handle the emitter
+          * @param minDistance distance the sound starts to attenuate (must be above 0)
+          * @param maxDistance distance the sound is culled beyond **/
+        virtual void setMinMaxDistance(EmitterHandle handle, float minDistance, float maxDistance);
+        /** @brief setPriority
+          * @param handle the emitter
+          * @param priority (0 most important to 256 least important) **/
+        virtual void setPriority(EmitterHandle handle, int priority);
+        /** @brief getDistance
+          * @param handle the emitter
+          * @return distance to the closest listener at the last update **/
+        virtual float getDistance(EmitterHandle handle);
+        /** @brief getAudibility
+          * @param handle the emitter
+          * @return volume x attenuation at the last update **/
+        virtual float getAudibility(EmitterHandle handle);
+
+    protected:
+        // A handle slot
+        struct EmitterSlot
+        {
+            // Generation of the slot
+            unsigned int generation;
+            // Index of the emitter in the arrays (-1 while the slot is free)
+            int index;
+        };
+        // Everything about an emitter the culling does not read
+        struct EmitterState
+        {
+            // Handle slot of the emitter
+            unsigned int slot;
+            // SoundSample the emitter plays
+            SoundSample* pSoundSample;
+            // Voice while the emitter is real
+            VoiceHandle voiceHandle;
+            // Priority (0 most important to 256 least important)
+            int priority;
+            // Length of the sound in milliseconds
+            unsigned int length;
+            // Where the emitter is (or would be) in its sound in milliseconds (read from the voice while real)
+            float playbackPosition;
+            // Does the sound loop
+            bool loopFlag;
+            // Has a sound which does not loop reached the end
+            bool finishedFlag;
+            // Has the position, volume or distances changed since the voice was told
+            bool dirtyFlag;
+            // Was the derived velocity moving at the last update
+            bool movingFlag;
+        };
+
+    protected:
+        /** @brief resolve (lock must be held)
+          * @param handle the emitter
+          * @return index of the emitter in the arrays or -1 if the handle is stale **/
+        virtual int resolve(EmitterHandle handle);
+        /** @brief computeAudibility (lock must be held)
+          * Fill distance, audibility and inRangeFlags for every emitter
+          * @param pListenerPositions positions of the listeners
+          * @param numberOfListeners number of listeners **/
+        virtual void computeAudibility(const FMOD_VECTOR* pListenerPositions, int numberOfListeners);
+        /** @brief stopVoice (lock must be held)
+          * @param state the emitter to make virtual **/
+        virtual void stopVoice(EmitterState& state);
+
+    protected:
+        /* NOTE: The float arrays are padded to a multiple of four with
+            silent emitters so the SSE loop never needs a scalar tail.
+            Emitters are kept packed at the front, removing one moves the
+            last emitter into its place and points its slot at it */
+        // Voice Pool
+        VoicePool* pVoicePool;
+        // Handle Slots
+        std::vector<EmitterSlot> slots;
+        // Indices of the free Handle Slots (used as a stack)
+        std::vector<unsigned int> freeSlots;
+        // Number of emitters
+        int numberOfEmitters;
+        // Positions
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        // Min and Max Distance
+        std::vector<float> minDistance;
+        std::vector<float> maxDistance;
+        // Volume
+        std::vector<float> volume;
+        // 1 for linear and linear square rolloff, 0 for inverse
+        std::vector<float> linearWeight;
+        // 1 for linear square rolloff
+        std::vector<float> squareWeight;
+        // Positions at the last update
+        std::vector<float> previousX;
+        std::vector<float> previousY;
+        std::vector<float> previousZ;
+        // Velocities
+        std::vector<float> xVelocity;
+        std::vector<float> yVelocity;
+        std::vector<float> zVelocity;
+        // 1 for auto velocity, 0 for velocity set by hand
+        std::vector<float> autoVelocityWeight;
+        // Distance to the closest listener (last update)
+        std::vector<float> distance;
+        // Volume x attenuation (last update)
+        std::vector<float> audibility;
+        // Inside max distance (last update)
+        std::vector<unsigned char> inRangeFlags;
+        // Emitter States
+        std::vector<EmitterState> states;
+        // Emitters which could have a voice this update, and their scores
+        std::vector<int> candidates;
+        std::vector<float> scores;
+        // Emitters chosen for a voice this update
+        std::vector<unsigned char> realFlags;
+        // Real Voice Budget
+        int realVoiceBudget;
+        // Audibility Threshold
+        float audibilityThreshold;
+        // Hysteresis
+        float hysteresis;
+        // Velocity Smoothing
+        float velocitySmoothing;
+        // Teleport Speed
+        float teleportSpeed;
+        // Real emitters after the last update
+        int numberOfRealEmitters;
+        // Microseconds the last update took
+        float lastUpdateTime;
+        // Time of the last update
+        std::chrono::steady_clock::time_point lastUpdate;
+        // Has update been called yet
+        bool updatedFlag;
+        // Guards everything (emitters can be added from any thread)
+        std::mutex mutex;
+};
+
+#endif // EMITTERSYSTEM_H
@@ -0,0 +1,39 @@
+/**
+  * @file   VoiceHandle.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  VoiceHandle is a 32 bit generation checked reference
+  * to a slot in a VoicePool
+*/
+
+#ifndef VOICEHANDLE_H
+#define VOICEHANDLE_H
+
+/** A VoiceHandle packs a slot index (low 16 bits) and the generation of
+    the slot (high 16 bits). Every time a slot is recycled its generation
+    goes up, so a handle to a voice which has finished simply stops
+    resolving instead of pointing at whatever plays in the slot next.
+    Generations start at 1 so a handle of 0 is never valid **/
+typedef unsigned int VoiceHandle;
+
+// The handle returned when there was no voice to give out
+const VoiceHandle INVALID_VOICE_HANDLE = 0;
+
+namespace VoiceHandles
+{
+    /** @brief Build a handle
+      * @param index slot index (0 to 65535)
+      * @param generation slot generation (1 to 65535)
+      * @return the handle **/
+    inline VoiceHandle make(unsigned int index, unsigned int generation) { return ((generation & 0xFFFF) << 16) | (index & 0xFFFF); }
+    /** @brief Get the slot index of a handle
+      * @param handle the handle
+      * @return slot index **/
+    inline unsigned int getIndex(VoiceHandle handle) { return handle & 0xFFFF; }
+    /** @brief Get the generation of a handle
+      * @param handle the handle
+      * @return generation **/
+    inline unsigned int getGeneration(VoiceHandle handle) { return (handle >> 16) & 0xFFFF; }
+}
+
+#endif // VOICEHANDLE_H
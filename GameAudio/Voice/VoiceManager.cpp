@@ -0,0 +1,376 @@
+#include "VoiceManager.h"
+#include "System/AudioSystem.h"
+
+VoiceManager::VoiceManager()
+{
+    // Real Voice Budget
+    this->realVoiceBudget = 64;
+    // Hysteresis
+    this->hysteresis = 1.1f;
+    // Mixer Clock
+    this->dspClock = 0;
+    this->sampleRate = 0;
+    // Voices
+    this->voices.clear();
+    this->rankedVoices.clear();
+    // Counts
+    this->numberOfRealVoices = 0;
+    this->numberOfVirtualVoices = 0;
+}
+
+VoiceManager::~VoiceManager()
+{
+
+}
+
+void VoiceManager::update(const FMOD_VECTOR* pListenerPositions, int numberOfListeners, const VoiceState* pVoiceStates, int numberOfVoiceStates)
+{
+    // Lock the Manager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Where the mixer is (virtual voices move on by the audio it mixed, not the wall clock)
+    this->readMixerClock();
+    // Find the live voices
+    this->rankedVoices.clear();
+    this->positionedVoices.clear();
+    this->x.clear();
+    this->y.clear();
+    this->z.clear();
+    this->minDistances.clear();
+    this->maxDistances.clear();
+    for (unsigned int i = 0; i < this->voices.size(); i++)
+    {
+        // Grab the Voice
+        ManagedVoice& voice = this->voices[i];
+        // Grab the Channel
+        Channel* pChannel = voice.pChannel;
+        // Find its published state (not published yet means it has only just been added)
+        const VoiceState* pVoiceState = this->findVoiceState(voice, pVoiceStates, numberOfVoiceStates);
+        if (pVoiceState == 0)
+        {
+            voice.playingFlag = false;
+            continue;
+        }
+        voice.playingFlag = pVoiceState->playingFlag;
+        // A Channel stopped while virtual is not virtual any more (whether or not it was played again since)
+        if (voice.virtualFlag == true && pChannel->isSuspendedFor(CHANNEL_SUSPEND_VIRTUAL) == false)
+            voice.virtualFlag = false;
+        // Finished Channels (or ones which were stopped while virtual) are not voices
+        if (voice.playingFlag == false)
+        {
+            if (voice.virtualFlag == true)
+                pChannel->setSuspended(CHANNEL_SUSPEND_VIRTUAL, false);
+            voice.virtualFlag = false;
+            continue;
+        }
+        // A Channel the game paused is not using a voice (while virtual its position stands still too)
+        if (pChannel->isPaused() == true)
+        {
+            if (voice.virtualFlag == true)
+                voice.virtualClock = this->dspClock;
+            continue;
+        }
+        // Rank this voice
+        this->rankedVoices.push_back(i);
+        // Positional voices are estimated once the closest listeners are known
+        FMOD_VECTOR position;
+        float minDistance = 0.0f;
+        float maxDistance = 0.0f;
+        voice.nearestListener = -1;
+        voice.distance = 0.0f;
+        if (pChannel->getEstimatePosition(position, minDistance, maxDistance) == true)
+        {
+            this->positionedVoices.push_back(i);
+            this->x.push_back(position.x);
+            this->y.push_back(position.y);
+            this->z.push_back(position.z);
+            this->minDistances.push_back(minDistance);
+            this->maxDistances.push_back(maxDistance);
+            continue;
+        }
+        // The rest only have their volume
+        voice.audibility = pChannel->getEstimatedAudibility(pListenerPositions, numberOfListeners);
+    }
+    // Closest listener to every positional voice in one pass
+    int numberOfPositionedVoices = (int)this->positionedVoices.size();
+    this->distances.resize(numberOfPositionedVoices);
+    this->nearestListeners.resize(numberOfPositionedVoices);
+    if (numberOfPositionedVoices > 0)
+        NearestListener::find(&(this->x[0]), &(this->y[0]), &(this->z[0]), numberOfPositionedVoices, pListenerPositions, numberOfListeners, &(this->distances[0]), &(this->nearestListeners[0]));
+    for (int i = 0; i < numberOfPositionedVoices; i++)
+    {
+        // Grab the Voice
+        ManagedVoice& voice = this->voices[this->positionedVoices[i]];
+        // Keep the closest listener for culling and LOD
+        voice.nearestListener = (pListenerPositions != 0 && numberOfListeners > 0) ? this->nearestListeners[i] : -1;
+        voice.distance = this->distances[i];
+        // Estimate at that distance
+        voice.audibility = voice.pChannel->estimateAudibilityAt(this->distances[i], this->minDistances[i], this->maxDistances[i]);
+    }
+    // Score every live voice
+    for (unsigned int i = 0; i < this->rankedVoices.size(); i++)
+    {
+        // Grab the Voice
+        ManagedVoice& voice = this->voices[this->rankedVoices[i]];
+        // Priority 0 is the most important and 256 the least
+        int priority = std::max(0, std::min(256, voice.pChannel->getPriority()));
+        float priorityWeight = (float)(257 - priority) / 257.0f;
+        // Score
+        voice.score = priorityWeight * voice.audibility;
+        // Favour voices which are already real
+        if (voice.virtualFlag == false)
+            voice.score *= this->hysteresis;
+    }
+    // Highest score first
+    std::vector<ManagedVoice>& voices = this->voices;
+    std::sort(this->rankedVoices.begin(), this->rankedVoices.end(), [&voices](int a, int b) { return voices[a].score > voices[b].score; });
+    // Reset Counts
+    this->numberOfRealVoices = 0;
+    this->numberOfVirtualVoices = 0;
+    // Inside the budget play for real, outside it go virtual
+    for (unsigned int i = 0; i < this->rankedVoices.size(); i++)
+    {
+        // Grab the Voice
+        ManagedVoice& voice = this->voices[this->rankedVoices[i]];
+        // Real
+        if ((int)i < this->realVoiceBudget)
+        {
+            if (voice.virtualFlag == true)
+                this->makeReal(voice);
+            // The voice may have reached its end while virtual
+            if (voice.virtualFlag == false && voice.playingFlag == true)
+                this->numberOfRealVoices++;
+        }
+        // Virtual
+        else
+        {
+            // Move a voice which stays virtual on at its pitch this update (pitch may change while virtual)
+            if (voice.virtualFlag == false)
+                this->makeVirtual(voice);
+            else
+                this->advanceVirtual(voice);
+            this->numberOfVirtualVoices++;
+        }
+    }
+}
+
+void VoiceManager::clear()
+{
+    // Lock the Manager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Give back every virtual voice
+    this->readMixerClock();
+    for (unsigned int i = 0; i < this->voices.size(); i++)
+    {
+        if (this->voices[i].virtualFlag == true)
+            this->makeReal(this->voices[i]);
+    }
+    // Forget the voices
+    this->voices.clear();
+    this->rankedVoices.clear();
+    // Reset Counts
+    this->numberOfRealVoices = 0;
+    this->numberOfVirtualVoices = 0;
+}
+
+void VoiceManager::addChannel(Channel* pChannel)
+{
+    // Validate the Channel
+    if (pChannel == 0)
+        return;
+    // Fill in the voice
+    ManagedVoice voice;
+    voice.pChannel = pChannel;
+    voice.virtualFlag = false;
+    voice.virtualPosition = 0.0;
+    voice.virtualClock = 0;
+    voice.score = 0.0f;
+    voice.audibility = 0.0f;
+    voice.distance = 0.0f;
+    voice.nearestListener = -1;
+    voice.playingFlag = false;
+    voice.stateIndex = 0;
+    {
+        // Lock the Manager
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // Only manage a Channel once
+        for (unsigned int i = 0; i < this->voices.size(); i++)
+        {
+            if (this->voices[i].pChannel == pChannel)
+                return;
+        }
+        // Add the Channel
+        this->voices.push_back(voice);
+        // Make room to rank it
+        this->rankedVoices.reserve(this->voices.size());
+    }
+    // Ask the update thread to publish its state (which the update reads instead of asking FMOD)
+    if (FMODGlobals::pAudioSystem != 0)
+        FMODGlobals::pAudioSystem->watchChannel(pChannel);
+}
+
+void VoiceManager::removeChannel(Channel* pChannel)
+{
+    // Lock the Manager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the Channel
+    for (unsigned int i = 0; i < this->voices.size(); i++)
+    {
+        if (this->voices[i].pChannel == pChannel)
+        {
+            // Stop holding it paused for the manager
+            if (this->voices[i].virtualFlag == true)
+                pChannel->setSuspended(CHANNEL_SUSPEND_VIRTUAL, false);
+            // Swap with the last voice and remove
+            this->voices[i] = this->voices.back();
+            this->voices.pop_back();
+            return;
+        }
+    }
+}
+
+bool VoiceManager::isVirtual(Channel* pChannel)
+{
+    // Lock the Manager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the Channel
+    for (unsigned int i = 0; i < this->voices.size(); i++)
+    {
+        if (this->voices[i].pChannel == pChannel)
+            return this->voices[i].virtualFlag;
+    }
+    // Not managed
+    return false;
+}
+
+int VoiceManager::getNearestListener(Channel* pChannel, float* pDistance)
+{
+    // Lock the Manager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the Channel
+    for (unsigned int i = 0; i < this->voices.size(); i++)
+    {
+        if (this->voices[i].pChannel == pChannel)
+        {
+            // Hand back the distance
+            if (pDistance != 0)
+                *pDistance = this->voices[i].distance;
+            // return the listener
+            return this->voices[i].nearestListener;
+        }
+    }
+    // Not managed
+    return -1;
+}
+
+int VoiceManager::getRealVoiceBudget()
+{
+    // Lock the Manager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the Real Voice Budget
+    return this->realVoiceBudget;
+}
+
+void VoiceManager::setRealVoiceBudget(int realVoiceBudget)
+{
+    // Validate the budget
+    if (realVoiceBudget < 0)
+    {
+        std::cout << "void VoiceManager::setRealVoiceBudget() failure. realVoiceBudget must not be negative" << std::endl;
+        return;
+    }
+    // Lock the Manager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Set Real Voice Budget
+    this->realVoiceBudget = realVoiceBudget;
+}
+
+int VoiceManager::getNumberOfManagedChannels()
+{
+    // Lock the Manager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of voices
+    return (int)this->voices.size();
+}
+
+const VoiceState* VoiceManager::findVoiceState(ManagedVoice& voice, const VoiceState* pVoiceStates, int numberOfVoiceStates)
+{
+    // Where it was last update (the snapshot only changes when Channels are watched or unwatched)
+    if (voice.stateIndex < numberOfVoiceStates && pVoiceStates[voice.stateIndex].pChannel == voice.pChannel)
+        return &(pVoiceStates[voice.stateIndex]);
+    // Look for it
+    for (int i = 0; i < numberOfVoiceStates; i++)
+    {
+        if (pVoiceStates[i].pChannel == voice.pChannel)
+        {
+            voice.stateIndex = i;
+            return &(pVoiceStates[i]);
+        }
+    }
+    // Not published
+    return 0;
+}
+
+void VoiceManager::readMixerClock()
+{
+    // Grab the master channel group's clock (it counts the samples the mixer has really mixed)
+    this->dspClock = 0;
+    FMOD_CHANNELGROUP* pMasterChannelGroup = FMODGlobals::getMasterChannelGroup();
+    if (pMasterChannelGroup != 0)
+        FMOD_ChannelGroup_GetDSPClock(pMasterChannelGroup, &(this->dspClock), 0);
+    // Grab the mixer rate
+    this->sampleRate = 0;
+    FMOD_System_GetSoftwareFormat(FMODGlobals::pFMODSystem, &(this->sampleRate), 0, 0);
+}
+
+void VoiceManager::advanceVirtual(ManagedVoice& voice)
+{
+    // Samples mixed since the voice was last moved on (none without a clock)
+    unsigned long long mixedSamples = 0;
+    if (this->sampleRate > 0 && this->dspClock > voice.virtualClock)
+        mixedSamples = this->dspClock - voice.virtualClock;
+    // Move the position on at the voice's current pitch
+    voice.virtualPosition += (double)mixedSamples * 1000.0 / (double)std::max(this->sampleRate, 1) * (double)voice.pChannel->getPitch();
+    voice.virtualClock = this->dspClock;
+}
+
+void VoiceManager::makeVirtual(ManagedVoice& voice)
+{
+    // Remember where the voice was (read back from FMOD)
+    voice.virtualPosition = (double)voice.pChannel->getPlaybackPosition();
+    voice.virtualClock = this->dspClock;
+    // Hold the voice paused so it stops costing DSP time (the game's paused flag is left alone)
+    voice.pChannel->setSuspended(CHANNEL_SUSPEND_VIRTUAL, true);
+    // Flag as virtual
+    voice.virtualFlag = true;
+}
+
+void VoiceManager::makeReal(ManagedVoice& voice)
+{
+    // No longer virtual
+    voice.virtualFlag = false;
+    // Work out where the voice would be had it kept playing
+    this->advanceVirtual(voice);
+    unsigned int position = (unsigned int)std::min(std::max(voice.virtualPosition, 0.0), 4294967295.0);
+    // Handle running off the end of the sound
+    unsigned int length = voice.pChannel->getPlaybackLength();
+    if (length > 0 && position >= length)
+    {
+        // A looping voice wraps around
+        if (voice.pChannel->isLoop() == true)
+        {
+            position = position % length;
+        }
+        // Anything else would have finished by now
+        else
+        {
+            voice.pChannel->setSuspended(CHANNEL_SUSPEND_VIRTUAL, false);
+            voice.pChannel->stop();
+            voice.playingFlag = false;
+            return;
+        }
+    }
+    // Jump to the position
+    voice.pChannel->setPlaybackPosition(position);
+    // Stop holding the voice paused (it stays paused if the game paused it)
+    voice.pChannel->setSuspended(CHANNEL_SUSPEND_VIRTUAL, false);
+}
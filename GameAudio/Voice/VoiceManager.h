@@ -0,0 +1,200 @@
+/**
+  * @file   VoiceManager.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  VoiceManager keeps the number of really playing Channels
+  * inside a budget by pausing the least important ones (virtual voices)
+*/
+
+#ifndef VOICEMANAGER_H
+#define VOICEMANAGER_H
+
+// C++ Includes
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Channel/Channel.h"
+#include "System/NearestListener.h"
+#include "System/VoiceState.h"
+
+/** The VoiceManager scores every managed Channel each update as
+    priority weight x estimated audibility. The estimate comes from the
+    Channel's own volume, position and rolloff so there is no FMOD call
+    per voice, and whether a voice is still playing comes from the
+    VoiceStates the AudioSystem publishes (managed Channels are watched).
+    The highest scorers up to the real voice budget keep playing, the rest
+    become virtual: they are suspended (held paused without touching the
+    game's paused flag), their playback position is remembered and when
+    they score well enough again they resume at the position they would
+    have reached had they kept playing **/
+class VoiceManager
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        VoiceManager();
+        //! Destructor
+        virtual ~VoiceManager();
+
+    protected:
+        //! VoiceManager Copy constructor
+        VoiceManager(const VoiceManager& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! VoiceManager Assignment operator
+        VoiceManager& operator=(const VoiceManager& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief update
+          * Score the managed Channels and make voices real or virtual
+          * @param pListenerPositions positions of the listeners
+          * @param numberOfListeners number of listeners
+          * @param pVoiceStates the last published VoiceStates
+          * @param numberOfVoiceStates number of VoiceStates **/
+        virtual void update(const FMOD_VECTOR* pListenerPositions, int numberOfListeners, const VoiceState* pVoiceStates, int numberOfVoiceStates);
+        /** @brief clear
+          * Resume every virtual voice and forget all managed Channels **/
+        virtual void clear();
+
+    public:
+        /** @brief addChannel
+          * @param pChannel a Sound, Stream or Music for the manager to look after **/
+        virtual void addChannel(Channel* pChannel);
+        /** @brief removeChannel (called by the Channel destructor)
+          * @param pChannel the Channel to stop managing **/
+        virtual void removeChannel(Channel* pChannel);
+        /** @brief isVirtual
+          * @param pChannel a managed Channel
+          * @return true if the manager has made the Channel virtual **/
+        virtual bool isVirtual(Channel* pChannel);
+        /** @brief getNearestListener
+          * The closest listener to a positional Channel at the last update
+          * (for culling and LOD with more than one listener)
+          * @param pChannel a managed Channel
+          * @param pDistance receives the distance to the listener (may be 0)
+          * @return index of the listener or -1 if the Channel has no position or is not managed **/
+        virtual int getNearestListener(Channel* pChannel, float* pDistance = 0);
+
+    public:
+        /** @brief Get the Real Voice Budget
+          * @return the maximum number of Channels allowed to really play **/
+        virtual int getRealVoiceBudget();
+        /** @brief Set the Real Voice Budget
+          * @param realVoiceBudget the maximum number of Channels allowed to really play **/
+        virtual void setRealVoiceBudget(int realVoiceBudget);
+        /** @brief Get Hysteresis
+          * @return score multiplier given to voices which are already real **/
+        virtual float getHysteresis() { return this->hysteresis; }
+        /** @brief Set Hysteresis
+          * Stops two voices with similar scores swapping every update
+          * @param hysteresis score multiplier for voices which are already real (1.0 for none) **/
+        virtual void setHysteresis(float hysteresis) { this->hysteresis = hysteresis; }
+        /** @brief Get the number of managed Channels
+          * @return managed Channels **/
+        virtual int getNumberOfManagedChannels();
+        /** @brief Get the number of real voices after the last update
+          * @return real voices **/
+        virtual int getNumberOfRealVoices() { return this->numberOfRealVoices; }
+        /** @brief Get the number of virtual voices after the last update
+          * @return virtual voices **/
+        virtual int getNumberOfVirtualVoices() { return this->numberOfVirtualVoices; }
+
+    protected:
+        // A managed Channel
+        struct ManagedVoice
+        {
+            // The Channel
+            Channel* pChannel;
+            // Has the manager made this Channel virtual
+            bool virtualFlag;
+            // Playback position (ms) the Channel would have reached had it kept playing
+            double virtualPosition;
+            // Mixer clock the virtual position was last moved on at
+            unsigned long long virtualClock;
+            // Score from the last update
+            float score;
+            // Estimated audibility from the last update
+            float audibility;
+            // Distance to the closest listener at the last update
+            float distance;
+            // Closest listener at the last update (-1 without a position)
+            int nearestListener;
+            // Playing at the last published VoiceState
+            bool playingFlag;
+            // Index of its VoiceState at the last update
+            int stateIndex;
+        };
+
+    protected:
+        /** @brief findVoiceState
+          * @param voice the voice
+          * @param pVoiceStates the published VoiceStates
+          * @param numberOfVoiceStates number of VoiceStates
+          * @return the VoiceState of the voice's Channel or 0 **/
+        virtual const VoiceState* findVoiceState(ManagedVoice& voice, const VoiceState* pVoiceStates, int numberOfVoiceStates);
+        /** @brief readMixerClock
+          * Grab the mixer clock and rate virtual voices are moved on by **/
+        virtual void readMixerClock();
+        /** @brief advanceVirtual
+          * Move a virtual voice on by the audio mixed since it was last moved, at its current pitch
+          * @param voice the voice **/
+        virtual void advanceVirtual(ManagedVoice& voice);
+        /** @brief makeVirtual
+          * Suspend a voice and remember where it was
+          * @param voice the voice **/
+        virtual void makeVirtual(ManagedVoice& voice);
+        /** @brief makeReal
+          * Move a virtual voice on by the audio mixed while it was virtual and resume it
+          * @param voice the voice **/
+        virtual void makeReal(ManagedVoice& voice);
+
+    protected:
+        // Real Voice Budget
+        int realVoiceBudget;
+        // Hysteresis
+        float hysteresis;
+        // Mixer clock (in samples) at the last update
+        unsigned long long dspClock;
+        // Mixer rate
+        int sampleRate;
+        // Managed Voices
+        std::vector<ManagedVoice> voices;
+        // Indices of the voices scored this update (kept to avoid reallocating)
+        std::vector<int> rankedVoices;
+        // Positional voices laid out for the closest listener pass (kept to avoid reallocating)
+        std::vector<int> positionedVoices;
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> minDistances;
+        std::vector<float> maxDistances;
+        std::vector<float> distances;
+        std::vector<int> nearestListeners;
+        // Real Voices after the last update
+        int numberOfRealVoices;
+        // Virtual Voices after the last update
+        int numberOfVirtualVoices;
+        // Guards voices (Channels can be added from any thread)
+        std::mutex mutex;
+};
+
+#endif // VOICEMANAGER_H
@@ -0,0 +1,429 @@
+#include "VoicePool.h"
+#include "Sound/RolloffManager.h"
+
+VoicePool::VoicePool()
+{
+    // Voices
+    this->voices.clear();
+    // Free Voices
+    this->freeVoices.clear();
+    // Refused Plays
+    this->refusedPlays = 0;
+}
+
+VoicePool::~VoicePool()
+{
+    // Free the voices
+    this->free();
+}
+
+bool VoicePool::create(int numberOfVoices)
+{
+    // Validate the number of voices (the index has to fit in 16 bits)
+    if (numberOfVoices < 1 || numberOfVoices > 0xFFFF)
+    {
+        std::cout << "bool VoicePool::create() failure. numberOfVoices must be between 1 and 65535" << std::endl;
+        return false;
+    }
+    // Get rid of any existing voices
+    this->free();
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Create the Voice Slots
+    this->voices.resize(numberOfVoices);
+    this->freeVoices.reserve(numberOfVoices);
+    for (int i = 0; i < numberOfVoices; i++)
+    {
+        // Grab the Voice
+        Voice& voice = this->voices[i];
+        // Initialise the Voice
+        voice.pVoicePool = this;
+        voice.index = (unsigned int)i;
+        voice.generation = 1;
+        voice.pChannel = 0;
+        voice.pSoundSample = 0;
+        voice.activeFlag = false;
+    }
+    // Push the slots in reverse so slot 0 is handed out first
+    for (int i = numberOfVoices - 1; i >= 0; i--)
+        this->freeVoices.push_back((unsigned int)i);
+    // Success
+    return true;
+}
+
+void VoicePool::free()
+{
+    // Stop every voice
+    this->stopAll();
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Release the Voice Slots
+    this->voices.clear();
+    this->freeVoices.clear();
+    // Reset Refused Plays
+    this->refusedPlays = 0;
+}
+
+VoiceHandle VoicePool::play(SoundSample* pSoundSample, FMOD_CHANNELGROUP* pChannelGroup, float volume, float pitch)
+{
+    // Start the voice
+    return this->startVoice(pSoundSample, pChannelGroup, 0, volume, pitch);
+}
+
+VoiceHandle VoicePool::play3D(SoundSample* pSoundSample, float x, float y, float z, float volume, float pitch)
+{
+    // Position
+    FMOD_VECTOR position;
+        position.x = x;
+        position.y = y;
+        position.z = z;
+    // Start the voice
+    return this->startVoice(pSoundSample, 0, &position, volume, pitch);
+}
+
+void VoicePool::stop(VoiceHandle handle)
+{
+    // Channel to stop
+    FMOD_CHANNEL* pChannel = 0;
+    {
+        // Lock the Pool
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // Resolve the handle
+        pChannel = this->getChannel(handle);
+        if (pChannel == 0)
+            return;
+        // Give the slot back straight away
+        this->releaseVoice(&(this->voices[VoiceHandles::getIndex(handle)]));
+    }
+    // Unhook the callback so the end of the channel doesn't touch the recycled slot
+    FMOD_Channel_SetCallback(pChannel, 0);
+    // Stop the channel
+    FMOD_Channel_Stop(pChannel);
+}
+
+void VoicePool::stopAll()
+{
+    // Stop the voices one at a time (FMOD is never called with the lock held)
+    for (unsigned int i = 0; i < this->voices.size(); i++)
+    {
+        // Channel to stop
+        FMOD_CHANNEL* pChannel = 0;
+        {
+            // Lock the Pool
+            std::lock_guard<std::mutex> lock(this->mutex);
+            // Skip free slots
+            if (this->voices[i].activeFlag == false)
+                continue;
+            // Grab the Channel
+            pChannel = this->voices[i].pChannel;
+            // Give the slot back
+            this->releaseVoice(&(this->voices[i]));
+        }
+        // A slot which was still starting has no channel yet
+        if (pChannel == 0)
+            continue;
+        // Unhook the callback
+        FMOD_Channel_SetCallback(pChannel, 0);
+        // Stop the channel
+        FMOD_Channel_Stop(pChannel);
+    }
+}
+
+bool VoicePool::isValid(VoiceHandle handle)
+{
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // The handle is valid if it still resolves to a channel
+    return (this->getChannel(handle) != 0);
+}
+
+void VoicePool::setPaused(VoiceHandle handle, bool pausedFlag)
+{
+    // Resolve the handle
+    FMOD_CHANNEL* pChannel = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        pChannel = this->getChannel(handle);
+    }
+    if (pChannel == 0)
+        return;
+    // Set channel paused flag
+    FMOD_Channel_SetPaused(pChannel, pausedFlag);
+}
+
+void VoicePool::setVolume(VoiceHandle handle, float volume)
+{
+    // Resolve the handle
+    FMOD_CHANNEL* pChannel = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        pChannel = this->getChannel(handle);
+    }
+    if (pChannel == 0)
+        return;
+    // Set channel volume
+    FMOD_Channel_SetVolume(pChannel, volume);
+}
+
+void VoicePool::setPitch(VoiceHandle handle, float pitch)
+{
+    // Resolve the handle
+    FMOD_CHANNEL* pChannel = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        pChannel = this->getChannel(handle);
+    }
+    if (pChannel == 0)
+        return;
+    // Set channel pitch
+    FMOD_Channel_SetPitch(pChannel, pitch);
+}
+
+void VoicePool::setPosition(VoiceHandle handle, float x, float y, float z)
+{
+    // Resolve the handle
+    FMOD_CHANNEL* pChannel = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        pChannel = this->getChannel(handle);
+    }
+    if (pChannel == 0)
+        return;
+    // Position
+    FMOD_VECTOR position;
+        position.x = x;
+        position.y = y;
+        position.z = z;
+    // Set Position of the Channel (leave velocity alone)
+    FMOD_Channel_Set3DAttributes(pChannel, &position, 0, 0);
+}
+
+void VoicePool::setVelocity(VoiceHandle handle, float xVelocity, float yVelocity, float zVelocity)
+{
+    // Resolve the handle
+    FMOD_CHANNEL* pChannel = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        pChannel = this->getChannel(handle);
+    }
+    if (pChannel == 0)
+        return;
+    // Velocity
+    FMOD_VECTOR velocity;
+        velocity.x = xVelocity;
+        velocity.y = yVelocity;
+        velocity.z = zVelocity;
+    // Set Velocity of the Channel (leave position alone)
+    FMOD_Channel_Set3DAttributes(pChannel, 0, &velocity, 0);
+}
+
+void VoicePool::setPlaybackPosition(VoiceHandle handle, unsigned int position)
+{
+    // Resolve the handle
+    FMOD_CHANNEL* pChannel = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        pChannel = this->getChannel(handle);
+    }
+    if (pChannel == 0)
+        return;
+    // Set channel playback position
+    FMOD_Channel_SetPosition(pChannel, position, FMOD_TIMEUNIT_MS);
+}
+
+bool VoicePool::getPlaybackPosition(VoiceHandle handle, unsigned int& position)
+{
+    // Resolve the handle
+    FMOD_CHANNEL* pChannel = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        pChannel = this->getChannel(handle);
+    }
+    if (pChannel == 0)
+        return false;
+    // Get channel playback position (fails once FMOD has stopped or stolen the channel)
+    return (FMOD_Channel_GetPosition(pChannel, &position, FMOD_TIMEUNIT_MS) == FMOD_OK);
+}
+
+void VoicePool::set3DMinMaxDistance(VoiceHandle handle, float minDistance, float maxDistance)
+{
+    // Resolve the handle (and the SoundSample for its rolloff curve)
+    FMOD_CHANNEL* pChannel = 0;
+    SoundSample* pSoundSample = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        pChannel = this->getChannel(handle);
+        if (pChannel != 0)
+            pSoundSample = this->voices[VoiceHandles::getIndex(handle)].pSoundSample;
+    }
+    if (pChannel == 0)
+        return;
+    // Set channel min and max distance
+    FMOD_Channel_Set3DMinMaxDistance(pChannel, minDistance, maxDistance);
+    // The rolloff curve spans the new distances
+    if (pSoundSample != 0 && FMODGlobals::pRolloffManager != 0)
+        FMODGlobals::pRolloffManager->bindChannel(pChannel, pSoundSample->getRolloffCurve(), minDistance, maxDistance);
+}
+
+int VoicePool::getNumberOfActiveVoices()
+{
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Everything not on the free list is active
+    return (int)(this->voices.size() - this->freeVoices.size());
+}
+
+VoicePool::Voice* VoicePool::acquireVoice()
+{
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Every voice is busy
+    if (this->freeVoices.empty() == true)
+    {
+        this->refusedPlays++;
+        return 0;
+    }
+    // Take a slot off the free list
+    Voice* pVoice = &(this->voices[this->freeVoices.back()]);
+    this->freeVoices.pop_back();
+    // New generation (skipping 0 so a handle is never 0)
+    pVoice->generation = (pVoice->generation + 1) & 0xFFFF;
+    if (pVoice->generation == 0)
+        pVoice->generation = 1;
+    // Mark the slot as in use
+    pVoice->activeFlag = true;
+    pVoice->pChannel = 0;
+    // return the voice
+    return pVoice;
+}
+
+void VoicePool::releaseVoice(Voice* pVoice)
+{
+    // Already free
+    if (pVoice->activeFlag == false)
+        return;
+    // Clear the slot
+    pVoice->activeFlag = false;
+    pVoice->pChannel = 0;
+    // Let go of the SoundSample
+    if (pVoice->pSoundSample != 0)
+        pVoice->pSoundSample->removeReference();
+    pVoice->pSoundSample = 0;
+    // Put it back on the free list (never allocates, capacity was reserved in create)
+    this->freeVoices.push_back(pVoice->index);
+}
+
+FMOD_CHANNEL* VoicePool::getChannel(VoiceHandle handle)
+{
+    // Grab the slot index
+    unsigned int index = VoiceHandles::getIndex(handle);
+    // Validate the index
+    if (index >= this->voices.size())
+        return 0;
+    // Grab the Voice
+    Voice& voice = this->voices[index];
+    // The slot must still be on the same generation
+    if (voice.activeFlag == false || voice.generation != VoiceHandles::getGeneration(handle))
+        return 0;
+    // return the channel
+    return voice.pChannel;
+}
+
+VoiceHandle VoicePool::startVoice(SoundSample* pSoundSample, FMOD_CHANNELGROUP* pChannelGroup, const FMOD_VECTOR* pPosition, float volume, float pitch)
+{
+    // There must be a SoundSample to play
+    if (pSoundSample == 0)
+        return INVALID_VOICE_HANDLE;
+    // The SoundSample must have a valid FMODSound
+    if (pSoundSample->getFMODSound() == 0)
+        return INVALID_VOICE_HANDLE;
+    // Grab a voice
+    Voice* pVoice = this->acquireVoice();
+    if (pVoice == 0)
+        return INVALID_VOICE_HANDLE;
+    // Build the handle (and hold a reference to the SoundSample while the voice uses it)
+    unsigned int generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        generation = pVoice->generation;
+        pVoice->pSoundSample = pSoundSample;
+        pSoundSample->addReference();
+    }
+    VoiceHandle handle = VoiceHandles::make(pVoice->index, generation);
+    // Default to the sound effects channel group
+    if (pChannelGroup == 0)
+        pChannelGroup = FMODGlobals::pSoundEffectsChannelGroup;
+    // Play the sound paused so we can set it up before it is heard
+    FMOD_CHANNEL* pChannel = 0;
+    FMOD_RESULT result = FMOD_System_PlaySound(FMODGlobals::pFMODSystem, pSoundSample->getFMODSound(), pChannelGroup, true, &pChannel);
+    // If playback failed give the slot back
+    if (result != FMOD_OK)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (pVoice->generation == generation)
+            this->releaseVoice(pVoice);
+        return INVALID_VOICE_HANDLE;
+    }
+    // Let the callback find the voice
+    FMOD_Channel_SetUserData(pChannel, (void*)pVoice);
+    FMOD_Channel_SetCallback(pChannel, VoicePool::channelCallback);
+    // Set Position
+    if (pPosition != 0)
+        FMOD_Channel_Set3DAttributes(pChannel, pPosition, 0, 0);
+    // Bind the channel to the SoundSample's rolloff curve
+    if (FMODGlobals::pRolloffManager != 0 && pSoundSample->getRolloffCurve() != -1)
+        FMODGlobals::pRolloffManager->bindChannel(pChannel, pSoundSample->getRolloffCurve(), pSoundSample->getMinDistance(), pSoundSample->getMaxDistance());
+    // Set the volume
+    FMOD_Channel_SetVolume(pChannel, volume);
+    // Set the pitch
+    FMOD_Channel_SetPitch(pChannel, pitch);
+    // Hand the channel to the voice
+    bool staleFlag = false;
+    {
+        // Lock the Pool
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // The voice was stopped while we were starting it
+        if (pVoice->activeFlag == false || pVoice->generation != generation)
+            staleFlag = true;
+        else
+            pVoice->pChannel = pChannel;
+    }
+    // Throw the channel away if nobody wants it any more
+    if (staleFlag == true)
+    {
+        FMOD_Channel_SetCallback(pChannel, 0);
+        FMOD_Channel_Stop(pChannel);
+        return INVALID_VOICE_HANDLE;
+    }
+    // Start the voice
+    FMOD_Channel_SetPaused(pChannel, false);
+    // return the handle
+    return handle;
+}
+
+FMOD_RESULT F_CALLBACK VoicePool::channelCallback(FMOD_CHANNELCONTROL* pChannelControl, FMOD_CHANNELCONTROL_TYPE controlType, FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType, void* /*pCommandData1*/, void* /*pCommandData2*/)
+{
+    // We only care about channels ending
+    if (controlType != FMOD_CHANNELCONTROL_CHANNEL || callbackType != FMOD_CHANNELCONTROL_CALLBACK_END)
+        return FMOD_OK;
+    // Grab the Channel
+    FMOD_CHANNEL* pChannel = (FMOD_CHANNEL*)pChannelControl;
+    // Unbind it from its rolloff curve
+    if (FMODGlobals::pRolloffManager != 0)
+        FMODGlobals::pRolloffManager->unbindChannel(pChannel);
+    // Grab the Voice
+    void* pUserData = 0;
+    FMOD_Channel_GetUserData(pChannel, &pUserData);
+    Voice* pVoice = (Voice*)pUserData;
+    if (pVoice == 0)
+        return FMOD_OK;
+    // Grab the Pool
+    VoicePool* pVoicePool = pVoice->pVoicePool;
+    // Lock the Pool
+    std::lock_guard<std::mutex> lock(pVoicePool->mutex);
+    // Only recycle the slot if it still belongs to this channel
+    if (pVoice->activeFlag == true && pVoice->pChannel == pChannel)
+        pVoicePool->releaseVoice(pVoice);
+    // Done
+    return FMOD_OK;
+}
@@ -0,0 +1,208 @@
+/**
+  * @file   VoicePool.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  VoicePool plays fire and forget instances of a SoundSample
+  * from a fixed set of pre-allocated voice slots
+*/
+
+#ifndef VOICEPOOL_H
+#define VOICEPOOL_H
+
+// C++ Includes
+#include <iostream>
+#include <vector>
+#include <mutex>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_codec.h>
+#include <fmod_common.h>
+#include <fmod_dsp.h>
+#include <fmod_dsp_effects.h>
+#include <fmod_errors.h>
+#include <fmod_output.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Sound/SoundSample.h"
+#include "Voice/VoiceHandle.h"
+
+/** The VoicePool owns a flat array of voice slots created up front. Each
+    call to play hands out a slot and returns a VoiceHandle, so the same
+    SoundSample can be playing many times at once without a Sound object
+    per instance and without any heap allocation per play. Slots are
+    handed back from the FMOD channel end callback (during
+    FMOD_System_Update) rather than by polling isPlaying **/
+class VoicePool
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        VoicePool();
+        //! Destructor
+        virtual ~VoicePool();
+
+    protected:
+        //! VoicePool Copy constructor
+        VoicePool(const VoicePool& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! VoicePool Assignment operator
+        VoicePool& operator=(const VoicePool& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief create
+          * Allocate the voice slots (stops and replaces any existing slots)
+          * @param numberOfVoices number of slots (1 to 65535)
+          * @return true on success false otherwise **/
+        virtual bool create(int numberOfVoices);
+        /** @brief free
+          * Stop every voice and release the slots **/
+        virtual void free();
+
+    public:
+        /** @brief play
+          * Play a SoundSample on a free voice
+          * @param pSoundSample the SoundSample to play
+          * @param pChannelGroup the channel group to play in (0 for the sound effects group)
+          * @param volume (0.0 silent 1.0 fullblast)
+          * @param pitch (0.5 half pitch, 2.0 double pitch, 1.0 default pitch)
+          * @return a handle to the voice or INVALID_VOICE_HANDLE if no voice was free **/
+        virtual VoiceHandle play(SoundSample* pSoundSample, FMOD_CHANNELGROUP* pChannelGroup = 0, float volume = 1.0f, float pitch = 1.0f);
+        /** @brief play3D
+          * Play a 3D SoundSample on a free voice at a position
+          * @param pSoundSample the SoundSample to play (created with FMOD_3D)
+          * @param x x position
+          * @param y y position
+          * @param z z position
+          * @param volume (0.0 silent 1.0 fullblast)
+          * @param pitch (0.5 half pitch, 2.0 double pitch, 1.0 default pitch)
+          * @return a handle to the voice or INVALID_VOICE_HANDLE if no voice was free **/
+        virtual VoiceHandle play3D(SoundSample* pSoundSample, float x, float y, float z, float volume = 1.0f, float pitch = 1.0f);
+        /** @brief stop
+          * @param handle the voice to stop **/
+        virtual void stop(VoiceHandle handle);
+        /** @brief stopAll
+          * Stop every voice in the pool **/
+        virtual void stopAll();
+        /** @brief isValid
+          * @param handle the voice
+          * @return true if the handle still refers to a playing voice **/
+        virtual bool isValid(VoiceHandle handle);
+        /** @brief setPaused
+          * @param handle the voice
+          * @param pausedFlag true to pause false to resume **/
+        virtual void setPaused(VoiceHandle handle, bool pausedFlag);
+        /** @brief setVolume
+          * @param handle the voice
+          * @param volume (0.0 silent 1.0 fullblast) **/
+        virtual void setVolume(VoiceHandle handle, float volume);
+        /** @brief setPitch
+          * @param handle the voice
+          * @param pitch (0.5 half pitch, 2.0 double pitch, 1.0 default pitch) **/
+        virtual void setPitch(VoiceHandle handle, float pitch);
+        /** @brief setPosition
+          * @param handle the voice
+          * @param x x position
+          * @param y y position
+          * @param z z position **/
+        virtual void setPosition(VoiceHandle handle, float x, float y, float z);
+        /** @brief setVelocity
+          * @param handle the voice
+          * @param xVelocity x velocity
+          * @param yVelocity y velocity
+          * @param zVelocity z velocity **/
+        virtual void setVelocity(VoiceHandle handle, float xVelocity, float yVelocity, float zVelocity);
+        /** @brief setPlaybackPosition
+          * @param handle the voice
+          * @param position playback position in milliseconds **/
+        virtual void setPlaybackPosition(VoiceHandle handle, unsigned int position);
+        /** @brief getPlaybackPosition
+          * @param handle the voice
+          * @param position receives the playback position in milliseconds
+          * @return false if the voice has gone **/
+        virtual bool getPlaybackPosition(VoiceHandle handle, unsigned int& position);
+        /** @brief set3DMinMaxDistance
+          * @param handle the voice
+          * @param minDistance distance the sound starts to attenuate
+          * @param maxDistance distance the sound stops attenuating **/
+        virtual void set3DMinMaxDistance(VoiceHandle handle, float minDistance, float maxDistance);
+
+    public:
+        /** @brief Get the number of voice slots
+          * @return number of slots **/
+        virtual int getNumberOfVoices() { return (int)this->voices.size(); }
+        /** @brief Get the number of voices in use
+          * @return active voices **/
+        virtual int getNumberOfActiveVoices();
+        /** @brief Get the number of plays refused because every voice was busy
+          * @return refused plays **/
+        virtual int getNumberOfRefusedPlays() { return this->refusedPlays; }
+
+    protected:
+        // A voice slot
+        struct Voice
+        {
+            // The Pool the voice belongs to (so the callback can find it)
+            VoicePool* pVoicePool;
+            // Index of the slot
+            unsigned int index;
+            // Generation of the slot
+            unsigned int generation;
+            // FMOD Channel (0 while the slot is free or being started)
+            FMOD_CHANNEL* pChannel;
+            // SoundSample playing on the voice (holds a reference so it isn't evicted)
+            SoundSample* pSoundSample;
+            // Active Flag
+            bool activeFlag;
+        };
+
+    protected:
+        /** @brief acquireVoice
+          * Take a slot off the free list and bump its generation
+          * @return the voice or 0 if the pool is empty **/
+        virtual Voice* acquireVoice();
+        /** @brief releaseVoice (lock must be held)
+          * Put a slot back on the free list
+          * @param pVoice the voice **/
+        virtual void releaseVoice(Voice* pVoice);
+        /** @brief getChannel (lock must be held)
+          * @param handle the voice
+          * @return the FMOD_CHANNEL of the voice or 0 if the handle is stale **/
+        virtual FMOD_CHANNEL* getChannel(VoiceHandle handle);
+        /** @brief startVoice
+          * Start a SoundSample paused on a voice, hook up the callback and apply settings
+          * @return the handle or INVALID_VOICE_HANDLE **/
+        virtual VoiceHandle startVoice(SoundSample* pSoundSample, FMOD_CHANNELGROUP* pChannelGroup, const FMOD_VECTOR* pPosition, float volume, float pitch);
+        /** @brief channelCallback
+          * FMOD channel callback, frees the voice when its channel ends **/
+        static FMOD_RESULT F_CALLBACK channelCallback(FMOD_CHANNELCONTROL* pChannelControl, FMOD_CHANNELCONTROL_TYPE controlType, FMOD_CHANNELCONTROL_CALLBACK_TYPE callbackType, void* pCommandData1, void* pCommandData2);
+
+    protected:
+        /* NOTE: voices never grows after create so the Voice pointers stored
+            as FMOD user data stay valid. FMOD calls must never be made
+            while holding the mutex, stopping or stealing a channel fires
+            the callback which takes the mutex itself */
+        // Voice Slots
+        std::vector<Voice> voices;
+        // Indices of the free Voice Slots (used as a stack)
+        std::vector<unsigned int> freeVoices;
+        // Guards voices and freeVoices
+        std::mutex mutex;
+        // Plays refused because every voice was busy
+        int refusedPlays;
+};
+
+#endif // VOICEPOOL_H
@@ -0,0 +1,79 @@
+/**
+  * @file   AssetId.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  AssetId is a 64 bit case folded hash of an asset path
+*/
+
+#ifndef ASSETID_H
+#define ASSETID_H
+
+// C++ Includes
+#include <string>
+
+/** An AssetId is the 64 bit FNV-1a hash of an asset path with the letters
+    folded to upper case and '\' treated as '/', so "Media/Sounds/A.ogg" and
+    "media\sounds\a.ogg" are the same asset (the AudioManager has always
+    upper cased its keys). AssetIds::make is constexpr so the id of a literal
+    path can be worked out at compile time:
+
+        const AssetId EXPLOSION = AssetIds::make("media/sounds/explosion.ogg");
+
+    0 is never handed out so it can mean "no asset" **/
+typedef unsigned long long AssetId;
+
+// The id of no asset
+const AssetId INVALID_ASSET_ID = 0;
+
+namespace AssetIds
+{
+    // FNV-1a 64 bit offset basis
+    const AssetId OFFSET_BASIS = 14695981039346656037ULL;
+    // FNV-1a 64 bit prime
+    const AssetId PRIME = 1099511628211ULL;
+
+    /** @brief Fold a character (upper case and forward slashes)
+      * @param c the character
+      * @return the folded character **/
+    constexpr unsigned char fold(char c)
+    {
+        return (c >= 'a' && c <= 'z') ? (unsigned char)(c - 'a' + 'A') : ((c == '\\') ? (unsigned char)'/' : (unsigned char)c);
+    }
+    /** @brief Hash the rest of a null terminated path (C++11 constexpr has to recurse)
+      * @param text the rest of the path
+      * @param hash the hash so far
+      * @return the hash **/
+    constexpr AssetId hash(const char* text, AssetId hash)
+    {
+        return (*text == 0) ? hash : AssetIds::hash(text + 1, (hash ^ AssetIds::fold(*text)) * PRIME);
+    }
+    /** @brief Keep 0 free for INVALID_ASSET_ID
+      * @param hash the hash
+      * @return the AssetId **/
+    constexpr AssetId finish(AssetId hash)
+    {
+        return (hash == INVALID_ASSET_ID) ? PRIME : hash;
+    }
+    /** @brief Make the AssetId of a path (at compile time for literals)
+      * @param path null terminated path
+      * @return the AssetId **/
+    constexpr AssetId make(const char* path)
+    {
+        return AssetIds::finish(AssetIds::hash(path, OFFSET_BASIS));
+    }
+    /** @brief Make the AssetId of a path at run time (a loop, no allocation)
+      * @param path the path
+      * @return the AssetId **/
+    inline AssetId make(const std::string& path)
+    {
+        // Start with the offset basis
+        AssetId hash = OFFSET_BASIS;
+        // Hash each folded character
+        for (std::string::size_type i = 0; i < path.size(); i++)
+            hash = (hash ^ AssetIds::fold(path[i])) * PRIME;
+        // Keep 0 free
+        return AssetIds::finish(hash);
+    }
+}
+
+#endif // ASSETID_H
@@ -1,141 +1,1139 @@
 #include "AudioManager.h"
 
-SoundSample* AudioManager::getSoundSample(std::string filename)
+SoundSample* AudioManager::getSoundSample(const std::string& filename)
 {
     return this->getSoundSample(filename, true);
 }
 
-SoundSample* AudioManager::getSoundSample(std::string filename, bool addToMap)
+SoundSample* AudioManager::getSoundSample(const std::string& filename, bool addToMap)
+{
+    // Load a 2D SoundSample
+    return this->loadSoundSample(filename, false, addToMap);
+}
+
+SoundSample* AudioManager::getSoundSample2D(const std::string& filename)
+{
+    return this->getSoundSample3D(filename, true);
+}
+
+SoundSample* AudioManager::getSoundSample2D(const std::string& filename, bool addToMap)
+{
+    return this->getSoundSample3D(filename, addToMap);
+}
+
+SoundSample* AudioManager::getSoundSample3D(const std::string& filename)
+{
+    return this->getSoundSample3D(filename, true);
+}
+
+SoundSample* AudioManager::getSoundSample3D(const std::string& filename, bool addToMap)
+{
+    // Load a 3D SoundSample
+    return this->loadSoundSample(filename, true, addToMap);
+}
+
+SoundSample* AudioManager::loadSoundSample(const std::string& filename, bool threeDFlag, bool addToMap)
 {
     // Validate Filename
     if (filename.size() == 0)
         return 0;
+    // Hash the filename (case folded, so no upper case copy is needed to look it up)
+    AssetId id = AssetIds::make(filename);
+    // Pick the index
+    SoundSampleIndex* pIndex = (threeDFlag == true) ? &(this->soundSample3DIndex) : &(this->soundSampleIndex);
+    // Try and find existing SoundSample (streams are never in the index)
+    SoundSample* pExistingSoundSample = this->findSoundSample(pIndex, id);
+    if (pExistingSoundSample != 0)
+        return pExistingSoundSample;
     // uppercase the filename
-    filename = this->toUpperCase(filename);
+    std::string uppercaseFilename = this->toUpperCase(filename);
     // Send a message to the console
-    std::cout << "SoundSample* AudioManager::getSoundSample(std::string filename, bool addToMap)" << std::endl;
-    // Try and find existing SoundSample
-    std::map<std::string, SoundSample*>::iterator i = this->soundSampleMap.find(filename);
-    if (i != this->soundSampleMap.end())
+    std::cout << "SoundSample* AudioManager::loadSoundSample(std::string filename, bool threeDFlag, bool addToMap)" << std::endl;
+    // Work out how it will be held
+    LOAD_POLICY policy = this->resolveLoadPolicy(uppercaseFilename, id, true);
+    // A stream nothing references any more can be handed out again
+    if (policy == LOAD_POLICY_STREAM && addToMap == true)
     {
-        //// Send a message to the console
-        //std::cout << filename.c_str() << " already loaded. Function Successful" << std::endl;
-        return i->second;
+        std::lock_guard<std::mutex> lock(this->mutex);
+        SoundSample* pIdleSoundSample = this->findIdleStreamSoundSample(id, threeDFlag);
+        if (pIdleSoundSample != 0)
+        {
+            this->touch(pIdleSoundSample);
+            return pIdleSoundSample;
+        }
     }
     // A variable to track the result of FMOD function calls
     FMOD_RESULT result;
     // Make a pointer to an FMODSound
     FMOD_SOUND* pFMODSound = 0;
     // Create an FMODSound
-    result = FMOD_System_CreateSound(FMODGlobals::pFMODSystem, filename.c_str(), FMOD_DEFAULT | FMOD_LOOP_NORMAL, 0, &pFMODSound); // FMOD_LOOP_NORMAL
+    FMOD_MODE mode = (threeDFlag == true) ? (FMOD_LOOP_NORMAL | FMOD_3D) : (FMOD_DEFAULT | FMOD_LOOP_NORMAL);
+    result = this->createFMODSound(uppercaseFilename, id, mode, policy, &pFMODSound);
     // If there were any problems
     if (result != FMOD_OK)
     {
         // Send a message to the console
-        std::cout << "ERROR: Could not sound sample: " << filename.c_str() << std::endl;
+        std::cout << "ERROR: Could not sound sample: " << uppercaseFilename.c_str() << std::endl;
         std::cout << "FMOD error! (" << FMOD_ErrorString(result) << ") " << std::endl;
         // sound effect was not loaded
         return 0;
     }
     // Send a message to the console
-    std::cout << "SoundSample: " << filename << " Loaded." << std::endl;
+    std::cout << "SoundSample: " << uppercaseFilename << " Loaded." << std::endl;
     SoundSample* pSoundSample = new SoundSample();
-    pSoundSample->setFilename(filename.c_str());
+    pSoundSample->setFilename(uppercaseFilename.c_str());
     pSoundSample->setFMODSound(pFMODSound);
     if (addToMap == true)
     {
-        this->soundSampleMap[filename] = pSoundSample;
+        std::unique_lock<std::mutex> lock(this->mutex);
+        // Another thread may have loaded (or started loading) the same file while the lock was not held
+        SoundSample* pOtherSoundSample = (policy == LOAD_POLICY_STREAM) ? 0 : pIndex->find(id);
+        if (pOtherSoundSample != 0)
+        {
+            this->touch(pOtherSoundSample);
+            lock.unlock();
+            // Throw ours away (it finished loading so releasing it doesn't block)
+            FMOD_Sound_Release(pFMODSound);
+            delete pSoundSample;
+            // Share theirs once it is ready
+            if (this->waitForSoundSample(pOtherSoundSample) == false)
+                return 0;
+            return pOtherSoundSample;
+        }
+        // A stream gets a handle of its own, everything else is shared through the index
+        if (policy == LOAD_POLICY_STREAM)
+        {
+            StreamSoundSample streamSoundSample;
+            streamSoundSample.pSoundSample = pSoundSample;
+            streamSoundSample.id = id;
+            streamSoundSample.threeDFlag = threeDFlag;
+            this->streamSoundSamples.push_back(streamSoundSample);
+        }
+        else
+        {
+            pIndex->add(id, pSoundSample);
+        }
+        // Count the memory and make room for it (never by evicting the SoundSample being handed out)
+        this->memoryUsage += pSoundSample->getMemoryUsage();
+        this->touch(pSoundSample);
+        this->evict(pSoundSample);
         // Send a message to the console
-        std::cout << "SoundSample added to sound sample map under the key: " << filename.c_str() << " " << filename << std::endl;
+        std::cout << "SoundSample added to sound sample index under the key: " << uppercaseFilename.c_str() << " " << id << std::endl;
     }
     // sound effect was successfully loaded
     return pSoundSample;
 }
 
-SoundSample* AudioManager::getSoundSample2D(std::string filename)
+SoundSample* AudioManager::getSoundSample(AssetId id)
 {
-    return this->getSoundSample3D(filename, true);
+    // Find the SoundSample
+    return this->findSoundSample(&(this->soundSampleIndex), id);
 }
 
-SoundSample* AudioManager::getSoundSample2D(std::string filename, bool addToMap)
+SoundSample* AudioManager::getSoundSample3D(AssetId id)
 {
-    return this->getSoundSample3D(filename, addToMap);
+    // Find the SoundSample
+    return this->findSoundSample(&(this->soundSample3DIndex), id);
 }
 
-SoundSample* AudioManager::getSoundSample3D(std::string filename)
+SoundSample* AudioManager::findSoundSample(SoundSampleIndex* pIndex, AssetId id)
 {
-    return this->getSoundSample3D(filename, true);
+    // Try and find existing SoundSample
+    SoundSample* pExistingSoundSample = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        pExistingSoundSample = pIndex->find(id);
+        if (pExistingSoundSample != 0)
+            this->touch(pExistingSoundSample);
+    }
+    // Not loaded
+    if (pExistingSoundSample == 0)
+        return 0;
+    // It may still be loading asynchronously, callers of this function expect it ready
+    if (this->waitForSoundSample(pExistingSoundSample) == false)
+        return 0;
+    // return the SoundSample
+    return pExistingSoundSample;
+}
+
+void AudioManager::destroySoundSample(SoundSample* pSoundSample)
+{
+    // Validate the SoundSample
+    if (pSoundSample == 0)
+        return;
+    {
+        // Lock the AudioManager
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // Something is still using it
+        if (pSoundSample->getReferenceCount() > 0)
+        {
+            std::cout << "void AudioManager::destroySoundSample() failure. " << pSoundSample->getFilename() << " is still referenced" << std::endl;
+            return;
+        }
+        // Still loading (the pending load would finish into freed memory)
+        if (this->findPendingLoad(pSoundSample) != -1)
+        {
+            std::cout << "void AudioManager::destroySoundSample() failure. " << pSoundSample->getFilename() << " is still loading" << std::endl;
+            return;
+        }
+        // Take it out of the index (evict and clear would find it again) and its memory off the total
+        if (this->forgetSoundSample(pSoundSample) == true)
+        {
+            unsigned int sizeInBytes = pSoundSample->getMemoryUsage();
+            this->memoryUsage = (sizeInBytes < this->memoryUsage) ? this->memoryUsage - sizeInBytes : 0;
+        }
+    }
+    // Release it
+    FMOD_Sound_Release(pSoundSample->getFMODSound());
+    delete pSoundSample;
+}
+
+void AudioManager::clear()
+{
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Forget the Pending Loads (releasing a sound still loading waits for FMOD to finish it)
+    for (unsigned int i = 0; i < this->pendingLoads.size(); i++)
+    {
+        // Throw away loads which lost a race, nobody has them
+        if (this->pendingLoads[i].discardFlag == true)
+        {
+            FMOD_Sound_Release(this->pendingLoads[i].pSoundSample->getFMODSound());
+            delete this->pendingLoads[i].pSoundSample;
+        }
+    }
+    this->pendingLoads.clear();
+    // Delete the SoundSamples which failed to load (a Sound still holding one keeps it until the next clear)
+    std::vector<SoundSample*> referencedSoundSamples;
+    for (unsigned int i = 0; i < this->failedSoundSamples.size(); i++)
+    {
+        if (this->failedSoundSamples[i]->getReferenceCount() > 0)
+            referencedSoundSamples.push_back(this->failedSoundSamples[i]);
+        else
+            delete this->failedSoundSamples[i];
+    }
+    this->failedSoundSamples.swap(referencedSoundSamples);
+    // Release the Sound Samples nothing references (a Sound still holding one would write to freed memory)
+    this->clearIndex(&(this->soundSampleIndex));
+    this->clearIndex(&(this->soundSample3DIndex));
+    // Release the streams nothing references
+    for (unsigned int i = 0; i < this->streamSoundSamples.size();)
+    {
+        // Grab the SoundSample
+        SoundSample* pSoundSample = this->streamSoundSamples[i].pSoundSample;
+        // Still referenced so it stays
+        if (pSoundSample->getReferenceCount() > 0)
+        {
+            std::cout << "void AudioManager::clear() " << pSoundSample->getFilename() << " is still referenced and was kept" << std::endl;
+            i++;
+            continue;
+        }
+        // Release it
+        this->streamSoundSamples.erase(this->streamSoundSamples.begin() + i);
+        FMOD_Sound_Release(pSoundSample->getFMODSound());
+        delete pSoundSample;
+    }
+    // Unload the Banks no SoundSample which is left came from
+    for (unsigned int i = 0; i < this->banks.size();)
+    {
+        // Keep it
+        if (this->isBankInUse(this->banks[i], false) == true)
+        {
+            i++;
+            continue;
+        }
+        // Unload it
+        delete this->banks[i];
+        this->banks.erase(this->banks.begin() + i);
+    }
+    // Forget what LOAD_POLICY_AUTO picked (the files may have changed)
+    this->autoLoadPolicies.clear();
+    // Count what is left
+    this->memoryUsage = 0;
+    SoundSampleIndex* pIndices[2] = { &(this->soundSampleIndex), &(this->soundSample3DIndex) };
+    for (int m = 0; m < 2; m++)
+    {
+        for (unsigned int i = 0; i < pIndices[m]->getCapacity(); i++)
+        {
+            if (pIndices[m]->getSoundSample(i) != 0)
+                this->memoryUsage += pIndices[m]->getSoundSample(i)->getMemoryUsage();
+        }
+    }
+    for (unsigned int i = 0; i < this->streamSoundSamples.size(); i++)
+        this->memoryUsage += this->streamSoundSamples[i].pSoundSample->getMemoryUsage();
+}
+
+void AudioManager::clearIndex(SoundSampleIndex* pIndex)
+{
+    // Check each slot
+    for (unsigned int i = 0; i < pIndex->getCapacity(); i++)
+    {
+        // Grab the SoundSample
+        SoundSample* pSoundSample = pIndex->getSoundSample(i);
+        if (pSoundSample == 0)
+            continue;
+        // Still referenced so it stays (removing leaves a tombstone so the walk is safe)
+        if (pSoundSample->getReferenceCount() > 0)
+        {
+            std::cout << "void AudioManager::clear() " << pSoundSample->getFilename() << " is still referenced and was kept" << std::endl;
+            continue;
+        }
+        // Release it
+        pIndex->remove(pIndex->getKey(i));
+        FMOD_Sound_Release(pSoundSample->getFMODSound());
+        delete pSoundSample;
+    }
+}
+
+SoundSample* AudioManager::findIdleStreamSoundSample(AssetId id, bool threeDFlag)
+{
+    // Look for a stream of this path nothing references or is still loading
+    for (unsigned int i = 0; i < this->streamSoundSamples.size(); i++)
+    {
+        // Grab the stream
+        StreamSoundSample& streamSoundSample = this->streamSoundSamples[i];
+        if (streamSoundSample.id != id || streamSoundSample.threeDFlag != threeDFlag)
+            continue;
+        // Idle
+        if (streamSoundSample.pSoundSample->getReferenceCount() == 0 && this->findPendingLoad(streamSoundSample.pSoundSample) == -1)
+            return streamSoundSample.pSoundSample;
+    }
+    // None idle
+    return 0;
+}
+
+bool AudioManager::forgetSoundSample(SoundSample* pSoundSample)
+{
+    // A stream
+    for (unsigned int i = 0; i < this->streamSoundSamples.size(); i++)
+    {
+        if (this->streamSoundSamples[i].pSoundSample == pSoundSample)
+        {
+            this->streamSoundSamples.erase(this->streamSoundSamples.begin() + i);
+            return true;
+        }
+    }
+    // In an index (the filename is the path upper cased so it hashes to the same AssetId)
+    AssetId id = AssetIds::make(pSoundSample->getFilename());
+    if (this->soundSampleIndex.find(id) == pSoundSample)
+        this->soundSampleIndex.remove(id);
+    else if (this->soundSample3DIndex.find(id) == pSoundSample)
+        this->soundSample3DIndex.remove(id);
+    else
+        return false;
+    // Forgotten
+    return true;
+}
+
+SoundSample* AudioManager::acquireSoundSample(const std::string& filename)
+{
+    // Get the SoundSample
+    SoundSample* pSoundSample = this->getSoundSample(filename, true);
+    // Hold a reference
+    if (pSoundSample != 0)
+        pSoundSample->addReference();
+    // return the SoundSample
+    return pSoundSample;
+}
+
+SoundSample* AudioManager::acquireSoundSample3D(const std::string& filename)
+{
+    // Get the SoundSample
+    SoundSample* pSoundSample = this->getSoundSample3D(filename, true);
+    // Hold a reference
+    if (pSoundSample != 0)
+        pSoundSample->addReference();
+    // return the SoundSample
+    return pSoundSample;
 }
 
-SoundSample* AudioManager::getSoundSample3D(std::string filename, bool addToMap)
+void AudioManager::releaseSoundSample(SoundSample* pSoundSample)
+{
+    // Validate the SoundSample
+    if (pSoundSample == 0)
+        return;
+    // Drop the reference
+    pSoundSample->removeReference();
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // The SoundSample may now be evictable
+    this->evict();
+}
+
+void AudioManager::pinSoundSample(SoundSample* pSoundSample, bool pinnedFlag)
+{
+    // Validate the SoundSample
+    if (pSoundSample == 0)
+        return;
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Set the pinned flag
+    pSoundSample->setPinned(pinnedFlag);
+    // An unpinned SoundSample may now be evictable
+    if (pinnedFlag == false)
+        this->evict();
+}
+
+void AudioManager::setMemoryBudget(unsigned int memoryBudget)
+{
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Set Memory Budget
+    this->memoryBudget = memoryBudget;
+    // Get inside the new budget
+    this->evict();
+}
+
+unsigned int AudioManager::getMemoryUsage()
+{
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return memoryUsage
+    return this->memoryUsage;
+}
+
+void AudioManager::evict(SoundSample* pKeepSoundSample)
+{
+    // No budget or inside it
+    if (this->memoryBudget == 0 || this->memoryUsage <= this->memoryBudget)
+        return;
+    // Gather every SoundSample (the indices and the streams)
+    std::vector<SoundSample*> soundSamples;
+    SoundSampleIndex* pIndices[2] = { &(this->soundSampleIndex), &(this->soundSample3DIndex) };
+    for (int m = 0; m < 2; m++)
+    {
+        for (unsigned int i = 0; i < pIndices[m]->getCapacity(); i++)
+        {
+            if (pIndices[m]->getSoundSample(i) != 0)
+                soundSamples.push_back(pIndices[m]->getSoundSample(i));
+        }
+    }
+    for (unsigned int i = 0; i < this->streamSoundSamples.size(); i++)
+        soundSamples.push_back(this->streamSoundSamples[i].pSoundSample);
+    // Keep the ones which are allowed to go
+    std::vector< std::pair<unsigned long long, SoundSample*> > candidates;
+    for (unsigned int i = 0; i < soundSamples.size(); i++)
+    {
+        // Grab the SoundSample
+        SoundSample* pSoundSample = soundSamples[i];
+        // Pinned, in use, still loading or about to be handed out SoundSamples stay
+        if (pSoundSample == pKeepSoundSample || pSoundSample->isPinned() == true || pSoundSample->getReferenceCount() > 0 || this->findPendingLoad(pSoundSample) != -1)
+            continue;
+        // Candidate
+        candidates.push_back(std::make_pair(pSoundSample->getLastUsed(), pSoundSample));
+    }
+    // Least recently used first
+    std::sort(candidates.begin(), candidates.end());
+    // Release until we are inside the budget
+    for (unsigned int i = 0; i < candidates.size() && this->memoryUsage > this->memoryBudget; i++)
+    {
+        // Grab the SoundSample
+        SoundSample* pSoundSample = candidates[i].second;
+        // Take its memory off the total
+        unsigned int sizeInBytes = pSoundSample->getMemoryUsage();
+        this->memoryUsage = (sizeInBytes < this->memoryUsage) ? this->memoryUsage - sizeInBytes : 0;
+        // Send a message to the console
+        std::cout << "SoundSample: " << pSoundSample->getFilename() << " Evicted." << std::endl;
+        // Release it
+        this->forgetSoundSample(pSoundSample);
+        FMOD_Sound_Release(pSoundSample->getFMODSound());
+        delete pSoundSample;
+    }
+}
+
+bool AudioManager::loadBank(const std::string& filename)
 {
     // Validate Filename
     if (filename.size() == 0)
-        return 0;
-    // uppercase the filename
-    filename = this->toUpperCase(filename);
-    // Try and find existing SoundSample
-    std::map<std::string, SoundSample*>::iterator i = this->soundSample3DMap.find(filename);
-    if (i != this->soundSample3DMap.end())
+        return false;
+    // Already loaded
+    for (unsigned int i = 0; i < this->banks.size(); i++)
+    {
+        if (this->banks[i]->getFilename() == filename)
+            return true;
+    }
+    // Map the bank
+    BankLoader* pBankLoader = new BankLoader();
+    if (pBankLoader->load(filename) == false)
+    {
+        delete pBankLoader;
+        return false;
+    }
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Add it to the banks
+    this->banks.push_back(pBankLoader);
+    // Success
+    return true;
+}
+
+bool AudioManager::unloadBank(const std::string& filename)
+{
+    // Find the bank
+    for (unsigned int i = 0; i < this->banks.size(); i++)
+    {
+        // Grab the bank
+        BankLoader* pBankLoader = this->banks[i];
+        if (pBankLoader->getFilename() != filename)
+            continue;
+        // Lock the AudioManager
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // Everything from the bank has to be unused (or still loading, it may be reading the mapping)
+        if (this->isBankInUse(pBankLoader, true) == true)
+        {
+            std::cout << "bool AudioManager::unloadBank() failure. " << filename << " is still in use" << std::endl;
+            return false;
+        }
+        // Release the SoundSamples from the bank
+        this->releaseBankSoundSamples(pBankLoader, &(this->soundSampleIndex));
+        this->releaseBankSoundSamples(pBankLoader, &(this->soundSample3DIndex));
+        for (unsigned int j = 0; j < this->streamSoundSamples.size();)
+        {
+            // Grab the stream
+            StreamSoundSample streamSoundSample = this->streamSoundSamples[j];
+            if (pBankLoader->findEntry(streamSoundSample.id) == 0)
+            {
+                j++;
+                continue;
+            }
+            // Take its memory off the total
+            unsigned int sizeInBytes = streamSoundSample.pSoundSample->getMemoryUsage();
+            this->memoryUsage = (sizeInBytes < this->memoryUsage) ? this->memoryUsage - sizeInBytes : 0;
+            // Release it
+            this->streamSoundSamples.erase(this->streamSoundSamples.begin() + j);
+            FMOD_Sound_Release(streamSoundSample.pSoundSample->getFMODSound());
+            delete streamSoundSample.pSoundSample;
+        }
+        // Unload the bank
+        this->banks.erase(this->banks.begin() + i);
+        delete pBankLoader;
+        // Success
+        return true;
+    }
+    // Not loaded
+    std::cout << "bool AudioManager::unloadBank() failure. " << filename << " is not loaded" << std::endl;
+    return false;
+}
+
+bool AudioManager::isBankInUse(BankLoader* pBankLoader, bool referencedOnlyFlag)
+{
+    // Check the indices
+    SoundSampleIndex* pIndices[2] = { &(this->soundSampleIndex), &(this->soundSample3DIndex) };
+    for (int m = 0; m < 2; m++)
+    {
+        for (unsigned int i = 0; i < pIndices[m]->getCapacity(); i++)
+        {
+            // Grab the SoundSample
+            SoundSample* pSoundSample = pIndices[m]->getSoundSample(i);
+            if (pSoundSample == 0 || pBankLoader->findEntry(pIndices[m]->getKey(i)) == 0)
+                continue;
+            // In use
+            if (referencedOnlyFlag == false || pSoundSample->getReferenceCount() > 0 || this->findPendingLoad(pSoundSample) != -1)
+                return true;
+        }
+    }
+    // Check the streams
+    for (unsigned int i = 0; i < this->streamSoundSamples.size(); i++)
+    {
+        // Grab the SoundSample
+        SoundSample* pSoundSample = this->streamSoundSamples[i].pSoundSample;
+        if (pBankLoader->findEntry(this->streamSoundSamples[i].id) == 0)
+            continue;
+        // In use
+        if (referencedOnlyFlag == false || pSoundSample->getReferenceCount() > 0 || this->findPendingLoad(pSoundSample) != -1)
+            return true;
+    }
+    // Unused
+    return false;
+}
+
+const SoundBankEntry* AudioManager::findBankEntry(AssetId id, BankLoader** ppBankLoader)
+{
+    // Look in the banks (newest first so a patch bank overrides)
+    for (int i = (int)this->banks.size() - 1; i >= 0; i--)
+    {
+        const SoundBankEntry* pEntry = this->banks[i]->findEntry(id);
+        if (pEntry != 0)
+        {
+            *ppBankLoader = this->banks[i];
+            return pEntry;
+        }
+    }
+    // No bank has it
+    *ppBankLoader = 0;
+    return 0;
+}
+
+FMOD_RESULT AudioManager::createFMODSound(const std::string& filename, AssetId id, FMOD_MODE mode, LOAD_POLICY policy, FMOD_SOUND** ppFMODSound)
+{
+    // Look in the banks
+    BankLoader* pBankLoader = 0;
+    const SoundBankEntry* pEntry = this->findBankEntry(id, &pBankLoader);
+    // Apply the Load Policy
+    if (policy == LOAD_POLICY_COMPRESSED)
+        mode |= FMOD_CREATECOMPRESSEDSAMPLE;
+    else if (policy == LOAD_POLICY_STREAM)
+        mode |= FMOD_CREATESTREAM;
+    // Create from the bank
+    if (pEntry != 0)
+        return pBankLoader->createFMODSound(pEntry, mode, ppFMODSound);
+    // Open the file (a stream is tagged so its async reads are refilled ahead of loads)
+    FMOD_CREATESOUNDEXINFO exinfo;
+    AudioFileSystem::getStreamExInfo(exinfo);
+    return FMOD_System_CreateSound(FMODGlobals::pFMODSystem, filename.c_str(), mode, ((mode & FMOD_CREATESTREAM) != 0) ? &exinfo : 0, ppFMODSound);
+}
+
+LOAD_POLICY AudioManager::resolveLoadPolicy(const std::string& filename, AssetId id, bool probeFlag)
+{
+    // Pick the Load Policy
+    LOAD_POLICY policy = this->getLoadPolicy(filename);
+    if (policy != LOAD_POLICY_AUTO)
+        return policy;
+    // The bank already knows the type and length
+    BankLoader* pBankLoader = 0;
+    const SoundBankEntry* pEntry = this->findBankEntry(id, &pBankLoader);
+    if (pEntry != 0)
+        return this->chooseLoadPolicy((FMOD_SOUND_TYPE)pEntry->soundType, pEntry->lengthInMilliseconds);
+    // A file probed before
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        std::map<AssetId, LOAD_POLICY>::iterator i = this->autoLoadPolicies.find(id);
+        if (i != this->autoLoadPolicies.end())
+            return i->second;
+    }
+    // Leave it to the caller to find out
+    if (probeFlag == false)
+        return LOAD_POLICY_AUTO;
+    // Probe the file
+    FMOD_SOUND_TYPE soundType = FMOD_SOUND_TYPE_UNKNOWN;
+    unsigned int lengthInMilliseconds = 0;
+    this->probeSound(filename, &soundType, &lengthInMilliseconds);
+    policy = this->chooseLoadPolicy(soundType, lengthInMilliseconds);
+    // Remember it
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->autoLoadPolicies[id] = policy;
+    // return the policy
+    return policy;
+}
+
+void AudioManager::setLoadPolicy(const std::string& pathPrefix, LOAD_POLICY policy)
+{
+    // Fold the prefix the same way as AssetIds
+    std::string foldedPathPrefix = pathPrefix;
+    for (unsigned int i = 0; i < foldedPathPrefix.size(); i++)
+        foldedPathPrefix[i] = (char)AssetIds::fold(foldedPathPrefix[i]);
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Replace an existing category
+    for (unsigned int i = 0; i < this->loadPolicyRules.size(); i++)
+    {
+        if (this->loadPolicyRules[i].pathPrefix == foldedPathPrefix)
+        {
+            this->loadPolicyRules[i].policy = policy;
+            return;
+        }
+    }
+    // Add the category
+    LoadPolicyRule loadPolicyRule;
+    loadPolicyRule.pathPrefix = foldedPathPrefix;
+    loadPolicyRule.policy = policy;
+    this->loadPolicyRules.push_back(loadPolicyRule);
+}
+
+void AudioManager::removeLoadPolicy(const std::string& pathPrefix)
+{
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the category
+    for (unsigned int i = 0; i < this->loadPolicyRules.size(); i++)
+    {
+        // Compare folded
+        const std::string& rulePathPrefix = this->loadPolicyRules[i].pathPrefix;
+        if (rulePathPrefix.size() != pathPrefix.size())
+            continue;
+        unsigned int j = 0;
+        while (j < pathPrefix.size() && (char)AssetIds::fold(pathPrefix[j]) == rulePathPrefix[j])
+            j++;
+        // Remove it
+        if (j == pathPrefix.size())
+        {
+            this->loadPolicyRules.erase(this->loadPolicyRules.begin() + i);
+            return;
+        }
+    }
+}
+
+LOAD_POLICY AudioManager::getLoadPolicy(const std::string& filename)
+{
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the category
+    int rule = this->findLoadPolicyRule(filename);
+    // return its policy
+    return (rule != -1) ? this->loadPolicyRules[rule].policy : this->defaultLoadPolicy;
+}
+
+void AudioManager::setAutoLoadPolicyThresholds(unsigned int compressAboveMilliseconds, unsigned int streamAboveMilliseconds)
+{
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Set Compress Above Milliseconds
+    this->compressAboveMilliseconds = compressAboveMilliseconds;
+    // Set Stream Above Milliseconds
+    this->streamAboveMilliseconds = streamAboveMilliseconds;
+    // What LOAD_POLICY_AUTO picked before may now be different
+    this->autoLoadPolicies.clear();
+}
+
+std::vector<LoadPolicyReport> AudioManager::getLoadPolicyReport()
+{
+    // Lock the AudioManager (the categories can change on another thread)
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // One report per category and one for everything else
+    std::vector<LoadPolicyReport> reports(this->loadPolicyRules.size() + 1);
+    for (unsigned int i = 0; i < reports.size(); i++)
+    {
+        LoadPolicyReport& report = reports[i];
+        report.category = (i < this->loadPolicyRules.size()) ? this->loadPolicyRules[i].pathPrefix : std::string();
+        report.policy = (i < this->loadPolicyRules.size()) ? this->loadPolicyRules[i].policy : this->defaultLoadPolicy;
+        report.numberOfSoundSamples = 0;
+        report.numberOfDecompressed = 0;
+        report.numberOfCompressed = 0;
+        report.numberOfStreamed = 0;
+        report.decodedBytes = 0;
+        report.residentBytes = 0;
+    }
+    // Gather every SoundSample (the indices and the streams)
+    std::vector<SoundSample*> soundSamples;
+    SoundSampleIndex* pIndices[2] = { &(this->soundSampleIndex), &(this->soundSample3DIndex) };
+    for (int m = 0; m < 2; m++)
+    {
+        for (unsigned int i = 0; i < pIndices[m]->getCapacity(); i++)
+        {
+            if (pIndices[m]->getSoundSample(i) != 0)
+                soundSamples.push_back(pIndices[m]->getSoundSample(i));
+        }
+    }
+    for (unsigned int i = 0; i < this->streamSoundSamples.size(); i++)
+        soundSamples.push_back(this->streamSoundSamples[i].pSoundSample);
+    // Add up the SoundSamples
+    for (unsigned int i = 0; i < soundSamples.size(); i++)
+    {
+        // Grab the SoundSample (skipping ones still loading)
+        SoundSample* pSoundSample = soundSamples[i];
+        if (this->findPendingLoad(pSoundSample) != -1)
+            continue;
+        // Find its category
+        int rule = this->findLoadPolicyRule(pSoundSample->getFilename());
+        LoadPolicyReport& report = reports[(rule != -1) ? rule : reports.size() - 1];
+        // How is it held
+        FMOD_MODE mode = pSoundSample->getMode();
+        if ((mode & FMOD_CREATESTREAM) != 0)
+            report.numberOfStreamed++;
+        else if ((mode & FMOD_CREATECOMPRESSEDSAMPLE) != 0)
+            report.numberOfCompressed++;
+        else
+            report.numberOfDecompressed++;
+        report.numberOfSoundSamples++;
+        // Add up the bytes
+        unsigned int decodedBytes = 0;
+        FMOD_Sound_GetLength(pSoundSample->getFMODSound(), &decodedBytes, FMOD_TIMEUNIT_PCMBYTES);
+        report.decodedBytes += decodedBytes;
+        report.residentBytes += pSoundSample->getMemoryUsage();
+    }
+    // return the reports
+    return reports;
+}
+
+void AudioManager::printLoadPolicyReport()
+{
+    // Names of the policies
+    const char* policyNames[] = { "AUTO", "DECOMPRESS", "COMPRESSED", "STREAM" };
+    // Grab the report
+    std::vector<LoadPolicyReport> reports = this->getLoadPolicyReport();
+    // Send it to the console
+    std::cout << "AudioManager Load Policy Report" << std::endl;
+    for (unsigned int i = 0; i < reports.size(); i++)
+    {
+        LoadPolicyReport& report = reports[i];
+        std::cout << "  " << ((report.category.empty() == true) ? "(default)" : report.category.c_str()) << " [" << policyNames[report.policy] << "] ";
+        std::cout << report.numberOfSoundSamples << " samples (" << report.numberOfDecompressed << " decompressed, " << report.numberOfCompressed << " compressed, " << report.numberOfStreamed << " streamed) ";
+        std::cout << report.residentBytes << " bytes resident, " << report.decodedBytes << " bytes decoded" << std::endl;
+    }
+}
+
+int AudioManager::findLoadPolicyRule(const std::string& filename)
+{
+    // Longest matching prefix
+    int bestRule = -1;
+    unsigned int bestLength = 0;
+    for (unsigned int i = 0; i < this->loadPolicyRules.size(); i++)
+    {
+        // Grab the prefix
+        const std::string& pathPrefix = this->loadPolicyRules[i].pathPrefix;
+        if (pathPrefix.size() > filename.size() || (bestRule != -1 && pathPrefix.size() <= bestLength))
+            continue;
+        // Compare folded
+        unsigned int j = 0;
+        while (j < pathPrefix.size() && (char)AssetIds::fold(filename[j]) == pathPrefix[j])
+            j++;
+        // Matches
+        if (j == pathPrefix.size())
+        {
+            bestRule = (int)i;
+            bestLength = (unsigned int)pathPrefix.size();
+        }
+    }
+    // return the category
+    return bestRule;
+}
+
+LOAD_POLICY AudioManager::chooseLoadPolicy(FMOD_SOUND_TYPE soundType, unsigned int lengthInMilliseconds)
+{
+    // Long sounds (music, ambience) are streamed
+    if (lengthInMilliseconds >= this->streamAboveMilliseconds)
+        return LOAD_POLICY_STREAM;
+    // Medium sounds stay compressed if FMOD can decode them while playing
+    bool compressibleFlag = (soundType == FMOD_SOUND_TYPE_MPEG || soundType == FMOD_SOUND_TYPE_FSB);
+    if (compressibleFlag == true && lengthInMilliseconds >= this->compressAboveMilliseconds)
+        return LOAD_POLICY_COMPRESSED;
+    // Short sounds are cheapest to play as PCM
+    return LOAD_POLICY_DECOMPRESS;
+}
+
+bool AudioManager::probeSound(const std::string& filename, FMOD_SOUND_TYPE* pSoundType, unsigned int* pLengthInMilliseconds)
+{
+    // Open the file without decoding it
+    FMOD_SOUND* pFMODSound = 0;
+    if (FMOD_System_CreateSound(FMODGlobals::pFMODSystem, filename.c_str(), FMOD_OPENONLY, 0, &pFMODSound) != FMOD_OK)
+        return false;
+    // Read the type and length
+    FMOD_Sound_GetFormat(pFMODSound, pSoundType, 0, 0, 0);
+    FMOD_Sound_GetLength(pFMODSound, pLengthInMilliseconds, FMOD_TIMEUNIT_MS);
+    // Done with it
+    FMOD_Sound_Release(pFMODSound);
+    // Success
+    return true;
+}
+
+void AudioManager::releaseBankSoundSamples(BankLoader* pBankLoader, SoundSampleIndex* pIndex)
+{
+    // Check each slot
+    for (unsigned int i = 0; i < pIndex->getCapacity(); i++)
     {
-        //// Send a message to the console
-        //std::cout << filename.c_str() << " already loaded. Function Successful" << std::endl;
-        return i->second;
+        // Grab the SoundSample
+        SoundSample* pSoundSample = pIndex->getSoundSample(i);
+        if (pSoundSample == 0)
+            continue;
+        // Not from this bank
+        AssetId id = pIndex->getKey(i);
+        if (pBankLoader->findEntry(id) == 0)
+            continue;
+        // Take its memory off the total
+        unsigned int sizeInBytes = pSoundSample->getMemoryUsage();
+        this->memoryUsage = (sizeInBytes < this->memoryUsage) ? this->memoryUsage - sizeInBytes : 0;
+        // Release it
+        pIndex->remove(id);
+        FMOD_Sound_Release(pSoundSample->getFMODSound());
+        delete pSoundSample;
     }
+}
+
+SoundSample* AudioManager::loadSoundSampleAsync(const std::string& filename, SOUNDSAMPLE_LOADED_CALLBACK pCallBack, void* pUserData)
+{
+    // Load a 2D SoundSample
+    return this->loadSoundSampleAsync(filename, false, pCallBack, pUserData);
+}
+
+SoundSample* AudioManager::loadSoundSample3DAsync(const std::string& filename, SOUNDSAMPLE_LOADED_CALLBACK pCallBack, void* pUserData)
+{
+    // Load a 3D SoundSample
+    return this->loadSoundSampleAsync(filename, true, pCallBack, pUserData);
+}
+
+SoundSample* AudioManager::loadSoundSampleAsync(const std::string& filename, bool threeDFlag, SOUNDSAMPLE_LOADED_CALLBACK pCallBack, void* pUserData)
+{
+    // Validate Filename
+    if (filename.size() == 0)
+        return 0;
+    // Hash the filename
+    AssetId id = AssetIds::make(filename);
+    // Pick the index
+    SoundSampleIndex* pIndex = (threeDFlag == true) ? &(this->soundSample3DIndex) : &(this->soundSampleIndex);
+    // uppercase the filename
+    std::string uppercaseFilename = this->toUpperCase(filename);
+    // Work out how it will be held without opening the file (LOAD_POLICY_AUTO on a file not seen before is probed by the load itself)
+    LOAD_POLICY policy = this->resolveLoadPolicy(uppercaseFilename, id, false);
+    // Lock the AudioManager
+    std::unique_lock<std::mutex> lock(this->mutex);
+    // Try and find existing SoundSample (a stream nothing references any more can be handed out again)
+    SoundSample* pExistingSoundSample = (policy == LOAD_POLICY_STREAM) ? this->findIdleStreamSoundSample(id, threeDFlag) : pIndex->find(id);
+    if (pExistingSoundSample != 0)
+        return this->joinLoad(pExistingSoundSample, pCallBack, pUserData, lock);
+    // Start the load without holding the lock (the bank, the file system and FMOD's loading thread are all involved)
+    lock.unlock();
     // A variable to track the result of FMOD function calls
     FMOD_RESULT result;
     // Make a pointer to an FMODSound
     FMOD_SOUND* pFMODSound = 0;
-    // Create an FMODSound
-    result = FMOD_System_CreateSound(FMODGlobals::pFMODSystem, filename.c_str(), FMOD_LOOP_NORMAL | FMOD_3D, 0, &pFMODSound);
-    //// handle any problems loading this file
+    // Start loading the FMODSound (returns straight away). A probe opens it as a stream, which reads no more than the header
+    FMOD_MODE mode = (threeDFlag == true) ? (FMOD_LOOP_NORMAL | FMOD_3D) : (FMOD_DEFAULT | FMOD_LOOP_NORMAL);
+    result = this->createFMODSound(uppercaseFilename, id, mode | FMOD_NONBLOCKING, (policy == LOAD_POLICY_AUTO) ? LOAD_POLICY_STREAM : policy, &pFMODSound);
+    // If there were any problems
     if (result != FMOD_OK)
     {
         // Send a message to the console
-        std::cout << "ERROR: Could not sound sample: " << filename.c_str() << std::endl;
+        std::cout << "ERROR: Could not start loading sound sample: " << uppercaseFilename.c_str() << std::endl;
         std::cout << "FMOD error! (" << FMOD_ErrorString(result) << ") " << std::endl;
         // sound effect was not loaded
         return 0;
     }
-    // Send a message to the console
-    std::cout << "SoundSample: " << filename << " Loaded." << std::endl;
+    // Create the SoundSample
     SoundSample* pSoundSample = new SoundSample();
-    pSoundSample->setFilename(filename.c_str());
+    pSoundSample->setFilename(uppercaseFilename.c_str());
     pSoundSample->setFMODSound(pFMODSound);
-    if (addToMap == true)
+    // Lock the AudioManager again
+    lock.lock();
+    // Another thread may have started the same load while the lock was not held
+    pExistingSoundSample = (policy == LOAD_POLICY_STREAM) ? 0 : pIndex->find(id);
+    if (pExistingSoundSample != 0)
     {
-        this->soundSample3DMap[filename] = pSoundSample;
-        // Send a message to the console
-        std::cout << "SoundSample3D added to sound sample map under the key: " << filename.c_str() << " " << filename << std::endl;
+        // Let ours finish and throw it away in update (releasing a sound still loading would block)
+        PendingLoad discardedLoad;
+        discardedLoad.pSoundSample = pSoundSample;
+        discardedLoad.pIndex = 0;
+        discardedLoad.id = id;
+        discardedLoad.mode = mode;
+        discardedLoad.probeFlag = false;
+        discardedLoad.discardFlag = true;
+        this->pendingLoads.push_back(discardedLoad);
+        // Share the other load
+        return this->joinLoad(pExistingSoundSample, pCallBack, pUserData, lock);
     }
-    // sound effect was successfully loaded
+    // A stream gets a handle of its own, anything else goes in the index so later requests share this load
+    if (policy == LOAD_POLICY_STREAM)
+    {
+        StreamSoundSample streamSoundSample;
+        streamSoundSample.pSoundSample = pSoundSample;
+        streamSoundSample.id = id;
+        streamSoundSample.threeDFlag = threeDFlag;
+        this->streamSoundSamples.push_back(streamSoundSample);
+        pIndex = 0;
+    }
+    else
+    {
+        pIndex->add(id, pSoundSample);
+    }
+    // Mark it as used
+    this->touch(pSoundSample);
+    // Track the load
+    PendingLoad pendingLoad;
+    pendingLoad.pSoundSample = pSoundSample;
+    pendingLoad.pIndex = pIndex;
+    pendingLoad.id = id;
+    pendingLoad.mode = mode;
+    pendingLoad.probeFlag = (policy == LOAD_POLICY_AUTO);
+    pendingLoad.discardFlag = false;
+    if (pCallBack != 0)
+        pendingLoad.callbacks.push_back(std::make_pair(pCallBack, pUserData));
+    this->pendingLoads.push_back(pendingLoad);
+    // return the SoundSample
     return pSoundSample;
 }
 
-void AudioManager::destroySoundSample(SoundSample* pSoundSample)
+SoundSample* AudioManager::joinLoad(SoundSample* pSoundSample, SOUNDSAMPLE_LOADED_CALLBACK pCallBack, void* pUserData, std::unique_lock<std::mutex>& lock)
 {
-    FMOD_Sound_Release(pSoundSample->getFMODSound());
-    delete pSoundSample;
+    // Mark it as used
+    this->touch(pSoundSample);
+    // Still loading so wait on the same load
+    int index = this->findPendingLoad(pSoundSample);
+    if (index != -1)
+    {
+        if (pCallBack != 0)
+            this->pendingLoads[index].callbacks.push_back(std::make_pair(pCallBack, pUserData));
+        return pSoundSample;
+    }
+    // Already loaded so call the callback straight away
+    lock.unlock();
+    if (pCallBack != 0)
+        pCallBack(pSoundSample, true, pUserData);
+    return pSoundSample;
 }
 
-void AudioManager::clear()
+void AudioManager::update()
+{
+    // Loads which have finished this update
+    std::vector<PendingLoad> finishedLoads;
+    {
+        // Lock the AudioManager
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // Nothing to do
+        if (this->pendingLoads.empty() == true)
+            return;
+        // Check each load
+        for (unsigned int i = 0; i < this->pendingLoads.size();)
+        {
+            // Grab the Load
+            PendingLoad& pendingLoad = this->pendingLoads[i];
+            // Grab the Open State
+            FMOD_OPENSTATE openState = pendingLoad.pSoundSample->getOpenState();
+            // Still loading
+            if (openState != FMOD_OPENSTATE_READY && openState != FMOD_OPENSTATE_ERROR)
+            {
+                i++;
+                continue;
+            }
+            // A probe has opened so pick the policy, which may mean loading it again
+            if (pendingLoad.probeFlag == true && openState == FMOD_OPENSTATE_READY)
+            {
+                this->finishProbe(pendingLoad);
+                openState = pendingLoad.pSoundSample->getOpenState();
+                if (openState != FMOD_OPENSTATE_READY && openState != FMOD_OPENSTATE_ERROR)
+                {
+                    i++;
+                    continue;
+                }
+            }
+            // Lost a race with another load of the same file, nobody has it so throw it away
+            if (pendingLoad.discardFlag == true)
+            {
+                FMOD_Sound_Release(pendingLoad.pSoundSample->getFMODSound());
+                delete pendingLoad.pSoundSample;
+                this->pendingLoads[i] = this->pendingLoads.back();
+                this->pendingLoads.pop_back();
+                continue;
+            }
+            // Failed
+            if (openState == FMOD_OPENSTATE_ERROR)
+            {
+                // Send a message to the console
+                std::cout << "ERROR: Could not sound sample: " << pendingLoad.pSoundSample->getFilename() << std::endl;
+                // Take it out of the index (or the streams) so the next request tries again
+                this->forgetSoundSample(pendingLoad.pSoundSample);
+                // Release the FMODSound
+                FMOD_Sound_Release(pendingLoad.pSoundSample->getFMODSound());
+                pendingLoad.pSoundSample->setFMODSound(0);
+                // Keep the SoundSample alive until clear
+                this->failedSoundSamples.push_back(pendingLoad.pSoundSample);
+            }
+            // Loaded so count its memory
+            else
+            {
+                this->memoryUsage += pendingLoad.pSoundSample->getMemoryUsage();
+            }
+            // Move it to the finished loads
+            finishedLoads.push_back(pendingLoad);
+            this->pendingLoads[i] = this->pendingLoads.back();
+            this->pendingLoads.pop_back();
+        }
+    }
+    // Call the callbacks without holding the lock (they may ask for more SoundSamples)
+    for (unsigned int i = 0; i < finishedLoads.size(); i++)
+    {
+        // Grab the Load
+        PendingLoad& finishedLoad = finishedLoads[i];
+        // Did it work
+        bool successFlag = (finishedLoad.pSoundSample->getFMODSound() != 0);
+        // Call the callbacks
+        for (unsigned int j = 0; j < finishedLoad.callbacks.size(); j++)
+            finishedLoad.callbacks[j].first(finishedLoad.pSoundSample, successFlag, finishedLoad.callbacks[j].second);
+    }
+    // Make room for anything which just finished (only now the callbacks have had the chance to take references)
+    if (finishedLoads.empty() == false)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->evict();
+    }
+}
+
+bool AudioManager::waitForSoundSample(SoundSample* pSoundSample)
+{
+    // Validate the SoundSample
+    if (pSoundSample == 0)
+        return false;
+    // Wait for FMOD to finish opening the sound
+    while (true)
+    {
+        // Grab the Open State
+        FMOD_OPENSTATE openState = FMOD_OPENSTATE_LOADING;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            // A probe which has opened is finished here rather than waiting for update (it is not the sound to play yet)
+            int index = this->findPendingLoad(pSoundSample);
+            if (index != -1 && this->pendingLoads[index].probeFlag == true && pSoundSample->getOpenState() == FMOD_OPENSTATE_READY)
+                this->finishProbe(this->pendingLoads[index]);
+            openState = pSoundSample->getOpenState();
+        }
+        // Loaded
+        if (openState == FMOD_OPENSTATE_READY)
+            return true;
+        // Failed
+        if (openState == FMOD_OPENSTATE_ERROR)
+            return false;
+        // Give FMOD's loading thread some time
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void AudioManager::finishProbe(PendingLoad& pendingLoad)
 {
-    // Release Sound Samples
-    for (std::map<std::string, SoundSample*>::iterator i = this->soundSampleMap.begin(); i != this->soundSampleMap.end(); i++)
+    // Grab the SoundSample
+    SoundSample* pSoundSample = pendingLoad.pSoundSample;
+    // Read the type and length from the open stream
+    FMOD_SOUND_TYPE soundType = FMOD_SOUND_TYPE_UNKNOWN;
+    unsigned int lengthInMilliseconds = 0;
+    FMOD_Sound_GetFormat(pSoundSample->getFMODSound(), &soundType, 0, 0, 0);
+    FMOD_Sound_GetLength(pSoundSample->getFMODSound(), &lengthInMilliseconds, FMOD_TIMEUNIT_MS);
+    // Pick the policy and remember it
+    LOAD_POLICY policy = this->chooseLoadPolicy(soundType, lengthInMilliseconds);
+    this->autoLoadPolicies[pendingLoad.id] = policy;
+    pendingLoad.probeFlag = false;
+    // Already open as a stream so keep it (it leaves the index, later requests get streams of their own)
+    if (policy == LOAD_POLICY_STREAM)
     {
-        SoundSample* pSoundSample = i->second;
-        this->destroySoundSample(pSoundSample);
+        this->forgetSoundSample(pSoundSample);
+        StreamSoundSample streamSoundSample;
+        streamSoundSample.pSoundSample = pSoundSample;
+        streamSoundSample.id = pendingLoad.id;
+        streamSoundSample.threeDFlag = ((pendingLoad.mode & FMOD_3D) != 0);
+        this->streamSoundSamples.push_back(streamSoundSample);
+        pendingLoad.pIndex = 0;
+        return;
+    }
+    // Load it again as it should be held (returns straight away)
+    FMOD_SOUND* pFMODSound = 0;
+    FMOD_RESULT result = this->createFMODSound(pSoundSample->getFilename(), pendingLoad.id, pendingLoad.mode | FMOD_NONBLOCKING, policy, &pFMODSound);
+    if (result != FMOD_OK)
+    {
+        // Send a message to the console
+        std::cout << "ERROR: Could not start loading sound sample: " << pSoundSample->getFilename() << std::endl;
+        std::cout << "FMOD error! (" << FMOD_ErrorString(result) << ") " << std::endl;
+        pFMODSound = 0;
     }
-    // Clear sound Sample Map
-    this->soundSampleMap.clear();
-    // Clear 3D Sound Samples
-    for (std::map<std::string, SoundSample*>::iterator i = this->soundSample3DMap.begin(); i != this->soundSample3DMap.end(); i++)
+    // Swap the probe for the load (no sound is an error the next time it is checked)
+    FMOD_SOUND* pProbeSound = pSoundSample->getFMODSound();
+    pSoundSample->setFMODSound(pFMODSound);
+    FMOD_Sound_Release(pProbeSound);
+}
+
+int AudioManager::getNumberOfPendingLoads()
+{
+    // Lock the AudioManager
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of pending loads
+    return (int)this->pendingLoads.size();
+}
+
+int AudioManager::findPendingLoad(SoundSample* pSoundSample)
+{
+    // Look for the SoundSample
+    for (unsigned int i = 0; i < this->pendingLoads.size(); i++)
     {
-        SoundSample* pSoundSample = i->second;
-        this->destroySoundSample(pSoundSample);
+        if (this->pendingLoads[i].pSoundSample == pSoundSample)
+            return (int)i;
     }
-    // Clear sound Sample Map
-    this->soundSample3DMap.clear();
+    // Not pending
+    return -1;
 }
 
 //void AudioManager::bindToLua(lua_State* pLuaState)
@@ -150,12 +1148,12 @@ void AudioManager::clear()
 //        luabind::class_<AudioManager>("AudioManager")
 //        .def(luabind::constructor<>())
 //        .def("getVersion", (std::string (AudioManager::*)()) &AudioManager::getVersion)
-//        .def("getSoundSample", (SoundSample*(AudioManager::*)(std::string)) &AudioManager::getSoundSample)
-//        .def("getSoundSample", (SoundSample*(AudioManager::*)(std::string, bool)) &AudioManager::getSoundSample)
-//        .def("getSoundSample2D", (SoundSample*(AudioManager::*)(std::string)) &AudioManager::getSoundSample2D)
-//        .def("getSoundSample2D", (SoundSample*(AudioManager::*)(std::string, bool)) &AudioManager::getSoundSample2D)
-//        .def("getSoundSample3D", (SoundSample*(AudioManager::*)(std::string)) &AudioManager::getSoundSample3D)
-//        .def("getSoundSample3D", (SoundSample*(AudioManager::*)(std::string, bool)) &AudioManager::getSoundSample3D)
+//        .def("getSoundSample", (SoundSample*(AudioManager::*)(const std::string&)) &AudioManager::getSoundSample)
+//        .def("getSoundSample", (SoundSample*(AudioManager::*)(const std::string&, bool)) &AudioManager::getSoundSample)
+//        .def("getSoundSample2D", (SoundSample*(AudioManager::*)(const std::string&)) &AudioManager::getSoundSample2D)
+//        .def("getSoundSample2D", (SoundSample*(AudioManager::*)(const std::string&, bool)) &AudioManager::getSoundSample2D)
+//        .def("getSoundSample3D", (SoundSample*(AudioManager::*)(const std::string&)) &AudioManager::getSoundSample3D)
+//        .def("getSoundSample3D", (SoundSample*(AudioManager::*)(const std::string&, bool)) &AudioManager::getSoundSample3D)
 //        .def("destroySoundSample", (void(AudioManager::*)()) &AudioManager::destroySoundSample)
 //        .def("clear", (void(AudioManager::*)()) &AudioManager::clear)
 //    ];
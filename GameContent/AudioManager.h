@@ -2,7 +2,12 @@
 #define AUDIOMANAGER_H
 
 // C/C++ Includes
+#include <algorithm>
+#include <chrono>
 #include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 //// Macro which asks TinyXML to use the TICPP Wrapper
 //#define TIXML_USE_TICPP
@@ -30,6 +35,18 @@
 
 // Include GameAudio related headers
 #include "Sound/SoundSample.h"
+#include "System/AudioFileSystem.h"
+
+// Include GameContent related headers
+#include "AssetId.h"
+#include "BankLoader.h"
+#include "LoadPolicy.h"
+#include "SoundSampleIndex.h"
+
+/** Function called when an asynchronous SoundSample load finishes. On
+    failure the SoundSample is taken out of the index and left without an
+    FMOD_SOUND (it is deleted by AudioManager::clear) **/
+typedef void (*SOUNDSAMPLE_LOADED_CALLBACK)(SoundSample* pSoundSample, bool successFlag, void* pUserData);
 
 /** The AudioManager class loads instancable sounds assets **/
 class AudioManager
@@ -42,8 +59,18 @@ class AudioManager
         AudioManager()
         {
             this->version = std::string("1.0");
-            this->soundSampleMap.clear();
-            this->soundSample3DMap.clear();
+            this->pendingLoads.clear();
+            this->failedSoundSamples.clear();
+            this->banks.clear();
+            this->loadPolicyRules.clear();
+            this->autoLoadPolicies.clear();
+            this->streamSoundSamples.clear();
+            this->defaultLoadPolicy = LOAD_POLICY_DECOMPRESS;
+            this->compressAboveMilliseconds = 2000;
+            this->streamAboveMilliseconds = 30000;
+            this->memoryBudget = 0;
+            this->memoryUsage = 0;
+            this->tick = 0;
         }
         //! Destructor
         virtual ~AudioManager() {}
@@ -67,34 +94,344 @@ class AudioManager
     // * CORE MANAGER FUNCTIONS *
     // **************************
     public:
+        // A streamed SoundSample (LOAD_POLICY_STREAM) plays on one Channel at a
+        // time so it is never shared: every request gets its own, handing back
+        // one nothing references any more. Take a reference (acquireSoundSample
+        // or Sound::setSoundSample) before asking for the same stream again
+
         //! Get SoundSample
-        virtual SoundSample* getSoundSample(std::string filename);
+        virtual SoundSample* getSoundSample(const std::string& filename);
         //! Get SoundSample
-        virtual SoundSample* getSoundSample(std::string filename, bool addToMap);
+        virtual SoundSample* getSoundSample(const std::string& filename, bool addToMap);
 
         //! Get SoundSample2D
-        virtual SoundSample* getSoundSample2D(std::string filename);
+        virtual SoundSample* getSoundSample2D(const std::string& filename);
         //! Get SoundSample2D
-        virtual SoundSample* getSoundSample2D(std::string filename, bool addToMap);
+        virtual SoundSample* getSoundSample2D(const std::string& filename, bool addToMap);
 
         //! Get SoundSample3D
-        virtual SoundSample* getSoundSample3D(std::string filename);
+        virtual SoundSample* getSoundSample3D(const std::string& filename);
         //! Get SoundSample3D
-        virtual SoundSample* getSoundSample3D(std::string filename, bool addToMap);
+        virtual SoundSample* getSoundSample3D(const std::string& filename, bool addToMap);
+
+    public:
+        /** @brief getSoundSample
+          * Find an already loaded SoundSample by AssetId (nothing is hashed,
+          * copied or allocated; use AssetIds::make on the path once up front).
+          * Streamed SoundSamples are not shared so are never found
+          * @param id AssetId of the path
+          * @return the SoundSample or 0 if it has not been loaded **/
+        virtual SoundSample* getSoundSample(AssetId id);
+        /** @brief getSoundSample3D
+          * @param id AssetId of the path
+          * @return the 3D SoundSample or 0 if it has not been loaded **/
+        virtual SoundSample* getSoundSample3D(AssetId id);
 
     public:
-        //! Destroy a SoundSample (use only on SoundSamples not added to the Map)
+        //! Destroy a SoundSample nothing references (it is taken out of the index and its memory off the total)
         virtual void destroySoundSample(SoundSample* pSoundSample);
 
     public:
-        //! Clear the AudioManager
+        //! Clear the AudioManager (SoundSamples still referenced by Sounds are kept)
         virtual void clear();
 
     protected:
-        // SoundSample Map
-        std::map<std::string, SoundSample*> soundSampleMap;
-        // SoundSample3D Map
-        std::map<std::string, SoundSample*> soundSample3DMap;
+        /** @brief Load a SoundSample (shared by the 2D and 3D versions) **/
+        virtual SoundSample* loadSoundSample(const std::string& filename, bool threeDFlag, bool addToMap);
+        /** @brief Release the SoundSamples in an index which nothing references (lock must be held) **/
+        virtual void clearIndex(SoundSampleIndex* pIndex);
+        /** @brief Find a streamed SoundSample nothing references (lock must be held)
+          * @return the SoundSample or 0 **/
+        virtual SoundSample* findIdleStreamSoundSample(AssetId id, bool threeDFlag);
+        /** @brief Take a SoundSample out of the index or stream list it is in (lock must be held)
+          * @return false if it was in neither **/
+        virtual bool forgetSoundSample(SoundSample* pSoundSample);
+        /** @brief Find a SoundSample in an index, mark it used and wait for it to finish loading
+          * @return the SoundSample or 0 if it is not there or failed **/
+        virtual SoundSample* findSoundSample(SoundSampleIndex* pIndex, AssetId id);
+
+    protected:
+        // SoundSample Index (keyed by the AssetId of the path)
+        SoundSampleIndex soundSampleIndex;
+        // SoundSample3D Index (keyed by the AssetId of the path)
+        SoundSampleIndex soundSample3DIndex;
+        // A streamed SoundSample
+        struct StreamSoundSample
+        {
+            // The SoundSample
+            SoundSample* pSoundSample;
+            // AssetId of the path
+            AssetId id;
+            // Opened with FMOD_3D
+            bool threeDFlag;
+        };
+        // Streamed SoundSamples (one per user, never in the indices)
+        std::vector<StreamSoundSample> streamSoundSamples;
+        // Guards the indices and the pending loads (update may run on the audio thread)
+        std::mutex mutex;
+
+    // ***************************
+    // * MEMORY BUDGET FUNCTIONS *
+    // ***************************
+    public:
+        /** @brief acquireSoundSample
+          * Get a SoundSample and hold a reference to it. A referenced SoundSample
+          * is never evicted, call releaseSoundSample when finished with it
+          * (Sound::setSoundSample takes its own reference)
+          * @param filename file to load
+          * @return the SoundSample or 0 **/
+        virtual SoundSample* acquireSoundSample(const std::string& filename);
+        /** @brief acquireSoundSample3D
+          * @param filename file to load
+          * @return the 3D SoundSample or 0 **/
+        virtual SoundSample* acquireSoundSample3D(const std::string& filename);
+        /** @brief releaseSoundSample
+          * Drop a reference taken with acquireSoundSample. The SoundSample
+          * stays cached until the memory budget needs the space
+          * @param pSoundSample the SoundSample **/
+        virtual void releaseSoundSample(SoundSample* pSoundSample);
+        /** @brief pinSoundSample
+          * A pinned SoundSample is never evicted (for critical sounds like UI)
+          * @param pSoundSample the SoundSample
+          * @param pinnedFlag true to pin, false to unpin **/
+        virtual void pinSoundSample(SoundSample* pSoundSample, bool pinnedFlag);
+        /** @brief getMemoryBudget
+          * @return the memory budget in bytes (0 is unlimited) **/
+        virtual unsigned int getMemoryBudget() { return this->memoryBudget; }
+        /** @brief setMemoryBudget
+          * When the SoundSamples in the indices use more than this the least
+          * recently used ones with no references and no pin are released
+          * @param memoryBudget budget in bytes (0 is unlimited) **/
+        virtual void setMemoryBudget(unsigned int memoryBudget);
+        /** @brief getMemoryUsage
+          * @return bytes used by the loaded SoundSamples **/
+        virtual unsigned int getMemoryUsage();
+
+    protected:
+        /** @brief touch (lock must be held)
+          * Mark a SoundSample as just used **/
+        virtual void touch(SoundSample* pSoundSample) { pSoundSample->setLastUsed(++this->tick); }
+        /** @brief evict (lock must be held)
+          * Release least recently used SoundSamples until we are inside the budget
+          * @param pKeepSoundSample a SoundSample which must stay (one about to be handed out) **/
+        virtual void evict(SoundSample* pKeepSoundSample = 0);
+
+    protected:
+        // Memory Budget in bytes (0 is unlimited)
+        unsigned int memoryBudget;
+        // Memory used by the loaded SoundSamples
+        unsigned int memoryUsage;
+        // Incremented every time a SoundSample is asked for
+        unsigned long long tick;
+
+    // **************************
+    // * SOUND BANK FUNCTIONS *
+    // **************************
+    public:
+        /** @brief loadBank
+          * Map a sound bank written by the BankPacker. From then on a SoundSample
+          * whose path is in the bank is created from the mapping instead of
+          * opening its file (banks are searched newest first)
+          * @param filename bank to load
+          * @return true on success **/
+        virtual bool loadBank(const std::string& filename);
+        /** @brief unloadBank
+          * Release the SoundSamples which came from the bank and unmap it. Fails
+          * if any of them is still referenced
+          * @param filename bank to unload
+          * @return true on success **/
+        virtual bool unloadBank(const std::string& filename);
+        /** @brief getNumberOfBanks
+          * @return number of loaded banks **/
+        virtual int getNumberOfBanks() { return (int)this->banks.size(); }
+
+    protected:
+        /** @brief findBankEntry
+          * @param id AssetId of the path
+          * @param ppBankLoader receives the bank which has it
+          * @return the entry of the newest bank which has it or 0 **/
+        virtual const SoundBankEntry* findBankEntry(AssetId id, BankLoader** ppBankLoader);
+        /** @brief createFMODSound
+          * Create an FMOD_SOUND from the loaded banks, or from its file when no bank has it
+          * @param filename upper cased path
+          * @param id AssetId of the path
+          * @param mode FMOD_MODE of the sound
+          * @param policy how to hold it (from resolveLoadPolicy)
+          * @param ppFMODSound receives the sound
+          * @return result of FMOD_System_CreateSound **/
+        virtual FMOD_RESULT createFMODSound(const std::string& filename, AssetId id, FMOD_MODE mode, LOAD_POLICY policy, FMOD_SOUND** ppFMODSound);
+        /** @brief Release the SoundSamples in an index which a bank has (lock must be held) **/
+        virtual void releaseBankSoundSamples(BankLoader* pBankLoader, SoundSampleIndex* pIndex);
+        /** @brief Is anything loaded from a bank (lock must be held)
+          * @param referencedOnlyFlag true to count only SoundSamples which are referenced or still loading **/
+        virtual bool isBankInUse(BankLoader* pBankLoader, bool referencedOnlyFlag);
+
+    protected:
+        // Loaded Banks (loaded and unloaded from the game thread only)
+        std::vector<BankLoader*> banks;
+
+    // *************************
+    // * LOAD POLICY FUNCTIONS *
+    // *************************
+    public:
+        /** @brief setLoadPolicy
+          * Set how the SoundSamples of a category are held. A category is a path
+          * prefix ("media/ambience/"), the longest matching prefix wins. Only
+          * affects SoundSamples loaded from now on
+          * @param pathPrefix path prefix of the category (case does not matter)
+          * @param policy the LOAD_POLICY **/
+        virtual void setLoadPolicy(const std::string& pathPrefix, LOAD_POLICY policy);
+        /** @brief removeLoadPolicy
+          * @param pathPrefix path prefix of the category **/
+        virtual void removeLoadPolicy(const std::string& pathPrefix);
+        /** @brief getLoadPolicy
+          * @param filename path of a SoundSample
+          * @return the LOAD_POLICY of its category (may be LOAD_POLICY_AUTO) **/
+        virtual LOAD_POLICY getLoadPolicy(const std::string& filename);
+        /** @brief getDefaultLoadPolicy
+          * @return the LOAD_POLICY of paths in no category **/
+        virtual LOAD_POLICY getDefaultLoadPolicy() { return this->defaultLoadPolicy; }
+        /** @brief setDefaultLoadPolicy
+          * @param policy the LOAD_POLICY of paths in no category (LOAD_POLICY_DECOMPRESS by default) **/
+        virtual void setDefaultLoadPolicy(LOAD_POLICY policy) { this->defaultLoadPolicy = policy; }
+        /** @brief setAutoLoadPolicyThresholds
+          * LOAD_POLICY_AUTO streams sounds at least streamAboveMilliseconds long,
+          * keeps sounds at least compressAboveMilliseconds long compressed when
+          * FMOD can and decompresses everything else
+          * @param compressAboveMilliseconds (2000 by default)
+          * @param streamAboveMilliseconds (30000 by default) **/
+        virtual void setAutoLoadPolicyThresholds(unsigned int compressAboveMilliseconds, unsigned int streamAboveMilliseconds);
+        /** @brief resolveLoadPolicy
+          * Work out how a SoundSample will be held. LOAD_POLICY_AUTO is resolved
+          * from the bank entry, or by probing the file (remembered per path)
+          * @param filename upper cased path
+          * @param id AssetId of the path
+          * @param probeFlag false to return LOAD_POLICY_AUTO rather than open a file not probed before
+          * @return the LOAD_POLICY **/
+        virtual LOAD_POLICY resolveLoadPolicy(const std::string& filename, AssetId id, bool probeFlag);
+        /** @brief getCompressAboveMilliseconds
+          * @return shortest sound LOAD_POLICY_AUTO keeps compressed **/
+        virtual unsigned int getCompressAboveMilliseconds() { return this->compressAboveMilliseconds; }
+        /** @brief getStreamAboveMilliseconds
+          * @return shortest sound LOAD_POLICY_AUTO streams **/
+        virtual unsigned int getStreamAboveMilliseconds() { return this->streamAboveMilliseconds; }
+        /** @brief getLoadPolicyReport
+          * @return decoded and resident bytes of the loaded SoundSamples per
+          * category (the last report is for paths in no category) **/
+        virtual std::vector<LoadPolicyReport> getLoadPolicyReport();
+        /** @brief printLoadPolicyReport
+          * Send the load policy report to the console **/
+        virtual void printLoadPolicyReport();
+
+    protected:
+        /** @brief Find the category of a path (lock must be held)
+          * @return index into loadPolicyRules or -1 **/
+        virtual int findLoadPolicyRule(const std::string& filename);
+        /** @brief Resolve LOAD_POLICY_AUTO
+          * @return the LOAD_POLICY for a sound of this type and length **/
+        virtual LOAD_POLICY chooseLoadPolicy(FMOD_SOUND_TYPE soundType, unsigned int lengthInMilliseconds);
+        /** @brief Read the type and length of a file without decoding it
+          * @return true on success **/
+        virtual bool probeSound(const std::string& filename, FMOD_SOUND_TYPE* pSoundType, unsigned int* pLengthInMilliseconds);
+
+    protected:
+        // A category
+        struct LoadPolicyRule
+        {
+            // Upper cased path prefix ('\' as '/')
+            std::string pathPrefix;
+            // Policy
+            LOAD_POLICY policy;
+        };
+        // Categories (guarded by the lock)
+        std::vector<LoadPolicyRule> loadPolicyRules;
+        // What LOAD_POLICY_AUTO picked for each probed file (guarded by the lock)
+        std::map<AssetId, LOAD_POLICY> autoLoadPolicies;
+        // Policy of paths in no category
+        LOAD_POLICY defaultLoadPolicy;
+        // LOAD_POLICY_AUTO thresholds
+        unsigned int compressAboveMilliseconds;
+        unsigned int streamAboveMilliseconds;
+
+    // **********************************
+    // * ASYNCHRONOUS LOADING FUNCTIONS *
+    // **********************************
+    public:
+        /** @brief loadSoundSampleAsync
+          * Start loading a SoundSample with FMOD_NONBLOCKING and return straight
+          * away. The SoundSample goes into the index immediately so asking for the
+          * same file again (sync or async) shares the one load (streams are not
+          * shared, each request gets its own). The callback is
+          * called from update() once FMOD has finished
+          * @param filename file to load
+          * @param pCallBack called when the load finishes (can be 0)
+          * @param pUserData passed to the callback
+          * @return the SoundSample (not playable until isReady) or 0 if the load could not be started **/
+        virtual SoundSample* loadSoundSampleAsync(const std::string& filename, SOUNDSAMPLE_LOADED_CALLBACK pCallBack = 0, void* pUserData = 0);
+        /** @brief loadSoundSample3DAsync
+          * As loadSoundSampleAsync but for 3D SoundSamples
+          * @param filename file to load
+          * @param pCallBack called when the load finishes (can be 0)
+          * @param pUserData passed to the callback
+          * @return the SoundSample (not playable until isReady) or 0 if the load could not be started **/
+        virtual SoundSample* loadSoundSample3DAsync(const std::string& filename, SOUNDSAMPLE_LOADED_CALLBACK pCallBack = 0, void* pUserData = 0);
+        /** @brief update
+          * Check the pending loads and call the callbacks of the ones which have finished **/
+        virtual void update();
+        /** @brief updateCallback
+          * Hook for AudioSystem::addUpdateCallback so pending loads are polled
+          * every AudioSystem::update() (pass the AudioManager as pUserData) **/
+        static void updateCallback(void* pUserData) { ((AudioManager*)pUserData)->update(); }
+        /** @brief waitForSoundSample
+          * Block until a SoundSample has finished loading
+          * @param pSoundSample the SoundSample
+          * @return true if it loaded, false if it failed **/
+        virtual bool waitForSoundSample(SoundSample* pSoundSample);
+        /** @brief getNumberOfPendingLoads
+          * @return the number of loads still in flight **/
+        virtual int getNumberOfPendingLoads();
+
+    protected:
+        /** @brief Start an asynchronous load (shared by the 2D and 3D versions) **/
+        virtual SoundSample* loadSoundSampleAsync(const std::string& filename, bool threeDFlag, SOUNDSAMPLE_LOADED_CALLBACK pCallBack, void* pUserData);
+        /** @brief Share a load which already exists (lock must be held, it is released
+          * before the callback is called when the load has already finished)
+          * @return the SoundSample **/
+        virtual SoundSample* joinLoad(SoundSample* pSoundSample, SOUNDSAMPLE_LOADED_CALLBACK pCallBack, void* pUserData, std::unique_lock<std::mutex>& lock);
+        /** @brief Find a pending load (lock must be held)
+          * @return index into pendingLoads or -1 **/
+        virtual int findPendingLoad(SoundSample* pSoundSample);
+
+    protected:
+        // A load in flight and everyone waiting on it
+        struct PendingLoad
+        {
+            // The SoundSample being loaded
+            SoundSample* pSoundSample;
+            // The index the SoundSample lives in (0 for a stream)
+            SoundSampleIndex* pIndex;
+            // Key in the index
+            AssetId id;
+            // FMOD_MODE it was asked for (without FMOD_NONBLOCKING)
+            FMOD_MODE mode;
+            // LOAD_POLICY_AUTO on a file not seen before: opened as a stream to read
+            // its type and length, then loaded again unless it is to be streamed
+            bool probeFlag;
+            // Lost a race with another load of the same file (released when it finishes)
+            bool discardFlag;
+            // Callbacks to call when it finishes
+            std::vector< std::pair<SOUNDSAMPLE_LOADED_CALLBACK, void*> > callbacks;
+        };
+
+    protected:
+        /** @brief Pick the policy of a probe which has opened and load it as it should be held (lock must be held) **/
+        virtual void finishProbe(PendingLoad& pendingLoad);
+
+    protected:
+        // Pending Loads
+        std::vector<PendingLoad> pendingLoads;
+        // SoundSamples whose load failed (kept so pointers handed out stay valid)
+        std::vector<SoundSample*> failedSoundSamples;
 
     // *********************
     // * UTILITY FUNCTIONS *
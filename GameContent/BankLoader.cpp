@@ -0,0 +1,144 @@
+#include "BankLoader.h"
+
+BankLoader::BankLoader()
+{
+    // Filename
+    this->filename.clear();
+    // Mapped data
+    this->pHeader = 0;
+    this->pEntries = 0;
+    this->pNames = 0;
+}
+
+BankLoader::~BankLoader()
+{
+    // Unmap the bank
+    this->unload();
+}
+
+bool BankLoader::load(const std::string& filename)
+{
+    // Unload any existing bank
+    this->unload();
+    // Map the file
+    if (this->mappedFile.open(filename, true) == false)
+        return false;
+    // Grab the mapping
+    const unsigned char* pData = this->mappedFile.getData();
+    unsigned long long size = this->mappedFile.getSize();
+    // Validate the header
+    const SoundBankHeader* pHeader = (const SoundBankHeader*)pData;
+    if (size < sizeof(SoundBankHeader) || pHeader->magic != SOUNDBANK_MAGIC || pHeader->version != SOUNDBANK_VERSION)
+    {
+        std::cout << "bool BankLoader::load() failure. " << filename << " is not a version " << SOUNDBANK_VERSION << " sound bank" << std::endl;
+        this->mappedFile.close();
+        return false;
+    }
+    // Validate the table of contents
+    if (pHeader->entriesOffset > size || (unsigned long long)pHeader->numberOfEntries * sizeof(SoundBankEntry) > size - pHeader->entriesOffset || pHeader->namesOffset > size)
+    {
+        std::cout << "bool BankLoader::load() failure. " << filename << " is truncated" << std::endl;
+        this->mappedFile.close();
+        return false;
+    }
+    // Validate every entry (a sound or name outside the mapping would be read, or written through FMOD_OPENMEMORY_POINT)
+    const SoundBankEntry* pEntries = (const SoundBankEntry*)(pData + pHeader->entriesOffset);
+    unsigned long long namesSize = size - pHeader->namesOffset;
+    for (unsigned int i = 0; i < pHeader->numberOfEntries; i++)
+    {
+        // The data must have its padding either side inside the mapping
+        const SoundBankEntry& entry = pEntries[i];
+        bool validFlag = (entry.dataOffset >= SOUNDBANK_PADDING && entry.dataOffset <= size && (unsigned long long)entry.dataSize + SOUNDBANK_PADDING <= size - entry.dataOffset);
+        // The name must start and end (null terminated) inside the names
+        if (validFlag == true)
+            validFlag = (entry.nameOffset < namesSize && memchr(pData + pHeader->namesOffset + entry.nameOffset, 0, (size_t)(namesSize - entry.nameOffset)) != 0);
+        if (validFlag == false)
+        {
+            std::cout << "bool BankLoader::load() failure. " << filename << " entry " << i << " is outside the bank" << std::endl;
+            this->mappedFile.close();
+            return false;
+        }
+    }
+    // Point into the mapping
+    this->pHeader = pHeader;
+    this->pEntries = (const SoundBankEntry*)(pData + pHeader->entriesOffset);
+    this->pNames = (const char*)(pData + pHeader->namesOffset);
+    this->filename = filename;
+    // Send a message to the console
+    std::cout << "SoundBank: " << filename << " Loaded with " << pHeader->numberOfEntries << " sounds." << std::endl;
+    // Success
+    return true;
+}
+
+void BankLoader::unload()
+{
+    // Forget the mapped data
+    this->pHeader = 0;
+    this->pEntries = 0;
+    this->pNames = 0;
+    this->filename.clear();
+    // Unmap the file
+    this->mappedFile.close();
+}
+
+const SoundBankEntry* BankLoader::findEntry(AssetId id)
+{
+    // Nothing loaded
+    if (this->pHeader == 0)
+        return 0;
+    // Binary search the entries (the BankPacker sorted them by id)
+    unsigned int first = 0;
+    unsigned int last = this->pHeader->numberOfEntries;
+    while (first < last)
+    {
+        unsigned int middle = first + (last - first) / 2;
+        if (this->pEntries[middle].id < id)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    // Found
+    if (first < this->pHeader->numberOfEntries && this->pEntries[first].id == id)
+        return &(this->pEntries[first]);
+    // Not in this bank
+    return 0;
+}
+
+FMOD_RESULT BankLoader::createFMODSound(const SoundBankEntry* pEntry, FMOD_MODE mode, FMOD_SOUND** ppFMODSound)
+{
+    // Validate the entry
+    if (this->pHeader == 0 || pEntry == 0)
+        return FMOD_ERR_INVALID_PARAM;
+    // Tell FMOD everything it would otherwise probe for
+    FMOD_CREATESOUNDEXINFO exinfo;
+    memset(&exinfo, 0, sizeof(FMOD_CREATESOUNDEXINFO));
+    exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+    exinfo.length = pEntry->dataSize;
+    exinfo.suggestedsoundtype = (FMOD_SOUND_TYPE)pEntry->soundType;
+    // Raw data has no header so it needs its format
+    if (pEntry->soundType == FMOD_SOUND_TYPE_RAW)
+    {
+        exinfo.format = (FMOD_SOUND_FORMAT)pEntry->format;
+        exinfo.numchannels = pEntry->channels;
+        exinfo.defaultfrequency = (int)pEntry->defaultFrequency;
+        mode |= FMOD_OPENRAW;
+    }
+    /* NOTE: Streams read straight out of the mapping (FMOD_OPENMEMORY would
+        copy the whole file into FMOD's heap). The AudioManager releases
+        every sound from a bank before the bank and its mapping go */
+    if ((mode & FMOD_CREATESTREAM) != 0)
+    {
+        mode |= FMOD_OPENMEMORY_POINT;
+    }
+    // FMOD can point at PCM and FSB samples, and at MPEG kept compressed
+    else
+    {
+        bool pointFlag = (pEntry->soundType == FMOD_SOUND_TYPE_WAV || pEntry->soundType == FMOD_SOUND_TYPE_RAW || pEntry->soundType == FMOD_SOUND_TYPE_FSB);
+        if (pEntry->soundType == FMOD_SOUND_TYPE_MPEG && (mode & FMOD_CREATECOMPRESSEDSAMPLE) != 0)
+            pointFlag = true;
+        mode |= (pointFlag == true) ? FMOD_OPENMEMORY_POINT : FMOD_OPENMEMORY;
+    }
+    // Create the sound
+    const char* pData = (const char*)(this->mappedFile.getData() + pEntry->dataOffset);
+    return FMOD_System_CreateSound(FMODGlobals::pFMODSystem, pData, mode, &exinfo, ppFMODSound);
+}
@@ -0,0 +1,109 @@
+/**
+  * @file   BankLoader.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  BankLoader maps a packed sound bank and creates
+  * FMOD sounds straight out of the mapping
+*/
+
+#ifndef BANKLOADER_H
+#define BANKLOADER_H
+
+// C++ Includes
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+#include <fmod_errors.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+
+// GAMECONTENT Includes
+#include "MappedFile.h"
+#include "SoundBankFormat.h"
+
+/** The BankLoader class maps a bank written by the BankPacker (copy on
+    write, the file is never changed) and finds sounds in its table of
+    contents by AssetId (a binary search over the mapped entries, nothing
+    is copied or allocated). The codec, length and (for raw data) format
+    come from the entry instead of being probed. FMOD reads the mapping in
+    place where it can:
+        - PCM (WAV, RAW) and FSB samples, and MPEG with
+          FMOD_CREATECOMPRESSEDSAMPLE, use FMOD_OPENMEMORY_POINT (FMOD
+          touches the padding either side, hence copy on write)
+        - streams use FMOD_OPENMEMORY_POINT too and stream out of the
+          mapping (FMOD_OPENMEMORY would copy the whole file)
+        - anything else (an Ogg decoded to a sample) uses FMOD_OPENMEMORY,
+          which copies but still does no file access
+    Every sound created from a bank must be released before it is unloaded **/
+class BankLoader
+{
+    // ****************************
+    // * CONSTRUCTOR / DESTRUCTOR *
+    // ****************************
+    public:
+        //! Constructor
+        BankLoader();
+        //! Destructor
+        virtual ~BankLoader();
+
+    protected:
+        //! BankLoader Copy constructor
+        BankLoader(const BankLoader& other) {}
+
+    // ******************
+    // * BANK FUNCTIONS *
+    // ******************
+    public:
+        /** @brief load
+          * @param filename bank to map
+          * @return true on success **/
+        virtual bool load(const std::string& filename);
+        /** @brief unload (release every sound created from the bank first) **/
+        virtual void unload();
+        /** @brief isLoaded
+          * @return true if a bank is mapped **/
+        virtual bool isLoaded() { return (this->pHeader != 0); }
+        /** @brief getFilename
+          * @return filename of the bank **/
+        virtual std::string getFilename() { return this->filename; }
+        /** @brief getNumberOfEntries
+          * @return number of sounds in the bank **/
+        virtual unsigned int getNumberOfEntries() { return (this->pHeader != 0) ? this->pHeader->numberOfEntries : 0; }
+        /** @brief getEntry
+          * @param index 0 to getNumberOfEntries() - 1
+          * @return the entry **/
+        virtual const SoundBankEntry* getEntry(unsigned int index) { return &(this->pEntries[index]); }
+        /** @brief findEntry
+          * @param id AssetId of the sound
+          * @return the entry or 0 if the bank does not have the sound **/
+        virtual const SoundBankEntry* findEntry(AssetId id);
+        /** @brief getName
+          * @param pEntry an entry of this bank
+          * @return the path the sound was packed from **/
+        virtual const char* getName(const SoundBankEntry* pEntry) { return this->pNames + pEntry->nameOffset; }
+        /** @brief createFMODSound
+          * @param pEntry an entry of this bank
+          * @param mode FMOD_MODE the sound is wanted in (FMOD_3D, FMOD_CREATESTREAM and so on)
+          * @param ppFMODSound receives the sound
+          * @return result of FMOD_System_CreateSound **/
+        virtual FMOD_RESULT createFMODSound(const SoundBankEntry* pEntry, FMOD_MODE mode, FMOD_SOUND** ppFMODSound);
+
+    protected:
+        // The mapped bank
+        MappedFile mappedFile;
+        // Filename of the bank
+        std::string filename;
+        // Header (in the mapping)
+        const SoundBankHeader* pHeader;
+        // Entries (in the mapping)
+        const SoundBankEntry* pEntries;
+        // Names (in the mapping)
+        const char* pNames;
+};
+
+#endif // BANKLOADER_H
@@ -0,0 +1,168 @@
+#include "BankPacker.h"
+
+bool BankPacker::pack(const std::string& bankFilename)
+{
+    // Validate the files
+    if (this->filenames.empty() == true)
+    {
+        std::cout << "bool BankPacker::pack() failure. No files to pack" << std::endl;
+        return false;
+    }
+    // Open the bank
+    std::ofstream bank(bankFilename.c_str(), std::ios::binary | std::ios::trunc);
+    if (bank.is_open() == false)
+    {
+        std::cout << "bool BankPacker::pack() failure. Could not create " << bankFilename << std::endl;
+        return false;
+    }
+    // Leave room for the header
+    SoundBankHeader header;
+    header.magic = SOUNDBANK_MAGIC;
+    header.version = SOUNDBANK_VERSION;
+    header.numberOfEntries = 0;
+    header.reserved = 0;
+    header.entriesOffset = 0;
+    header.namesOffset = 0;
+    bank.write((const char*)&header, sizeof(SoundBankHeader));
+    // Write the sound data
+    std::vector<SoundBankEntry> entries;
+    std::string names;
+    unsigned long long offset = sizeof(SoundBankHeader);
+    std::vector<char> data;
+    for (unsigned int i = 0; i < this->filenames.size(); i++)
+    {
+        // Grab the filename
+        const std::string& filename = this->filenames[i];
+        // Read it
+        if (this->readFile(filename, data) == false)
+            return false;
+        // Make the entry
+        SoundBankEntry entry;
+        entry.id = AssetIds::make(filename);
+        entry.dataSize = (unsigned int)data.size();
+        entry.nameOffset = (unsigned int)names.size();
+        // Read its format
+        if (this->probe(filename, data, entry) == false)
+            return false;
+        // Two paths with the same id would shadow each other
+        for (unsigned int j = 0; j < entries.size(); j++)
+        {
+            if (entries[j].id == entry.id)
+            {
+                std::cout << "bool BankPacker::pack() failure. " << filename << " has the same id as " << (names.c_str() + entries[j].nameOffset) << std::endl;
+                return false;
+            }
+        }
+        // Pad and align the data
+        for (unsigned int j = 0; j < SOUNDBANK_PADDING; j++)
+            bank.put(0);
+        offset += SOUNDBANK_PADDING;
+        while (offset % SOUNDBANK_ALIGNMENT != 0)
+        {
+            bank.put(0);
+            offset++;
+        }
+        // Write the data
+        entry.dataOffset = offset;
+        bank.write(&data[0], data.size());
+        offset += data.size();
+        // Pad after the data
+        for (unsigned int j = 0; j < SOUNDBANK_PADDING; j++)
+            bank.put(0);
+        offset += SOUNDBANK_PADDING;
+        // Keep the name and entry
+        names.append(filename.c_str(), filename.size() + 1);
+        entries.push_back(entry);
+    }
+    // Sort the entries so the BankLoader can binary search them
+    std::sort(entries.begin(), entries.end(), [](const SoundBankEntry& a, const SoundBankEntry& b) { return a.id < b.id; });
+    // Align the entries
+    while (offset % 8 != 0)
+    {
+        bank.put(0);
+        offset++;
+    }
+    // Write the entries
+    header.numberOfEntries = (unsigned int)entries.size();
+    header.entriesOffset = offset;
+    bank.write((const char*)&entries[0], entries.size() * sizeof(SoundBankEntry));
+    offset += entries.size() * sizeof(SoundBankEntry);
+    // Write the names
+    header.namesOffset = offset;
+    bank.write(names.c_str(), names.size());
+    // Write the finished header
+    bank.seekp(0);
+    bank.write((const char*)&header, sizeof(SoundBankHeader));
+    // Did everything make it to disk
+    if (bank.good() == false)
+    {
+        std::cout << "bool BankPacker::pack() failure. Could not write " << bankFilename << std::endl;
+        return false;
+    }
+    // Send a message to the console
+    std::cout << "SoundBank: " << bankFilename << " Packed with " << entries.size() << " sounds." << std::endl;
+    // Success
+    return true;
+}
+
+bool BankPacker::readFile(const std::string& filename, std::vector<char>& data)
+{
+    // Open the file
+    std::ifstream file(filename.c_str(), std::ios::binary | std::ios::ate);
+    if (file.is_open() == false)
+    {
+        std::cout << "bool BankPacker::readFile() failure. Could not open " << filename << std::endl;
+        return false;
+    }
+    // Grab the size
+    std::streamoff size = file.tellg();
+    if (size <= 0)
+    {
+        std::cout << "bool BankPacker::readFile() failure. " << filename << " is empty" << std::endl;
+        return false;
+    }
+    // Read it
+    data.resize((size_t)size);
+    file.seekg(0);
+    file.read(&data[0], size);
+    // Success
+    return file.good();
+}
+
+bool BankPacker::probe(const std::string& filename, std::vector<char>& data, SoundBankEntry& entry)
+{
+    // Open the data without decoding it
+    FMOD_CREATESOUNDEXINFO exinfo;
+    memset(&exinfo, 0, sizeof(FMOD_CREATESOUNDEXINFO));
+    exinfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+    exinfo.length = (unsigned int)data.size();
+    FMOD_SOUND* pFMODSound = 0;
+    FMOD_RESULT result = FMOD_System_CreateSound(FMODGlobals::pFMODSystem, &data[0], FMOD_OPENMEMORY | FMOD_OPENONLY, &exinfo, &pFMODSound);
+    if (result != FMOD_OK)
+    {
+        std::cout << "bool BankPacker::probe() failure. " << filename << " FMOD error! (" << FMOD_ErrorString(result) << ") " << std::endl;
+        return false;
+    }
+    // Read the format
+    FMOD_SOUND_TYPE soundType = FMOD_SOUND_TYPE_UNKNOWN;
+    FMOD_SOUND_FORMAT format = FMOD_SOUND_FORMAT_NONE;
+    int channels = 0;
+    FMOD_Sound_GetFormat(pFMODSound, &soundType, &format, &channels, 0);
+    float defaultFrequency = 0.0f;
+    FMOD_Sound_GetDefaults(pFMODSound, &defaultFrequency, 0);
+    unsigned int lengthInMilliseconds = 0;
+    FMOD_Sound_GetLength(pFMODSound, &lengthInMilliseconds, FMOD_TIMEUNIT_MS);
+    unsigned int lengthInPCM = 0;
+    FMOD_Sound_GetLength(pFMODSound, &lengthInPCM, FMOD_TIMEUNIT_PCM);
+    // Done with it
+    FMOD_Sound_Release(pFMODSound);
+    // Fill in the entry
+    entry.soundType = (int)soundType;
+    entry.format = (int)format;
+    entry.channels = channels;
+    entry.defaultFrequency = defaultFrequency;
+    entry.lengthInMilliseconds = lengthInMilliseconds;
+    entry.lengthInPCM = lengthInPCM;
+    // Success
+    return true;
+}
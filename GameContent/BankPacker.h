@@ -0,0 +1,82 @@
+/**
+  * @file   BankPacker.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  BankPacker packs sound files into one sound bank
+*/
+
+#ifndef BANKPACKER_H
+#define BANKPACKER_H
+
+// C++ Includes
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+#include <fmod_errors.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+
+// GAMECONTENT Includes
+#include "SoundBankFormat.h"
+
+/** The BankPacker class is the offline half of the sound bank. Add the
+    files, then pack: each file is opened once with FMOD_OPENONLY to read
+    its type, format, channels, frequency and length into the table of
+    contents, and its bytes are copied into the bank unchanged. The
+    AudioSystem must be initialised. A command line tool is just:
+
+        AudioSystem audioSystem;
+        audioSystem.init(32);
+        BankPacker bankPacker;
+        for (int i = 2; i < argc; i++)
+            bankPacker.addFile(argv[i]);
+        return (bankPacker.pack(argv[1]) == true) ? 0 : 1;
+**/
+class BankPacker
+{
+    // ****************************
+    // * CONSTRUCTOR / DESTRUCTOR *
+    // ****************************
+    public:
+        //! Constructor
+        BankPacker() {}
+        //! Destructor
+        virtual ~BankPacker() {}
+
+    // ********************
+    // * PACKER FUNCTIONS *
+    // ********************
+    public:
+        /** @brief addFile
+          * @param filename file to pack (it is keyed by AssetIds::make(filename),
+          * so use the path the game asks the AudioManager for) **/
+        virtual void addFile(const std::string& filename) { this->filenames.push_back(filename); }
+        /** @brief clear (forget the files) **/
+        virtual void clear() { this->filenames.clear(); }
+        /** @brief pack
+          * @param bankFilename bank to write
+          * @return true on success **/
+        virtual bool pack(const std::string& bankFilename);
+
+    protected:
+        /** @brief Read a whole file
+          * @return true on success **/
+        virtual bool readFile(const std::string& filename, std::vector<char>& data);
+        /** @brief Fill in the format fields of an entry by opening the data with FMOD
+          * @return true on success **/
+        virtual bool probe(const std::string& filename, std::vector<char>& data, SoundBankEntry& entry);
+
+    protected:
+        // Files to pack
+        std::vector<std::string> filenames;
+};
+
+#endif // BANKPACKER_H
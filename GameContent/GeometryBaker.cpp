@@ -0,0 +1,153 @@
+#include "GeometryBaker.h"
+
+bool GeometryBaker::addGeometry(const std::string& name, Geometry* pGeometry)
+{
+    // Validate the Geometry
+    if (pGeometry == 0 || pGeometry->getFMODGeometry() == 0)
+    {
+        std::cout << "bool GeometryBaker::addGeometry() failure. " << name << " has no geometry" << std::endl;
+        return false;
+    }
+    // Two names with the same id would shadow each other
+    AssetId id = AssetIds::make(name);
+    for (unsigned int i = 0; i < this->meshes.size(); i++)
+    {
+        if (this->meshes[i].mesh.id == id)
+        {
+            std::cout << "bool GeometryBaker::addGeometry() failure. " << name << " has the same id as " << this->meshes[i].name << std::endl;
+            return false;
+        }
+    }
+    // Save the mesh
+    BakedMesh bakedMesh;
+    bakedMesh.name = name;
+    bakedMesh.data.resize(pGeometry->getSaveSize());
+    if (bakedMesh.data.empty() == true || pGeometry->save(&(bakedMesh.data[0]), (int)bakedMesh.data.size()) == false)
+    {
+        std::cout << "bool GeometryBaker::addGeometry() failure. Could not save " << name << std::endl;
+        return false;
+    }
+    // Grab the transform and bounds FMOD has (the Geometry members are only set by its setters)
+    FMOD_GEOMETRY* pFMODGeometry = pGeometry->getFMODGeometry();
+    FMOD_VECTOR position = { 0.0f, 0.0f, 0.0f };
+    FMOD_VECTOR forward = { 0.0f, 0.0f, 1.0f };
+    FMOD_VECTOR up = { 0.0f, 1.0f, 0.0f };
+    FMOD_VECTOR scale = { 1.0f, 1.0f, 1.0f };
+    FMOD_Geometry_GetPosition(pFMODGeometry, &position);
+    FMOD_Geometry_GetRotation(pFMODGeometry, &forward, &up);
+    FMOD_Geometry_GetScale(pFMODGeometry, &scale);
+    FMOD_BOOL activeFlag = true;
+    FMOD_Geometry_GetActive(pFMODGeometry, &activeFlag);
+    // Fill in the entry
+    GeometryFileMesh& mesh = bakedMesh.mesh;
+    mesh.id = id;
+    mesh.dataOffset = 0;
+    mesh.dataSize = (unsigned int)bakedMesh.data.size();
+    mesh.nameOffset = 0;
+    mesh.numberOfPolygons = (unsigned int)pGeometry->getPolyCount();
+    mesh.activeFlag = (activeFlag != 0) ? 1 : 0;
+    mesh.position[0] = position.x;
+    mesh.position[1] = position.y;
+    mesh.position[2] = position.z;
+    mesh.forward[0] = forward.x;
+    mesh.forward[1] = forward.y;
+    mesh.forward[2] = forward.z;
+    mesh.up[0] = up.x;
+    mesh.up[1] = up.y;
+    mesh.up[2] = up.z;
+    mesh.scale[0] = scale.x;
+    mesh.scale[1] = scale.y;
+    mesh.scale[2] = scale.z;
+    FMOD_VECTOR minimum = position;
+    FMOD_VECTOR maximum = position;
+    pGeometry->getWorldBounds(minimum, maximum);
+    mesh.minimum[0] = minimum.x;
+    mesh.minimum[1] = minimum.y;
+    mesh.minimum[2] = minimum.z;
+    mesh.maximum[0] = maximum.x;
+    mesh.maximum[1] = maximum.y;
+    mesh.maximum[2] = maximum.z;
+    // Keep it
+    this->meshes.push_back(bakedMesh);
+    // Success
+    return true;
+}
+
+bool GeometryBaker::bake(const std::string& filename)
+{
+    // Validate the meshes
+    if (this->meshes.empty() == true)
+    {
+        std::cout << "bool GeometryBaker::bake() failure. No meshes to bake" << std::endl;
+        return false;
+    }
+    // Open the file
+    std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (file.is_open() == false)
+    {
+        std::cout << "bool GeometryBaker::bake() failure. Could not create " << filename << std::endl;
+        return false;
+    }
+    // Leave room for the header
+    GeometryFileHeader header;
+    header.magic = GEOMETRYFILE_MAGIC;
+    header.version = GEOMETRYFILE_VERSION;
+    header.numberOfMeshes = 0;
+    header.numberOfPolygons = 0;
+    header.meshesOffset = 0;
+    header.namesOffset = 0;
+    file.write((const char*)&header, sizeof(GeometryFileHeader));
+    // Write the mesh data
+    std::vector<GeometryFileMesh> entries;
+    std::string names;
+    unsigned long long offset = sizeof(GeometryFileHeader);
+    for (unsigned int i = 0; i < this->meshes.size(); i++)
+    {
+        // Grab the mesh
+        BakedMesh& bakedMesh = this->meshes[i];
+        // Align the data
+        while (offset % GEOMETRYFILE_ALIGNMENT != 0)
+        {
+            file.put(0);
+            offset++;
+        }
+        // Write the data
+        bakedMesh.mesh.dataOffset = offset;
+        bakedMesh.mesh.nameOffset = (unsigned int)names.size();
+        file.write(&(bakedMesh.data[0]), bakedMesh.data.size());
+        offset += bakedMesh.data.size();
+        // Keep the name and entry
+        names.append(bakedMesh.name.c_str(), bakedMesh.name.size() + 1);
+        entries.push_back(bakedMesh.mesh);
+        header.numberOfPolygons += bakedMesh.mesh.numberOfPolygons;
+    }
+    // Sort the entries so the GeometryLibrary can binary search them
+    std::sort(entries.begin(), entries.end(), [](const GeometryFileMesh& a, const GeometryFileMesh& b) { return a.id < b.id; });
+    // Align the entries
+    while (offset % 8 != 0)
+    {
+        file.put(0);
+        offset++;
+    }
+    // Write the entries
+    header.numberOfMeshes = (unsigned int)entries.size();
+    header.meshesOffset = offset;
+    file.write((const char*)&entries[0], entries.size() * sizeof(GeometryFileMesh));
+    offset += entries.size() * sizeof(GeometryFileMesh);
+    // Write the names
+    header.namesOffset = offset;
+    file.write(names.c_str(), names.size());
+    // Write the finished header
+    file.seekp(0);
+    file.write((const char*)&header, sizeof(GeometryFileHeader));
+    // Did everything make it to disk
+    if (file.good() == false)
+    {
+        std::cout << "bool GeometryBaker::bake() failure. Could not write " << filename << std::endl;
+        return false;
+    }
+    // Send a message to the console
+    std::cout << "Geometry: " << filename << " Baked with " << entries.size() << " meshes and " << header.numberOfPolygons << " polygons." << std::endl;
+    // Success
+    return true;
+}
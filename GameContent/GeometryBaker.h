@@ -0,0 +1,92 @@
+/**
+  * @file   GeometryBaker.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  GeometryBaker bakes Geometry meshes into one geometry file
+*/
+
+#ifndef GEOMETRYBAKER_H
+#define GEOMETRYBAKER_H
+
+// C++ Includes
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Geometry/Geometry.h"
+
+// GAMECONTENT Includes
+#include "GeometryFileFormat.h"
+
+/** The GeometryBaker class is the offline half of the geometry file.
+    Build each level mesh the slow way (create and addPolygon, then place
+    it), add it under the name the game will ask the GeometryLibrary for
+    and bake: every mesh is saved with FMOD_Geometry_Save along with its
+    transform, polygon count and active flag. The AudioSystem must be
+    initialised. A command line tool is just:
+
+        AudioSystem audioSystem;
+        audioSystem.init(32);
+        GeometryBaker geometryBaker;
+        for (int i = 2; i < argc; i++)
+        {
+            Geometry geometry;
+            buildLevelMesh(argv[i], geometry);
+            geometryBaker.addGeometry(argv[i], &geometry);
+        }
+        return (geometryBaker.bake(argv[1]) == true) ? 0 : 1;
+**/
+class GeometryBaker
+{
+    // ****************************
+    // * CONSTRUCTOR / DESTRUCTOR *
+    // ****************************
+    public:
+        //! Constructor
+        GeometryBaker() {}
+        //! Destructor
+        virtual ~GeometryBaker() {}
+
+    // *******************
+    // * BAKER FUNCTIONS *
+    // *******************
+    public:
+        /** @brief addGeometry
+          * Save the mesh and its transform now (the Geometry can go afterwards)
+          * @param name name of the mesh (it is keyed by AssetIds::make(name))
+          * @param pGeometry the Geometry
+          * @return true on success **/
+        virtual bool addGeometry(const std::string& name, Geometry* pGeometry);
+        /** @brief clear (forget the meshes) **/
+        virtual void clear() { this->meshes.clear(); }
+        /** @brief bake
+          * @param filename geometry file to write
+          * @return true on success **/
+        virtual bool bake(const std::string& filename);
+
+    protected:
+        // A mesh waiting to be baked
+        struct BakedMesh
+        {
+            // Name
+            std::string name;
+            // Entry (offsets are filled in by bake)
+            GeometryFileMesh mesh;
+            // FMOD_Geometry_Save data
+            std::vector<char> data;
+        };
+
+    protected:
+        // Meshes to bake
+        std::vector<BakedMesh> meshes;
+};
+
+#endif // GEOMETRYBAKER_H
@@ -0,0 +1,85 @@
+/**
+  * @file   GeometryFileFormat.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  On disk layout of a baked geometry file (written by
+  * GeometryBaker, read by GeometryLibrary)
+*/
+
+#ifndef GEOMETRYFILEFORMAT_H
+#define GEOMETRYFILEFORMAT_H
+
+// GAMECONTENT Includes
+#include "AssetId.h"
+
+/** A baked geometry file is one file laid out as:
+
+        GeometryFileHeader
+        mesh data       (each mesh as FMOD_Geometry_Save wrote it, its
+                         polygons and vertices in one block, 16 byte aligned)
+        GeometryFileMesh (numberOfMeshes of them, sorted by id)
+        names           (null terminated names the meshes point into)
+
+    Everything is little endian and every offset is from the start of the
+    file so the GeometryLibrary can hand the mesh data straight out of a
+    mapping to FMOD_System_LoadGeometry. The transform of each mesh is kept
+    beside it and set after the load, along with its world space bounds so
+    a GeometryStreamer knows where it is without loading it **/
+
+// "GEOM"
+const unsigned int GEOMETRYFILE_MAGIC = 0x4D4F4547;
+// Bump when the layout changes
+const unsigned int GEOMETRYFILE_VERSION = 2;
+// Mesh data alignment
+const unsigned int GEOMETRYFILE_ALIGNMENT = 16;
+
+/** Start of the file **/
+struct GeometryFileHeader
+{
+    // GEOMETRYFILE_MAGIC
+    unsigned int magic;
+    // GEOMETRYFILE_VERSION
+    unsigned int version;
+    // Number of meshes
+    unsigned int numberOfMeshes;
+    // Total polygons in the file
+    unsigned int numberOfPolygons;
+    // Offset of the first GeometryFileMesh
+    unsigned long long meshesOffset;
+    // Offset of the names
+    unsigned long long namesOffset;
+};
+
+/** One mesh in the file **/
+struct GeometryFileMesh
+{
+    // AssetId of the name the mesh was baked with
+    AssetId id;
+    // Offset of the mesh data
+    unsigned long long dataOffset;
+    // Size of the mesh data in bytes
+    unsigned int dataSize;
+    // Offset of the name from the start of the names
+    unsigned int nameOffset;
+    // Number of polygons
+    unsigned int numberOfPolygons;
+    // Active when loaded (0 or 1)
+    unsigned int activeFlag;
+    // Position
+    float position[3];
+    // Forward Vector
+    float forward[3];
+    // Up Vector
+    float up[3];
+    // Scale
+    float scale[3];
+    // World space bounds (so the mesh can be placed before it is loaded)
+    float minimum[3];
+    float maximum[3];
+};
+
+// The layout must not depend on the compiler
+static_assert(sizeof(GeometryFileHeader) == 32, "GeometryFileHeader must be 32 bytes");
+static_assert(sizeof(GeometryFileMesh) == 104, "GeometryFileMesh must be 104 bytes");
+
+#endif // GEOMETRYFILEFORMAT_H
@@ -0,0 +1,211 @@
+#include "GeometryLibrary.h"
+
+GeometryLibrary::GeometryLibrary()
+{
+    // Filename
+    this->filename.clear();
+    // Mapped data
+    this->pHeader = 0;
+    this->pMeshes = 0;
+    this->pNames = 0;
+    // Geometry
+    this->geometries.clear();
+    // Load Time
+    this->loadTime = 0.0f;
+}
+
+GeometryLibrary::~GeometryLibrary()
+{
+    // Release the meshes and unmap the file
+    this->unload();
+}
+
+bool GeometryLibrary::load(const std::string& filename, bool createFlag)
+{
+    // Time the load
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    // Unload any existing file
+    this->unload();
+    // Map the file
+    if (this->mappedFile.open(filename) == false)
+        return false;
+    // Grab the mapping
+    const unsigned char* pData = this->mappedFile.getData();
+    unsigned long long size = this->mappedFile.getSize();
+    // Validate the header
+    const GeometryFileHeader* pHeader = (const GeometryFileHeader*)pData;
+    if (size < sizeof(GeometryFileHeader) || pHeader->magic != GEOMETRYFILE_MAGIC || pHeader->version != GEOMETRYFILE_VERSION)
+    {
+        std::cout << "bool GeometryLibrary::load() failure. " << filename << " is not a version " << GEOMETRYFILE_VERSION << " geometry file" << std::endl;
+        this->mappedFile.close();
+        return false;
+    }
+    // Validate the meshes (offset first then the length left after it, so a huge offset cannot wrap around)
+    const GeometryFileMesh* pMeshes = (const GeometryFileMesh*)(pData + pHeader->meshesOffset);
+    bool truncatedFlag = (pHeader->meshesOffset > size || (unsigned long long)pHeader->numberOfMeshes * sizeof(GeometryFileMesh) > size - pHeader->meshesOffset || pHeader->namesOffset > size);
+    for (unsigned int i = 0; truncatedFlag == false && i < pHeader->numberOfMeshes; i++)
+    {
+        // The mesh block
+        truncatedFlag = (pMeshes[i].dataOffset > size || pMeshes[i].dataSize > size - pMeshes[i].dataOffset);
+        // The name (and its terminator)
+        unsigned long long nameStart = pHeader->namesOffset + pMeshes[i].nameOffset;
+        if (truncatedFlag == false)
+            truncatedFlag = (nameStart >= size || std::memchr(pData + nameStart, 0, (size_t)(size - nameStart)) == 0);
+    }
+    if (truncatedFlag == true)
+    {
+        std::cout << "bool GeometryLibrary::load() failure. " << filename << " is truncated" << std::endl;
+        this->mappedFile.close();
+        return false;
+    }
+    // Point into the mapping
+    this->pHeader = pHeader;
+    this->pMeshes = pMeshes;
+    this->pNames = (const char*)(pData + pHeader->namesOffset);
+    this->filename = filename;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->geometries.assign(pHeader->numberOfMeshes, (Geometry*)0);
+    }
+    // Create the meshes
+    if (createFlag == true)
+    {
+        for (unsigned int i = 0; i < pHeader->numberOfMeshes; i++)
+            this->createGeometry(i);
+    }
+    // How long did it take
+    this->loadTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    // Send a message to the console
+    std::cout << "Geometry: " << filename << " Loaded with " << pHeader->numberOfMeshes << " meshes in " << this->loadTime << "ms." << std::endl;
+    // Success
+    return true;
+}
+
+void GeometryLibrary::unload()
+{
+    // Release the meshes
+    std::vector<Geometry*> geometries;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        geometries.swap(this->geometries);
+    }
+    for (unsigned int i = 0; i < geometries.size(); i++)
+    {
+        if (geometries[i] == 0)
+            continue;
+        geometries[i]->release();
+        delete geometries[i];
+    }
+    // Forget the mapped data
+    this->pHeader = 0;
+    this->pMeshes = 0;
+    this->pNames = 0;
+    this->filename.clear();
+    // Unmap the file
+    this->mappedFile.close();
+}
+
+int GeometryLibrary::findMesh(AssetId id)
+{
+    // Nothing loaded
+    if (this->pHeader == 0)
+        return -1;
+    // Binary search the sorted meshes
+    int low = 0;
+    int high = (int)this->pHeader->numberOfMeshes - 1;
+    while (low <= high)
+    {
+        int middle = low + (high - low) / 2;
+        if (this->pMeshes[middle].id == id)
+            return middle;
+        if (this->pMeshes[middle].id < id)
+            low = middle + 1;
+        else
+            high = middle - 1;
+    }
+    // Not found
+    return -1;
+}
+
+Geometry* GeometryLibrary::createGeometry(unsigned int index)
+{
+    {
+        // Lock the Library
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // Validate the index
+        if (index >= this->geometries.size())
+            return 0;
+        // Already loaded
+        if (this->geometries[index] != 0)
+            return this->geometries[index];
+    }
+    // Load the mesh out of the mapping (without the lock, it is the slow part)
+    const GeometryFileMesh& mesh = this->pMeshes[index];
+    Geometry* pGeometry = new Geometry();
+    if (pGeometry->load(this->mappedFile.getData() + mesh.dataOffset, (int)mesh.dataSize) == false)
+    {
+        std::cout << "Geometry* GeometryLibrary::createGeometry() failure. Could not load " << this->getName(index) << std::endl;
+        delete pGeometry;
+        return 0;
+    }
+    // Place it
+    pGeometry->setPosition(mesh.position[0], mesh.position[1], mesh.position[2]);
+    pGeometry->setRotation(mesh.forward[0], mesh.forward[1], mesh.forward[2], mesh.up[0], mesh.up[1], mesh.up[2]);
+    pGeometry->setScale(mesh.scale[0], mesh.scale[1], mesh.scale[2]);
+    pGeometry->setActive(mesh.activeFlag != 0);
+    // Keep it (unless another thread got there first)
+    bool keptFlag = false;
+    Geometry* pExisting = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (index < this->geometries.size())
+        {
+            pExisting = this->geometries[index];
+            if (pExisting == 0)
+            {
+                this->geometries[index] = pGeometry;
+                keptFlag = true;
+            }
+        }
+    }
+    if (keptFlag == false)
+    {
+        pGeometry->release();
+        delete pGeometry;
+        return pExisting;
+    }
+    // return the Geometry
+    return pGeometry;
+}
+
+void GeometryLibrary::releaseGeometry(unsigned int index)
+{
+    // Take the mesh out
+    Geometry* pGeometry = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (index >= this->geometries.size() || this->geometries[index] == 0)
+            return;
+        pGeometry = this->geometries[index];
+        this->geometries[index] = 0;
+    }
+    // Release the mesh
+    pGeometry->release();
+    delete pGeometry;
+}
+
+Geometry* GeometryLibrary::getGeometry(unsigned int index)
+{
+    // Lock the Library
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the Geometry
+    return (index < this->geometries.size()) ? this->geometries[index] : 0;
+}
+
+Geometry* GeometryLibrary::findGeometry(const std::string& name)
+{
+    // Find the mesh
+    int index = this->findMesh(AssetIds::make(name));
+    // return its Geometry
+    return (index == -1) ? 0 : this->getGeometry((unsigned int)index);
+}
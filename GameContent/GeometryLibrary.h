@@ -0,0 +1,131 @@
+/**
+  * @file   GeometryLibrary.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  GeometryLibrary maps a baked geometry file and loads its
+  * meshes into FMOD straight out of the mapping
+*/
+
+#ifndef GEOMETRYLIBRARY_H
+#define GEOMETRYLIBRARY_H
+
+// C++ Includes
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Geometry/Geometry.h"
+
+// GAMECONTENT Includes
+#include "GeometryFileFormat.h"
+#include "MappedFile.h"
+
+/** The GeometryLibrary class maps a file written by the GeometryBaker
+    (read only) and hands each mesh's block to FMOD_System_LoadGeometry
+    where it sits in the mapping, so a level's meshes are loaded without
+    rebuilding them a polygon at a time and without reading the file into
+    a buffer first. Each mesh gets a Geometry placed with its baked
+    transform. load creates every mesh straight away, or none of them so
+    the meshes can be created and released one at a time (the mapping stays
+    open for that), which a GeometryStreamer does from its loader thread.
+    Meshes are found by AssetId (a binary search over the mapped entries)
+    or by index **/
+class GeometryLibrary
+{
+    // ****************************
+    // * CONSTRUCTOR / DESTRUCTOR *
+    // ****************************
+    public:
+        //! Constructor
+        GeometryLibrary();
+        //! Destructor
+        virtual ~GeometryLibrary();
+
+    protected:
+        //! GeometryLibrary Copy constructor
+        GeometryLibrary(const GeometryLibrary& other) {}
+
+    // *********************
+    // * LIBRARY FUNCTIONS *
+    // *********************
+    public:
+        /** @brief load
+          * @param filename geometry file to map
+          * @param createFlag true to create every mesh now, false to leave them to createGeometry
+          * @return true on success **/
+        virtual bool load(const std::string& filename, bool createFlag = true);
+        /** @brief unload (releases every mesh and unmaps the file) **/
+        virtual void unload();
+        /** @brief isLoaded
+          * @return true if a file is mapped **/
+        virtual bool isLoaded() { return (this->pHeader != 0); }
+        /** @brief getFilename
+          * @return filename of the geometry file **/
+        virtual std::string getFilename() { return this->filename; }
+        /** @brief getNumberOfMeshes
+          * @return number of meshes in the file **/
+        virtual unsigned int getNumberOfMeshes() { return (this->pHeader != 0) ? this->pHeader->numberOfMeshes : 0; }
+        /** @brief getMesh
+          * @param index 0 to getNumberOfMeshes() - 1
+          * @return the entry (position, polygon count and so on) **/
+        virtual const GeometryFileMesh* getMesh(unsigned int index) { return &(this->pMeshes[index]); }
+        /** @brief findMesh
+          * @param id AssetId of the mesh name
+          * @return index of the mesh or -1 if the file does not have it **/
+        virtual int findMesh(AssetId id);
+        /** @brief getName
+          * @param index 0 to getNumberOfMeshes() - 1
+          * @return the name the mesh was baked with **/
+        virtual const char* getName(unsigned int index) { return this->pNames + this->pMeshes[index].nameOffset; }
+        /** @brief createGeometry
+          * Load a mesh into FMOD (nothing happens if it already is)
+          * @param index 0 to getNumberOfMeshes() - 1
+          * @return the Geometry or 0 on failure **/
+        virtual Geometry* createGeometry(unsigned int index);
+        /** @brief releaseGeometry
+          * @param index 0 to getNumberOfMeshes() - 1 **/
+        virtual void releaseGeometry(unsigned int index);
+        /** @brief getGeometry
+          * @param index 0 to getNumberOfMeshes() - 1
+          * @return the Geometry or 0 if the mesh is not loaded **/
+        virtual Geometry* getGeometry(unsigned int index);
+        /** @brief findGeometry
+          * @param name name the mesh was baked with
+          * @return the Geometry or 0 if the mesh is not loaded **/
+        virtual Geometry* findGeometry(const std::string& name);
+        /** @brief getNumberOfPolygons
+          * @return polygons in the file **/
+        virtual unsigned int getNumberOfPolygons() { return (this->pHeader != 0) ? this->pHeader->numberOfPolygons : 0; }
+        /** @brief getLoadTime
+          * @return milliseconds the last load took **/
+        virtual float getLoadTime() { return this->loadTime; }
+
+    protected:
+        // The mapped file
+        MappedFile mappedFile;
+        // Filename of the geometry file
+        std::string filename;
+        // Header (in the mapping)
+        const GeometryFileHeader* pHeader;
+        // Meshes (in the mapping)
+        const GeometryFileMesh* pMeshes;
+        // Names (in the mapping)
+        const char* pNames;
+        // Geometry of each mesh (0 while not loaded)
+        std::vector<Geometry*> geometries;
+        // Guards geometries (meshes are created and released from a loader thread)
+        std::mutex mutex;
+        // Milliseconds the last load took
+        float loadTime;
+};
+
+#endif // GEOMETRYLIBRARY_H
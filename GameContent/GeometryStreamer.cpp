@@ -0,0 +1,631 @@
+#include "GeometryStreamer.h"
+
+GeometryStreamer::GeometryStreamer()
+{
+    // Meshes
+    this->meshes.clear();
+    this->freeMeshes.clear();
+    this->cells.clear();
+    this->residentMeshes.clear();
+    this->nextResidentMeshes.clear();
+    this->candidates.clear();
+    this->jobs.clear();
+    // Settings
+    this->cellSize = 50.0f;
+    this->radius = 100.0f;
+    this->unloadRadius = 150.0f;
+    this->maxActivePolygons = 50000;
+    // Nothing in the cells yet
+    this->largestExtent = 0.0f;
+    this->updateCount = 0;
+    // Stats
+    this->numberOfActiveMeshes = 0;
+    this->numberOfActivePolygons = 0;
+    this->numberOfLoadedMeshes = 0;
+    // Loader Thread
+    this->loaderThreadRunningFlag.store(false);
+}
+
+GeometryStreamer::~GeometryStreamer()
+{
+    // Stop the loader and let go of everything
+    this->stopLoaderThread();
+    this->clear();
+}
+
+void GeometryStreamer::update(const FMOD_VECTOR* pListenerPositions, int numberOfListeners)
+{
+    {
+        // Lock the Streamer
+        std::lock_guard<std::mutex> lock(this->mutex);
+        // New update
+        this->updateCount++;
+        this->candidates.clear();
+        this->nextResidentMeshes.clear();
+        // Find the meshes near the listeners
+        if (pListenerPositions == 0)
+            numberOfListeners = 0;
+        float keepRadius = std::max(this->radius, this->unloadRadius);
+        int cellReach = (int)std::ceil((keepRadius + this->largestExtent) / this->cellSize);
+        float cellsPerListener = (float)(2 * cellReach + 1) * (float)(2 * cellReach + 1) * (float)(2 * cellReach + 1);
+        bool visitAllFlag = (cellsPerListener * (float)numberOfListeners >= (float)this->cells.size());
+        std::unordered_map< unsigned long long, std::vector<int> >::iterator cell = this->cells.begin();
+        for (int l = 0; l < numberOfListeners; l++)
+        {
+            // Cells within reach of the listener (or every cell when that is fewer)
+            int x = this->getCell(pListenerPositions[l].x);
+            int y = this->getCell(pListenerPositions[l].y);
+            int z = this->getCell(pListenerPositions[l].z);
+            int numberOfCells = (visitAllFlag == true) ? (int)this->cells.size() : (int)cellsPerListener;
+            for (int c = 0; c < numberOfCells; c++)
+            {
+                // Next cell
+                const std::vector<int>* pCell = 0;
+                if (visitAllFlag == true)
+                {
+                    pCell = &(cell->second);
+                    ++cell;
+                }
+                else
+                {
+                    int width = 2 * cellReach + 1;
+                    std::unordered_map< unsigned long long, std::vector<int> >::iterator found = this->cells.find(this->getCellKey(x - cellReach + c % width, y - cellReach + (c / width) % width, z - cellReach + c / (width * width)));
+                    if (found == this->cells.end())
+                        continue;
+                    pCell = &(found->second);
+                }
+                // Meshes in the cell
+                for (unsigned int i = 0; i < pCell->size(); i++)
+                {
+                    // Each mesh once
+                    int index = (*pCell)[i];
+                    StreamedMesh& mesh = this->meshes[index];
+                    if (mesh.visitedUpdate == this->updateCount)
+                        continue;
+                    // Closest listener
+                    float distance = FLT_MAX;
+                    for (int k = 0; k < numberOfListeners; k++)
+                        distance = std::min(distance, this->getDistance(mesh, pListenerPositions[k]));
+                    // Out of reach
+                    if (distance > keepRadius)
+                        continue;
+                    mesh.visitedUpdate = this->updateCount;
+                    // Close enough to switch on
+                    if (distance <= this->radius)
+                    {
+                        MeshCandidate candidate;
+                        candidate.index = index;
+                        candidate.distance = distance;
+                        this->candidates.push_back(candidate);
+                    }
+                }
+            }
+            // Every cell has been visited
+            if (visitAllFlag == true)
+                break;
+        }
+        // Time of this update (for failed loads)
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        // Closest first
+        std::sort(this->candidates.begin(), this->candidates.end(), [](const MeshCandidate& a, const MeshCandidate& b) { return a.distance < b.distance; });
+        // Hand out the polygon budget
+        int budgetUsed = 0;
+        this->numberOfActiveMeshes = 0;
+        this->numberOfActivePolygons = 0;
+        for (unsigned int i = 0; i < this->candidates.size(); i++)
+        {
+            // Grab the mesh
+            int index = this->candidates[i].index;
+            StreamedMesh& mesh = this->meshes[index];
+            // Too big for what is left (something smaller further away may fit)
+            if (this->maxActivePolygons > 0 && budgetUsed + mesh.numberOfPolygons > this->maxActivePolygons)
+                continue;
+            budgetUsed += mesh.numberOfPolygons;
+            mesh.wantedUpdate = this->updateCount;
+            this->nextResidentMeshes.push_back(index);
+            // A library mesh which is not in FMOD yet is loaded (or its release called off)
+            if (mesh.pGeometryLibrary != 0)
+            {
+                if (mesh.state == MESH_STATE_UNLOADING && this->cancelJob(index) == true)
+                    mesh.state = MESH_STATE_LOADED;
+                if (mesh.state == MESH_STATE_FAILED && now >= mesh.retryTime)
+                    mesh.state = MESH_STATE_UNLOADED;
+                if (mesh.state == MESH_STATE_UNLOADED)
+                {
+                    LoaderJob job;
+                    job.index = index;
+                    job.loadFlag = true;
+                    this->jobs.push_back(job);
+                    mesh.state = MESH_STATE_LOADING;
+                }
+                if (mesh.state != MESH_STATE_LOADED)
+                    continue;
+            }
+            // Switch it on
+            this->setMeshActive(mesh, true);
+            this->numberOfActiveMeshes++;
+            this->numberOfActivePolygons += mesh.numberOfPolygons;
+        }
+        // Switch off (and release) what is no longer wanted
+        for (unsigned int i = 0; i < this->residentMeshes.size(); i++)
+        {
+            // Grab the mesh
+            int index = this->residentMeshes[i];
+            StreamedMesh& mesh = this->meshes[index];
+            // Still wanted (already kept)
+            if (mesh.wantedUpdate == this->updateCount)
+                continue;
+            // Switch it off
+            this->setMeshActive(mesh, false);
+            // An added Geometry is done with
+            if (mesh.pGeometryLibrary == 0)
+                continue;
+            // A library mesh stays in FMOD until every listener is beyond the unload radius
+            if (mesh.visitedUpdate != this->updateCount)
+            {
+                if (mesh.state == MESH_STATE_LOADING && this->cancelJob(index) == true)
+                    mesh.state = MESH_STATE_UNLOADED;
+                if (mesh.state == MESH_STATE_LOADED)
+                {
+                    LoaderJob job;
+                    job.index = index;
+                    job.loadFlag = false;
+                    this->jobs.push_back(job);
+                    mesh.state = MESH_STATE_UNLOADING;
+                }
+            }
+            // Keep track of it until it has gone
+            if (mesh.state != MESH_STATE_UNLOADED && mesh.state != MESH_STATE_FAILED)
+                this->nextResidentMeshes.push_back(index);
+        }
+        // The wanted and loaded meshes are the resident ones now
+        this->residentMeshes.swap(this->nextResidentMeshes);
+    }
+    // Hand the jobs to the loader
+    if (this->loaderThreadRunningFlag.load() == true)
+    {
+        this->loaderCondition.notify_one();
+        return;
+    }
+    // Or do them here without one
+    while (this->runJob() == true) {}
+}
+
+bool GeometryStreamer::startLoaderThread()
+{
+    // Already running
+    if (this->loaderThreadRunningFlag.load() == true)
+        return true;
+    // Flag the thread as running
+    this->loaderThreadRunningFlag.store(true);
+    // Start the thread
+    this->loaderThread = std::thread(&GeometryStreamer::loaderThreadMain, this);
+    // Success
+    return true;
+}
+
+void GeometryStreamer::stopLoaderThread()
+{
+    // Tell the thread to finish
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->loaderThreadRunningFlag.store(false);
+    }
+    this->loaderCondition.notify_one();
+    // Wait for it
+    if (this->loaderThread.joinable() == true)
+        this->loaderThread.join();
+}
+
+void GeometryStreamer::clear()
+{
+    // Wait for any job in progress then lock the Streamer
+    std::lock_guard<std::mutex> loaderLock(this->loaderMutex);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Forget the jobs
+    this->jobs.clear();
+    // Let go of every mesh
+    for (unsigned int i = 0; i < this->meshes.size(); i++)
+    {
+        if (this->meshes[i].usedFlag == true)
+            this->removeMesh((int)i);
+    }
+    // Forget everything
+    this->meshes.clear();
+    this->freeMeshes.clear();
+    this->cells.clear();
+    this->residentMeshes.clear();
+    this->largestExtent = 0.0f;
+    // Reset Stats
+    this->numberOfActiveMeshes = 0;
+    this->numberOfActivePolygons = 0;
+    this->numberOfLoadedMeshes = 0;
+}
+
+void GeometryStreamer::addGeometry(Geometry* pGeometry)
+{
+    // Validate the Geometry
+    if (pGeometry == 0)
+        return;
+    // Lock the Streamer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Only add a Geometry once
+    for (unsigned int i = 0; i < this->meshes.size(); i++)
+    {
+        if (this->meshes[i].usedFlag == true && this->meshes[i].pGeometry == pGeometry && this->meshes[i].pGeometryLibrary == 0)
+            return;
+    }
+    // Take its bounds
+    StreamedMesh mesh;
+    mesh.pGeometry = pGeometry;
+    mesh.pGeometryLibrary = 0;
+    mesh.libraryIndex = 0;
+    mesh.minimum.x = pGeometry->getX();
+    mesh.minimum.y = pGeometry->getY();
+    mesh.minimum.z = pGeometry->getZ();
+    mesh.maximum = mesh.minimum;
+    pGeometry->getWorldBounds(mesh.minimum, mesh.maximum);
+    mesh.numberOfPolygons = pGeometry->getPolyCount();
+    mesh.state = MESH_STATE_LOADED;
+    mesh.activeFlag = pGeometry->isActive();
+    // Add it (an active one is switched off by the next update unless it is wanted)
+    int index = this->addMesh(mesh);
+    if (mesh.activeFlag == true)
+        this->residentMeshes.push_back(index);
+}
+
+void GeometryStreamer::removeGeometry(Geometry* pGeometry)
+{
+    // Lock the Streamer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the Geometry
+    for (unsigned int i = 0; i < this->meshes.size(); i++)
+    {
+        if (this->meshes[i].usedFlag == true && this->meshes[i].pGeometry == pGeometry && this->meshes[i].pGeometryLibrary == 0)
+        {
+            // Remove it
+            this->removeMesh((int)i);
+            return;
+        }
+    }
+}
+
+void GeometryStreamer::moveGeometry(Geometry* pGeometry)
+{
+    // Lock the Streamer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Find the Geometry
+    for (unsigned int i = 0; i < this->meshes.size(); i++)
+    {
+        StreamedMesh& mesh = this->meshes[i];
+        if (mesh.usedFlag == true && mesh.pGeometry == pGeometry && mesh.pGeometryLibrary == 0)
+        {
+            // Take its bounds again and move it cell
+            this->eraseMesh((int)i);
+            pGeometry->getWorldBounds(mesh.minimum, mesh.maximum);
+            mesh.numberOfPolygons = pGeometry->getPolyCount();
+            this->insertMesh((int)i);
+            return;
+        }
+    }
+}
+
+void GeometryStreamer::addLibrary(GeometryLibrary* pGeometryLibrary)
+{
+    // Validate the library
+    if (pGeometryLibrary == 0 || pGeometryLibrary->isLoaded() == false)
+    {
+        std::cout << "void GeometryStreamer::addLibrary() failure. The library is not loaded" << std::endl;
+        return;
+    }
+    // Lock the Streamer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Only add a library once
+    for (unsigned int i = 0; i < this->meshes.size(); i++)
+    {
+        if (this->meshes[i].usedFlag == true && this->meshes[i].pGeometryLibrary == pGeometryLibrary)
+            return;
+    }
+    // Add each of its meshes by its baked bounds
+    for (unsigned int i = 0; i < pGeometryLibrary->getNumberOfMeshes(); i++)
+    {
+        const GeometryFileMesh* pFileMesh = pGeometryLibrary->getMesh(i);
+        StreamedMesh mesh;
+        mesh.pGeometry = pGeometryLibrary->getGeometry(i);
+        mesh.pGeometryLibrary = pGeometryLibrary;
+        mesh.libraryIndex = i;
+        mesh.minimum.x = pFileMesh->minimum[0];
+        mesh.minimum.y = pFileMesh->minimum[1];
+        mesh.minimum.z = pFileMesh->minimum[2];
+        mesh.maximum.x = pFileMesh->maximum[0];
+        mesh.maximum.y = pFileMesh->maximum[1];
+        mesh.maximum.z = pFileMesh->maximum[2];
+        mesh.numberOfPolygons = (int)pFileMesh->numberOfPolygons;
+        mesh.state = (mesh.pGeometry != 0) ? MESH_STATE_LOADED : MESH_STATE_UNLOADED;
+        mesh.activeFlag = (mesh.pGeometry != 0) ? mesh.pGeometry->isActive() : false;
+        // Add it (a loaded one is released by the next update unless it is near)
+        int index = this->addMesh(mesh);
+        if (mesh.state == MESH_STATE_LOADED)
+        {
+            this->residentMeshes.push_back(index);
+            this->numberOfLoadedMeshes++;
+        }
+    }
+}
+
+void GeometryStreamer::removeLibrary(GeometryLibrary* pGeometryLibrary)
+{
+    // Wait for any job in progress then lock the Streamer
+    std::lock_guard<std::mutex> loaderLock(this->loaderMutex);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Remove each of its meshes
+    for (unsigned int i = 0; i < this->meshes.size(); i++)
+    {
+        if (this->meshes[i].usedFlag == true && this->meshes[i].pGeometryLibrary == pGeometryLibrary)
+        {
+            this->cancelJob((int)i);
+            this->removeMesh((int)i);
+        }
+    }
+}
+
+void GeometryStreamer::setCellSize(float cellSize)
+{
+    // Validate the cell size
+    if (cellSize <= 0.0f)
+    {
+        std::cout << "void GeometryStreamer::setCellSize() failure. cellSize must be above 0" << std::endl;
+        return;
+    }
+    // Lock the Streamer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // Set Cell Size and sort the meshes into the new cells
+    this->cellSize = cellSize;
+    this->cells.clear();
+    for (unsigned int i = 0; i < this->meshes.size(); i++)
+    {
+        if (this->meshes[i].usedFlag == true)
+            this->insertMesh((int)i);
+    }
+}
+
+int GeometryStreamer::getNumberOfMeshes()
+{
+    // Lock the Streamer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of meshes in use
+    return (int)(this->meshes.size() - this->freeMeshes.size());
+}
+
+int GeometryStreamer::getNumberOfPendingJobs()
+{
+    // Lock the Streamer
+    std::lock_guard<std::mutex> lock(this->mutex);
+    // return the number of jobs
+    return (int)this->jobs.size();
+}
+
+int GeometryStreamer::addMesh(const StreamedMesh& mesh)
+{
+    // Reuse a free slot if there is one
+    int index = 0;
+    if (this->freeMeshes.empty() == false)
+    {
+        index = this->freeMeshes.back();
+        this->freeMeshes.pop_back();
+        this->meshes[index] = mesh;
+    }
+    else
+    {
+        index = (int)this->meshes.size();
+        this->meshes.push_back(mesh);
+    }
+    // Fill in the bookkeeping
+    StreamedMesh& added = this->meshes[index];
+    added.usedFlag = true;
+    added.visitedUpdate = 0;
+    added.wantedUpdate = 0;
+    added.numberOfFailures = 0;
+    added.retryTime = std::chrono::steady_clock::time_point();
+    // Put it in its cell
+    this->insertMesh(index);
+    // return the index
+    return index;
+}
+
+void GeometryStreamer::removeMesh(int index)
+{
+    // Grab the mesh
+    StreamedMesh& mesh = this->meshes[index];
+    // An added Geometry goes back to being switched on
+    if (mesh.pGeometryLibrary == 0)
+        this->setMeshActive(mesh, true);
+    // A streamed mesh is released
+    if (mesh.pGeometryLibrary != 0 && mesh.pGeometry != 0)
+    {
+        mesh.pGeometryLibrary->releaseGeometry(mesh.libraryIndex);
+        this->numberOfLoadedMeshes--;
+    }
+    // Take it out of its cell and the resident meshes
+    this->eraseMesh(index);
+    std::vector<int>::iterator iter = std::find(this->residentMeshes.begin(), this->residentMeshes.end(), index);
+    if (iter != this->residentMeshes.end())
+        this->residentMeshes.erase(iter);
+    // Free the slot
+    mesh.pGeometry = 0;
+    mesh.pGeometryLibrary = 0;
+    mesh.usedFlag = false;
+    this->freeMeshes.push_back(index);
+    // Work out how far the meshes left reach out of their cells
+    this->largestExtent = 0.0f;
+    for (unsigned int i = 0; i < this->meshes.size(); i++)
+    {
+        if (this->meshes[i].usedFlag == false)
+            continue;
+        float xExtent = this->meshes[i].maximum.x - this->meshes[i].minimum.x;
+        float yExtent = this->meshes[i].maximum.y - this->meshes[i].minimum.y;
+        float zExtent = this->meshes[i].maximum.z - this->meshes[i].minimum.z;
+        this->largestExtent = std::max(this->largestExtent, 0.5f * std::sqrt(xExtent * xExtent + yExtent * yExtent + zExtent * zExtent));
+    }
+}
+
+unsigned long long GeometryStreamer::getCellKey(int x, int y, int z)
+{
+    // Pack 21 bits per axis (cells either side of the origin)
+    unsigned long long xKey = (unsigned long long)(x + (1 << 20)) & 0x1FFFFF;
+    unsigned long long yKey = (unsigned long long)(y + (1 << 20)) & 0x1FFFFF;
+    unsigned long long zKey = (unsigned long long)(z + (1 << 20)) & 0x1FFFFF;
+    // return the key
+    return (xKey << 42) | (yKey << 21) | zKey;
+}
+
+int GeometryStreamer::getCell(float value)
+{
+    // return the cell holding the value
+    return (int)std::floor(value / this->cellSize);
+}
+
+void GeometryStreamer::insertMesh(int index)
+{
+    // Grab the mesh
+    StreamedMesh& mesh = this->meshes[index];
+    // Cell holding the centre of its bounds
+    int x = this->getCell((mesh.minimum.x + mesh.maximum.x) * 0.5f);
+    int y = this->getCell((mesh.minimum.y + mesh.maximum.y) * 0.5f);
+    int z = this->getCell((mesh.minimum.z + mesh.maximum.z) * 0.5f);
+    mesh.cellKey = this->getCellKey(x, y, z);
+    this->cells[mesh.cellKey].push_back(index);
+    // How far it reaches out of the cell
+    float xExtent = mesh.maximum.x - mesh.minimum.x;
+    float yExtent = mesh.maximum.y - mesh.minimum.y;
+    float zExtent = mesh.maximum.z - mesh.minimum.z;
+    this->largestExtent = std::max(this->largestExtent, 0.5f * std::sqrt(xExtent * xExtent + yExtent * yExtent + zExtent * zExtent));
+}
+
+void GeometryStreamer::eraseMesh(int index)
+{
+    // Find its cell
+    std::unordered_map< unsigned long long, std::vector<int> >::iterator cell = this->cells.find(this->meshes[index].cellKey);
+    if (cell == this->cells.end())
+        return;
+    // Swap with the last in the cell and remove
+    std::vector<int>& cellMeshes = cell->second;
+    for (unsigned int i = 0; i < cellMeshes.size(); i++)
+    {
+        if (cellMeshes[i] == index)
+        {
+            cellMeshes[i] = cellMeshes.back();
+            cellMeshes.pop_back();
+            break;
+        }
+    }
+    // Empty cells go
+    if (cellMeshes.empty() == true)
+        this->cells.erase(cell);
+}
+
+float GeometryStreamer::getDistance(const StreamedMesh& mesh, const FMOD_VECTOR& position)
+{
+    // Distance outside the bounds on each axis
+    float dx = std::max(std::max(mesh.minimum.x - position.x, position.x - mesh.maximum.x), 0.0f);
+    float dy = std::max(std::max(mesh.minimum.y - position.y, position.y - mesh.maximum.y), 0.0f);
+    float dz = std::max(std::max(mesh.minimum.z - position.z, position.z - mesh.maximum.z), 0.0f);
+    // return the distance
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+void GeometryStreamer::setMeshActive(StreamedMesh& mesh, bool activeFlag)
+{
+    // Nothing to do
+    if (mesh.activeFlag == activeFlag || mesh.pGeometry == 0)
+        return;
+    // Switch it
+    mesh.pGeometry->setActive(activeFlag);
+    mesh.activeFlag = activeFlag;
+}
+
+bool GeometryStreamer::cancelJob(int index)
+{
+    // Find a job for the mesh still waiting
+    for (std::deque<LoaderJob>::iterator iter = this->jobs.begin(); iter != this->jobs.end(); ++iter)
+    {
+        if (iter->index == index)
+        {
+            // Call it off
+            this->jobs.erase(iter);
+            return true;
+        }
+    }
+    // The loader already has it (or there was none)
+    return false;
+}
+
+bool GeometryStreamer::runJob()
+{
+    // Only one job at a time
+    std::lock_guard<std::mutex> loaderLock(this->loaderMutex);
+    // Take the next job
+    LoaderJob job;
+    GeometryLibrary* pGeometryLibrary = 0;
+    unsigned int libraryIndex = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->jobs.empty() == true)
+            return false;
+        job = this->jobs.front();
+        this->jobs.pop_front();
+        pGeometryLibrary = this->meshes[job.index].pGeometryLibrary;
+        libraryIndex = this->meshes[job.index].libraryIndex;
+    }
+    // Load the mesh (switched off until an update wants it) or release it
+    Geometry* pGeometry = 0;
+    if (job.loadFlag == true)
+    {
+        pGeometry = pGeometryLibrary->createGeometry(libraryIndex);
+        if (pGeometry != 0)
+            pGeometry->setActive(false);
+    }
+    else
+    {
+        pGeometryLibrary->releaseGeometry(libraryIndex);
+    }
+    // Tell the updates
+    std::lock_guard<std::mutex> lock(this->mutex);
+    StreamedMesh& mesh = this->meshes[job.index];
+    mesh.pGeometry = pGeometry;
+    mesh.activeFlag = false;
+    mesh.state = (pGeometry != 0) ? MESH_STATE_LOADED : MESH_STATE_UNLOADED;
+    this->numberOfLoadedMeshes += (job.loadFlag == true) ? ((pGeometry != 0) ? 1 : 0) : -1;
+    // A failed load waits (longer each time) before it is tried again
+    if (job.loadFlag == true)
+    {
+        if (pGeometry != 0)
+        {
+            mesh.numberOfFailures = 0;
+        }
+        else
+        {
+            int delay = GEOMETRYSTREAMER_RETRY_DELAY << std::min(mesh.numberOfFailures, 16);
+            mesh.numberOfFailures++;
+            mesh.retryTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::min(delay, GEOMETRYSTREAMER_MAX_RETRY_DELAY));
+            mesh.state = MESH_STATE_FAILED;
+        }
+    }
+    // A job was done
+    return true;
+}
+
+void GeometryStreamer::loaderThreadMain()
+{
+    // Keep loading until we are told to stop
+    while (this->loaderThreadRunningFlag.load() == true)
+    {
+        // Wait for work
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->loaderCondition.wait(lock, [this]() { return (this->jobs.empty() == false || this->loaderThreadRunningFlag.load() == false); });
+        }
+        // Do it
+        while (this->loaderThreadRunningFlag.load() == true && this->runJob() == true) {}
+    }
+}
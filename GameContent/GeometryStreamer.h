@@ -0,0 +1,313 @@
+/**
+  * @file   GeometryStreamer.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  GeometryStreamer keeps only the Geometry near the listeners
+  * active (and loaded) within a polygon budget
+*/
+
+#ifndef GEOMETRYSTREAMER_H
+#define GEOMETRYSTREAMER_H
+
+// C++ Includes
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// FMOD Includes
+#include <fmod.h>
+#include <fmod_common.h>
+
+// GAMEAUDIO Includes
+#include "FMODGlobals.h"
+#include "Geometry/Geometry.h"
+
+// GAMECONTENT Includes
+#include "GeometryLibrary.h"
+
+// Milliseconds before a mesh which failed to load is tried again (doubled each time it fails)
+const int GEOMETRYSTREAMER_RETRY_DELAY = 1000;
+// Longest wait before a mesh which failed to load is tried again in milliseconds
+const int GEOMETRYSTREAMER_MAX_RETRY_DELAY = 60000;
+
+/** The GeometryStreamer sorts meshes into cubic world cells by the centre
+    of their bounds. Two kinds of mesh can be added: a Geometry the game
+    already has (which is only switched on and off) and the meshes of a
+    GeometryLibrary loaded without creating them (which are loaded into FMOD
+    when a listener comes near and released again when every listener has
+    gone). Each update the cells within reach of the listeners are visited,
+    the meshes within the radius are ranked closest first and switched on
+    until the active polygon budget is spent, and everything else is switched
+    off. Loads and releases run on a loader thread when one is started (on
+    the calling thread during update otherwise) so a mesh appears a few
+    updates after it is wanted instead of stalling the update. Meshes keep
+    loaded out to the unload radius so walking back and forth across the
+    edge does not load them over and over. A mesh which fails to load is
+    left alone for a while (longer each time it fails) rather than being
+    tried again every update. The cost of occlusion then follows what is
+    near the listeners rather than the size of the map **/
+class GeometryStreamer
+{
+    // ******************************
+    // * CONSTRUCTORS / DESTRUCTORS *
+    // ******************************
+    public:
+        //! Default Constructor
+        GeometryStreamer();
+        //! Destructor
+        virtual ~GeometryStreamer();
+
+    protected:
+        //! GeometryStreamer Copy constructor
+        GeometryStreamer(const GeometryStreamer& other) {}
+
+    // ************************
+    // * OVERLOADED OPERATORS *
+    // ************************
+    public:
+        // No functions
+
+    protected:
+        //! GeometryStreamer Assignment operator
+        GeometryStreamer& operator=(const GeometryStreamer& other) { return *this; }
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief update
+          * Switch meshes on and off (and queue loads and releases) for where the listeners are
+          * @param pListenerPositions positions of the listeners
+          * @param numberOfListeners number of listeners **/
+        virtual void update(const FMOD_VECTOR* pListenerPositions, int numberOfListeners);
+        /** @brief startLoaderThread
+          * Load and release library meshes on a thread of their own
+          * @return true on success **/
+        virtual bool startLoaderThread();
+        /** @brief stopLoaderThread (finishes the mesh being loaded first) **/
+        virtual void stopLoaderThread();
+        /** @brief clear
+          * Switch every added Geometry back on, release every streamed mesh and forget them all **/
+        virtual void clear();
+
+    public:
+        /** @brief addGeometry
+          * @param pGeometry a Geometry to switch on and off (its bounds are taken now) **/
+        virtual void addGeometry(Geometry* pGeometry);
+        /** @brief removeGeometry (the Geometry is switched back on)
+          * @param pGeometry the Geometry **/
+        virtual void removeGeometry(Geometry* pGeometry);
+        /** @brief moveGeometry
+          * Take the bounds of a Geometry again after it has been moved
+          * @param pGeometry the Geometry **/
+        virtual void moveGeometry(Geometry* pGeometry);
+        /** @brief addLibrary
+          * Stream the meshes of a library (load it with createFlag false; the
+          * streamer owns its meshes until the library is removed)
+          * @param pGeometryLibrary the library **/
+        virtual void addLibrary(GeometryLibrary* pGeometryLibrary);
+        /** @brief removeLibrary (its streamed meshes are released)
+          * @param pGeometryLibrary the library **/
+        virtual void removeLibrary(GeometryLibrary* pGeometryLibrary);
+
+    public:
+        /** @brief Get Cell Size
+          * @return width of a cell **/
+        virtual float getCellSize() { return this->cellSize; }
+        /** @brief Set Cell Size (the meshes are sorted into the new cells)
+          * @param cellSize width of a cell (default 50) **/
+        virtual void setCellSize(float cellSize);
+        /** @brief Get Radius
+          * @return distance from a listener within which meshes are switched on **/
+        virtual float getRadius() { return this->radius; }
+        /** @brief Set Radius
+          * @param radius distance from a listener within which meshes are switched on (default 100) **/
+        virtual void setRadius(float radius) { this->radius = radius; }
+        /** @brief Get Unload Radius
+          * @return distance from every listener beyond which streamed meshes are released **/
+        virtual float getUnloadRadius() { return this->unloadRadius; }
+        /** @brief Set Unload Radius
+          * @param unloadRadius distance from every listener beyond which streamed meshes are released (default 150) **/
+        virtual void setUnloadRadius(float unloadRadius) { this->unloadRadius = unloadRadius; }
+        /** @brief Get Max Active Polygons
+          * @return most polygons switched on at once **/
+        virtual int getMaxActivePolygons() { return this->maxActivePolygons; }
+        /** @brief Set Max Active Polygons
+          * @param maxActivePolygons most polygons switched on at once (default 50000) **/
+        virtual void setMaxActivePolygons(int maxActivePolygons) { this->maxActivePolygons = maxActivePolygons; }
+        /** @brief Get the number of meshes
+          * @return meshes added (Geometry and library meshes) **/
+        virtual int getNumberOfMeshes();
+        /** @brief Get the number of active meshes
+          * @return meshes switched on after the last update **/
+        virtual int getNumberOfActiveMeshes() { return this->numberOfActiveMeshes; }
+        /** @brief Get the number of active polygons
+          * @return polygons switched on after the last update **/
+        virtual int getNumberOfActivePolygons() { return this->numberOfActivePolygons; }
+        /** @brief Get the number of loaded meshes
+          * @return library meshes in FMOD **/
+        virtual int getNumberOfLoadedMeshes() { return this->numberOfLoadedMeshes; }
+        /** @brief Get the number of pending jobs
+          * @return loads and releases waiting for the loader **/
+        virtual int getNumberOfPendingJobs();
+
+    protected:
+        // Where a library mesh is up to
+        enum MESH_STATE
+        {
+            // Not in FMOD
+            MESH_STATE_UNLOADED = 0,
+            // Waiting for (or being loaded by) the loader
+            MESH_STATE_LOADING,
+            // In FMOD
+            MESH_STATE_LOADED,
+            // Waiting for (or being released by) the loader
+            MESH_STATE_UNLOADING,
+            // Not in FMOD because the load failed (tried again after a while)
+            MESH_STATE_FAILED
+        };
+        // A mesh the streamer looks after
+        struct StreamedMesh
+        {
+            // The Geometry (0 while a library mesh is not loaded)
+            Geometry* pGeometry;
+            // The library it streams from (0 for an added Geometry)
+            GeometryLibrary* pGeometryLibrary;
+            // Index in the library
+            unsigned int libraryIndex;
+            // World space bounds
+            FMOD_VECTOR minimum;
+            FMOD_VECTOR maximum;
+            // Number of polygons
+            int numberOfPolygons;
+            // Key of the cell holding the mesh
+            unsigned long long cellKey;
+            // Where a library mesh is up to
+            MESH_STATE state;
+            // Is the mesh switched on
+            bool activeFlag;
+            // Is the slot in use
+            bool usedFlag;
+            // Update the mesh was last found within the unload radius
+            unsigned int visitedUpdate;
+            // Update the mesh was last given a share of the budget
+            unsigned int wantedUpdate;
+            // Loads which have failed in a row
+            int numberOfFailures;
+            // When a failed load may be tried again
+            std::chrono::steady_clock::time_point retryTime;
+        };
+        // A mesh within the radius of a listener
+        struct MeshCandidate
+        {
+            // Index of the mesh
+            int index;
+            // Distance to the closest listener
+            float distance;
+        };
+        // Work for the loader
+        struct LoaderJob
+        {
+            // Index of the mesh
+            int index;
+            // Load (true) or release (false)
+            bool loadFlag;
+        };
+
+    protected:
+        /** @brief addMesh (lock must be held)
+          * @return index of the new mesh **/
+        virtual int addMesh(const StreamedMesh& mesh);
+        /** @brief removeMesh (lock must be held; switches an added Geometry back on) **/
+        virtual void removeMesh(int index);
+        /** @brief getCellKey
+          * @param x cell on the horizontal axis
+          * @param y cell on the vertical axis
+          * @param z cell on the depth axis
+          * @return key of the cell **/
+        virtual unsigned long long getCellKey(int x, int y, int z);
+        /** @brief getCell
+          * @param value position on one axis
+          * @return cell on that axis **/
+        virtual int getCell(float value);
+        /** @brief insertMesh (lock must be held)
+          * @param index mesh to put in the cell for its bounds **/
+        virtual void insertMesh(int index);
+        /** @brief eraseMesh (lock must be held)
+          * @param index mesh to take out of its cell **/
+        virtual void eraseMesh(int index);
+        /** @brief getDistance
+          * @param mesh a mesh
+          * @param position a position
+          * @return distance from the position to the bounds of the mesh **/
+        virtual float getDistance(const StreamedMesh& mesh, const FMOD_VECTOR& position);
+        /** @brief setMeshActive (lock must be held)
+          * @param mesh a mesh
+          * @param activeFlag switch it on or off **/
+        virtual void setMeshActive(StreamedMesh& mesh, bool activeFlag);
+        /** @brief cancelJob (lock must be held)
+          * @param index mesh whose waiting job is called off
+          * @return false if the loader already has it (or there was none) **/
+        virtual bool cancelJob(int index);
+        /** @brief runJob
+          * Load or release one mesh (takes the loader lock itself)
+          * @return false if there was nothing to do **/
+        virtual bool runJob();
+        /** @brief The body of the loader thread **/
+        virtual void loaderThreadMain();
+
+    protected:
+        /* NOTE: The loader lock is held while a job runs so clear and
+            removeLibrary can wait for a load in progress before pulling the
+            mesh out from under it. It is always taken before the main lock */
+        // Meshes
+        std::vector<StreamedMesh> meshes;
+        // Indices of the free meshes (used as a stack)
+        std::vector<int> freeMeshes;
+        // Occupied cells
+        std::unordered_map< unsigned long long, std::vector<int> > cells;
+        // Meshes switched on or loaded after the last update
+        std::vector<int> residentMeshes;
+        // Kept to avoid reallocating each update
+        std::vector<int> nextResidentMeshes;
+        std::vector<MeshCandidate> candidates;
+        // Work for the loader
+        std::deque<LoaderJob> jobs;
+        // Width of a cell
+        float cellSize;
+        // Switch on radius
+        float radius;
+        // Release radius
+        float unloadRadius;
+        // Most polygons switched on at once
+        int maxActivePolygons;
+        // Largest half diagonal of a mesh (how far a mesh reaches out of its cell)
+        float largestExtent;
+        // Update counter
+        unsigned int updateCount;
+        // Stats
+        int numberOfActiveMeshes;
+        int numberOfActivePolygons;
+        int numberOfLoadedMeshes;
+        // Loader Thread
+        std::thread loaderThread;
+        // Loader Thread Running Flag
+        std::atomic<bool> loaderThreadRunningFlag;
+        // Wakes the loader when there is work
+        std::condition_variable loaderCondition;
+        // Held while a job runs
+        std::mutex loaderMutex;
+        // Guards everything else
+        std::mutex mutex;
+};
+
+#endif // GEOMETRYSTREAMER_H
@@ -0,0 +1,52 @@
+/**
+  * @file   LoadPolicy.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  How the AudioManager keeps a SoundSample in memory
+*/
+
+#ifndef LOADPOLICY_H
+#define LOADPOLICY_H
+
+// C++ Includes
+#include <string>
+
+/** How a SoundSample is held. Decompressing costs memory (PCM is around ten
+    times the size of Ogg or MP3), keeping it compressed costs CPU every time
+    it plays and streaming costs a file or bank read while it plays. FMOD can
+    only keep MP2/MP3/IMA ADPCM (and Vorbis inside an FSB) compressed, other
+    formats asked for LOAD_POLICY_COMPRESSED are decoded as usual **/
+enum LOAD_POLICY
+{
+    // Pick from the length and format of the sound
+    LOAD_POLICY_AUTO = 0,
+    // Decode to PCM when loaded (FMOD_CREATESAMPLE, what the AudioManager always did)
+    LOAD_POLICY_DECOMPRESS,
+    // Keep it compressed and decode while playing (FMOD_CREATECOMPRESSEDSAMPLE)
+    LOAD_POLICY_COMPRESSED,
+    // Stream it (FMOD_CREATESTREAM, only one Channel can play it at a time)
+    LOAD_POLICY_STREAM
+};
+
+/** Memory used by the SoundSamples of one category **/
+struct LoadPolicyReport
+{
+    // Path prefix of the category ("" for everything not in a category)
+    std::string category;
+    // Policy of the category
+    LOAD_POLICY policy;
+    // SoundSamples loaded
+    int numberOfSoundSamples;
+    // Of which decoded to PCM
+    int numberOfDecompressed;
+    // Of which kept compressed
+    int numberOfCompressed;
+    // Of which streamed
+    int numberOfStreamed;
+    // Bytes the SoundSamples would take decoded to PCM
+    unsigned long long decodedBytes;
+    // Bytes the SoundSamples actually hold
+    unsigned long long residentBytes;
+};
+
+#endif // LOADPOLICY_H
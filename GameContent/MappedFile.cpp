@@ -0,0 +1,125 @@
+#include "MappedFile.h"
+
+// Platform Includes
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+    // Data
+    this->pData = 0;
+    // Size
+    this->size = 0;
+    // Handles
+    this->pFileHandle = 0;
+    this->pMappingHandle = 0;
+}
+
+MappedFile::~MappedFile()
+{
+    // Unmap the file
+    this->close();
+}
+
+bool MappedFile::open(const std::string& filename, bool copyOnWriteFlag)
+{
+    // Close any existing file
+    this->close();
+    #ifdef _WIN32
+        // Open the file
+        HANDLE hFile = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, 0);
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            std::cout << "bool MappedFile::open() failure. Could not open " << filename << std::endl;
+            return false;
+        }
+        // Grab the size
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(hFile, &fileSize) == 0 || fileSize.QuadPart == 0)
+        {
+            std::cout << "bool MappedFile::open() failure. " << filename << " is empty" << std::endl;
+            CloseHandle(hFile);
+            return false;
+        }
+        // Create the mapping
+        HANDLE hMapping = CreateFileMappingA(hFile, 0, (copyOnWriteFlag == true) ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, 0);
+        if (hMapping == 0)
+        {
+            std::cout << "bool MappedFile::open() failure. Could not map " << filename << std::endl;
+            CloseHandle(hFile);
+            return false;
+        }
+        // Map the whole file
+        void* pView = MapViewOfFile(hMapping, (copyOnWriteFlag == true) ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+        if (pView == 0)
+        {
+            std::cout << "bool MappedFile::open() failure. Could not map " << filename << std::endl;
+            CloseHandle(hMapping);
+            CloseHandle(hFile);
+            return false;
+        }
+        // Keep the handles
+        this->pFileHandle = (void*)hFile;
+        this->pMappingHandle = (void*)hMapping;
+        this->pData = (const unsigned char*)pView;
+        this->size = (unsigned long long)fileSize.QuadPart;
+    #else
+        // Open the file
+        int fileDescriptor = ::open(filename.c_str(), O_RDONLY);
+        if (fileDescriptor == -1)
+        {
+            std::cout << "bool MappedFile::open() failure. Could not open " << filename << std::endl;
+            return false;
+        }
+        // Grab the size
+        struct stat fileStatus;
+        if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+        {
+            std::cout << "bool MappedFile::open() failure. " << filename << " is empty" << std::endl;
+            ::close(fileDescriptor);
+            return false;
+        }
+        // Map the whole file
+        void* pView = mmap(0, (size_t)fileStatus.st_size, (copyOnWriteFlag == true) ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (pView == MAP_FAILED)
+        {
+            std::cout << "bool MappedFile::open() failure. Could not map " << filename << std::endl;
+            ::close(fileDescriptor);
+            return false;
+        }
+        // The mapping keeps the file alive
+        ::close(fileDescriptor);
+        // Keep the mapping
+        this->pData = (const unsigned char*)pView;
+        this->size = (unsigned long long)fileStatus.st_size;
+    #endif
+    // Success
+    return true;
+}
+
+void MappedFile::close()
+{
+    // Nothing mapped
+    if (this->pData == 0)
+        return;
+    #ifdef _WIN32
+        // Unmap the view and close the handles
+        UnmapViewOfFile((LPCVOID)this->pData);
+        CloseHandle((HANDLE)this->pMappingHandle);
+        CloseHandle((HANDLE)this->pFileHandle);
+    #else
+        // Unmap the file
+        munmap((void*)this->pData, (size_t)this->size);
+    #endif
+    // Reset
+    this->pData = 0;
+    this->size = 0;
+    this->pFileHandle = 0;
+    this->pMappingHandle = 0;
+}
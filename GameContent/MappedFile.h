@@ -0,0 +1,68 @@
+/**
+  * @file   MappedFile.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  MappedFile maps a whole file into memory read only
+*/
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+// C++ Includes
+#include <iostream>
+#include <string>
+
+/** The MappedFile class maps a file read only (MapViewOfFile on Windows,
+    mmap everywhere else). Pages are only read from disk when they are
+    touched and are shared with the OS file cache, so nothing is copied
+    into the process until it is used. A copy on write mapping can also be
+    written to: the pages written become private copies and the file on
+    disk is never changed **/
+class MappedFile
+{
+    // ****************************
+    // * CONSTRUCTOR / DESTRUCTOR *
+    // ****************************
+    public:
+        //! Constructor
+        MappedFile();
+        //! Destructor
+        virtual ~MappedFile();
+
+    protected:
+        //! MappedFile Copy constructor
+        MappedFile(const MappedFile& other) {}
+
+    // *********************
+    // * GENERAL FUNCTIONS *
+    // *********************
+    public:
+        /** @brief open
+          * @param filename file to map
+          * @param copyOnWriteFlag true to allow writes to the mapping (never written back)
+          * @return true on success **/
+        virtual bool open(const std::string& filename, bool copyOnWriteFlag = false);
+        /** @brief close (unmaps the file, pointers into it become invalid) **/
+        virtual void close();
+        /** @brief isOpen
+          * @return true if a file is mapped **/
+        virtual bool isOpen() { return (this->pData != 0); }
+        /** @brief getData
+          * @return the start of the mapped file **/
+        virtual const unsigned char* getData() { return this->pData; }
+        /** @brief getSize
+          * @return size of the mapped file in bytes **/
+        virtual unsigned long long getSize() { return this->size; }
+
+    protected:
+        // Start of the mapping
+        const unsigned char* pData;
+        // Size of the mapping
+        unsigned long long size;
+        // File handle (HANDLE on Windows, file descriptor elsewhere)
+        void* pFileHandle;
+        // Mapping handle (Windows only)
+        void* pMappingHandle;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,83 @@
+/**
+  * @file   SoundBankFormat.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  On disk layout of a packed sound bank (written by
+  * BankPacker, read by BankLoader)
+*/
+
+#ifndef SOUNDBANKFORMAT_H
+#define SOUNDBANKFORMAT_H
+
+// GAMECONTENT Includes
+#include "AssetId.h"
+
+/** A sound bank is one file laid out as:
+
+        SoundBankHeader
+        sound data      (each file as it was on disk, 32 byte aligned with
+                         at least SOUNDBANK_PADDING zero bytes either side)
+        SoundBankEntry  (numberOfEntries of them, sorted by id)
+        names           (null terminated paths the entries point into)
+
+    Everything is little endian and every offset is from the start of the
+    file so the BankLoader can use the file straight out of a mapping. The
+    entries carry what FMOD would otherwise have to probe the data for **/
+
+// "SBNK"
+const unsigned int SOUNDBANK_MAGIC = 0x4B4E4253;
+// Bump when the layout changes (2 added SOUNDBANK_PADDING around the sound data)
+const unsigned int SOUNDBANK_VERSION = 2;
+// Sound data alignment
+const unsigned int SOUNDBANK_ALIGNMENT = 32;
+// Zero bytes either side of the sound data (FMOD_OPENMEMORY_POINT on PCM
+// writes to the 16 bytes either side for looping and interpolation)
+const unsigned int SOUNDBANK_PADDING = 16;
+
+/** Start of the bank **/
+struct SoundBankHeader
+{
+    // SOUNDBANK_MAGIC
+    unsigned int magic;
+    // SOUNDBANK_VERSION
+    unsigned int version;
+    // Number of entries
+    unsigned int numberOfEntries;
+    // Unused (keeps the offsets 8 byte aligned)
+    unsigned int reserved;
+    // Offset of the first SoundBankEntry
+    unsigned long long entriesOffset;
+    // Offset of the names
+    unsigned long long namesOffset;
+};
+
+/** One sound in the bank **/
+struct SoundBankEntry
+{
+    // AssetId of the path the sound was packed from
+    AssetId id;
+    // Offset of the sound data
+    unsigned long long dataOffset;
+    // Size of the sound data in bytes
+    unsigned int dataSize;
+    // Offset of the name from the start of the names
+    unsigned int nameOffset;
+    // FMOD_SOUND_TYPE of the data (so FMOD goes straight to the right codec)
+    int soundType;
+    // FMOD_SOUND_FORMAT it decodes to
+    int format;
+    // Number of channels
+    int channels;
+    // Default frequency in Hz
+    float defaultFrequency;
+    // Length in milliseconds
+    unsigned int lengthInMilliseconds;
+    // Length in PCM samples
+    unsigned int lengthInPCM;
+};
+
+// The layout must not depend on the compiler
+static_assert(sizeof(SoundBankHeader) == 32, "SoundBankHeader must be 32 bytes");
+static_assert(sizeof(SoundBankEntry) == 48, "SoundBankEntry must be 48 bytes");
+
+#endif // SOUNDBANKFORMAT_H
@@ -0,0 +1,126 @@
+#include "SoundSampleIndex.h"
+
+SoundSampleIndex::SoundSampleIndex()
+{
+    // Size
+    this->size = 0;
+    // Tombstones
+    this->tombstones = 0;
+    // Start with room for a few SoundSamples
+    this->rehash(64);
+}
+
+SoundSample* SoundSampleIndex::find(AssetId id)
+{
+    // Find the slot
+    int slot = this->findSlot(id);
+    // return the SoundSample
+    return (slot != -1) ? this->slots[slot].pSoundSample : 0;
+}
+
+void SoundSampleIndex::add(AssetId id, SoundSample* pSoundSample)
+{
+    // Validate the parameters
+    if (id == INVALID_ASSET_ID || pSoundSample == 0)
+        return;
+    // Already there so replace it
+    int existingSlot = this->findSlot(id);
+    if (existingSlot != -1)
+    {
+        this->slots[existingSlot].pSoundSample = pSoundSample;
+        return;
+    }
+    // Keep the table under 3/4 full (counting tombstones, they lengthen runs too)
+    unsigned int capacity = (unsigned int)this->slots.size();
+    if ((this->size + this->tombstones + 1) * 4 > capacity * 3)
+        this->rehash(((this->size + 1) * 2 > capacity / 2) ? capacity * 2 : capacity);
+    // Probe for a free slot (reusing a tombstone is fine, the id is not in the table)
+    unsigned int mask = (unsigned int)this->slots.size() - 1;
+    unsigned int slot = (unsigned int)(id ^ (id >> 32)) & mask;
+    while (this->slots[slot].pSoundSample != 0)
+        slot = (slot + 1) & mask;
+    // Reusing a tombstone
+    if (this->slots[slot].id != INVALID_ASSET_ID)
+        this->tombstones--;
+    // Fill the slot
+    this->slots[slot].id = id;
+    this->slots[slot].pSoundSample = pSoundSample;
+    this->size++;
+}
+
+bool SoundSampleIndex::remove(AssetId id)
+{
+    // Find the slot
+    int slot = this->findSlot(id);
+    if (slot == -1)
+        return false;
+    // Leave a tombstone (keep the id so the run is not broken)
+    this->slots[slot].pSoundSample = 0;
+    this->size--;
+    this->tombstones++;
+    // Success
+    return true;
+}
+
+void SoundSampleIndex::clear()
+{
+    // Empty every slot
+    for (unsigned int i = 0; i < this->slots.size(); i++)
+    {
+        this->slots[i].id = INVALID_ASSET_ID;
+        this->slots[i].pSoundSample = 0;
+    }
+    // Nothing left
+    this->size = 0;
+    this->tombstones = 0;
+}
+
+int SoundSampleIndex::findSlot(AssetId id)
+{
+    // Validate the id
+    if (id == INVALID_ASSET_ID)
+        return -1;
+    // Start where the id hashes to
+    unsigned int mask = (unsigned int)this->slots.size() - 1;
+    unsigned int slot = (unsigned int)(id ^ (id >> 32)) & mask;
+    // Walk the run until a never used slot
+    while (this->slots[slot].id != INVALID_ASSET_ID)
+    {
+        // Found it (a tombstone holding the id means it was removed)
+        if (this->slots[slot].id == id)
+            return (this->slots[slot].pSoundSample != 0) ? (int)slot : -1;
+        // Next slot
+        slot = (slot + 1) & mask;
+    }
+    // Not found
+    return -1;
+}
+
+void SoundSampleIndex::rehash(unsigned int capacity)
+{
+    // Keep the old slots
+    std::vector<Slot> oldSlots;
+    oldSlots.swap(this->slots);
+    // Make the new table
+    Slot emptySlot;
+    emptySlot.id = INVALID_ASSET_ID;
+    emptySlot.pSoundSample = 0;
+    this->slots.assign(capacity, emptySlot);
+    this->size = 0;
+    this->tombstones = 0;
+    // Put the SoundSamples back (dropping the tombstones)
+    unsigned int mask = capacity - 1;
+    for (unsigned int i = 0; i < oldSlots.size(); i++)
+    {
+        // Skip empty slots and tombstones
+        if (oldSlots[i].pSoundSample == 0)
+            continue;
+        // Probe for a free slot
+        unsigned int slot = (unsigned int)(oldSlots[i].id ^ (oldSlots[i].id >> 32)) & mask;
+        while (this->slots[slot].id != INVALID_ASSET_ID)
+            slot = (slot + 1) & mask;
+        // Fill the slot
+        this->slots[slot] = oldSlots[i];
+        this->size++;
+    }
+}
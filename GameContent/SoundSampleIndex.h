@@ -0,0 +1,98 @@
+/**
+  * @file   SoundSampleIndex.h
+  * @Author Sergeant Neipo (sergeant.neipo@gmail.com)
+  * @date   October, 2026
+  * @brief  SoundSampleIndex is an open addressing hash table
+  * from AssetId to SoundSample
+*/
+
+#ifndef SOUNDSAMPLEINDEX_H
+#define SOUNDSAMPLEINDEX_H
+
+// C++ Includes
+#include <vector>
+
+// GAMECONTENT Includes
+#include "AssetId.h"
+
+// GAMEAUDIO Includes
+#include "Sound/SoundSample.h"
+
+/** The SoundSampleIndex finds a SoundSample from its AssetId with linear
+    probing over a power of two table. A find is a mask and a few compares
+    of adjacent slots and never allocates; only an add that pushes the
+    table past 3/4 full grows it. Removed slots are left as tombstones
+    (key kept, SoundSample 0) so later keys in the same run are still found.
+    The SoundSampleIndex does not own the SoundSamples and is not thread
+    safe (the AudioManager locks around it) **/
+class SoundSampleIndex
+{
+    // ****************************
+    // * CONSTRUCTOR / DESTRUCTOR *
+    // ****************************
+    public:
+        //! Constructor
+        SoundSampleIndex();
+        //! Destructor
+        virtual ~SoundSampleIndex() {}
+
+    // *******************
+    // * INDEX FUNCTIONS *
+    // *******************
+    public:
+        /** @brief find
+          * @param id AssetId of the SoundSample
+          * @return the SoundSample or 0 **/
+        virtual SoundSample* find(AssetId id);
+        /** @brief add (replaces any SoundSample already under the id)
+          * @param id AssetId of the SoundSample
+          * @param pSoundSample the SoundSample (not 0) **/
+        virtual void add(AssetId id, SoundSample* pSoundSample);
+        /** @brief remove
+          * @param id AssetId of the SoundSample
+          * @return true if there was a SoundSample under the id **/
+        virtual bool remove(AssetId id);
+        /** @brief clear (keeps the table so refilling it does not allocate) **/
+        virtual void clear();
+        /** @brief getSize
+          * @return number of SoundSamples in the index **/
+        virtual unsigned int getSize() { return this->size; }
+
+    public:
+        /** @brief getCapacity (for walking the slots)
+          * @return number of slots **/
+        virtual unsigned int getCapacity() { return (unsigned int)this->slots.size(); }
+        /** @brief getKey
+          * @param slot slot number
+          * @return the AssetId in the slot (INVALID_ASSET_ID when empty) **/
+        virtual AssetId getKey(unsigned int slot) { return (this->slots[slot].pSoundSample != 0) ? this->slots[slot].id : INVALID_ASSET_ID; }
+        /** @brief getSoundSample
+          * @param slot slot number
+          * @return the SoundSample in the slot (0 when empty or removed) **/
+        virtual SoundSample* getSoundSample(unsigned int slot) { return this->slots[slot].pSoundSample; }
+
+    protected:
+        /** @brief Find the slot holding an id
+          * @return slot number or -1 **/
+        virtual int findSlot(AssetId id);
+        /** @brief Rebuild the table with a new capacity (a power of two) **/
+        virtual void rehash(unsigned int capacity);
+
+    protected:
+        // A slot in the table
+        struct Slot
+        {
+            // AssetId (INVALID_ASSET_ID if never used)
+            AssetId id;
+            // SoundSample (0 if empty or removed)
+            SoundSample* pSoundSample;
+        };
+        // Slots
+        std::vector<Slot> slots;
+        // Slots holding a SoundSample
+        unsigned int size;
+        // Slots which have been removed
+        unsigned int tombstones;
+};
+
+#endif // SOUNDSAMPLEINDEX_H
@@ -1,15 +1,22 @@
 // C++ Includes
 #include <iostream>
 #include <cstdio>
+#include <cstring>
 #include <conio.h>
 #include <vector>
 #include <limits>
 #include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 // GAMEAUDIO Includes
 #include "GameAudio.h"
 // GAMECONTENT Includes
 #include "AudioManager.h"
+#include "GeometryLibrary.h"
 
 /* The Video Class is just a
     placeholder class used in
@@ -70,6 +77,32 @@ void stream2DUnitTest();
 void stream3DUnitTest();
 // Music Test
 void musicUnitTest();
+// MusicPlayer Test
+void musicPlayerUnitTest();
+// MusicScheduler Test
+void musicSchedulerUnitTest();
+// EmitterSystem Test
+void emitterSystemUnitTest();
+// OcclusionTracer Test
+void occlusionTracerUnitTest();
+// NearestListener Test
+void nearestListenerUnitTest();
+// AutoVelocity Test
+void autoVelocityUnitTest();
+// StreamPool Test
+void streamPoolUnitTest();
+// AudioFileSystem Test
+void audioFileSystemUnitTest();
+// AudioIOScheduler Test
+void audioIOSchedulerUnitTest();
+// AudioManager Test
+void audioManagerUnitTest();
+// Async Load Test
+void asyncLoadUnitTest();
+// AudioCommandQueue Test
+void audioCommandQueueUnitTest();
+// File Validation Test
+void fileValidationUnitTest();
 // DSPTest
 void dspUnitTest();
 // ReverbTest
@@ -84,6 +117,8 @@ void audioStreamForVideo();
 void waitForKeypress();
 // Wait until there are NoKeyPresses
 void waitForNoKeypress();
+// Write a file (for the tests which craft their own)
+bool writeTestFile(const std::string& filename, const std::vector<unsigned char>& bytes);
 
 // CALLBACKS
 // pcm Callback - simulates an audio stream being read from a source such as video
@@ -110,6 +145,47 @@ FMOD_RESULT F_CALLBACK pcmReadCallback(FMOD_SOUND *sound, void *data, unsigned i
     return FMOD_OK;
 }
 
+/* The I/O Test Log records the order the
+    AudioIOScheduler finishes its reads in.
+    The first read holds its thread until the
+    gate opens so the rest can queue up */
+struct IOTestLog
+{
+    std::mutex mutex;
+    std::vector<unsigned int> order;
+    std::vector<FMOD_RESULT> results;
+    std::atomic<bool> startedFlag;
+    std::atomic<bool> gateFlag;
+};
+
+// io Read Callback - stands in for the disk (the offset is the read's id)
+FMOD_RESULT ioReadCallback(FMOD_ASYNCREADINFO* /*pInfo*/, void* pUserData)
+{
+    IOTestLog* pLog = (IOTestLog*)pUserData;
+    pLog->startedFlag.store(true);
+    // Hold the thread until the gate opens
+    while (pLog->gateFlag.load() == false)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    // Success
+    return FMOD_OK;
+}
+
+// io Done Callback - stands in for FMOD being told a read is done
+void F_CALLBACK ioDoneCallback(FMOD_ASYNCREADINFO* pInfo, FMOD_RESULT result)
+{
+    IOTestLog* pLog = (IOTestLog*)pInfo->userdata;
+    std::lock_guard<std::mutex> lock(pLog->mutex);
+    pLog->order.push_back(pInfo->offset);
+    pLog->results.push_back(result);
+}
+
+// sound Sample Loaded Callback - counts the finished loads
+void soundSampleLoadedCallback(SoundSample* /*pSoundSample*/, bool successFlag, void* pUserData)
+{
+    if (successFlag == true)
+        (*(int*)pUserData)++;
+}
+
 // Entry Point
 int main(int argc, char* argv[])
 {
@@ -153,6 +229,32 @@ int main(int argc, char* argv[])
     stream3DUnitTest();
     // Run Music Unit Test
     musicUnitTest();
+    // Run MusicPlayer Unit Test
+    musicPlayerUnitTest();
+    // Run MusicScheduler Unit Test
+    musicSchedulerUnitTest();
+    // Run EmitterSystem Unit Test
+    emitterSystemUnitTest();
+    // Run OcclusionTracer Unit Test
+    occlusionTracerUnitTest();
+    // Run NearestListener Unit Test
+    nearestListenerUnitTest();
+    // Run AutoVelocity Unit Test
+    autoVelocityUnitTest();
+    // Run StreamPool Unit Test
+    streamPoolUnitTest();
+    // Run AudioFileSystem Unit Test
+    audioFileSystemUnitTest();
+    // Run AudioIOScheduler Unit Test
+    audioIOSchedulerUnitTest();
+    // Run AudioManager Unit Test
+    audioManagerUnitTest();
+    // Run Async Load Unit Test
+    asyncLoadUnitTest();
+    // Run AudioCommandQueue Unit Test
+    audioCommandQueueUnitTest();
+    // Run File Validation Unit Test
+    fileValidationUnitTest();
     // DSP Unit test
     dspUnitTest();
     // Reverb Test
@@ -695,6 +797,1109 @@ void musicUnitTest()
     waitForNoKeypress();
 }
 
+void musicPlayerUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING MUSIC PLAYER UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    // The tracks
+    std::string firstTrack = "media/music/bensound-jazzyfrenchy.ogg";
+    std::string secondTrack = "media/music/bensound-littleidea.ogg";
+    // Make a MusicPlayer
+    MusicPlayer musicPlayer;
+    // Play the first track
+    if (musicPlayer.play(firstTrack) == false)
+    {
+        // Send a message to the console
+        std::cout << "ERROR: Failed to play: " << firstTrack << std::endl;
+        // Failure
+        return;
+    }
+    // Loop ends are worked out in one step, so the end of a later loop is never short of the first
+    unsigned long long startClock = musicPlayer.getStartClock();
+    unsigned long long firstEndClock = musicPlayer.getLoopEndClock(startClock + 1);
+    unsigned long long laterEndClock = musicPlayer.getLoopEndClock(startClock + (firstEndClock - startClock) * 99 + 1);
+    std::cout << "Loop length: " << (firstEndClock - startClock) << " Hundredth loop ends after: " << (laterEndClock - startClock) << std::endl;
+    if (laterEndClock - startClock < (firstEndClock - startClock) * 100)
+        std::cout << "ERROR: Loop ends drift" << std::endl;
+    // Crossfade to the second track in a second, over two seconds
+    musicPlayer.cue(secondTrack);
+    musicPlayer.crossfadeAt(musicPlayer.getClock() + musicPlayer.getSampleRate(), 2.0f);
+    // The idle deck is still in use so another cue must be refused
+    if (musicPlayer.cue(firstTrack) == true)
+        std::cout << "ERROR: Cued while a switch is scheduled" << std::endl;
+    // 0 waiting for the crossfade, 1 crossfading back, 2 fading out
+    int stage = 0;
+    // Send a mesaage to the console
+    std::cout << "Listen for the fade out starting half way up the fade in, without a jump. Press Space to Stop this Unit Test" << std::endl;
+    // Psuedo Main Loop
+    while(true)
+    {
+        // Think for the AudioSystem
+        audioSystem.think();
+        // Update the AudioSystem
+        audioSystem.update();
+        // Once the crossfade is done cue the first track again and crossfade back over four seconds
+        if (stage == 0 && musicPlayer.isTransitioning() == false && musicPlayer.cue(firstTrack) == true)
+        {
+            musicPlayer.crossfade(4.0f);
+            stage = 1;
+        }
+        // Half way through stop, the first track fades out from half its level
+        if (stage == 1 && musicPlayer.getClock() >= musicPlayer.getStartClock() + (unsigned long long)musicPlayer.getSampleRate() * 2)
+        {
+            std::cout << "Fading out from half way" << std::endl;
+            musicPlayer.stop(2.0f);
+            stage = 2;
+        }
+        // Finished
+        if (stage == 2 && musicPlayer.isTransitioning() == false)
+            break;
+        // If a key was pressed
+        if (kbhit() == true)
+        {
+            // Grab the Keypressed
+            char ch = getch();
+            // If key was space then break
+            if (ch == 32)
+                break;
+         }
+    }
+    // Free the MusicPlayer
+    musicPlayer.free();
+    // Send a message to the console
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void musicSchedulerUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING MUSIC SCHEDULER UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    // The sections
+    std::string firstSection = "media/music/bensound-jazzyfrenchy.ogg";
+    std::string secondSection = "media/music/bensound-littleidea.ogg";
+    // Make a MusicScheduler and hook it to the AudioSystem
+    MusicScheduler musicScheduler;
+    musicScheduler.setTempo(firstSection, 120.0f, 4);
+    musicScheduler.setTempo(secondSection, 100.0f, 4);
+    audioSystem.addUpdateCallback(MusicScheduler::updateCallback, &musicScheduler);
+    // A section that isn't preloaded must be refused (the update thread never opens a file)
+    if (musicScheduler.cue(firstSection) == true)
+        std::cout << "ERROR: Cued a section that isn't preloaded" << std::endl;
+    // Preload the sections and wait until they are ready
+    StreamPool* pStreamPool = audioSystem.getStreamPool();
+    pStreamPool->preload(firstSection, MUSICSCHEDULER_SECTION_MODE, 1);
+    pStreamPool->preload(secondSection, MUSICSCHEDULER_SECTION_MODE, 1);
+    while (pStreamPool->getNumberOfReady(firstSection, MUSICSCHEDULER_SECTION_MODE) < 1 || pStreamPool->getNumberOfReady(secondSection, MUSICSCHEDULER_SECTION_MODE) < 1)
+    {
+        // Think for the AudioSystem
+        audioSystem.think();
+        // Update the AudioSystem
+        audioSystem.update();
+    }
+    // Start the first section
+    if (musicScheduler.cue(firstSection) == false)
+    {
+        // Send a message to the console
+        std::cout << "ERROR: Failed to cue a preloaded section" << std::endl;
+        // Unhook the MusicScheduler
+        audioSystem.removeUpdateCallback(MusicScheduler::updateCallback, &musicScheduler);
+        // Failure
+        return;
+    }
+    musicScheduler.transition(MUSICSYNC_NOW);
+    // Make a stinger
+    Sound stinger;
+    stinger.setSoundSample(audioManager.getSoundSample("media/sounds/electronics014.ogg"));
+    // Section playing
+    bool firstFlag = true;
+    // Last beat printed
+    int lastBeat = -1;
+    // Send a mesaage to the console
+    std::cout << "Press S for a Stinger on the beat, T to Transition on the bar, Space to Stop this Unit Test" << std::endl;
+    // Psuedo Main Loop
+    while(true)
+    {
+        // Think for the AudioSystem
+        audioSystem.think();
+        // Update the AudioSystem
+        audioSystem.update();
+        // Print each beat
+        int beat = musicScheduler.getBeat();
+        if (beat != lastBeat)
+        {
+            std::cout << "Bar: " << musicScheduler.getBar() << " Beat: " << beat << std::endl;
+            lastBeat = beat;
+        }
+        // If a key was pressed
+        if (kbhit() == true)
+        {
+            // Grab the Keypressed
+            char ch = getch();
+            // Stinger on the next beat
+            if (ch == 's' || ch == 'S')
+                musicScheduler.playStinger(&stinger, MUSICSYNC_BEAT);
+            // Crossfade to the other section on the next bar (a cue during a crossfade waits for it)
+            if (ch == 't' || ch == 'T')
+            {
+                // The other section
+                firstFlag = (firstFlag == false);
+                // Cue and transition
+                if (musicScheduler.cue((firstFlag == true) ? firstSection : secondSection) == true)
+                    musicScheduler.transition(MUSICSYNC_BAR, 1.0f);
+            }
+            // If key was space then break
+            if (ch == 32)
+                break;
+         }
+    }
+    // Unhook the MusicScheduler
+    audioSystem.removeUpdateCallback(MusicScheduler::updateCallback, &musicScheduler);
+    // Stop the stinger
+    stinger.stop();
+    // Free the MusicScheduler
+    musicScheduler.free();
+    // Forget the preloads
+    pStreamPool->unload(firstSection, MUSICSCHEDULER_SECTION_MODE);
+    pStreamPool->unload(secondSection, MUSICSCHEDULER_SECTION_MODE);
+    // Send a message to the console
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void emitterSystemUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING EMITTER SYSTEM UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    // Try and load a SoundSample
+    SoundSample* pSoundSample = audioManager.getSoundSample3D("media/sounds/electronics014.ogg");
+    // If our SoundSample is invalid
+    if (pSoundSample == 0)
+    {
+        // Send a message to the console
+        std::cout << "ERROR: Failed to load file" << std::endl;
+        // Failure
+        return;
+    }
+    // Emitters, updates to time and voices to hand out
+    const int numberOfEmitters = 4096;
+    const int numberOfUpdates = 100;
+    const int realVoiceBudget = 32;
+    // The listener sits at the origin of a grid of emitters 8 units apart
+    FMOD_VECTOR listenerPosition;
+        listenerPosition.x = 0.0f;
+        listenerPosition.y = 0.0f;
+        listenerPosition.z = 0.0f;
+    // Sound3Ds looped over the way a game without the EmitterSystem would
+    Sound3D* pSounds = new Sound3D[numberOfEmitters];
+    // An EmitterSystem with no VoicePool so only the culling and ranking are timed
+    EmitterSystem emitterSystem;
+    emitterSystem.setVoicePool(0);
+    emitterSystem.setRealVoiceBudget(realVoiceBudget);
+    for (int i = 0; i < numberOfEmitters; i++)
+    {
+        // The same emitter both ways
+        float x = (float)(i % 64 - 32) * 8.0f;
+        float z = (float)(i / 64 - 32) * 8.0f;
+        pSounds[i].setSoundSample(pSoundSample);
+        pSounds[i].setPosition(x, 0.0f, z);
+        pSounds[i].setMinMaxDistance(pSoundSample->getMinDistance(), pSoundSample->getMaxDistance());
+        emitterSystem.addEmitter(pSoundSample, x, 0.0f, z);
+    }
+    // Time the Sound3D loop (a virtual call per getter, the same inverse rolloff and ranking)
+    std::vector<int> candidates;
+    std::vector<float> scores(numberOfEmitters, 0.0f);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int u = 0; u < numberOfUpdates; u++)
+    {
+        // Start the candidates over
+        candidates.clear();
+        for (int i = 0; i < numberOfEmitters; i++)
+        {
+            // Distance to the listener
+            Sound3D* pSound = &(pSounds[i]);
+            float dx = pSound->getX() - listenerPosition.x;
+            float dy = pSound->getY() - listenerPosition.y;
+            float dz = pSound->getZ() - listenerPosition.z;
+            float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+            // Out of range
+            float minDistance = pSound->getMinDistance();
+            float maxDistance = pSound->getMaxDistance();
+            if (distance > maxDistance)
+                continue;
+            // Score it
+            scores[i] = pSound->getVolume() * minDistance / std::max(distance, minDistance);
+            candidates.push_back(i);
+        }
+        // Keep the best up to the budget
+        if ((int)candidates.size() > realVoiceBudget)
+            std::nth_element(candidates.begin(), candidates.begin() + realVoiceBudget, candidates.end(), [&scores](int a, int b) { return scores[a] > scores[b]; });
+    }
+    float sound3DTime = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count() / (float)numberOfUpdates;
+    // Time the EmitterSystem
+    float emitterSystemTime = 0.0f;
+    for (int u = 0; u < numberOfUpdates; u++)
+    {
+        // Update and add up the time it took
+        emitterSystem.update(&listenerPosition, 1);
+        emitterSystemTime += emitterSystem.getLastUpdateTime();
+    }
+    emitterSystemTime /= (float)numberOfUpdates;
+    // Send a message to the console
+    std::cout << numberOfEmitters << " emitters, microseconds an update" << std::endl;
+    std::cout << "Looping over Sound3D: " << sound3DTime << std::endl;
+    std::cout << "EmitterSystem: " << emitterSystemTime << std::endl;
+    // Clean up
+    emitterSystem.clear();
+    delete[] pSounds;
+    // Send a message to the console
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void occlusionTracerUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING OCCLUSION TRACER UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    // Fixture: a single sided wall at z = 0 wound to face -z and a double sided wall at z = 5
+    Geometry geometry;
+    if (geometry.create(2, 8) == false)
+    {
+        // Send a message to the console
+        std::cout << "ERROR: Failed to create the Geometry" << std::endl;
+        // Failure
+        return;
+    }
+    float singleSidedVertices[] = { -1.0f, -1.0f, 0.0f, -1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f, -1.0f, 0.0f };
+    geometry.addPolygon(0.5f, 0.25f, false, 4, singleSidedVertices);
+    float doubleSidedVertices[] = { -1.0f, -1.0f, 5.0f, 1.0f, -1.0f, 5.0f, 1.0f, 1.0f, 5.0f, -1.0f, 1.0f, 5.0f };
+    geometry.addPolygon(0.8f, 0.4f, true, 4, doubleSidedVertices);
+    // The same Geometry through an OcclusionTracer
+    OcclusionTracer occlusionTracer;
+    occlusionTracer.addGeometry(&geometry);
+    // Let FMOD take the Geometry in
+    audioSystem.update();
+    // Rays into the front of the single sided wall, into its back, through both walls either way and past both walls
+    const int numberOfRays = 5;
+    FMOD_VECTOR starts[numberOfRays] = { { 0.0f, 0.0f, -3.0f }, { 0.0f, 0.0f, 3.0f }, { 0.0f, 0.0f, -3.0f }, { 0.0f, 0.0f, 8.0f }, { 3.0f, 0.0f, -3.0f } };
+    FMOD_VECTOR finishes[numberOfRays] = { { 0.0f, 0.0f, 3.0f }, { 0.0f, 0.0f, -3.0f }, { 0.0f, 0.0f, 8.0f }, { 0.0f, 0.0f, -3.0f }, { 3.0f, 0.0f, 8.0f } };
+    const char* names[numberOfRays] = { "Front of single sided", "Back of single sided", "Through both", "Through both backwards", "Past both" };
+    // FMOD's geometry engine is the reference
+    int mismatches = 0;
+    for (int i = 0; i < numberOfRays; i++)
+    {
+        // Trace the ray both ways
+        float fmodDirectOcclusion = 0.0f;
+        float fmodReverbOcclusion = 0.0f;
+        audioSystem.getGeometryOcclusion(starts[i], finishes[i], fmodDirectOcclusion, fmodReverbOcclusion);
+        float tracerDirectOcclusion = 0.0f;
+        float tracerReverbOcclusion = 0.0f;
+        occlusionTracer.trace(starts[i], finishes[i], tracerDirectOcclusion, tracerReverbOcclusion);
+        // Send a message to the console
+        std::cout << names[i] << ": FMOD " << fmodDirectOcclusion << " / " << fmodReverbOcclusion << " Tracer " << tracerDirectOcclusion << " / " << tracerReverbOcclusion << std::endl;
+        // They must agree
+        if (std::fabs(fmodDirectOcclusion - tracerDirectOcclusion) > 0.01f || std::fabs(fmodReverbOcclusion - tracerReverbOcclusion) > 0.01f)
+        {
+            std::cout << "ERROR: The OcclusionTracer disagrees with FMOD" << std::endl;
+            mismatches++;
+        }
+    }
+    // Send a message to the console
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    // Clean up
+    occlusionTracer.clear();
+    geometry.release();
+    // Send a message to the console
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void nearestListenerUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING NEAREST LISTENER UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    // Listeners on the axes, then the same listeners in reverse so ties fall to different ones
+    const FMOD_VECTOR listenerSets[2][4] = { { { 0.0f, 0.0f, 0.0f }, { 10.0f, 0.0f, 0.0f }, { 0.0f, 10.0f, 0.0f }, { 0.0f, 0.0f, 10.0f } },
+                                             { { 0.0f, 0.0f, 10.0f }, { 0.0f, 10.0f, 0.0f }, { 10.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } } };
+    // Seven positions cover a batch of four and a tail of three; the first four sit exactly between listeners
+    const int numberOfPositions = 7;
+    float x[numberOfPositions] = { 5.0f, 5.0f, 5.0f, 0.0f, 9.0f, -3.0f, 1.0f };
+    float y[numberOfPositions] = { 0.0f, 5.0f, 5.0f, 5.0f, 1.0f, 0.0f, 8.0f };
+    float z[numberOfPositions] = { 0.0f, 0.0f, 5.0f, 5.0f, 0.0f, 2.0f, 7.0f };
+    int mismatches = 0;
+    for (int set = 0; set < 2; set++)
+    {
+        for (int numberOfListeners = 1; numberOfListeners <= 4; numberOfListeners++)
+        {
+            // Find them all in one pass
+            float distances[numberOfPositions];
+            int listeners[numberOfPositions];
+            NearestListener::find(x, y, z, numberOfPositions, listenerSets[set], numberOfListeners, distances, listeners);
+            for (int i = 0; i < numberOfPositions; i++)
+            {
+                // The reference: a plain loop where only a strictly closer listener replaces the best one
+                int expectedListener = 0;
+                float expectedDistanceSquared = std::numeric_limits<float>::max();
+                for (int j = 0; j < numberOfListeners; j++)
+                {
+                    float dX = x[i] - listenerSets[set][j].x;
+                    float dY = y[i] - listenerSets[set][j].y;
+                    float dZ = z[i] - listenerSets[set][j].z;
+                    float distanceSquared = dX * dX + dY * dY + dZ * dZ;
+                    if (distanceSquared < expectedDistanceSquared)
+                    {
+                        expectedDistanceSquared = distanceSquared;
+                        expectedListener = j;
+                    }
+                }
+                float expectedDistance = std::sqrt(expectedDistanceSquared);
+                // The single position overload must agree with the batch
+                FMOD_VECTOR position = { x[i], y[i], z[i] };
+                float distance = 0.0f;
+                int listener = NearestListener::find(position, listenerSets[set], numberOfListeners, &distance);
+                if (listeners[i] != expectedListener || listener != expectedListener || std::fabs(distances[i] - expectedDistance) > 0.001f || std::fabs(distance - expectedDistance) > 0.001f)
+                {
+                    // Send a message to the console
+                    std::cout << "ERROR: Set " << set << " with " << numberOfListeners << " listeners, position " << i << ": expected listener " << expectedListener << " at " << expectedDistance
+                              << ", batch gave " << listeners[i] << " at " << distances[i] << ", single gave " << listener << " at " << distance << std::endl;
+                    mismatches++;
+                }
+            }
+        }
+    }
+    // Position 2 is the same distance from all four listeners, so the first one always wins
+    float distances[numberOfPositions];
+    int listeners[numberOfPositions];
+    NearestListener::find(x, y, z, numberOfPositions, listenerSets[1], 4, distances, listeners);
+    if (listeners[2] != 0)
+    {
+        std::cout << "ERROR: A four way tie went to listener " << listeners[2] << std::endl;
+        mismatches++;
+    }
+    // With no listeners the answer is listener 0 at distance 0
+    NearestListener::find(x, y, z, numberOfPositions, 0, 0, distances, listeners);
+    for (int i = 0; i < numberOfPositions; i++)
+    {
+        if (listeners[i] != 0 || distances[i] != 0.0f)
+        {
+            std::cout << "ERROR: Position " << i << " found a listener when there are none" << std::endl;
+            mismatches++;
+        }
+    }
+    // Send a message to the console
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void autoVelocityUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING AUTO VELOCITY UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    // The same moves at a low and a high update rate must give the same answers
+    const int numberOfRates = 2;
+    float rates[numberOfRates] = { 30.0f, 144.0f };
+    int mismatches = 0;
+    for (int i = 0; i < numberOfRates; i++)
+    {
+        float dTime = 1.0f / rates[i];
+        // Cruise along x at 100 units a second for a second
+        FMOD_VECTOR position = { 0.0f, 0.0f, 0.0f };
+        FMOD_VECTOR previousPosition = position;
+        FMOD_VECTOR velocity = { 0.0f, 0.0f, 0.0f };
+        for (int step = 0; step < (int)rates[i]; step++)
+        {
+            position.x += 100.0f * dTime;
+            AutoVelocity::derive(position, previousPosition, velocity, dTime, AUTOVELOCITY_DEFAULT_SMOOTHING, AUTOVELOCITY_DEFAULT_TELEPORT_SPEED);
+        }
+        // Send a message to the console
+        std::cout << rates[i] << " updates a second: cruising at " << velocity.x << std::endl;
+        if (std::fabs(velocity.x - 100.0f) > 1.0f)
+        {
+            std::cout << "ERROR: The derived velocity did not settle on 100" << std::endl;
+            mismatches++;
+        }
+        // A jump of 50 units in one update is a teleport at either rate
+        position.x += 50.0f;
+        AutoVelocity::derive(position, previousPosition, velocity, dTime, AUTOVELOCITY_DEFAULT_SMOOTHING, AUTOVELOCITY_DEFAULT_TELEPORT_SPEED);
+        // Send a message to the console
+        std::cout << rates[i] << " updates a second: after a teleport " << velocity.x << std::endl;
+        if (velocity.x != 0.0f)
+        {
+            std::cout << "ERROR: The teleport was not caught" << std::endl;
+            mismatches++;
+        }
+        // Nothing changes when no time has passed
+        position.x += 1.0f;
+        AutoVelocity::derive(position, previousPosition, velocity, 0.0f, AUTOVELOCITY_DEFAULT_SMOOTHING, AUTOVELOCITY_DEFAULT_TELEPORT_SPEED);
+        if (velocity.x != 0.0f || previousPosition.x == position.x)
+        {
+            std::cout << "ERROR: A zero time step changed the velocity" << std::endl;
+            mismatches++;
+        }
+    }
+    // Send a message to the console
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void streamPoolUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING STREAM POOL UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    std::string filename = "media/music/bensound-littleidea.ogg";
+    // Grab the mixer block length and the output rate
+    unsigned int blockLength = 0;
+    int numberOfBlocks = 0;
+    FMOD_System_GetDSPBufferSize(FMODGlobals::pFMODSystem, &blockLength, &numberOfBlocks);
+    int outputRate = 0;
+    FMOD_System_GetSoftwareFormat(FMODGlobals::pFMODSystem, &outputRate, 0, 0);
+    FMOD_CHANNELGROUP* pMasterGroup = 0;
+    FMOD_System_GetMasterChannelGroup(FMODGlobals::pFMODSystem, &pMasterGroup);
+    // Preload the file and wait until a stream is ready
+    StreamPool* pStreamPool = audioSystem.getStreamPool();
+    pStreamPool->preload(filename, FMOD_DEFAULT, 1);
+    while (pStreamPool->getNumberOfReady(filename, FMOD_DEFAULT) < 1)
+    {
+        // Think for the AudioSystem
+        audioSystem.think();
+        // Update the AudioSystem
+        audioSystem.update();
+    }
+    int mismatches = 0;
+    const int numberOfPlays = 3;
+    for (int i = 0; i < numberOfPlays; i++)
+    {
+        // Take a ready stream
+        Stream stream;
+        if (stream.load(filename) == false)
+        {
+            std::cout << "ERROR: Failed to load " << filename << std::endl;
+            mismatches++;
+            break;
+        }
+        // Play it, noting the mixer clock at the moment of asking
+        unsigned long long playClock = 0;
+        FMOD_ChannelGroup_GetDSPClock(pMasterGroup, &playClock, 0);
+        stream.play();
+        // Wait until the mixer has played some of it
+        FMOD_CHANNEL* pChannel = stream.getFMODChannel();
+        unsigned int position = 0;
+        unsigned long long seenClock = 0;
+        for (int update = 0; update < 1000 && position == 0; update++)
+        {
+            // Update the AudioSystem
+            audioSystem.update();
+            // Read the clock either side of the position so both come from the same mix
+            unsigned long long checkClock = 0;
+            FMOD_ChannelGroup_GetDSPClock(pMasterGroup, &seenClock, 0);
+            FMOD_Channel_GetPosition(pChannel, &position, FMOD_TIMEUNIT_PCM);
+            FMOD_ChannelGroup_GetDSPClock(pMasterGroup, &checkClock, 0);
+            if (checkClock != seenClock)
+                position = 0;
+        }
+        if (position == 0)
+        {
+            std::cout << "ERROR: The stream never started" << std::endl;
+            mismatches++;
+            continue;
+        }
+        // Work back from how far it has played to the clock it started at
+        float frequency = 0.0f;
+        FMOD_Channel_GetFrequency(pChannel, &frequency);
+        unsigned long long played = (frequency > 0.0f) ? (unsigned long long)((double)position * outputRate / frequency) : 0;
+        long long startDelay = (long long)(seenClock - played) - (long long)playClock;
+        // Send a message to the console
+        std::cout << "Play " << i << ": started " << startDelay << " samples after asking (block is " << blockLength << ")" << std::endl;
+        if (startDelay > (long long)blockLength)
+        {
+            std::cout << "ERROR: A pooled stream took longer than one mixer block to start" << std::endl;
+            mismatches++;
+        }
+        stream.stop();
+        // Wait for the pool to prime another
+        while (pStreamPool->getNumberOfReady(filename, FMOD_DEFAULT) < 1)
+        {
+            // Think for the AudioSystem
+            audioSystem.think();
+            // Update the AudioSystem
+            audioSystem.update();
+        }
+    }
+    // Send a message to the console
+    std::cout << "Hits: " << pStreamPool->getNumberOfHits() << " Misses: " << pStreamPool->getNumberOfMisses() << std::endl;
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Stop keeping the file open
+    pStreamPool->unload(filename, FMOD_DEFAULT);
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void audioFileSystemUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING AUDIO FILE SYSTEM UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    std::string filename = "media/sounds/electronics014.ogg";
+    // Read through the AudioFileSystem
+    AudioFileSystem* pAudioFileSystem = audioSystem.getAudioFileSystem();
+    bool attachedFlag = pAudioFileSystem->isAttached();
+    if (attachedFlag == false && pAudioFileSystem->attach() == false)
+    {
+        // Send a message to the console
+        std::cout << "ERROR: Failed to attach the AudioFileSystem" << std::endl;
+        // Failure
+        return;
+    }
+    pAudioFileSystem->resetStats();
+    int mismatches = 0;
+    // Load the file twice (the second load should come out of the cache)
+    AudioFileStats stats[2];
+    for (int i = 0; i < 2; i++)
+    {
+        FMOD_SOUND* pFMODSound = 0;
+        if (FMOD_System_CreateSound(FMODGlobals::pFMODSystem, filename.c_str(), FMOD_DEFAULT, 0, &pFMODSound) != FMOD_OK)
+        {
+            std::cout << "ERROR: Failed to load " << filename << std::endl;
+            mismatches++;
+            break;
+        }
+        FMOD_Sound_Release(pFMODSound);
+        if (pAudioFileSystem->getFileStats(filename, stats[i]) == false)
+        {
+            std::cout << "ERROR: No stats for " << filename << std::endl;
+            mismatches++;
+            break;
+        }
+        // Send a message to the console
+        std::cout << "Load " << i << ": opens " << stats[i].numberOfOpens << " read " << stats[i].bytesRead << " from disk " << stats[i].bytesFromDisk << " cache hits " << stats[i].cacheHits << std::endl;
+    }
+    if (mismatches == 0)
+    {
+        // The first load reads the disk
+        if (stats[0].numberOfOpens != 1 || stats[0].bytesFromDisk <= 0 || stats[0].bytesRead <= 0)
+        {
+            std::cout << "ERROR: The first load did not read the file off the disk" << std::endl;
+            mismatches++;
+        }
+        // The second reads the same bytes without touching the disk
+        if (stats[1].numberOfOpens != 2 || stats[1].bytesRead != 2 * stats[0].bytesRead || stats[1].bytesFromDisk != stats[0].bytesFromDisk || stats[1].cacheHits <= stats[0].cacheHits)
+        {
+            std::cout << "ERROR: The second load did not come out of the cache" << std::endl;
+            mismatches++;
+        }
+    }
+    // Hand file I/O back to FMOD
+    if (attachedFlag == false)
+        pAudioFileSystem->detach();
+    // Send a message to the console
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void audioIOSchedulerUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING AUDIO IO SCHEDULER UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    // One thread so the order the reads are taken in is the order they finish
+    IOTestLog log;
+    log.startedFlag.store(false);
+    log.gateFlag.store(false);
+    AudioIOScheduler scheduler;
+    if (scheduler.start(1, ioReadCallback, &log) == false)
+    {
+        // Send a message to the console
+        std::cout << "ERROR: Failed to start the AudioIOScheduler" << std::endl;
+        // Failure
+        return;
+    }
+    // Reads 0-2 are loads, 3 is a stream refill FMOD isn't worried about and 4 one it is
+    const int numberOfReads = 5;
+    int priorities[numberOfReads] = { 0, 0, 0, 10, 90 };
+    AUDIOIO_LANE lanes[numberOfReads] = { AUDIOIO_LANE_LOAD, AUDIOIO_LANE_LOAD, AUDIOIO_LANE_LOAD, AUDIOIO_LANE_STREAM, AUDIOIO_LANE_STREAM };
+    FMOD_ASYNCREADINFO infos[numberOfReads];
+    for (int i = 0; i < numberOfReads; i++)
+    {
+        infos[i].handle = 0;
+        infos[i].offset = (unsigned int)i;
+        infos[i].sizebytes = 0;
+        infos[i].priority = priorities[i];
+        infos[i].userdata = &log;
+        infos[i].buffer = 0;
+        infos[i].bytesread = 0;
+        infos[i].done = ioDoneCallback;
+    }
+    // Tie the thread up with the first load
+    scheduler.submit(&(infos[0]), lanes[0]);
+    while (log.startedFlag.load() == false)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    // Queue the rest behind it and cancel a queued load
+    for (int i = 1; i < numberOfReads; i++)
+        scheduler.submit(&(infos[i]), lanes[i]);
+    scheduler.cancel(&(infos[2]));
+    // Let it go and wait for the queue to empty
+    log.gateFlag.store(true);
+    scheduler.stop();
+    // The cancel is done at once, then the load already being read, the urgent refill, the other refill and the load
+    const int numberExpected = 5;
+    unsigned int expected[numberExpected] = { 2, 0, 4, 3, 1 };
+    int mismatches = 0;
+    // Send a message to the console
+    std::cout << "Order:";
+    for (unsigned int i = 0; i < log.order.size(); i++)
+        std::cout << " " << log.order[i];
+    std::cout << std::endl;
+    if ((int)log.order.size() != numberExpected)
+    {
+        std::cout << "ERROR: Expected " << numberExpected << " reads to finish, " << log.order.size() << " did" << std::endl;
+        mismatches++;
+    }
+    else
+    {
+        for (int i = 0; i < numberExpected; i++)
+        {
+            if (log.order[i] != expected[i])
+            {
+                std::cout << "ERROR: Read " << log.order[i] << " finished where read " << expected[i] << " should have" << std::endl;
+                mismatches++;
+            }
+            FMOD_RESULT expectedResult = (expected[i] == 2) ? FMOD_ERR_FILE_DISKEJECTED : FMOD_OK;
+            if (log.results[i] != expectedResult)
+            {
+                std::cout << "ERROR: Read " << log.order[i] << " finished with " << FMOD_ErrorString(log.results[i]) << std::endl;
+                mismatches++;
+            }
+        }
+    }
+    // The counters must agree
+    if (scheduler.getNumberOfCompleted(AUDIOIO_LANE_STREAM) != 2 || scheduler.getNumberOfCompleted(AUDIOIO_LANE_LOAD) != 2 || scheduler.getNumberOfCancelled() != 1)
+    {
+        std::cout << "ERROR: The counters don't match the reads" << std::endl;
+        mismatches++;
+    }
+    // Send a message to the console
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void audioManagerUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING AUDIO MANAGER UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    std::string filename = "media/sounds/electronics014.ogg";
+    int mismatches = 0;
+    // Start empty with no budget
+    audioManager.clear();
+    audioManager.setMemoryBudget(0);
+    // Load the file as a 2D and a 3D SoundSample
+    SoundSample* pSoundSample2D = audioManager.getSoundSample(filename);
+    SoundSample* pSoundSample3D = audioManager.getSoundSample3D(filename);
+    if (pSoundSample2D == 0 || pSoundSample3D == 0)
+    {
+        // Send a message to the console
+        std::cout << "ERROR: Failed to load " << filename << std::endl;
+        // Failure
+        return;
+    }
+    // Destroy the 3D one (it must leave the index and the memory total)
+    unsigned int memoryUsage = audioManager.getMemoryUsage();
+    unsigned int sizeInBytes = pSoundSample3D->getMemoryUsage();
+    audioManager.destroySoundSample(pSoundSample3D);
+    // Send a message to the console
+    std::cout << "Destroy: memory " << memoryUsage << " -> " << audioManager.getMemoryUsage() << std::endl;
+    if (audioManager.getMemoryUsage() != memoryUsage - sizeInBytes)
+    {
+        std::cout << "ERROR: Destroying a SoundSample left its memory in the total" << std::endl;
+        mismatches++;
+    }
+    if (audioManager.getSoundSample3D(AssetIds::make(filename)) != 0)
+    {
+        std::cout << "ERROR: Destroying a SoundSample left it in the index" << std::endl;
+        mismatches++;
+    }
+    // Evict everything (only the 2D one may be found and released)
+    audioManager.setMemoryBudget(1);
+    // Send a message to the console
+    std::cout << "Evict: memory " << audioManager.getMemoryUsage() << std::endl;
+    if (audioManager.getMemoryUsage() != 0 || audioManager.getSoundSample(AssetIds::make(filename)) != 0)
+    {
+        std::cout << "ERROR: Evicting left a SoundSample behind" << std::endl;
+        mismatches++;
+    }
+    audioManager.setMemoryBudget(0);
+    // Clear (nothing left to release twice)
+    audioManager.clear();
+    // Send a message to the console
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void asyncLoadUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING ASYNC LOAD UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    std::string filename = "media/sounds/electronics014.ogg";
+    int mismatches = 0;
+    audioManager.clear();
+    // Two async loads of the same file share one load
+    int loaded = 0;
+    SoundSample* pFirst = audioManager.loadSoundSampleAsync(filename, soundSampleLoadedCallback, &loaded);
+    SoundSample* pSecond = audioManager.loadSoundSampleAsync(filename, soundSampleLoadedCallback, &loaded);
+    if (pFirst == 0 || pFirst != pSecond || audioManager.getNumberOfPendingLoads() != 1)
+    {
+        std::cout << "ERROR: Two async loads of the same file did not share one load" << std::endl;
+        mismatches++;
+    }
+    // A sync load while it is in flight waits for the same SoundSample
+    if (audioManager.getSoundSample(filename) != pFirst)
+    {
+        std::cout << "ERROR: A sync load did not join the async load" << std::endl;
+        mismatches++;
+    }
+    // Let the callbacks run
+    while (audioManager.getNumberOfPendingLoads() > 0)
+    {
+        audioManager.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // Send a message to the console
+    std::cout << "Async: " << loaded << " callbacks" << std::endl;
+    if (loaded != 2)
+    {
+        std::cout << "ERROR: Expected both callbacks to be called" << std::endl;
+        mismatches++;
+    }
+    audioManager.clear();
+    // Sync loads racing on several threads all get the same SoundSample
+    const int numberOfThreads = 4;
+    SoundSample* soundSamples[numberOfThreads];
+    std::atomic<bool> goFlag(false);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        soundSamples[i] = 0;
+        threads.push_back(std::thread([&soundSamples, &goFlag, &filename, i]()
+        {
+            while (goFlag.load() == false)
+                std::this_thread::yield();
+            soundSamples[i] = audioManager.getSoundSample3D(filename);
+        }));
+    }
+    goFlag.store(true);
+    for (int i = 0; i < numberOfThreads; i++)
+        threads[i].join();
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        if (soundSamples[i] == 0 || soundSamples[i] != soundSamples[0])
+        {
+            std::cout << "ERROR: Thread " << i << " got a SoundSample of its own" << std::endl;
+            mismatches++;
+        }
+    }
+    audioManager.clear();
+    // Send a message to the console
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void audioCommandQueueUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING AUDIO COMMAND QUEUE UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    int mismatches = 0;
+    // Stand in Channels (the queue only compares them, they are never called)
+    const int numberOfProducers = 4;
+    const int commandsPerProducer = 20000;
+    int targets[numberOfProducers];
+    Channel* pTargets[numberOfProducers];
+    for (int i = 0; i < numberOfProducers; i++)
+        pTargets[i] = (Channel*)&(targets[i]);
+    // Several producers push while this thread pops
+    AudioCommandQueue queue(1024);
+    std::atomic<int> finishedProducers(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numberOfProducers; i++)
+    {
+        threads.push_back(std::thread([&queue, &pTargets, &finishedProducers, i]()
+        {
+            for (int j = 0; j < commandsPerProducer; j++)
+            {
+                AudioCommand command;
+                command.type = AUDIO_COMMAND_VOLUME;
+                command.pChannel = pTargets[i];
+                command.values[0] = (float)j;
+                // A full queue drops the command so keep trying until the consumer makes room
+                while (queue.push(command) == false)
+                    std::this_thread::yield();
+            }
+            finishedProducers.fetch_add(1);
+        }));
+    }
+    // Each producer's commands must come out in the order it pushed them
+    int popped = 0;
+    int outOfOrder = 0;
+    float lastValues[numberOfProducers];
+    for (int i = 0; i < numberOfProducers; i++)
+        lastValues[i] = -1.0f;
+    AudioCommand command;
+    while (true)
+    {
+        // Every producer finished before the pop came back empty means the queue is drained
+        bool finishedFlag = (finishedProducers.load() == numberOfProducers);
+        if (queue.pop(command) == false)
+        {
+            if (finishedFlag == true)
+                break;
+            std::this_thread::yield();
+            continue;
+        }
+        popped++;
+        // Which producer pushed it
+        int producer = -1;
+        for (int i = 0; i < numberOfProducers; i++)
+        {
+            if (command.pChannel == pTargets[i])
+                producer = i;
+        }
+        if (producer == -1 || command.values[0] <= lastValues[producer])
+        {
+            outOfOrder++;
+            continue;
+        }
+        lastValues[producer] = command.values[0];
+    }
+    for (int i = 0; i < numberOfProducers; i++)
+        threads[i].join();
+    // Send a message to the console
+    std::cout << "MPSC: " << popped << " popped, " << queue.getDroppedCommands() << " pushes found the queue full" << std::endl;
+    if (popped != numberOfProducers * commandsPerProducer)
+    {
+        std::cout << "ERROR: Expected " << numberOfProducers * commandsPerProducer << " commands to be popped" << std::endl;
+        mismatches++;
+    }
+    if (outOfOrder > 0)
+    {
+        std::cout << "ERROR: " << outOfOrder << " commands came out of order or for the wrong Channel" << std::endl;
+        mismatches++;
+    }
+    // A full queue drops what does not fit and takes commands again once popped
+    AudioCommandQueue smallQueue(8);
+    int pushed = 0;
+    command.pChannel = pTargets[0];
+    for (int i = 0; i < 10; i++)
+    {
+        if (smallQueue.push(command) == true)
+            pushed++;
+    }
+    if (pushed != 8 || smallQueue.getDroppedCommands() != 2)
+    {
+        std::cout << "ERROR: A full queue of 8 took " << pushed << " commands and dropped " << smallQueue.getDroppedCommands() << std::endl;
+        mismatches++;
+    }
+    while (smallQueue.pop(command) == true) {}
+    if (smallQueue.push(command) == false)
+    {
+        std::cout << "ERROR: The queue did not take commands again once it was popped" << std::endl;
+        mismatches++;
+    }
+    while (smallQueue.pop(command) == true) {}
+    // Forgetting a Channel blanks its waiting commands and leaves the rest alone
+    for (int i = 0; i < 6; i++)
+    {
+        command.pChannel = pTargets[i % 2];
+        smallQueue.push(command);
+    }
+    unsigned int forgotten = smallQueue.forget(pTargets[0]);
+    int blanked = 0;
+    int kept = 0;
+    while (smallQueue.pop(command) == true)
+    {
+        if (command.pChannel == 0)
+            blanked++;
+        else if (command.pChannel == pTargets[1])
+            kept++;
+    }
+    if (forgotten != 3 || blanked != 3 || kept != 3)
+    {
+        std::cout << "ERROR: forget() blanked " << forgotten << " commands (" << blanked << " popped blank, " << kept << " kept)" << std::endl;
+        mismatches++;
+    }
+    // Send a message to the console
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
+void fileValidationUnitTest()
+{
+     // Send a message to the console
+    std::cout << std::endl;
+    std::cout << "PERFORMING FILE VALIDATION UNIT TEST" << std::endl;
+    std::cout << std::endl;
+    int mismatches = 0;
+    // An offset which wraps around when anything is added to it
+    const unsigned long long hugeOffset = 0xFFFFFFFFFFFFFFF0ULL;
+    // Compare a load against what was expected
+    auto expect = [&mismatches](const char* description, bool expectedFlag, bool loadedFlag)
+    {
+        if (loadedFlag == expectedFlag)
+            return;
+        std::cout << "ERROR: " << description << ((expectedFlag == true) ? " did not load" : " loaded") << std::endl;
+        mismatches++;
+    };
+    // A well formed bank: one 16 byte sound with its padding either side then the entry and its name
+    std::string bankFilename = "validation.bank";
+    unsigned long long entriesOffset = sizeof(SoundBankHeader) + SOUNDBANK_PADDING + 16 + SOUNDBANK_PADDING;
+    unsigned long long bankNamesOffset = entriesOffset + sizeof(SoundBankEntry);
+    SoundBankHeader bankHeader;
+    std::memset(&bankHeader, 0, sizeof(SoundBankHeader));
+    bankHeader.magic = SOUNDBANK_MAGIC;
+    bankHeader.version = SOUNDBANK_VERSION;
+    bankHeader.numberOfEntries = 1;
+    bankHeader.entriesOffset = entriesOffset;
+    bankHeader.namesOffset = bankNamesOffset;
+    SoundBankEntry bankEntry;
+    std::memset(&bankEntry, 0, sizeof(SoundBankEntry));
+    bankEntry.id = AssetIds::make("a");
+    bankEntry.dataOffset = sizeof(SoundBankHeader) + SOUNDBANK_PADDING;
+    bankEntry.dataSize = 16;
+    // Write the bank laid out as above with whatever the header and entry say
+    auto writeBank = [&](const SoundBankHeader& header, const SoundBankEntry& entry, unsigned long long size)
+    {
+        std::vector<unsigned char> bytes((size_t)(bankNamesOffset + 2), 0);
+        std::memcpy(&bytes[0], &header, sizeof(SoundBankHeader));
+        std::memcpy(&bytes[(size_t)entriesOffset], &entry, sizeof(SoundBankEntry));
+        bytes[(size_t)bankNamesOffset] = 'a';
+        bytes.resize((size_t)size);
+        return writeTestFile(bankFilename, bytes);
+    };
+    BankLoader bankLoader;
+    SoundBankHeader badBankHeader;
+    SoundBankEntry badBankEntry;
+    writeBank(bankHeader, bankEntry, bankNamesOffset + 2);
+    expect("A well formed bank", true, bankLoader.load(bankFilename));
+    bankLoader.unload();
+    writeBank(bankHeader, bankEntry, sizeof(SoundBankHeader) + 8);
+    expect("A bank cut short", false, bankLoader.load(bankFilename));
+    badBankHeader = bankHeader;
+    badBankHeader.entriesOffset = hugeOffset;
+    writeBank(badBankHeader, bankEntry, bankNamesOffset + 2);
+    expect("A bank with its entries past 2^64", false, bankLoader.load(bankFilename));
+    badBankHeader = bankHeader;
+    badBankHeader.numberOfEntries = 0x7FFFFFFF;
+    writeBank(badBankHeader, bankEntry, bankNamesOffset + 2);
+    expect("A bank with more entries than the file holds", false, bankLoader.load(bankFilename));
+    badBankEntry = bankEntry;
+    badBankEntry.dataOffset = hugeOffset;
+    badBankEntry.dataSize = 0x20;
+    writeBank(bankHeader, badBankEntry, bankNamesOffset + 2);
+    expect("A bank entry whose data wraps around", false, bankLoader.load(bankFilename));
+    badBankEntry = bankEntry;
+    badBankEntry.nameOffset = 100;
+    writeBank(bankHeader, badBankEntry, bankNamesOffset + 2);
+    expect("A bank entry whose name is past the end", false, bankLoader.load(bankFilename));
+    bankLoader.unload();
+    std::remove(bankFilename.c_str());
+    // A well formed geometry file: the header, one empty mesh and its name
+    std::string geometryFilename = "validation.geometry";
+    unsigned long long meshesOffset = sizeof(GeometryFileHeader);
+    unsigned long long geometryNamesOffset = meshesOffset + sizeof(GeometryFileMesh);
+    GeometryFileHeader geometryHeader;
+    std::memset(&geometryHeader, 0, sizeof(GeometryFileHeader));
+    geometryHeader.magic = GEOMETRYFILE_MAGIC;
+    geometryHeader.version = GEOMETRYFILE_VERSION;
+    geometryHeader.numberOfMeshes = 1;
+    geometryHeader.meshesOffset = meshesOffset;
+    geometryHeader.namesOffset = geometryNamesOffset;
+    GeometryFileMesh geometryMesh;
+    std::memset(&geometryMesh, 0, sizeof(GeometryFileMesh));
+    geometryMesh.id = AssetIds::make("a");
+    geometryMesh.dataOffset = meshesOffset;
+    // Write the geometry file laid out as above with whatever the header and mesh say
+    auto writeGeometry = [&](const GeometryFileHeader& header, const GeometryFileMesh& mesh, unsigned long long size)
+    {
+        std::vector<unsigned char> bytes((size_t)(geometryNamesOffset + 2), 0);
+        std::memcpy(&bytes[0], &header, sizeof(GeometryFileHeader));
+        std::memcpy(&bytes[(size_t)meshesOffset], &mesh, sizeof(GeometryFileMesh));
+        bytes[(size_t)geometryNamesOffset] = 'a';
+        bytes.resize((size_t)size);
+        return writeTestFile(geometryFilename, bytes);
+    };
+    // The meshes are not created so only the file itself is checked
+    GeometryLibrary geometryLibrary;
+    GeometryFileHeader badGeometryHeader;
+    GeometryFileMesh badGeometryMesh;
+    writeGeometry(geometryHeader, geometryMesh, geometryNamesOffset + 2);
+    expect("A well formed geometry file", true, geometryLibrary.load(geometryFilename, false));
+    geometryLibrary.unload();
+    writeGeometry(geometryHeader, geometryMesh, sizeof(GeometryFileHeader) + 8);
+    expect("A geometry file cut short", false, geometryLibrary.load(geometryFilename, false));
+    badGeometryHeader = geometryHeader;
+    badGeometryHeader.meshesOffset = hugeOffset;
+    writeGeometry(badGeometryHeader, geometryMesh, geometryNamesOffset + 2);
+    expect("A geometry file with its meshes past 2^64", false, geometryLibrary.load(geometryFilename, false));
+    badGeometryHeader = geometryHeader;
+    badGeometryHeader.numberOfMeshes = 0x7FFFFFFF;
+    writeGeometry(badGeometryHeader, geometryMesh, geometryNamesOffset + 2);
+    expect("A geometry file with more meshes than the file holds", false, geometryLibrary.load(geometryFilename, false));
+    badGeometryMesh = geometryMesh;
+    badGeometryMesh.dataOffset = hugeOffset;
+    badGeometryMesh.dataSize = 0x20;
+    writeGeometry(geometryHeader, badGeometryMesh, geometryNamesOffset + 2);
+    expect("A mesh whose data wraps around", false, geometryLibrary.load(geometryFilename, false));
+    badGeometryMesh = geometryMesh;
+    badGeometryMesh.nameOffset = 100;
+    writeGeometry(geometryHeader, badGeometryMesh, geometryNamesOffset + 2);
+    expect("A mesh whose name is past the end", false, geometryLibrary.load(geometryFilename, false));
+    geometryLibrary.unload();
+    std::remove(geometryFilename.c_str());
+    // Send a message to the console
+    std::cout << "Mismatches: " << mismatches << std::endl;
+    std::cout << "TEST COMPLETE" << std::endl;
+    // Wait for no keypress
+    waitForNoKeypress();
+}
+
 void dspUnitTest()
 {
      // Send a message to the console
@@ -1025,3 +2230,17 @@ void waitForNoKeypress()
          }
     }
 }
+
+bool writeTestFile(const std::string& filename, const std::vector<unsigned char>& bytes)
+{
+    // Open the file
+    FILE* pFile = fopen(filename.c_str(), "wb");
+    if (pFile == 0)
+        return false;
+    // Write the bytes
+    size_t written = (bytes.empty() == true) ? 0 : fwrite(&bytes[0], 1, bytes.size(), pFile);
+    // Close the file
+    fclose(pFile);
+    // Success if all of it was written
+    return (written == bytes.size());
+}